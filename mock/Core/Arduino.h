@@ -31,6 +31,7 @@
 #define PROGMEM
 struct __FlashStringHelper;
 #define pgm_read_ptr_near(ptr) ((void *) *(ptr))
+#define pgm_read_word_near(ptr) (*(const uint16_t *)(ptr))
 #define F(x) (reinterpret_cast<const __FlashStringHelper *>(x))
 
 #define HIGH 0x1
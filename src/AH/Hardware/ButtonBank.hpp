@@ -0,0 +1,114 @@
+/* ✔ */
+
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
+
+#include <AH/Hardware/Button.hpp>
+#include <AH/Hardware/Hardware-Types.hpp>
+#include <AH/Hardware/VerticalDebounce.hpp>
+#include <AH/STL/type_traits>
+
+BEGIN_AH_NAMESPACE
+
+/**
+ * @brief   A class that debounces a bank of up to 64 buttons at once.
+ *
+ * Instead of reading and debouncing every button separately, like Button, the
+ * bank takes the raw inputs of all buttons as a single bit mask, e.g. from a
+ * port register or from ExtIO::digitalReadMask, and debounces all of them with
+ * a few bitwise operations and a single call to `millis()`.
+ *
+ * The buttons are debounced like Button: a button that has been stable for at
+ * least @ref BUTTON_DEBOUNCE_TIME reports its first edge immediately, and the
+ * bounces that follow are ignored until the button is stable again. See
+ * VerticalDebounce.
+ *
+ * The buttons that changed are returned as a bit mask, that can be iterated
+ * using @ref popFirst.
+ *
+ * @tparam  N
+ *          The number of buttons [1, 64].
+ *
+ * @ingroup AH_HardwareUtils
+ */
+template <uint8_t N>
+class ButtonBank {
+    static_assert(N >= 1 && N <= 64, "ButtonBank supports 1 to 64 buttons");
+
+  public:
+    /// A bit mask with one bit per button.
+    using Mask = typename std::conditional<(N <= 32), uint32_t, uint64_t>::type;
+    /// The mask with the bits of all buttons set.
+    constexpr static Mask AllButtons =
+        N == 8 * sizeof(Mask) ? ~Mask(0)
+                              : (Mask(1) << (N % (8 * sizeof(Mask)))) - 1;
+
+    /**
+     * @brief   Debounce the given raw inputs.
+     *
+     * @param   inputs
+     *          The raw inputs: bit `i` is the state of button `i`, `HIGH` if
+     *          it is released, `LOW` if it is pressed.
+     * @return  The mask of the buttons whose debounced state changed.
+     */
+    Mask update(Mask inputs);
+    /// @copydoc update(Mask)
+    /// @param  now
+    ///         The current time in milliseconds.
+    Mask update(Mask inputs, unsigned long now);
+
+    /// Get the debounced states of all buttons (bit set if released).
+    Mask getStates() const { return buttons.debounced; }
+    /// Get the buttons that were pressed during the last update.
+    Mask getFalling() const { return changed & ~buttons.debounced; }
+    /// Get the buttons that were released during the last update.
+    Mask getRising() const { return changed & buttons.debounced; }
+    /// Get the buttons that changed during the last update.
+    Mask getChanged() const { return changed; }
+
+    /// Get the state of the given button, like Button::getState.
+    Button::State getState(uint8_t index) const;
+
+    /// Read the given pins into a bit mask, using ExtIO::digitalReadMask.
+    static Mask read(const PinList<N> &pins);
+
+    /**
+     * @brief   Get the index of the lowest bit that is set in the given mask,
+     *          and clear it.
+     *
+     * ```
+     * while (changed) {
+     *     uint8_t index = ButtonBank<N>::popFirst(changed);
+     *     // ...
+     * }
+     * ```
+     *
+     * @pre     `mask != 0`
+     */
+    static uint8_t popFirst(Mask &mask) {
+        uint8_t index = countTrailingZeros(mask);
+        mask &= mask - 1;
+        return index;
+    }
+
+  private:
+    static uint8_t countTrailingZeros(uint32_t x) { return __builtin_ctzl(x); }
+    static uint8_t countTrailingZeros(uint64_t x) {
+        return __builtin_ctzll(x);
+    }
+
+    unsigned long prevTick = 0;
+    /// All buttons released and stable.
+    VerticalDebounce<Mask> buttons = {AllButtons, AllButtons, AllButtons,
+                                      AllButtons};
+    /// The buttons that changed during the last update.
+    Mask changed = 0;
+};
+
+END_AH_NAMESPACE
+
+#include "ButtonBank.ipp" // Template implementations
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,40 @@
+#include "ButtonBank.hpp"
+#include <AH/Hardware/ExtendedInputOutput/ExtendedInputOutput.hpp>
+
+BEGIN_AH_NAMESPACE
+
+template <uint8_t N>
+constexpr typename ButtonBank<N>::Mask ButtonBank<N>::AllButtons;
+
+template <uint8_t N>
+typename ButtonBank<N>::Mask ButtonBank<N>::update(Mask inputs) {
+    return update(inputs, millis());
+}
+
+template <uint8_t N>
+typename ButtonBank<N>::Mask ButtonBank<N>::update(Mask inputs,
+                                                   unsigned long now) {
+    // Edit BUTTON_DEBOUNCE_TIME in Settings/Settings.hpp
+    uint8_t ticks = VerticalDebounce<Mask>::elapsedTicks(prevTick, now);
+    changed = buttons.update(inputs, ticks, AllButtons);
+    return changed;
+}
+
+template <uint8_t N>
+Button::State ButtonBank<N>::getState(uint8_t index) const {
+    bool state = (buttons.debounced >> index) & 1;
+    bool prevState = state ^ ((changed >> index) & 1);
+    return static_cast<Button::State>((prevState << 1) | state);
+}
+
+template <uint8_t N>
+typename ButtonBank<N>::Mask ButtonBank<N>::read(const PinList<N> &pins) {
+    Mask inputs = 0;
+    for (uint8_t i = 0; i < N; i += 32) {
+        uint8_t length = N - i < 32 ? N - i : 32;
+        inputs |= Mask(ExtIO::digitalReadMask(pins.data + i, length)) << i;
+    }
+    return inputs;
+}
+
+END_AH_NAMESPACE
@@ -6,12 +6,24 @@
 AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
 
 #include <AH/Hardware/Hardware-Types.hpp>
+#include <AH/Hardware/VerticalDebounce.hpp>
 
 BEGIN_AH_NAMESPACE
 
 /**
  * @brief   A class that reads the states of a button matrix.
  *
+ * The matrix is scanned on every update, and every button is debounced
+ * separately: a button that has been stable for at least
+ * @ref BUTTON_DEBOUNCE_TIME reports its first edge immediately, and the bounces
+ * that follow are ignored until the button is stable again. Changes of buttons
+ * that are not yet stable are reported when they have been stable for that
+ * time.
+ *
+ * The number of debounce ticks since the last change of every button is kept
+ * in a 2-bit vertical counter (see VerticalDebounce), so the whole matrix uses
+ * four bits per button.
+ *
  * @tparam  nb_rows
  *          The number of rows in the button matrix.
  * @tparam  nb_cols
@@ -50,6 +62,9 @@ class ButtonMatrix {
     /**
      * @brief   Scan the matrix, read all button states, and call the
      *          onButtonChanged callback.
+     * 
+     * All columns of a row are read at once (see @ref ExtIO::digitalReadMask),
+     * so columns on an ExtIO element only take a single transaction per row.
      */
     void update();
 
@@ -74,13 +89,33 @@ class ButtonMatrix {
      */
     virtual void onButtonChanged(uint8_t row, uint8_t col, bool state) = 0;
 
-    static inline uint8_t positionToBits(uint8_t col, uint8_t row);
-    static inline uint8_t bitsToIndex(uint8_t bits);
-    static inline uint8_t bitsToBitmask(uint8_t bits);
-    void setPrevState(uint8_t col, uint8_t row, bool state);
+    static_assert(nb_cols <= 32, "The columns of a row are read as a 32-bit "
+                                 "mask, at most 32 columns are supported");
+
+    /// The number of bytes of the states of a single row.
+    constexpr static uint8_t bytesPerRow = (nb_cols + 7) / 8;
+    /// The mask of the column bits of a row.
+    constexpr static uint32_t colMask =
+        nb_cols == 32 ? 0xFFFFFFFF : (uint32_t(1) << nb_cols) - 1;
+    /// Debounces all columns of a row.
+    using Debounce = VerticalDebounce<uint32_t>;
+
+    /// The bit planes with the state of every button.
+    enum Plane : uint8_t {
+        Debounced = 0, ///< The debounced states that were reported.
+        Raw = 1,       ///< The states of the last scan.
+        Count0 = 2,    ///< Bit 0 of the ticks since the last change.
+        Count1 = 3,    ///< Bit 1 of the ticks since the last change.
+    };
+
+    /// Get the bits of all columns of the given row and plane.
+    uint32_t getRow(Plane plane, uint8_t row) const;
+    /// Set the bits of all columns of the given row and plane.
+    void setRow(Plane plane, uint8_t row, uint32_t bits);
 
-    unsigned long prevRefresh = 0;
-    uint8_t prevStates[(nb_cols * nb_rows + 7) / 8];
+    unsigned long prevTick = 0;
+    /// The states of the buttons, row by row: bit `col` of row `row`.
+    uint8_t states[4][nb_rows * bytesPerRow];
 
     const PinList<nb_rows> rowPins;
     const PinList<nb_cols> colPins;
@@ -10,29 +10,37 @@ template <uint8_t nb_rows, uint8_t nb_cols>
 ButtonMatrix<nb_rows, nb_cols>::ButtonMatrix(const PinList<nb_rows> &rowPins,
                                              const PinList<nb_cols> &colPins)
     : rowPins(rowPins), colPins(colPins) {
-    memset(prevStates, 0xFF, sizeof(prevStates));
+    // All buttons released and stable
+    memset(states, 0xFF, sizeof(states));
 }
 
 template <uint8_t nb_rows, uint8_t nb_cols>
 void ButtonMatrix<nb_rows, nb_cols>::update() {
-    unsigned long now = millis();
-    // only update 25 ms after previous change (crude software debounce).
-    // Edit this in Settings/Settings.hpp
-    if (now - prevRefresh < BUTTON_DEBOUNCE_TIME)
-        return;
+    // Edit BUTTON_DEBOUNCE_TIME in Settings/Settings.hpp
+    uint8_t ticks = Debounce::elapsedTicks(prevTick, millis());
 
-    for (size_t row = 0; row < nb_rows; row++) { // scan through all rows
-        pinMode(rowPins[row], OUTPUT);           // make the current row Lo-Z 0V
-        for (size_t col = 0; col < nb_cols; col++) { // scan through all columns
-            bool state = digitalRead(colPins[col]);  // read the state
-            if (state != getPrevState(col, row)) {
-                // if the state changed since last time
+    for (uint8_t row = 0; row < nb_rows; row++) { // scan through all rows
+        pinMode(rowPins[row], OUTPUT); // make the current row Lo-Z 0V
+        // read the states of all columns
+        uint32_t raw = digitalReadMask(colPins.data, nb_cols);
+
+        Debounce buttons = {
+            getRow(Debounced, row),
+            getRow(Raw, row),
+            getRow(Count0, row),
+            getRow(Count1, row),
+        };
+        uint32_t toggled = buttons.update(raw, ticks, colMask);
+
+        for (uint8_t col = 0; col < nb_cols; col++)
+            if ((toggled >> col) & 1)
                 // execute the handler
-                onButtonChanged(row, col, state);
-                setPrevState(col, row, state); // remember the state
-                prevRefresh = now;
-            }
-        }
+                onButtonChanged(row, col, (raw >> col) & 1);
+        // remember the states
+        setRow(Debounced, row, buttons.debounced);
+        setRow(Raw, row, buttons.prevInputs);
+        setRow(Count0, row, buttons.count0);
+        setRow(Count1, row, buttons.count1);
         pinMode(rowPins[row], INPUT); // make the current row Hi-Z again
     }
 }
@@ -49,36 +57,24 @@ void ButtonMatrix<nb_rows, nb_cols>::begin() {
 }
 
 template <uint8_t nb_rows, uint8_t nb_cols>
-inline uint8_t ButtonMatrix<nb_rows, nb_cols>::positionToBits(uint8_t col,
-                                                              uint8_t row) {
-    // map from a 2D array of bits to a flat array of bits
-    return col * nb_rows + row;
-}
-
-template <uint8_t nb_rows, uint8_t nb_cols>
-inline uint8_t ButtonMatrix<nb_rows, nb_cols>::bitsToIndex(uint8_t bits) {
-    return bits >> 3; // bits / 8
+uint32_t ButtonMatrix<nb_rows, nb_cols>::getRow(Plane plane,
+                                                uint8_t row) const {
+    uint32_t bits = 0;
+    for (uint8_t i = 0; i < bytesPerRow; ++i)
+        bits |= uint32_t(states[plane][row * bytesPerRow + i]) << (8 * i);
+    return bits;
 }
 
 template <uint8_t nb_rows, uint8_t nb_cols>
-inline uint8_t ButtonMatrix<nb_rows, nb_cols>::bitsToBitmask(uint8_t bits) {
-    return 1 << (bits & 7); // bits % 8
+void ButtonMatrix<nb_rows, nb_cols>::setRow(Plane plane, uint8_t row,
+                                            uint32_t bits) {
+    for (uint8_t i = 0; i < bytesPerRow; ++i)
+        states[plane][row * bytesPerRow + i] = bits >> (8 * i);
 }
 
 template <uint8_t nb_rows, uint8_t nb_cols>
 bool ButtonMatrix<nb_rows, nb_cols>::getPrevState(uint8_t col, uint8_t row) {
-    uint8_t bits = positionToBits(col, row);
-    return !!(prevStates[bitsToIndex(bits)] & bitsToBitmask(bits));
-}
-
-template <uint8_t nb_rows, uint8_t nb_cols>
-void ButtonMatrix<nb_rows, nb_cols>::setPrevState(uint8_t col, uint8_t row,
-                                                  bool state) {
-    uint8_t bits = positionToBits(col, row);
-    if (state)
-        prevStates[bitsToIndex(bits)] |= bitsToBitmask(bits);
-    else
-        prevStates[bitsToIndex(bits)] &= ~bitsToBitmask(bits);
+    return (getRow(Debounced, row) >> col) & 1;
 }
 
 END_AH_NAMESPACE
\ No newline at end of file
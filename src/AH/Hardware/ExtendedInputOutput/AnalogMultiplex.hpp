@@ -8,6 +8,8 @@ AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
 #include "ExtendedInputOutput.hpp"
 #include "StaticSizeExtendedIOElement.hpp"
 #include <AH/Containers/Array.hpp>
+#include <AH/Settings/SettingsWrapper.hpp>
+#include <AH/Timing/MillisMicrosTimer.hpp>
 #include <stdlib.h>
 
 BEGIN_AH_NAMESPACE
@@ -138,7 +140,7 @@ class AnalogMultiplex : public StaticSizeExtendedIOElement<1 << N> {
      */
     void updateBufferedInputs() override {} // LCOV_EXCL_LINE
 
-  private:
+  protected:
     const pin_t analogPin;
     const Array<pin_t, N> addressPins;
     const pin_t enablePin;
@@ -170,6 +172,86 @@ class AnalogMultiplex : public StaticSizeExtendedIOElement<1 << N> {
     constexpr static auto MUX_DISABLED = HIGH;
 };
 
+/**
+ * @brief   A class for reading multiplexed analog inputs, that reads all inputs
+ *          into a buffer in a single scan.
+ *
+ * AnalogMultiplex selects the input and discards a conversion to let the
+ * multiplexer settle for every single read, so reading all 16 inputs of a
+ * 74HC4067 takes 32 conversions and 64 writes to the address lines.
+ *
+ * This class reads all inputs at once when the buffered inputs are updated
+ * (by `Control_Surface.loop()`, at most once every
+ * @ref FILTERED_INPUT_UPDATE_INTERVAL), and analogRead returns the value of the
+ * last scan. The inputs are visited in Gray code order, so only a single
+ * address line toggles between two inputs, and the next input is selected
+ * right after the conversion of the previous input, so the multiplexer settles
+ * while the result is stored. Only the first conversion of every scan is
+ * discarded.
+ *
+ * @note    Sources with a high output impedance may need the longer settling
+ *          time of AnalogMultiplex.
+ *
+ * @tparam  N
+ *          The number of address lines.
+ *
+ * @ingroup AH_ExtIO
+ */
+template <uint8_t N>
+class ScanningAnalogMultiplex : public AnalogMultiplex<N> {
+  public:
+    /// @copydoc AnalogMultiplex::AnalogMultiplex
+    ScanningAnalogMultiplex(pin_t analogPin,
+                            const Array<pin_t, N> &addressPins,
+                            pin_t enablePin = NO_PIN)
+        : AnalogMultiplex<N>(analogPin, addressPins, enablePin) {}
+
+    /**
+     * @brief   Get the analog value of the given input from the last scan.
+     *
+     * @param   pin
+     *          The multiplexer's pin number to read from.
+     */
+    analog_t analogRead(pin_t pin) override { return buffer[pin]; }
+
+    /**
+     * @copydoc analogRead
+     */
+    analog_t analogReadBuffered(pin_t pin) override { return buffer[pin]; }
+
+    /**
+     * @brief   Initialize the multiplexer, and scan all inputs.
+     */
+    void begin() override;
+
+    /**
+     * @brief   Scan all inputs, if the scan interval has elapsed.
+     */
+    void updateBufferedInputs() override {
+        if (scanTimer)
+            scan();
+    }
+
+    /**
+     * @brief   Read all inputs into the buffer.
+     */
+    void scan();
+
+    /// Set the minimum time between two scans, in microseconds.
+    void setScanInterval(unsigned long interval) {
+        scanTimer.setInterval(interval);
+    }
+
+  private:
+    /// The number of inputs.
+    constexpr static uint16_t length = 1 << N;
+    /// The address of the i-th input of a scan.
+    static uint8_t grayCode(uint8_t i) { return i ^ (i >> 1); }
+
+    Timer<micros> scanTimer = {FILTERED_INPUT_UPDATE_INTERVAL};
+    analog_t buffer[length] = {};
+};
+
 /**
  * @brief   An alias for AnalogMultiplex<4> to use with CD74HC4067 analog 
  *          multiplexers.
@@ -260,6 +342,40 @@ void AnalogMultiplex<N>::afterReading() {
         ExtIO::digitalWrite(enablePin, MUX_DISABLED);
 }
 
+// -------------------------------------------------------------------------- //
+
+template <uint8_t N>
+void ScanningAnalogMultiplex<N>::begin() {
+    AnalogMultiplex<N>::begin();
+    scan();
+}
+
+template <uint8_t N>
+void ScanningAnalogMultiplex<N>::scan() {
+    this->prepareReading(grayCode(0));
+    ExtIO::analogRead(this->analogPin); // Discard first reading
+    for (uint16_t i = 0; i < length; ++i) {
+        analog_t result = ExtIO::analogRead(this->analogPin);
+        if (i + 1 < length) {
+            // The next Gray code differs in the lowest set bit of i + 1,
+            // select it before storing the result
+            uint16_t next = i + 1;
+            uint8_t line = 0;
+            while ((next & 1) == 0) {
+                next >>= 1;
+                ++line;
+            }
+            bool state = (grayCode(i + 1) >> line) & 1;
+            ExtIO::digitalWrite(this->addressPins[line], state ? HIGH : LOW);
+#if !defined(__AVR__) && defined(ARDUINO)
+            delayMicroseconds(5);
+#endif
+        }
+        buffer[grayCode(i)] = result;
+    }
+    this->afterReading();
+}
+
 END_AH_NAMESPACE
 
 AH_DIAGNOSTIC_POP()
@@ -15,6 +15,42 @@ ExtendedIOElement::ExtendedIOElement(pin_t length)
                       "recommended."),
                     0x00FF);
     offset = end;
+    // New elements get the highest pin numbers, so the table stays sorted
+    if (lookupTableSize < EXTIO_LOOKUP_TABLE_SIZE)
+        lookupTable[lookupTableSize++] = this;
+    else
+        ++numUntabled;
+}
+
+ExtendedIOElement::~ExtendedIOElement() {
+    for (uint8_t i = 0; i < lookupTableSize; ++i) {
+        if (lookupTable[i] == this) {
+            for (uint8_t j = i + 1; j < lookupTableSize; ++j)
+                lookupTable[j - 1] = lookupTable[j];
+            --lookupTableSize;
+            return;
+        }
+    }
+    --numUntabled;
+}
+
+ExtendedIOElement *ExtendedIOElement::find(pin_t pin) {
+    // Find the last element that starts at or before the given pin
+    uint8_t lo = 0, hi = lookupTableSize;
+    while (lo < hi) {
+        uint8_t mid = (lo + hi) / 2;
+        if (lookupTable[mid]->start <= pin)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo > 0 && pin < lookupTable[lo - 1]->end)
+        return lookupTable[lo - 1];
+    if (numUntabled > 0)
+        for (auto &el : updatables)
+            if (pin >= el.start && pin < el.end)
+                return &el;
+    return nullptr;
 }
 
 void ExtendedIOElement::beginAll() {
@@ -57,6 +93,9 @@ DoublyLinkedList<ExtendedIOElement> &ExtendedIOElement::getAll() {
 }
 
 pin_t ExtendedIOElement::offset = NUM_DIGITAL_PINS + NUM_ANALOG_INPUTS;
+ExtendedIOElement *ExtendedIOElement::lookupTable[EXTIO_LOOKUP_TABLE_SIZE];
+uint8_t ExtendedIOElement::lookupTableSize = 0;
+uint8_t ExtendedIOElement::numUntabled = 0;
 
 END_AH_NAMESPACE
 
@@ -8,6 +8,7 @@ AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
 #include "ExtendedInputOutput.hpp"
 #include <AH/Containers/Updatable.hpp>
 #include <AH/Hardware/Hardware-Types.hpp>
+#include <AH/Settings/SettingsWrapper.hpp>
 
 BEGIN_AH_NAMESPACE
 
@@ -47,18 +48,18 @@ BEGIN_AH_NAMESPACE
  * translated to `mux1.digitalRead(7)`.
  *
  * The number of extended IO elements is limited only by the size of
- * `pin_t`. However, looking up the extended IO element for a given
- * extended IO pin number uses linear search, so that might add
- * some noticable overhead for large pin numbers.  
+ * `pin_t`. Looking up the extended IO element for a given extended IO pin
+ * number uses binary search in a table of all elements, sorted by their first
+ * pin number, so it takes at most six comparisons for 32 elements.
+ * The table has room for @ref EXTIO_LOOKUP_TABLE_SIZE elements, the pins of
+ * any additional elements are found using linear search.
  * 
  * The design here is a compromise: saving a pointer to each extended IO element
- * to find it directly would be much faster than having to search all elements
- * each time. On the other hand, it would require each `pin_t` variable to be
- * at least one byte larger. Since almost all other classes in this library 
- * store pin variables, the memory penalty would be too large, especially on AVR
- * microcontrollers.  
- * Another reason to do it this way, is that this approach is still fast enough
- * to make sure it is not noticable to human users.
+ * in every pin number to find it directly would be faster than having to
+ * search the table each time. On the other hand, it would require each `pin_t`
+ * variable to be at least one byte larger. Since almost all other classes in
+ * this library store pin variables, the memory penalty would be too large,
+ * especially on AVR microcontrollers.
  */
 class ExtendedIOElement : public UpdatableCRTP<ExtendedIOElement> {
   protected:
@@ -71,6 +72,9 @@ class ExtendedIOElement : public UpdatableCRTP<ExtendedIOElement> {
     ExtendedIOElement(pin_t length);
 
   public:
+    /// Destructor: remove the element from the lookup table.
+    ~ExtendedIOElement();
+
     /** 
      * @brief   Set the mode of a given pin.
      * 
@@ -140,6 +144,29 @@ class ExtendedIOElement : public UpdatableCRTP<ExtendedIOElement> {
      */
     virtual int digitalReadBuffered(pin_t pin) = 0;
 
+    /**
+     * @brief   Read the states of multiple consecutive pins at once.
+     * 
+     * The default implementation reads the physical state into the input
+     * buffer once, and then reads the pins from the buffer, so all pins are
+     * read in a single transaction. Elements that can read a whole port
+     * directly can override it.
+     * 
+     * @param   pin
+     *          The (zero-based) pin of this IO element of the first state.
+     * @param   length
+     *          The number of pins to read [0, 32].
+     * @return  The states of the pins: bit `i` is the state of pin `pin + i`.
+     */
+    virtual uint32_t digitalReadMask(pin_t pin, uint8_t length) {
+        updateBufferedInputs();
+        uint32_t states = 0;
+        for (uint8_t i = 0; i < length; ++i)
+            if (digitalReadBuffered(pin + i))
+                states |= uint32_t(1) << i;
+        return states;
+    }
+
     /**
      * @brief   Write an analog (or PWM) value to the given pin.
      * 
@@ -255,7 +282,23 @@ class ExtendedIOElement : public UpdatableCRTP<ExtendedIOElement> {
      */
     static DoublyLinkedList<ExtendedIOElement> &getAll();
 
+    /**
+     * @brief   Find the extended IO element that the given extended IO pin
+     *          number belongs to.
+     * 
+     * @return  A pointer to the element, or `nullptr` if the pin doesn't belong
+     *          to any element.
+     */
+    static ExtendedIOElement *find(pin_t pin);
+
   private:
+    /// The elements, sorted by their first pin number.
+    static ExtendedIOElement *lookupTable[EXTIO_LOOKUP_TABLE_SIZE];
+    /// The number of elements in @ref lookupTable.
+    static uint8_t lookupTableSize;
+    /// The number of elements that didn't fit in @ref lookupTable.
+    static uint8_t numUntabled;
+
     const pin_t length;
     const pin_t start;
     const pin_t end;
@@ -9,28 +9,13 @@ BEGIN_AH_NAMESPACE
 
 namespace ExtIO {
 
-template <class T>
-bool inRange(T target, T start, T end) {
-    return target >= start && target < end;
-}
-
 ExtendedIOElement &getIOElementOfPin(pin_t pin) {
-    for (auto &el : ExtendedIOElement::getAll())
-        if (pin < el.getStart())
-            break;
-        else if (inRange(pin, el.getStart(), el.getEnd()))
-            return el;
-
-    FATAL_ERROR(
-        F("The given pin does not correspond to an Extended IO element."),
-        0x8888);
-
-    // TODO: why doesn't this give a compilation error?
-    // No return statement. On desktop, FATAL_ERROR throws an exception, so
-    // I get why that works, but on Arduino, it just calls fatalErrorExit, which
-    // is marked 'noreturn'. However, if I remove the 'noreturn' attribute, and
-    // have it return immediately, it still compiles, without returning a valid
-    // reference.
+    ExtendedIOElement *el = ExtendedIOElement::find(pin);
+    if (el == nullptr)
+        FATAL_ERROR(
+            F("The given pin does not correspond to an Extended IO element."),
+            0x8888);
+    return *el;
 }
 
 void pinMode(pin_t pin, PinMode_t mode) {
@@ -99,6 +84,53 @@ void analogWrite(int pin, analog_t val) { analogWrite((pin_t)pin, val); }
 void analogWrite(int pin, int val) { analogWrite((pin_t)pin, (analog_t)val); }
 void analogWrite(pin_t pin, int val) { analogWrite(pin, (analog_t)val); }
 
+void digitalWriteMask(const pin_t *pins, uint8_t length, uint32_t states) {
+    ExtendedIOElement *pending = nullptr;
+    for (uint8_t i = 0; i < length; ++i, states >>= 1) {
+        pin_t pin = pins[i];
+        PinStatus_t val = (states & 1) ? HIGH : LOW;
+        if (pin == NO_PIN)
+            continue;
+        else if (pin < NUM_DIGITAL_PINS + NUM_ANALOG_INPUTS) {
+            ::digitalWrite(pin, val);
+        } else {
+            ExtendedIOElement &el = getIOElementOfPin(pin);
+            // Send the buffer of the previous element before moving on
+            if (pending != nullptr && pending != &el)
+                pending->updateBufferedOutputs();
+            pending = &el;
+            el.digitalWriteBuffered(pin - el.getStart(), val);
+        }
+    }
+    if (pending != nullptr)
+        pending->updateBufferedOutputs();
+}
+
+uint32_t digitalReadMask(const pin_t *pins, uint8_t length) {
+    uint32_t states = 0;
+    uint8_t i = 0;
+    while (i < length) {
+        pin_t pin = pins[i];
+        if (pin == NO_PIN) {
+            ++i;
+        } else if (pin < NUM_DIGITAL_PINS + NUM_ANALOG_INPUTS) {
+            if (::digitalRead(pin))
+                states |= uint32_t(1) << i;
+            ++i;
+        } else {
+            ExtendedIOElement &el = getIOElementOfPin(pin);
+            // Find the run of consecutive pins on the same element
+            uint8_t run = 1;
+            while (i + run < length && pins[i + run] == pin + run &&
+                   pin + run < el.getEnd())
+                ++run;
+            states |= el.digitalReadMask(pin - el.getStart(), run) << i;
+            i += run;
+        }
+    }
+    return states;
+}
+
 void pinModeBuffered(pin_t pin, PinMode_t mode) {
     if (pin == NO_PIN)
         return;
@@ -126,6 +126,36 @@ void shiftOut(pin_t dataPin, pin_t clockPin, BitOrder_t bitOrder, uint8_t val);
 /// An ExtIO version of the Arduino function
 void shiftOut(int dataPin, int clockPin, BitOrder_t bitOrder, uint8_t val);
 
+/**
+ * @brief   Set the outputs of multiple pins at once.
+ * 
+ * The pins of the same ExtIO element are written to its buffer, and the buffer
+ * is sent to the device once, instead of once per pin.
+ * 
+ * @param   pins
+ *          The pins to write to.
+ * @param   length
+ *          The number of pins.
+ * @param   states
+ *          The new states: bit `i` is the state of `pins[i]`. Pins after the
+ *          first 32 are set low.
+ */
+void digitalWriteMask(const pin_t *pins, uint8_t length, uint32_t states);
+
+/**
+ * @brief   Read the states of multiple pins at once.
+ * 
+ * Consecutive pins of the same ExtIO element are read in a single transaction
+ * using @ref ExtendedIOElement::digitalReadMask, instead of once per pin.
+ * 
+ * @param   pins
+ *          The pins to read.
+ * @param   length
+ *          The number of pins [0, 32].
+ * @return  The states: bit `i` is the state of `pins[i]`.
+ */
+uint32_t digitalReadMask(const pin_t *pins, uint8_t length);
+
 /// A buffered ExtIO version of the Arduino function
 /// @see   ExtendedIOElement::pinModeBuffered
 void pinModeBuffered(pin_t pin, PinMode_t mode);
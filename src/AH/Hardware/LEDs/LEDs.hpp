@@ -54,6 +54,18 @@ class LEDs {
             clear(pin);
     }
 
+    /**
+     * @brief   Turn on the LEDs in the given bit mask, and turn off all others.
+     * 
+     * LEDs on the same ExtIO element are updated in a single write.
+     * 
+     * @param   mask
+     *          Bit `i` is the state of LED `i`.
+     */
+    void displayMask(uint32_t mask) const {
+        ExtIO::digitalWriteMask(ledPins.data, N, mask);
+    }
+
     /// Turn on the given LED.
     void set(uint8_t index) const {
         // TODO: bounds check?
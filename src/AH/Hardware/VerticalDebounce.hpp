@@ -0,0 +1,98 @@
+/* ✔ */
+
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
+
+#include <AH/Settings/SettingsWrapper.hpp>
+#include <stdint.h>
+
+BEGIN_AH_NAMESPACE
+
+/**
+ * @brief   Debounces a set of buttons at once, using 2-bit vertical counters.
+ *
+ * Every bit of the masks belongs to a single button. For every button, the
+ * number of debounce ticks since its last change is counted, saturating at
+ * three. A button that has been stable for at least @ref BUTTON_DEBOUNCE_TIME
+ * reports its first edge immediately, and the bounces that follow are ignored
+ * until the button is stable again. Changes of buttons that are not yet stable
+ * are reported when they have been stable for that time.
+ *
+ * Used by ButtonBank and ButtonMatrix.
+ *
+ * @tparam  Mask
+ *          The unsigned integer type with one bit per button.
+ *
+ * @ingroup AH_HardwareUtils
+ */
+template <class Mask>
+struct VerticalDebounce {
+    /// The length of a debounce tick in milliseconds. A button is stable when
+    /// its counter reaches three, i.e. after at least two full ticks.
+    constexpr static unsigned long Tick = (BUTTON_DEBOUNCE_TIME + 1) / 2;
+
+    /**
+     * @brief   Get the number of debounce ticks since the previous tick, and
+     *          advance the time of the previous tick.
+     *
+     * @param   prevTick
+     *          The time of the previous tick, in milliseconds.
+     * @param   now
+     *          The current time, in milliseconds.
+     * @return  The number of ticks, at most three.
+     */
+    static uint8_t elapsedTicks(unsigned long &prevTick, unsigned long now) {
+        unsigned long ticks = (now - prevTick) / Tick;
+        prevTick += ticks * Tick;
+        return ticks < 3 ? ticks : 3;
+    }
+
+    /**
+     * @brief   Advance the counters, and debounce the new inputs.
+     *
+     * @param   inputs
+     *          The raw inputs of the buttons.
+     * @param   ticks
+     *          The number of ticks since the previous update, see
+     *          @ref elapsedTicks.
+     * @param   all
+     *          The mask with the bits of all buttons set.
+     * @return  The mask of the buttons whose debounced state toggled.
+     */
+    Mask update(Mask inputs, uint8_t ticks, Mask all) {
+        // advance the counters, saturating at three
+        if (ticks >= 3) {
+            count0 = count1 = all;
+        } else if (ticks == 2) {
+            count0 |= count1;
+            count1 = all;
+        } else if (ticks == 1) {
+            Mask prev0 = count0;
+            count0 = (~count0 | count1) & all;
+            count1 |= prev0;
+        }
+        inputs &= all;
+        // stable buttons that differ from the reported state toggle
+        Mask toggled = (inputs ^ debounced) & count0 & count1;
+        debounced ^= toggled;
+        // buttons that changed since the previous update are no longer stable
+        Mask bounced = inputs ^ prevInputs;
+        count0 &= ~bounced;
+        count1 &= ~bounced;
+        prevInputs = inputs;
+        return toggled;
+    }
+
+    /// The debounced states that were reported.
+    Mask debounced;
+    /// The inputs of the previous update.
+    Mask prevInputs;
+    /// Bits 0 and 1 of the ticks since the last change of every button.
+    Mask count0, count1;
+};
+
+END_AH_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
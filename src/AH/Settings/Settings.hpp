@@ -84,6 +84,17 @@ constexpr unsigned long FILTERED_INPUT_UPDATE_INTERVAL = 1000; // microseconds
 
 constexpr static Frequency SPI_MAX_SPEED = 8_MHz;
 
+/// The number of ExtendedIOElement%s whose pins are found using binary search
+/// in a lookup table. The pins of any additional elements are found using
+/// linear search. The table is allocated statically, even if there are no 
+/// ExtendedIOElement%s, and uses one pointer of RAM per element: 16 bytes on
+/// AVR, 128 bytes on 32-bit boards.
+#ifdef __AVR__
+constexpr uint8_t EXTIO_LOOKUP_TABLE_SIZE = 8;
+#else
+constexpr uint8_t EXTIO_LOOKUP_TABLE_SIZE = 32;
+#endif
+
 /// Make it possible to invert individual push buttons.
 /// Enabling this will increase memory usage.
 #define AH_INDIVIDUAL_BUTTON_INVERT
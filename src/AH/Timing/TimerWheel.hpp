@@ -0,0 +1,260 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR() // Enable errors on warnings
+
+#include <AH/STL/type_traits> // conditional
+#include <AH/Settings/NamespaceSettings.hpp>
+#include <stdint.h>
+
+BEGIN_AH_NAMESPACE
+
+/// @addtogroup    AH_Timing
+/// @{
+
+/**
+ * @brief   A hierarchical timer wheel: a container of events that have to
+ *          expire at a given tick.
+ *
+ * All events are stored in a pool with a fixed capacity, no dynamic memory is
+ * used. Scheduling an event and expiring it are constant-time operations.
+ *
+ * Level @f$ l @f$ consists of @f$ 2^{\text{SlotBits}} @f$ slots that each span
+ * @f$ 2^{l\cdot\text{SlotBits}} @f$ ticks. An event is stored in the lowest
+ * level whose block contains both the current tick and the tick of the event.
+ * This means that all events that expire at the same tick are always kept in
+ * the same list, in the order they were scheduled in.
+ * Each time a level wraps around, the next slot of the level above it is
+ * cascaded down. Events that lie further in the future than the highest level
+ * can hold are kept in a separate overflow list.
+ *
+ * @tparam  T
+ *          The type of the payload of the events.
+ * @tparam  Capacity
+ *          The maximum number of pending events.
+ * @tparam  SlotBits
+ *          The base two logarithm of the number of slots per level.
+ * @tparam  Levels
+ *          The number of levels.
+ */
+template <class T, uint16_t Capacity, uint8_t SlotBits = 5, uint8_t Levels = 3>
+class TimerWheel {
+  public:
+    /// The type used to represent ticks.
+    using tick_t = unsigned long;
+
+    static_assert(Capacity > 0, "Capacity should be at least one");
+    static_assert(Capacity < 0xFFFF, "Capacity too large");
+    static_assert(SlotBits > 0 && Levels > 0, "");
+    static_assert(SlotBits * Levels < 8 * sizeof(tick_t),
+                  "Wheel cannot span more ticks than tick_t can represent");
+
+    TimerWheel() { clear(); }
+
+    /**
+     * @brief   Discard all pending events, and set the current tick.
+     *
+     * @param   now
+     *          The first tick that hasn't expired yet.
+     */
+    void begin(tick_t now) {
+        clear();
+        current = now;
+    }
+
+    /// Discard all pending events.
+    void clear() {
+        for (auto &level : slots)
+            for (List &slot : level)
+                slot = {};
+        overflow = {};
+        for (uint16_t i = 0; i < Capacity; ++i)
+            events[i].next = i + 1;
+        events[Capacity - 1].next = NIL;
+        freeList = 0;
+        count = 0;
+    }
+
+    /**
+     * @brief   Schedule a new event.
+     *
+     * @param   tick
+     *          The tick at which the event should expire. Ticks that are in the
+     *          past expire on the next call to @ref advance.
+     * @param   payload
+     *          The data associated with the event.
+     * @retval  true
+     *          The event was scheduled.
+     * @retval  false
+     *          All events of the pool are in use.
+     */
+    bool schedule(tick_t tick, const T &payload) {
+        if (freeList == NIL)
+            return false;
+        if (long(tick - current) < 0)
+            tick = current;
+        index_t i = freeList;
+        freeList = events[i].next;
+        events[i].tick = tick;
+        events[i].payload = payload;
+        insert(i);
+        ++count;
+        return true;
+    }
+
+    /**
+     * @brief   Expire all events up to and including the given tick.
+     *
+     * @param   now
+     *          The current tick.
+     * @param   callback
+     *          Function that is called with the tick and the payload of each
+     *          expired event, in chronological order. Events that expire at
+     *          the same tick are handled in the order they were scheduled in.
+     *          The callback is allowed to schedule new events.
+     */
+    template <class Callback>
+    void advance(tick_t now, Callback &&callback) {
+        while (long(now - current) >= 0) {
+            if (count == 0) { // nothing to cascade, skip ahead
+                current = now + 1;
+                return;
+            }
+            if ((current & levelMask(Levels)) == 0)
+                cascade(overflow);
+            for (uint8_t l = Levels - 1; l > 0; --l)
+                if ((current & levelMask(l)) == 0)
+                    cascade(slots[l][slotIndex(current, l)]);
+            List &due = slots[0][slotIndex(current, 0)];
+            while (due.head != NIL) {
+                index_t i = due.head;
+                due.head = events[i].next;
+                if (due.head == NIL)
+                    due.tail = NIL;
+                T payload = events[i].payload;
+                release(i);
+                callback(current, payload);
+            }
+            ++current;
+        }
+    }
+
+    /**
+     * @brief   Discard all pending events for which the given predicate
+     *          returns true.
+     *
+     * @note    This function is linear in the number of slots and events.
+     */
+    template <class Predicate>
+    void removeIf(Predicate &&predicate) {
+        for (auto &level : slots)
+            for (List &slot : level)
+                removeIf(slot, predicate);
+        removeIf(overflow, predicate);
+    }
+
+    /// Get the first tick that hasn't expired yet.
+    tick_t getCurrentTick() const { return current; }
+    /// Get the number of pending events.
+    uint16_t size() const { return count; }
+    /// Check whether there are no pending events.
+    bool empty() const { return count == 0; }
+    /// Check whether all events of the pool are in use.
+    bool full() const { return freeList == NIL; }
+    /// Get the maximum number of pending events.
+    constexpr static uint16_t capacity() { return Capacity; }
+
+  private:
+    using index_t =
+        typename std::conditional<(Capacity < 0xFF), uint8_t, uint16_t>::type;
+    constexpr static index_t NIL = index_t(~index_t(0));
+    constexpr static uint16_t NumSlots = 1u << SlotBits;
+
+    struct Event {
+        tick_t tick;
+        T payload;
+        index_t next;
+    };
+
+    struct List {
+        index_t head = NIL;
+        index_t tail = NIL;
+    };
+
+    /// Mask of the ticks that lie within one slot of the given level.
+    constexpr static tick_t levelMask(uint8_t level) {
+        return (tick_t(1) << (SlotBits * level)) - 1;
+    }
+    /// Index of the slot of the given level that contains the given tick.
+    constexpr static uint16_t slotIndex(tick_t tick, uint8_t level) {
+        return (tick >> (SlotBits * level)) & (NumSlots - 1);
+    }
+
+    void append(List &list, index_t i) {
+        events[i].next = NIL;
+        if (list.tail == NIL)
+            list.head = i;
+        else
+            events[list.tail].next = i;
+        list.tail = i;
+    }
+
+    /// Insert the event into the lowest level whose block contains both the
+    /// current tick and the tick of the event.
+    void insert(index_t i) {
+        tick_t tick = events[i].tick;
+        tick_t diff = tick ^ current;
+        for (uint8_t l = 0; l < Levels; ++l)
+            if ((diff & ~levelMask(l + 1)) == 0)
+                return append(slots[l][slotIndex(tick, l)], i);
+        append(overflow, i);
+    }
+
+    /// Re-insert all events of the given list into the lower levels.
+    void cascade(List &list) {
+        index_t i = list.head;
+        list = {};
+        while (i != NIL) {
+            index_t next = events[i].next;
+            insert(i);
+            i = next;
+        }
+    }
+
+    void release(index_t i) {
+        events[i].next = freeList;
+        freeList = i;
+        --count;
+    }
+
+    template <class Predicate>
+    void removeIf(List &list, Predicate &predicate) {
+        index_t i = list.head;
+        list = {};
+        while (i != NIL) {
+            index_t next = events[i].next;
+            if (predicate(events[i].payload))
+                release(i);
+            else
+                append(list, i);
+            i = next;
+        }
+    }
+
+    Event events[Capacity];
+    List slots[Levels][NumSlots];
+    List overflow;
+    index_t freeList;
+    uint16_t count;
+    tick_t current = 0;
+};
+
+template <class T, uint16_t Capacity, uint8_t SlotBits, uint8_t Levels>
+constexpr typename TimerWheel<T, Capacity, SlotBits, Levels>::index_t
+    TimerWheel<T, Capacity, SlotBits, Levels>::NIL;
+
+/// @}
+
+END_AH_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -84,6 +84,49 @@ class BankableMIDIInput : public DoublyLinkable<BankableMIDIInput<N>> {
         }
     }
 
+    /**
+     * @brief   Get the set of MIDI channels of all banks: bit `i` is set if 
+     *          one of the banks uses channel `i + 1`.
+     * 
+     * @param   base
+     *          The base address (the address of bank setting 0).
+     */
+    uint16_t getChannelMask(const MIDIAddress &base) const {
+        if (!base.isValid())
+            return 0;
+        if (type != CHANGE_CHANNEL)
+            return 1 << base.getRawChannel();
+        return getBankMask(base.getRawChannel());
+    }
+
+    /**
+     * @brief   Get the set of MIDI USB cable numbers of all banks: bit `i` is
+     *          set if one of the banks uses cable number `i`.
+     * 
+     * @param   base
+     *          The base address (the address of bank setting 0).
+     */
+    uint16_t getCableMask(const MIDIAddress &base) const {
+        if (!base.isValid())
+            return 0;
+        if (type != CHANGE_CABLENB)
+            return 1 << base.getCableNumber();
+        return getBankMask(base.getCableNumber());
+    }
+
+  private:
+    /// Set the bits of the channels or cables of all banks, starting from the
+    /// channel or cable of the first bank.
+    uint16_t getBankMask(uint8_t first) const {
+        uint16_t mask = 0;
+        for (setting_t i = 0; i < N; ++i) {
+            uint16_t bit = first + i * bank.getTracksPerBank();
+            if (bit < 16)
+                mask |= 1 << bit;
+        }
+        return mask;
+    }
+
   protected:
     /**
      * @brief   Check if the given address is part of the bank relative to the
@@ -238,6 +281,36 @@ class BankableMIDIInput : public DoublyLinkable<BankableMIDIInput<N>> {
         }
     }
 
+    /**
+     * @brief   Check whether the given bank listens to the given MIDI channel
+     *          and cable.
+     *
+     * @param   bankIndex
+     *          The index of the bank.
+     * @param   channel
+     *          The MIDI channel to check.
+     * @param   cable
+     *          The MIDI USB cable number to check.
+     * @param   base
+     *          The base address of the element.
+     */
+    bool bankUsesChannel(setting_t bankIndex, Channel channel, uint8_t cable,
+                         const MIDIAddress &base) const {
+        uint8_t offset = bankIndex * bank.getTracksPerBank();
+        switch (type) {
+            case CHANGE_CHANNEL:
+                return channel.getRaw() == base.getRawChannel() + offset &&
+                       cable == base.getCableNumber();
+            case CHANGE_CABLENB:
+                return channel == base.getChannel() &&
+                       cable == base.getCableNumber() + offset;
+            case CHANGE_ADDRESS:
+            default:
+                return channel == base.getChannel() &&
+                       cable == base.getCableNumber();
+        }
+    }
+
   private:
     Bank<N> &bank;
     const BankType type;
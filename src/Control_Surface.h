@@ -27,6 +27,7 @@
 
 // ------------------------------ MIDI Outputs ------------------------------ //
 #include <MIDI_Outputs/CCButton.hpp>
+#include <MIDI_Outputs/CCButtonBank.hpp>
 #include <MIDI_Outputs/CCButtonLatched.hpp>
 #include <MIDI_Outputs/CCButtonLatching.hpp>
 #include <MIDI_Outputs/CCButtonMatrix.hpp>
@@ -36,6 +37,7 @@
 #include <MIDI_Outputs/CCPotentiometer.hpp>
 
 #include <MIDI_Outputs/NoteButton.hpp>
+#include <MIDI_Outputs/NoteButtonBank.hpp>
 #include <MIDI_Outputs/NoteButtonLatched.hpp>
 #include <MIDI_Outputs/NoteButtonLatching.hpp>
 #include <MIDI_Outputs/NoteButtonMatrix.hpp>
@@ -45,6 +47,8 @@
 #include <MIDI_Outputs/PBPotentiometer.hpp>
 #include <MIDI_Outputs/PCButton.hpp>
 
+#include <MIDI_Outputs/LaunchpadLEDGrid.hpp>
+
 #include <MIDI_Outputs/Bankable/CCButton.hpp>
 #include <MIDI_Outputs/Bankable/CCButtonLatched.hpp>
 #include <MIDI_Outputs/Bankable/CCButtonLatching.hpp>
@@ -89,7 +93,11 @@
 #include <MIDI_Inputs/MCU/LCD.hpp>
 #include <MIDI_Inputs/MCU/VPotRing.hpp>
 #include <MIDI_Inputs/MCU/VU.hpp>
+#include <MIDI_Inputs/MPEZoneManager.hpp>
+#include <MIDI_Inputs/MTCDecoder.hpp>
 #include <MIDI_Inputs/NoteCCRange.hpp>
+#include <MIDI_Inputs/PBValue.hpp>
+#include <MIDI_Inputs/ParameterValue.hpp>
 
 #include <MIDI_Inputs/LEDs/MCU/VPotRingLEDs.hpp>
 #include <MIDI_Inputs/LEDs/MCU/VULEDs.hpp>
@@ -5,9 +5,14 @@
 #include <MIDI_Constants/Control_Change.hpp>
 #include <MIDI_Inputs/MIDIInputElementCC.hpp>
 #include <MIDI_Inputs/MIDIInputElementChannelPressure.hpp>
+#include <MIDI_Inputs/MIDIInputElementKP.hpp>
 #include <MIDI_Inputs/MIDIInputElementNote.hpp>
+#include <MIDI_Inputs/MIDIInputElementPB.hpp>
+#include <MIDI_Inputs/MIDIInputElementParameter.hpp>
 #include <MIDI_Inputs/MIDIInputElementPC.hpp>
 #include <MIDI_Inputs/MIDIInputElementSysEx.hpp>
+#include <MIDI_Inputs/MPEZoneManager.hpp>
+#include <MIDI_Inputs/MTCDecoder.hpp>
 #include <MIDI_Outputs/Abstract/MIDIOutputElement.hpp>
 #include <Selectors/Selector.hpp>
 
@@ -38,7 +43,11 @@ void Control_Surface_::begin() {
     MIDIInputElementPC::beginAll();
     MIDIInputElementChannelPressure::beginAll();
     MIDIInputElementNote::beginAll();
+    MIDIInputElementKP::beginAll();
+    MIDIInputElementPB::beginAll();
+    MIDIInputElementParameter::beginAll();
     MIDIInputElementSysEx::beginAll();
+    MPEZoneManager::beginAll();
     Updatable<>::beginAll();
     Updatable<Potentiometer>::beginAll();
     Updatable<MotorFader>::beginAll();
@@ -61,6 +70,7 @@ bool Control_Surface_::connectDefaultMIDI_Interface() {
 }
 
 void Control_Surface_::disconnectMIDI_Interfaces() {
+    MIDI_Interface::releaseAllActiveNotes();
     disconnectSinkPipes();
     disconnectSourcePipes();
 }
@@ -70,8 +80,10 @@ void Control_Surface_::loop() {
     Updatable<>::updateAll();
     if (potentiometerTimer)
         Updatable<Potentiometer>::updateAll();
+    MIDI_Scheduler::updateInstance();
     updateMidiInput();
     updateInputs();
+    MIDIInputElement::flushAll();
     if (displayTimer)
         updateDisplays();
     ExtendedIOElement::updateAllBufferedOutputs();
@@ -113,16 +125,37 @@ void Control_Surface_::sinkMIDIfromPipe(ChannelMessage midichmsg) {
     if (channelMessageCallback && channelMessageCallback(midichmsg))
         return;
 
-    if (midimsg.type == CC && midimsg.data1 == 0x79) {
-        // Reset All Controllers
+    // MIDI Time Code Quarter Frames are passed on as channel messages
+    if (midichmsg.header == MTCQuarterFrame) {
+        MTCDecoder::updateAllWith(midichmsg);
+        return;
+    }
+
+    // MPE zones keep track of the notes and expression of all member channels
+    MPEZoneManager::updateAllWith(midimsg);
+
+    // Channel Mode messages only reset the elements on the same channel and
+    // cable
+    Channel channel = Channel(midimsg.channel);
+    if (midimsg.type == CC &&
+        midimsg.data1 == MIDI_CC::Reset_All_Controllers) {
         DEBUG(F("Reset All Controllers"));
-        MIDIInputElementCC::resetAll();
-        MIDIInputElementChannelPressure::resetAll();
-    } else if (midimsg.type == CC && midimsg.data1 == MIDI_CC::All_Notes_Off) {
-        MIDIInputElementNote::resetAll();
+        MIDIInputElementCC::resetAll(channel, midimsg.CN);
+        MIDIInputElementChannelPressure::resetAll(channel, midimsg.CN);
+        MIDIInputElementKP::resetAll(channel, midimsg.CN);
+        MIDIInputElementPB::resetAll(channel, midimsg.CN);
+        MIDIInputElementParameter::resetSelection(channel, midimsg.CN);
+    } else if (midimsg.type == CC &&
+               (midimsg.data1 == MIDI_CC::All_Notes_Off ||
+                midimsg.data1 == MIDI_CC::All_Sound_Off)) {
+        MIDIInputElementNote::resetAll(channel, midimsg.CN);
     } else {
         if (midimsg.type == CC) {
             // Control Change
+            // NRPN and RPN parameters are assembled first, their CC messages
+            // can optionally be hidden from the other CC elements.
+            if (MIDIInputElementParameter::updateAllWith(midimsg))
+                return;
             DEBUGFN(F("Updating CC elements with new MIDI message."));
             MIDIInputElementCC::updateAllWith(midimsg);
 
@@ -131,6 +164,16 @@ void Control_Surface_::sinkMIDIfromPipe(ChannelMessage midichmsg) {
             DEBUGFN(F("Updating Note elements with new MIDI message."));
             MIDIInputElementNote::updateAllWith(midimsg);
 
+        } else if (midimsg.type == KEY_PRESSURE) {
+            // Polyphonic Key Pressure
+            DEBUGFN(F("Updating Key Pressure elements with new MIDI message."));
+            MIDIInputElementKP::updateAllWith(midimsg);
+
+        } else if (midimsg.type == PITCH_BEND) {
+            // Pitch Bend
+            DEBUGFN(F("Updating Pitch Bend elements with new MIDI message."));
+            MIDIInputElementPB::updateAllWith(midimsg);
+
         } else if (midimsg.type == CHANNEL_PRESSURE) {
             // Channel Pressure
             DEBUGFN(F("Updating Channel Pressure elements with new "
@@ -160,6 +203,7 @@ void Control_Surface_::sinkMIDIfromPipe(SysExMessage msg) {
     // continue handling it.
     if (sysExMessageCallback && sysExMessageCallback(msg))
         return;
+    MTCDecoder::updateAllWith(msg);
     MIDIInputElementSysEx::updateAllWith(msg);
 }
 
@@ -174,27 +218,57 @@ void Control_Surface_::sinkMIDIfromPipe(RealTimeMessage rtMessage) {
 void Control_Surface_::updateInputs() {
     MIDIInputElementCC::updateAll();
     MIDIInputElementNote::updateAll();
+    MIDIInputElementKP::updateAll();
+    MIDIInputElementPB::updateAll();
     MIDIInputElementChannelPressure::updateAll();
     MIDIInputElementPC::updateAll();
     MIDIInputElementSysEx::updateAll();
+    MIDIInputElementParameter::updateAll();
 }
 
-void Control_Surface_::updateDisplays() {
-    DisplayInterface *previousDisplay = nullptr;
-    for (DisplayElement &displayElement : DisplayElement::getAll()) {
-        DisplayInterface *thisDisplay = &displayElement.getDisplay();
-        if (!thisDisplay->isEnabled())
+namespace {
+
+using DisplayElementIterator = DoublyLinkedList<DisplayElement>::iterator;
+
+/// Update the given display, with the elements in the range [first, last).
+void updateDisplay(DisplayInterface &display, DisplayElementIterator first,
+                   DisplayElementIterator last) {
+    bool dirty = false;
+    bool incremental = true;
+    for (DisplayElementIterator it = first; it != last; ++it) {
+        if (!(*it).getDirty())
             continue;
-        if (thisDisplay != previousDisplay) {
-            if (previousDisplay)
-                previousDisplay->display();
-            previousDisplay = thisDisplay;
-            thisDisplay->clearAndDrawBackground();
-        }
-        displayElement.draw();
+        dirty = true;
+        // As soon as one element can't draw its changes, everything is
+        // redrawn from scratch
+        incremental = incremental && (*it).drawChanges();
+    }
+    if (!dirty)
+        return;
+    if (!incremental) {
+        display.clearAndDrawBackground();
+        for (DisplayElementIterator it = first; it != last; ++it)
+            (*it).draw();
+    }
+    display.display();
+}
+
+} // namespace
+
+void Control_Surface_::updateDisplays() {
+    DoublyLinkedList<DisplayElement> &elements = DisplayElement::getAll();
+    DisplayElementIterator first = elements.begin();
+    while (first != elements.end()) {
+        // The elements are sorted by display, so all elements that draw to
+        // the same display are next to each other.
+        DisplayInterface &display = (*first).getDisplay();
+        DisplayElementIterator last = first;
+        while (last != elements.end() && &(*last).getDisplay() == &display)
+            ++last;
+        if (display.isEnabled())
+            updateDisplay(display, first, last);
+        first = last;
     }
-    if (previousDisplay)
-        previousDisplay->display();
 }
 
 Control_Surface_ &Control_Surface = Control_Surface_::getInstance();
@@ -70,6 +70,10 @@ class Control_Surface_ : public MIDI_Sender<Control_Surface_>,
     /**
      * @brief   Disconnect Control Surface from the MIDI interfaces it's 
      *          connected to.
+     * 
+     * The notes that are still sounding on interfaces that keep track of their
+     * active notes are turned off first, see 
+     * @ref MIDI_Interface::setActiveNotes.
      */
     void disconnectMIDI_Interfaces();
 
@@ -92,6 +96,10 @@ class Control_Surface_ : public MIDI_Sender<Control_Surface_>,
 
     /** 
      * @brief   Clear, draw and display all displays.
+     * 
+     * Displays where none of the elements changed are skipped, and if all
+     * elements that changed can draw their changes only, the display is not
+     * cleared.
      */
     void updateDisplays();
 
@@ -115,6 +123,11 @@ class Control_Surface_ : public MIDI_Sender<Control_Surface_>,
      */
     void sendImpl(uint8_t rt, uint8_t cn);
 
+    /// Notes are tracked by the MIDI interfaces, not by Control Surface.
+    bool trackNote(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) {
+        return true;
+    }
+
   private:
     void sinkMIDIfromPipe(ChannelMessage msg) override;
     void sinkMIDIfromPipe(SysExMessage msg) override;
@@ -32,6 +32,27 @@ class DisplayElement : public DoublyLinkable<DisplayElement> {
     /// Draw this DisplayElement to the display buffer.
     virtual void draw() = 0;
 
+    /**
+     * @brief   Check if this element changed since it was last drawn.
+     * 
+     * If none of the elements of a display changed, the display is not 
+     * redrawn at all. By default, elements are always redrawn.
+     */
+    virtual bool getDirty() { return true; }
+
+    /**
+     * @brief   Draw only the parts of this element that changed since it was
+     *          last drawn, on top of the previous frame.
+     * 
+     * @retval  true
+     *          The changes were drawn.
+     * @retval  false
+     *          This element doesn't support drawing its changes only. The 
+     *          display will be cleared, and all of its elements will be 
+     *          redrawn using `draw()`.
+     */
+    virtual bool drawChanges() { return false; }
+
     /// Get a reference to the display that this element draws to.
     DisplayInterface &getDisplay() { return display; }
     /// Get a const reference to the display that this element draws to.
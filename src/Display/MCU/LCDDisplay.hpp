@@ -4,6 +4,7 @@
 #include <Display/DisplayElement.hpp>
 #include <Display/DisplayInterface.hpp>
 #include <MIDI_Inputs/MCU/LCD.hpp>
+#include <string.h> // memcpy, memset, strcmp
 
 BEGIN_CS_NAMESPACE
 
@@ -55,26 +56,72 @@ class LCDDisplay : public DisplayElement {
           line(line), x(loc.x), y(loc.y), size(textSize), color(color) {}
 
     void draw() override {
-        // If it's a message across all tracks, don't display anything.
-        if (!separateTracks())
-            return;
-        // Extract the six-character substring for this track.
-        uint8_t trackoffset = bank.getOffset() + offset;
-        if (trackoffset > 7) // TODO
-            trackoffset = 7;
-        if (line > 1) // TODO
-            line = 1;
-        const char *text = lcd.getText() + 7 * trackoffset + 56 * line;
-        char buffer[7];
-        strncpy(buffer, text, 6);
-        buffer[6] = '\0';
+        getTrackText(drawnText);
+        drawnVersion = lcd.getVersion();
+        drawnOffset = bank.getOffset();
+        drawnLine = line;
+        drawn = true;
         // Print it to the display
         display.setCursor(x, y);
         display.setTextSize(size);
         display.setTextColor(color);
-        display.print(buffer);
+        display.print(drawnText);
+    }
+
+    /// Check if the text for this track changed since it was last drawn.
+    bool getDirty() override {
+        if (!drawn || bank.getOffset() != drawnOffset || line != drawnLine)
+            return true;
+        uint16_t version = lcd.getVersion();
+        if (version == drawnVersion)
+            return false;
+        // If the only change since the last draw is outside of this line of
+        // the LCD, we don't have to look at the text
+        bool oneBehind = uint16_t(drawnVersion + 1) == version;
+        bool otherLine = lcd.getDirtyEnd() <= 56 * getLine() ||
+                         lcd.getDirtyBegin() >= 56 * (getLine() + 1);
+        if (!(oneBehind && otherLine)) {
+            char text[7];
+            getTrackText(text);
+            if (strcmp(text, drawnText) != 0)
+                return true;
+        }
+        drawnVersion = version;
+        return false;
+    }
+
+    /**
+     * @brief   Only redraw the characters that changed.
+     * 
+     * The cells of these characters are cleared by filling them with the
+     * background color (see @ref setBackgroundColor), so the background of
+     * the text should be a solid color.
+     */
+    bool drawChanges() override {
+        if (!drawn)
+            return false;
+        char text[7];
+        getTrackText(text);
+        const int16_t w = CharWidth * size, h = CharHeight * size;
+        display.setTextSize(size);
+        display.setTextColor(color);
+        for (uint8_t i = 0; i < 6; ++i) {
+            if (text[i] == drawnText[i])
+                continue;
+            display.fillRect(x + i * w, y, w, h, background);
+            display.setCursor(x + i * w, y);
+            display.write(text[i]);
+            drawnText[i] = text[i];
+        }
+        drawnVersion = lcd.getVersion();
+        drawnOffset = bank.getOffset();
+        drawnLine = line;
+        return true;
     }
 
+    /// Set the color used to clear a character before redrawing it.
+    void setBackgroundColor(uint16_t color) { background = color; }
+
     /**
      * @brief   Check if the display contains a message for each track 
      *          separately.
@@ -94,7 +141,7 @@ class LCDDisplay : public DisplayElement {
      */
     bool separateTracks() const {
         for (uint8_t i = 0; i < 7; ++i) {
-            const char *text = lcd.getText() + 7 * i + 56 * line;
+            const char *text = lcd.getText() + 7 * i + 56 * getLine();
             if (text[6] != ' ')
                 return false;
         }
@@ -103,6 +150,27 @@ class LCDDisplay : public DisplayElement {
 
     void setLine(uint8_t line) { this->line = line; }
 
+  private:
+    /// The line of the LCD to display [0, 1].
+    uint8_t getLine() const { return line > 1 ? 1 : line; } // TODO
+
+    /// Extract the six-character substring for this track. If the LCD contains
+    /// a message across all tracks, the text is blank.
+    void getTrackText(char (&text)[7]) const {
+        text[6] = '\0';
+        if (!separateTracks()) {
+            memset(text, ' ', 6);
+            return;
+        }
+        uint8_t trackoffset = bank.getOffset() + offset;
+        if (trackoffset > 7) // TODO
+            trackoffset = 7;
+        memcpy(text, lcd.getText() + 7 * trackoffset + 56 * getLine(), 6);
+    }
+
+    /// The size of a character of the default font, without scaling.
+    constexpr static int16_t CharWidth = 6, CharHeight = 8;
+
   private:
     const MCU::LCD<> &lcd;
     const OutputBank &bank;
@@ -111,6 +179,14 @@ class LCDDisplay : public DisplayElement {
     int16_t x, y;
     uint8_t size;
     uint16_t color;
+    uint16_t background = 0;
+
+    /// The text as it was last drawn to the display.
+    char drawnText[7] = {};
+    uint16_t drawnVersion = 0;
+    uint8_t drawnOffset = 0;
+    uint8_t drawnLine = 0;
+    bool drawn = false;
 };
 
 } // namespace MCU
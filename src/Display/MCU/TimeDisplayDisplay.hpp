@@ -11,12 +11,14 @@ namespace MCU {
 class TimeDisplayDisplay : public DisplayElement {
   public:
     TimeDisplayDisplay(DisplayInterface &display,
-                       const TimeDisplay &timedisplay, PixelLocation loc,
+                       const TimeDisplaySource &timedisplay, PixelLocation loc,
                        uint8_t size, uint16_t color)
         : DisplayElement(display), timedisplay(timedisplay), x(loc.x), y(loc.y),
           size(size), color(color) {}
 
     void draw() override {
+        drawnVersion = timedisplay.getVersion();
+        drawn = true;
         display.setTextColor(color);
         display.setTextSize(size);
         display.setCursor(x, y);
@@ -32,21 +34,29 @@ class TimeDisplayDisplay : public DisplayElement {
         display.print(frameStr);
     }
 
+    /// Check if the time changed since it was last drawn.
+    bool getDirty() override {
+        return !drawn || timedisplay.getVersion() != drawnVersion;
+    }
+
     int16_t getX() const { return x; }
     int16_t getY() const { return y; }
     uint8_t getSize() const { return size; }
     uint16_t getColor() const { return color; }
 
-    void setX(int16_t x) { this->x = x; }
-    void setY(int16_t y) { this->y = y; }
-    void setSize(uint8_t size) { this->size = size; }
-    void setColor(uint16_t color) { this->color = color; }
+    void setX(int16_t x) { this->x = x, drawn = false; }
+    void setY(int16_t y) { this->y = y, drawn = false; }
+    void setSize(uint8_t size) { this->size = size, drawn = false; }
+    void setColor(uint16_t color) { this->color = color, drawn = false; }
 
   private:
-    const TimeDisplay &timedisplay;
+    const TimeDisplaySource &timedisplay;
     int16_t x, y;
     uint8_t size;
     uint16_t color;
+
+    uint16_t drawnVersion = 0;
+    bool drawn = false;
 };
 
 } // namespace MCU
@@ -23,10 +23,10 @@ class VPotDisplay : public DisplayElement {
             display.fillCircle(x, y, innerRadius / 4, color);
         else
             display.drawCircle(x, y, innerRadius / 4, color);
-        uint8_t startOn = vpot.getStartOn();
-        uint8_t startOff = vpot.getStartOff();
-        for (uint8_t segment = startOn; segment < startOff; segment++)
-            drawVPotSegment(segment);
+        uint16_t mask = vpot.getRingMask();
+        for (uint8_t segment = 0; mask != 0; segment++, mask >>= 1)
+            if (mask & 1)
+                drawVPotSegment(segment);
     }
 
   private:
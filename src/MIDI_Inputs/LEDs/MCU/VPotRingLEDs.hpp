@@ -18,7 +18,7 @@ class VPotRingLEDsCallback {
 
     template <class T>
     void update(const T &t) {
-        leds.displayRange(t.getStartOn(), t.getStartOff());
+        leds.displayMask(t.getRingMask());
     }
 
   private:
@@ -3,5 +3,6 @@
 BEGIN_CS_NAMESPACE
 namespace MCU {
 uint8_t LCDCounter::instances = 0;
+const uint8_t LCDCounter::SysExHeader[4] = {0xF0, 0x00, 0x00, 0x66};
 }
 END_CS_NAMESPACE
\ No newline at end of file
@@ -3,7 +3,6 @@
 #include <AH/Debug/Debug.hpp>
 #include <AH/Math/MinMaxFix.hpp>
 #include <MIDI_Inputs/MIDIInputElementSysEx.hpp>
-#include <string.h> // memcpy
 
 #ifndef ARDUINO
 #include <cassert>
@@ -23,6 +22,10 @@ class LCDCounter {
 
     static uint8_t getInstances() { return instances; }
 
+  protected:
+    /// The Mackie manufacturer ID, preceded by the SysEx start byte.
+    static const uint8_t SysExHeader[4];
+
   private:
     static uint8_t instances;
 };
@@ -32,6 +35,7 @@ class LCD : public MIDIInputElementSysEx, private LCDCounter {
   public:
     LCD(uint8_t offset = 0, uint8_t CN = 0)
         : MIDIInputElementSysEx{CN}, offset{offset} {
+        setHeader(SysExHeader, sizeof(SysExHeader));
         buffer[BufferSize] = '\0';
         for (uint8_t i = 0; i < BufferSize; i++)
             buffer[i] = ' ';
@@ -39,6 +43,21 @@ class LCD : public MIDIInputElementSysEx, private LCDCounter {
 
     const char *getText() const { return &buffer[0]; }
 
+    /**
+     * @brief   Get the version of the text. It is incremented every time a
+     *          MIDI message changes at least one character.
+     * 
+     * Displays can save the version when they draw the text, and only look at
+     * the text again when the version changes.
+     */
+    uint16_t getVersion() const { return version; }
+    /// Get the index of the first character that was changed by the last
+    /// update that incremented the version.
+    uint8_t getDirtyBegin() const { return dirtyBegin; }
+    /// Get the index one past the last character that was changed by the last
+    /// update that incremented the version.
+    uint8_t getDirtyEnd() const { return dirtyEnd; }
+
   private:
     bool updateImpl(SysExMessage midimsg) override {
         // Format:
@@ -74,15 +93,26 @@ class LCD : public MIDIInputElementSysEx, private LCDCounter {
         DEBUGVAL(this->offset, midiOffset, BufferSize, midiLength, srcStart,
                  dstStart, length);
 
-#ifdef ARDUINO
-        memcpy(&buffer[dstStart], &text[srcStart], length);
-#else
+        // Only keep track of the characters that actually change, the DAW
+        // often resends the entire line for a single change
+        uint8_t begin = BufferSize, end = 0;
         for (uint8_t i = 0; i < length; ++i) {
-            buffer[dstStart + i] = text[srcStart + i];
+#ifndef ARDUINO
             assert(dstStart + i < BufferSize);
             assert(srcStart + i < midiLength);
-        }
 #endif
+            char c = text[srcStart + i];
+            if (buffer[dstStart + i] == c)
+                continue;
+            buffer[dstStart + i] = c;
+            begin = min(begin, dstStart + i);
+            end = dstStart + i + 1;
+        }
+        if (begin < end) {
+            dirtyBegin = begin;
+            dirtyEnd = end;
+            ++version;
+        }
 
         DEBUGFN(getText());
 
@@ -93,6 +123,9 @@ class LCD : public MIDIInputElementSysEx, private LCDCounter {
 
     Array<char, BufferSize + 1> buffer;
     uint8_t offset;
+    uint16_t version = 0;
+    uint8_t dirtyBegin = 0;
+    uint8_t dirtyEnd = 0;
 };
 
 } // namespace MCU
@@ -17,12 +17,22 @@ class SevenSegmentDisplay : public MIDIInputElementCC, public Printable {
     */
     SevenSegmentDisplay(const MIDIAddress &address)
         : MIDIInputElementCC{address} {
-        fillWithSpaces();
+        memset(text, ' ', LENGTH);
+        memset(decoded, ' ', LENGTH);
+        decoded[LENGTH] = '\0';
     }
 
     void fillWithSpaces() {
-        for (char &c : text)
-            c = ' ';
+        bool changed = false;
+        for (uint8_t i = 0; i < LENGTH; ++i) {
+            changed |= text[i] != ' ';
+            text[i] = ' ';
+            decoded[i] = ' ';
+        }
+        if (changed) {
+            ++version;
+            textChanged();
+        }
     }
 
     void reset() override {
@@ -31,6 +41,20 @@ class SevenSegmentDisplay : public MIDIInputElementCC, public Printable {
 #endif
     }
 
+    /**
+     * @brief   Get the version of the text. It is incremented every time a
+     *          MIDI message changes a character or a decimal point.
+     *
+     * Displays can save the version when they draw the text, and only look at
+     * the text again when the version changes.
+     */
+    uint16_t getVersion() const { return version; }
+
+  protected:
+    /// Called after a MIDI message changed a character or a decimal point, so
+    /// derived classes can decode the text once, instead of on every read.
+    virtual void textChanged() {}
+
   private:
     /**
      * @brief   Update a character.
@@ -45,7 +69,12 @@ class SevenSegmentDisplay : public MIDIInputElementCC, public Printable {
         uint8_t chardata = midimsg.data2 & 0x3F;
         uint8_t character = chardata >= 0x20 ? chardata : chardata + 0x40;
         character |= decimalPt;
-        text[index] = character;
+        if (text[index] != char(character)) {
+            text[index] = character;
+            decoded[index] = character & 0x7F;
+            ++version;
+            textChanged();
+        }
         return true;
     }
 
@@ -81,16 +110,18 @@ class SevenSegmentDisplay : public MIDIInputElementCC, public Printable {
             offset = LENGTH - 1;
         if (length > LENGTH - offset)
             length = LENGTH - offset;
-        for (uint8_t i = 0; i < length; i++)
-            buffer[i] = getCharacterAt(i + offset);
+        memcpy(buffer, decoded + offset, length);
         buffer[length] = '\0';
     }
 
+    /// Get the null-terminated ASCII text, without the decimal points.
+    const char *getText() const { return decoded; }
+
     /**
      * @brief   Get the character at the given index.
      * @todo    Documentation.
      */
-    char getCharacterAt(uint8_t index) const { return text[index] & 0x7F; }
+    char getCharacterAt(uint8_t index) const { return decoded[index]; }
 
     /**
      * @brief   Copy the decimal points into the given buffer.
@@ -124,7 +155,11 @@ class SevenSegmentDisplay : public MIDIInputElementCC, public Printable {
     }
 
   private:
+    /// The characters with the decimal points in bit 7.
     char text[LENGTH];
+    /// The ASCII characters without the decimal points.
+    char decoded[LENGTH + 1];
+    uint16_t version = 0;
 };
 
 } // namespace MCU
@@ -9,47 +9,110 @@ namespace MCU {
 constexpr static uint8_t TimeDisplayLength = 10;
 constexpr static uint8_t TimeDisplayAddress = 0x40;
 
-class TimeDisplay : public SevenSegmentDisplay<TimeDisplayLength> {
+/**
+ * @brief   The text of a time display, split into the three fields that are
+ *          shown by @ref TimeDisplayDisplay.
+ *
+ * Implemented by @ref TimeDisplay (MCU time display characters) and by
+ * @ref CS::MTCDecoder (MIDI Time Code).
+ */
+class TimeDisplaySource {
+  public:
+    virtual ~TimeDisplaySource() = default;
+
+    /// Copy the first field (at most 5 characters) into the given buffer of
+    /// at least 6 bytes.
+    virtual void getBars(char *buff) const = 0;
+    /// Copy the second field (at most 2 characters) into the given buffer of
+    /// at least 3 bytes.
+    virtual void getBeats(char *buff) const = 0;
+    /// Copy the third field (at most 3 characters) into the given buffer of
+    /// at least 4 bytes.
+    virtual void getFrames(char *buff) const = 0;
+    /// Get a number that changes whenever the text changes, so displays can
+    /// skip redrawing if it didn't.
+    virtual uint16_t getVersion() const = 0;
+};
+
+class TimeDisplay : public SevenSegmentDisplay<TimeDisplayLength>,
+                    public TimeDisplaySource {
   public:
     TimeDisplay(Channel channel = CHANNEL_1)
         : SevenSegmentDisplay<TimeDisplayLength>(
-              {TimeDisplayAddress, channel}) {}
+              {TimeDisplayAddress, channel}) {
+        textChanged();
+    }
     // TODO: add support for 5-digit bar counts
     void print() const {
-        char barStr[6], beatStr[3], frameStr[4];
-        getBars(barStr);
-        getBeats(beatStr);
-        getFrames(frameStr);
         DEBUG("Bar: " << barStr << "\tBeat: " << beatStr
                       << "\tFrame: " << frameStr);
     }
-    void getBars(char *buff) const {
-        if (getCharacterAt(5) == ' ') {
-            getText(buff, 0, 3);
-        } else if (getCharacterAt(6) == ' ') {
-            getText(buff, 0, 4);
-        } else {
-            getText(buff, 0, 5);
-        }
+
+    /// @name   Decoded text
+    /// The text is split into fields and decoded only when a MIDI message
+    /// changes a character, the getters only copy the cached result.
+    /// @{
+
+    void getBars(char *buff) const override { strcpy(buff, barStr); }
+    void getBeats(char *buff) const override { strcpy(buff, beatStr); }
+    void getFrames(char *buff) const override { strcpy(buff, frameStr); }
+    uint16_t getVersion() const override {
+        return SevenSegmentDisplay<TimeDisplayLength>::getVersion();
+    }
+
+    /// Get the bars, beats and frames, separated by spaces.
+    const char *getFormattedText() const { return formatted; }
+
+    /// Get the value of the bars field (digits only, other characters are
+    /// ignored).
+    uint32_t getBarsValue() const { return barsValue; }
+    /// Get the value of the beats field.
+    uint8_t getBeatsValue() const { return beatsValue; }
+    /// Get the value of the frames field.
+    uint16_t getFramesValue() const { return framesValue; }
+
+    /// @}
+
+  protected:
+    void textChanged() override {
+        // The length of the bars field depends on the mode of the DAW
+        uint8_t barLength = getCharacterAt(5) == ' '   ? 3
+                            : getCharacterAt(6) == ' ' ? 4
+                                                       : 5;
+        uint8_t frameOffset = barLength == 3 ? 7 : barLength == 4 ? 8 : 9;
+        getText(barStr, 0, barLength);
+        getText(beatStr, barLength, 2);
+        getText(frameStr, frameOffset, 3);
+        barsValue = parse(barStr);
+        beatsValue = parse(beatStr);
+        framesValue = parse(frameStr);
+        char *f = append(formatted, barStr);
+        *f++ = ' ';
+        f = append(f, beatStr);
+        *f++ = ' ';
+        append(f, frameStr);
     }
-    void getBeats(char *buff) const {
-        if (getCharacterAt(5) == ' ') {
-            getText(buff, 3, 2);
-        } else if (getCharacterAt(6) == ' ') {
-            getText(buff, 4, 2);
-        } else {
-            getText(buff, 5, 2);
-        }
+
+  private:
+    /// Copy a string, and return a pointer to its terminating null character.
+    static char *append(char *dst, const char *src) {
+        while ((*dst = *src++))
+            ++dst;
+        return dst;
     }
-    void getFrames(char *buff) const {
-        if (getCharacterAt(5) == ' ') {
-            getText(buff, 7, 3);
-        } else if (getCharacterAt(6) == ' ') {
-            getText(buff, 8, 2);
-        } else {
-            getText(buff, 9, 1);
-        }
+    static uint32_t parse(const char *str) {
+        uint32_t value = 0;
+        for (; *str; ++str)
+            if (*str >= '0' && *str <= '9')
+                value = 10 * value + (*str - '0');
+        return value;
     }
+
+    char barStr[6], beatStr[3], frameStr[4];
+    char formatted[13];
+    uint32_t barsValue;
+    uint8_t beatsValue;
+    uint16_t framesValue;
 };
 
 } // namespace MCU
@@ -1,3 +1,25 @@
-#ifdef TEST_COMPILE_ALL_HEADERS_SEPARATELY
 #include "VPotRing.hpp"
-#endif
\ No newline at end of file
+
+BEGIN_CS_NAMESPACE
+
+namespace MCU {
+
+// Generated from getStartOn() and getStartOff(): bits [startOn, startOff).
+const uint16_t IVPotRing::ringMasks[4][12] PROGMEM = {
+    // Single dot
+    {0x000, 0x001, 0x002, 0x004, 0x008, 0x010,
+     0x020, 0x040, 0x080, 0x100, 0x200, 0x400},
+    // Boost/cut
+    {0x03F, 0x03F, 0x03E, 0x03C, 0x038, 0x030,
+     0x020, 0x060, 0x0E0, 0x1E0, 0x3E0, 0x7E0},
+    // Wrap
+    {0x000, 0x001, 0x003, 0x007, 0x00F, 0x01F,
+     0x03F, 0x07F, 0x0FF, 0x1FF, 0x3FF, 0x7FF},
+    // Spread
+    {0x01F, 0x020, 0x070, 0x0F8, 0x1FC, 0x3FE,
+     0x7FF, 0x7FF, 0x7FF, 0x7FF, 0x7FF, 0x7FF},
+};
+
+} // namespace MCU
+
+END_CS_NAMESPACE
@@ -65,9 +65,28 @@ class IVPotRing {
         }
     }
 
+    /// Get the segments that should be on, as a bit mask: bit `i` is segment
+    /// `i` [0, 10]. These are the segments in the range
+    /// [@ref getStartOn(), @ref getStartOff()), looked up in a table.
+    uint16_t getRingMask() const { return getRingMask(getValue()); }
+    /// Get the segments that should be on, like @ref getRingMask(), with the
+    /// center LED in bit 11.
+    uint16_t getLEDMask() const {
+        uint8_t value = getValue();
+        return getRingMask(value) | uint16_t(getCenterLed(value)) << 11;
+    }
+
   private:
     virtual uint8_t getValue() const = 0;
 
+    /// Look up the ring segments for the given raw value.
+    static uint16_t getRingMask(uint8_t value) {
+        const uint16_t *mask = &ringMasks[getMode(value)][getPosition(value)];
+        return pgm_read_word_near(mask);
+    }
+    /// The segments that are on, for every mode and position.
+    static const uint16_t ringMasks[4][12];
+
     /// Extract the position from the raw value.
     static uint8_t getPosition(uint8_t value) {
         uint8_t position = value & 0x0F;
@@ -100,6 +119,17 @@ class VPotRing_Base : public MIDIInputElementCC, public IVPotRing {
     }
 
   protected:
+    /// Reset the value of the given bank to zero.
+    void resetBank(setting_t bank) {
+#ifdef VPOTRING_RESET
+        values[bank] = 0;
+        if (bank == getSelection())
+            callback.update(*this);
+#else
+        (void)bank;
+#endif
+    }
+
     /** Make sure that the received value is valid and will not result in array
      * out of bounds conditions. */
     static uint8_t sanitizeValue(uint8_t value) {
@@ -112,11 +142,13 @@ class VPotRing_Base : public MIDIInputElementCC, public IVPotRing {
         uint8_t index = getBankIndex(target);
         uint8_t value = sanitizeValue(midimsg.data2);
         values[index] = value;
-        if (getSelection() == index)
+        if (getSelection() == index && !this->deferUpdate())
             callback.update(*this);
         return true;
     }
 
+    void flush() override { callback.update(*this); }
+
     uint8_t getValue() const override { return values[getSelection()]; }
 
     /// Get the active bank selection
@@ -184,6 +216,22 @@ class GenericVPotRing : public VPotRing_Base<NumBanks, Callback>,
         : VPotRing_Base<NumBanks, Callback>{track, channelCN, callback},
           BankableMIDIInput<NumBanks>{config} {}
 
+    uint16_t getChannelMask() const override {
+        return BankableMIDIInput<NumBanks>::getChannelMask(this->address);
+    }
+
+    uint16_t getCableMask() const override {
+        return BankableMIDIInput<NumBanks>::getCableMask(this->address);
+    }
+
+    /// Reset the values of the banks that listen to the given channel and
+    /// cable, the other banks keep their values.
+    void resetChannel(Channel channel, uint8_t cable) override {
+        for (setting_t b = 0; b < NumBanks; ++b)
+            if (this->bankUsesChannel(b, channel, cable, this->address))
+                this->resetBank(b);
+    }
+
   private:
     setting_t getSelection() const override {
         return BankableMIDIInput<NumBanks>::getSelection();
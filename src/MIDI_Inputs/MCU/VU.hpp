@@ -3,6 +3,7 @@
 #include <Banks/BankableMIDIInput.hpp>
 #include <AH/Hardware/ExtendedInputOutput/ExtendedInputOutput.hpp>
 #include <AH/Math/MinMaxFix.hpp>
+#include <MIDI_Inputs/MCU/VUDecayEngine.hpp>
 #include <MIDI_Inputs/MIDIInputElementChannelPressure.hpp>
 #include <string.h>
 
@@ -73,24 +74,56 @@ struct VUEmptyCallback {
  * 100%.  
  * `0xD` is an invalid value.  
  * `0xE` sets the overload indicator, and `0xF` clears the overload indicator.
+ * 
+ * The levels and overload flags of decaying meters are stored in the 
+ * @ref VUDecayEngine, which decays the meters of all VU elements at once. Each
+ * bank has its own meter, that decays independently. Meters that hold their 
+ * value, or that don't fit in the engine, are stored and decayed by the 
+ * element itself.
  */
 template <uint8_t NumValues, class Callback>
-class VU_Base : public MIDIInputElementChannelPressure, public IVU {
+class VU_Base : public MIDIInputElementChannelPressure,
+                public IVU,
+                private VUDecayClient {
   protected:
     VU_Base(uint8_t track, const MIDIChannelCN &channelCN,
             unsigned int decayTime, const Callback &callback)
         : MIDIInputElementChannelPressure{{track - 1, channelCN}}, IVU(12),
-          decayTime(decayTime), callback(callback) {}
+          decayTime(decayTime), callback(callback) {
+        if (decayTime != 0)
+            inEngine = VUDecayEngine::getInstance().add(*this, NumValues,
+                                                         decayTime);
+    }
 
   public:
+    ~VU_Base() {
+        if (inEngine)
+            VUDecayEngine::getInstance().remove(*this);
+    }
+
     /// Initialize
     void begin() override { callback.begin(*this); }
     /// Reset all values to zero
     void reset() override {
-        values = {{}};
+        if (inEngine)
+            VUDecayEngine::getInstance().clear(firstMeter, NumValues);
+        else
+            values = {{}};
         callback.update(*this);
     }
 
+  protected:
+    /// Reset the value of the given bank to zero.
+    void resetBank(setting_t bank) {
+        if (inEngine)
+            VUDecayEngine::getInstance().clear(firstMeter + bank, 1);
+        else
+            values[bank] = 0;
+        if (bank == getSelection())
+            callback.update(*this);
+    }
+
+  public:
     /// Return the VU meter value as an integer in [0, 12].
     uint8_t getValue() override { return getValue(getSelection()); }
     /// Return the overload status.
@@ -98,7 +131,12 @@ class VU_Base : public MIDIInputElementChannelPressure, public IVU {
 
     /// Update is called periodically, it decays the meter if the time is right.
     void update() override {
-        if (decayTime && (millis() - prevDecayTime >= decayTime)) {
+        if (inEngine) {
+            // The first VU decays the meters of all VUs in the engine
+            VUDecayEngine &engine = VUDecayEngine::getInstance();
+            if (engine.isFirstClient(*this))
+                engine.update();
+        } else if (decayTime && (millis() - prevDecayTime >= decayTime)) {
             prevDecayTime += decayTime;
             decay();
             callback.update(*this);
@@ -117,10 +155,16 @@ class VU_Base : public MIDIInputElementChannelPressure, public IVU {
             case 0xD: break; // no meaning
             default: setValue(index, data); break;
         }
-        callback.update(*this);
+        if (!this->deferUpdate())
+            callback.update(*this);
         return true;
     }
 
+    void flush() override { callback.update(*this); }
+
+    /// Called by the decay engine when one of the meters decayed.
+    void onDecay() override { callback.update(*this); }
+
     /// The address of the VU meter is the high nibble of the first (and only)
     /// data byte.
     MIDIAddress
@@ -147,25 +191,49 @@ class VU_Base : public MIDIInputElementChannelPressure, public IVU {
         return 0;
     }
 
-    /// Set the VU meter value.
+    /// Set the VU meter value, and restart its decay timer.
     void setValue(uint8_t index, uint8_t newValue) {
+        if (inEngine) {
+            VUDecayEngine::getInstance().setLevel(firstMeter + index, newValue);
+            return;
+        }
         prevDecayTime = millis();
         values[index] = newValue | (values[index] & 0xF0);
     }
 
     /// Set the overload status.
-    void setOverload(uint8_t index) { values[index] |= 0xF0; }
+    void setOverload(uint8_t index) {
+        if (inEngine)
+            VUDecayEngine::getInstance().setOverload(firstMeter + index, true);
+        else
+            values[index] |= 0xF0;
+    }
     /// Clear the overload status.
-    void clearOverload(uint8_t index) { values[index] &= 0x0F; }
-    /// Get the VU meter value from the raw value.
-    uint8_t getValue(uint8_t index) const { return values[index] & 0x0F; }
-    /// Get the overload status value from the raw value.
-    bool getOverload(uint8_t index) const { return values[index] & 0xF0; }
+    void clearOverload(uint8_t index) {
+        if (inEngine)
+            VUDecayEngine::getInstance().setOverload(firstMeter + index, false);
+        else
+            values[index] &= 0x0F;
+    }
+    /// Get the VU meter value of the given bank.
+    uint8_t getValue(uint8_t index) const {
+        return inEngine
+                   ? VUDecayEngine::getInstance().getLevel(firstMeter + index)
+                   : values[index] & 0x0F;
+    }
+    /// Get the overload status of the given bank.
+    bool getOverload(uint8_t index) const {
+        return inEngine ? VUDecayEngine::getInstance().getOverload(firstMeter +
+                                                                   index)
+                        : values[index] & 0xF0;
+    }
 
   private:
+    /// The values of meters that are not in the engine.
     Array<uint8_t, NumValues> values = {{}};
     unsigned int decayTime;
     unsigned long prevDecayTime = 0;
+    bool inEngine = false;
 
   public:
     Callback callback;
@@ -321,6 +389,22 @@ class GenericVU : public VU_Base<NumBanks, Callback>,
         },
         BankableMIDIInput<NumBanks>{config} {}
 
+    uint16_t getChannelMask() const override {
+        return BankableMIDIInput<NumBanks>::getChannelMask(this->address);
+    }
+
+    uint16_t getCableMask() const override {
+        return BankableMIDIInput<NumBanks>::getCableMask(this->address);
+    }
+
+    /// Reset the values of the banks that listen to the given channel and
+    /// cable, the other banks keep their values.
+    void resetChannel(Channel channel, uint8_t cable) override {
+        for (setting_t b = 0; b < NumBanks; ++b)
+            if (this->bankUsesChannel(b, channel, cable, this->address))
+                this->resetBank(b);
+    }
+
   private:
     setting_t getSelection() const override {
         return BankableMIDIInput<NumBanks>::getSelection();
@@ -0,0 +1,14 @@
+#include "VUDecayEngine.hpp"
+
+BEGIN_CS_NAMESPACE
+
+namespace MCU {
+
+VUDecayEngine &VUDecayEngine::getInstance() {
+    static VUDecayEngine engine;
+    return engine;
+}
+
+} // namespace MCU
+
+END_CS_NAMESPACE
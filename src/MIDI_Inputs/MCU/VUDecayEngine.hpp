@@ -0,0 +1,255 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <AH/Arduino-Wrapper.h> // millis
+#include <AH/Containers/LinkedList.hpp>
+#include <AH/Error/Error.hpp>
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+namespace MCU {
+
+/**
+ * @brief   An object that owns a number of consecutive meters in a
+ *          @ref BasicVUDecayEngine, and that is notified when they decay.
+ */
+class VUDecayClient : public DoublyLinkable<VUDecayClient> {
+  public:
+    /// Called by the engine when one or more of the meters of this client
+    /// decayed.
+    virtual void onDecay() = 0;
+
+    /// The index of the first meter of this client in the engine.
+    uint16_t firstMeter = 0;
+    /// The number of meters of this client.
+    uint8_t numMeters = 0;
+
+  protected:
+    VUDecayClient() = default;
+    ~VUDecayClient() = default;
+};
+
+/**
+ * @brief   Stores the levels and overload flags of many VU meters, and decays
+ *          all of them in a single pass.
+ *
+ * The levels, decay deadlines, decay times and overload flags are stored in
+ * separate contiguous arrays, and the deadlines are kept as 16-bit timestamps,
+ * so decaying all meters only needs a single `millis()` call and some integer
+ * math. The engine also keeps track of the earliest deadline, so most loop
+ * iterations don't have to look at the meters at all.
+ *
+ * MCU::VU elements register their meters (one for each bank) in the
+ * @ref VUDecayEngine instance. The first client updates the engine in its
+ * `update()` method, so all meters still decay when the input elements are
+ * updated, with or without `Control_Surface.loop()`.
+ *
+ * @tparam  Capacity
+ *          The maximum number of meters.
+ */
+template <uint16_t Capacity>
+class BasicVUDecayEngine {
+  public:
+    /// The maximum decay time, in milliseconds.
+    constexpr static uint16_t MaxDecayTime = 0x7FFF;
+
+    /**
+     * @brief   Allocate meters for the given client.
+     *
+     * @retval  true
+     *          The meters were allocated.
+     * @retval  false
+     *          There is no free run of meters of the given length, the client
+     *          has to store and decay its meters itself.
+     *
+     * @param   client
+     *          The client that owns the meters.
+     * @param   numMeters
+     *          The number of consecutive meters to allocate.
+     * @param   decayTime
+     *          The time in milliseconds it takes for the level to decay one
+     *          step, or zero to disable decay.
+     */
+    bool add(VUDecayClient &client, uint8_t numMeters, uint16_t decayTime) {
+        uint16_t first = findFree(numMeters);
+        if (first + numMeters > Capacity)
+            return false;
+        decayTime = decayTime < MaxDecayTime ? decayTime : MaxDecayTime;
+        for (uint16_t i = first; i < first + numMeters; ++i) {
+            setBit(used, i, true);
+            levels[i] = 0;
+            setBit(overloads, i, false);
+            decayTimes[i] = decayTime;
+        }
+        client.firstMeter = first;
+        client.numMeters = numMeters;
+        clients.append(&client);
+        return true;
+    }
+
+    /// Release the meters of the given client.
+    void remove(VUDecayClient &client) {
+        if (!clients.couldContain(&client))
+            return;
+        clients.remove(&client);
+        for (uint16_t i = client.firstMeter;
+             i < client.firstMeter + client.numMeters; ++i) {
+            setBit(used, i, false);
+            levels[i] = 0;
+        }
+        if (clients.getFirst() == nullptr)
+            pending = false;
+    }
+
+    /// Get the level of the given meter.
+    uint8_t getLevel(uint16_t meter) const { return levels[meter]; }
+    /// Set the level of the given meter, and restart its decay timer.
+    void setLevel(uint16_t meter, uint8_t level) {
+        levels[meter] = level;
+        if (decayTimes[meter] == 0)
+            return;
+        uint16_t deadline = uint16_t(millis()) + decayTimes[meter];
+        deadlines[meter] = deadline;
+        if (!pending || int16_t(deadline - nextDeadline) < 0)
+            nextDeadline = deadline;
+        pending = true;
+    }
+    /// Get the overload flag of the given meter.
+    bool getOverload(uint16_t meter) const { return getBit(overloads, meter); }
+    /// Set or clear the overload flag of the given meter.
+    void setOverload(uint16_t meter, bool overload) {
+        setBit(overloads, meter, overload);
+    }
+    /// Set the level and the overload flag of the given meters to zero.
+    void clear(uint16_t first, uint8_t numMeters) {
+        for (uint16_t i = first; i < first + numMeters; ++i) {
+            levels[i] = 0;
+            setBit(overloads, i, false);
+        }
+    }
+
+    /**
+     * @brief   Decay all meters whose deadline has passed, by one step, and
+     *          notify their clients.
+     *
+     * @return  The number of meters that decayed.
+     */
+    uint16_t update() {
+        if (!pending)
+            return 0;
+        uint16_t now = millis();
+        if (int16_t(now - nextDeadline) < 0)
+            return 0;
+        return decay(now);
+    }
+
+    /// Check whether the given client is the first one, which is responsible
+    /// for updating the engine.
+    bool isFirstClient(const VUDecayClient &client) const {
+        return clients.getFirst() == &client;
+    }
+
+    /// Get the number of meters that are in use.
+    uint16_t size() const {
+        uint16_t count = 0;
+        for (uint8_t b : used)
+            for (; b; b &= b - 1)
+                ++count;
+        return count;
+    }
+
+    /// Get the maximum number of meters.
+    constexpr static uint16_t capacity() { return Capacity; }
+
+  private:
+    /// Decay all meters that are due, compute the next deadline, and notify
+    /// the clients of the meters that changed.
+    uint16_t decay(uint16_t now) {
+        uint16_t decayed = 0;
+        uint16_t next = now + MaxDecayTime;
+        bool stillPending = false;
+        for (uint16_t i = 0; i < Capacity; ++i) {
+            if (levels[i] == 0 || decayTimes[i] == 0)
+                continue;
+            // Deadlines are relative to the current time, in [-2^15, 2^15)
+            if (int16_t(now - deadlines[i]) >= 0) {
+                --levels[i];
+                deadlines[i] += decayTimes[i];
+                setBit(changed, i, true);
+                ++decayed;
+            }
+            if (levels[i] != 0) {
+                stillPending = true;
+                if (int16_t(deadlines[i] - next) < 0)
+                    next = deadlines[i];
+            }
+        }
+        pending = stillPending;
+        nextDeadline = next;
+        if (decayed == 0)
+            return 0;
+        for (VUDecayClient &client : clients) {
+            bool clientChanged = false;
+            for (uint16_t i = client.firstMeter;
+                 i < client.firstMeter + client.numMeters; ++i) {
+                clientChanged |= getBit(changed, i);
+                setBit(changed, i, false);
+            }
+            if (clientChanged)
+                client.onDecay();
+        }
+        return decayed;
+    }
+
+    /// Find the first run of free meters of the given length.
+    uint16_t findFree(uint8_t numMeters) const {
+        uint16_t run = 0;
+        for (uint16_t i = 0; i < Capacity; ++i) {
+            run = getBit(used, i) ? 0 : run + 1;
+            if (run == numMeters)
+                return i + 1 - numMeters;
+        }
+        return Capacity;
+    }
+
+    constexpr static uint16_t NumBytes = (Capacity + 7) / 8;
+    static bool getBit(const uint8_t (&bits)[NumBytes], uint16_t i) {
+        return (bits[i / 8] >> (i % 8)) & 1;
+    }
+    static void setBit(uint8_t (&bits)[NumBytes], uint16_t i, bool value) {
+        uint8_t mask = 1 << (i % 8);
+        bits[i / 8] = (bits[i / 8] & ~mask) | (-uint8_t(value) & mask);
+    }
+
+    uint8_t levels[Capacity] = {};
+    uint16_t deadlines[Capacity] = {};
+    uint16_t decayTimes[Capacity] = {};
+    uint8_t overloads[NumBytes] = {};
+    uint8_t used[NumBytes] = {};
+    uint8_t changed[NumBytes] = {};
+    uint16_t nextDeadline = 0;
+    bool pending = false;
+    DoublyLinkedList<VUDecayClient> clients;
+};
+
+/**
+ * @brief   The VU decay engine used by the MCU::VU elements, with a capacity of
+ *          @ref VU_DECAY_ENGINE_CAPACITY meters.
+ */
+class VUDecayEngine : public BasicVUDecayEngine<VU_DECAY_ENGINE_CAPACITY> {
+  public:
+    /// Get the engine instance. It is created on first use.
+    static VUDecayEngine &getInstance();
+
+  private:
+    VUDecayEngine() = default;
+};
+
+} // namespace MCU
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
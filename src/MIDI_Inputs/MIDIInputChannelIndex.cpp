@@ -0,0 +1,38 @@
+#include "MIDIInputChannelIndex.hpp"
+
+BEGIN_CS_NAMESPACE
+
+void MIDIInputChannelIndex::clear() {
+    for (MIDIInputElement *&list : lists)
+        list = nullptr;
+}
+
+void MIDIInputChannelIndex::insert(MIDIInputElement &element) {
+    uint16_t channels = element.getChannelMask();
+    if (channels == 0)
+        return;
+    // Single channel: the index of the only bit that is set
+    uint8_t list = NumLists - 1;
+    if ((channels & (channels - 1)) == 0) {
+        list = 0;
+        while ((channels >> list) != 1)
+            ++list;
+    }
+    element.nextInChannel = lists[list];
+    lists[list] = &element;
+}
+
+void MIDIInputChannelIndex::resetMatching(Channel channel, uint8_t cable) {
+    uint8_t ch = channel.getRaw();
+    uint16_t cableBit = 1 << cable;
+    for (MIDIInputElement *e = lists[ch]; e != nullptr; e = e->nextInChannel)
+        if (e->getCableMask() & cableBit)
+            e->resetChannel(channel, cable);
+    uint16_t channelBit = 1 << ch;
+    for (MIDIInputElement *e = lists[NumLists - 1]; e != nullptr;
+         e = e->nextInChannel)
+        if ((e->getChannelMask() & channelBit) && (e->getCableMask() & cableBit))
+            e->resetChannel(channel, cable);
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <MIDI_Inputs/MIDIInputElement.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Index of MIDI input elements by the MIDI channel they listen to.
+ * 
+ * Used for messages that affect an entire channel, such as Reset All 
+ * Controllers and All Notes Off, so only the elements on that channel have to
+ * be visited, instead of all elements.
+ * 
+ * Elements that listen to a single channel are kept in a list for that 
+ * channel. Elements that listen to multiple channels (e.g. bankable elements
+ * that change the channel) are kept in a separate list that is checked for 
+ * every channel.
+ * 
+ * The index is built lazily: adding or removing an element invalidates it, and
+ * it is rebuilt the next time it's used.
+ */
+class MIDIInputChannelIndex {
+  public:
+    /// Mark the index as outdated, e.g. after adding or removing an element.
+    void invalidate() { valid = false; }
+
+    /**
+     * @brief   Reset all elements that listen to the given channel and cable.
+     * 
+     * @param   elements
+     *          All elements, used to rebuild the index if it's outdated.
+     * @param   channel
+     *          The MIDI channel to reset.
+     * @param   cable
+     *          The MIDI USB cable number to reset.
+     */
+    template <class Elements>
+    void resetAll(Elements &elements, Channel channel, uint8_t cable) {
+        if (!valid) {
+            clear();
+            for (MIDIInputElement &e : elements)
+                insert(e);
+            valid = true;
+        }
+        resetMatching(channel, cable);
+    }
+
+  private:
+    void clear();
+    void insert(MIDIInputElement &element);
+    void resetMatching(Channel channel, uint8_t cable);
+
+    /// Number of lists: one for each channel, and one for elements that listen
+    /// to more than one channel.
+    constexpr static uint8_t NumLists = 17;
+    MIDIInputElement *lists[NumLists] = {};
+    bool valid = false;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -1,3 +1,34 @@
-#ifdef TEST_COMPILE_ALL_HEADERS_SEPARATELY
 #include "MIDIInputElement.hpp"
-#endif
\ No newline at end of file
+
+BEGIN_CS_NAMESPACE
+
+MIDIInputElement *MIDIInputElement::dirtyHead = nullptr;
+bool MIDIInputElement::coalesce = false;
+
+MIDIInputElement::~MIDIInputElement() {
+    if (!dirty)
+        return;
+    // Remove this element from the list of dirty elements
+    MIDIInputElement **el = &dirtyHead;
+    while (*el != this)
+        el = &(*el)->nextDirty;
+    *el = nextDirty;
+}
+
+void MIDIInputElement::setCoalescedUpdates(bool enabled) {
+    if (!enabled)
+        flushAll();
+    coalesce = enabled;
+}
+
+void MIDIInputElement::flushAll() {
+    while (dirtyHead != nullptr) {
+        MIDIInputElement *el = dirtyHead;
+        dirtyHead = el->nextDirty;
+        el->nextDirty = nullptr;
+        el->dirty = false;
+        el->flush();
+    }
+}
+
+END_CS_NAMESPACE
@@ -24,7 +24,7 @@ class MIDIInputElement {
     MIDIInputElement(const MIDIAddress &address) : address(address) {}
 
   public:
-    virtual ~MIDIInputElement() = default;
+    virtual ~MIDIInputElement();
 
     /// Initialize the input element.
     virtual void begin() {}
@@ -32,9 +32,28 @@ class MIDIInputElement {
     /// Reset the input element to its initial state.
     virtual void reset() {}
 
+    /// Reset the state of the input element that belongs to the given MIDI
+    /// channel and cable, e.g. when a Reset All Controllers message arrives.
+    /// Elements that don't keep separate state per channel reset everything.
+    virtual void resetChannel(Channel channel, uint8_t cable) {
+        (void)channel, (void)cable;
+        reset();
+    }
+
     /// Update the value of the input element. Used for decaying VU meters etc.
     virtual void update() {}
 
+    /// Get the set of MIDI channels this element listens to: bit `i` is set if
+    /// it listens to channel `i + 1`.
+    virtual uint16_t getChannelMask() const {
+        return address.isValid() ? 1 << address.getRawChannel() : 0;
+    }
+    /// Get the set of MIDI USB cable numbers this element listens to: bit `i`
+    /// is set if it listens to cable number `i`.
+    virtual uint16_t getCableMask() const {
+        return address.isValid() ? 1 << address.getCableNumber() : 0;
+    }
+
     /// Receive a new MIDI message and update the internal state.
     bool updateWith(const ChannelMessageMatcher &midimsg) {
         MIDIAddress target = getTarget(midimsg);
@@ -47,7 +66,63 @@ class MIDIInputElement {
         return true;
     }
 
+    /**
+     * @brief   Enable or disable coalesced updates.
+     * 
+     * By default, the callbacks of an input element (that update the LEDs, 
+     * displays, etc.) run as soon as a matching MIDI message arrives. When a
+     * burst of messages arrives for the same element, e.g. when the DAW resends
+     * all of its values, the same hardware is updated many times during a
+     * single loop iteration.
+     * 
+     * When coalescing is enabled, elements only save the new values and mark
+     * themselves as dirty. The callbacks of the dirty elements then run once,
+     * in @ref flushAll, which is called at the end of `Control_Surface.loop()`.
+     * 
+     * Disabling coalescing flushes all pending updates.
+     */
+    static void setCoalescedUpdates(bool enabled);
+    /// Check whether coalesced updates are enabled.
+    /// @see    setCoalescedUpdates
+    static bool hasCoalescedUpdates() { return coalesce; }
+    /// Run the deferred callbacks of all elements that received new values
+    /// since the last flush.
+    static void flushAll();
+
+  protected:
+    /**
+     * @brief   Check whether the callback of this element should be deferred.
+     * 
+     * If coalesced updates are enabled, the element is marked as dirty, and
+     * its @ref flush method will be called at the end of the loop.
+     * 
+     * @retval  true
+     *          Don't run the callback now, it will be run by @ref flush.
+     * @retval  false
+     *          Coalescing is disabled, run the callback immediately.
+     */
+    bool deferUpdate() {
+        if (!coalesce)
+            return false;
+        markDirty();
+        return true;
+    }
+
+    /// Add this element to the list of dirty elements, so its @ref flush 
+    /// method is called at the end of the loop, even if coalesced updates are
+    /// disabled.
+    void markDirty() {
+        if (!dirty) {
+            dirty = true;
+            nextDirty = dirtyHead;
+            dirtyHead = this;
+        }
+    }
+
   private:
+    /// Run the callbacks that were deferred by @ref deferUpdate.
+    virtual void flush() {}
+
     /// Update the internal state with the new MIDI message.
     virtual bool updateImpl(const ChannelMessageMatcher &midimsg,
                             const MIDIAddress &target) = 0;
@@ -78,6 +153,19 @@ class MIDIInputElement {
 
   protected:
     const MIDIAddress address;
+
+  private:
+    /// Whether this element is in the list of dirty elements.
+    bool dirty = false;
+    /// The next element in the list of dirty elements.
+    MIDIInputElement *nextDirty = nullptr;
+    /// The next element on the same channel.
+    /// @see    MIDIInputChannelIndex
+    MIDIInputElement *nextInChannel = nullptr;
+    friend class MIDIInputChannelIndex;
+
+    static MIDIInputElement *dirtyHead;
+    static bool coalesce;
 };
 
 END_CS_NAMESPACE
\ No newline at end of file
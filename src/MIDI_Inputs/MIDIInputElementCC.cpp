@@ -3,6 +3,7 @@
 BEGIN_CS_NAMESPACE
 
 DoublyLinkedList<MIDIInputElementCC> MIDIInputElementCC::elements;
+MIDIInputChannelIndex MIDIInputElementCC::channelIndex;
 #ifdef ESP32
 std::mutex MIDIInputElementCC::mutex;
 #endif
@@ -1,6 +1,7 @@
 #pragma once
 
 #include <AH/Containers/LinkedList.hpp>
+#include <MIDI_Inputs/MIDIInputChannelIndex.hpp>
 #include <MIDI_Inputs/MIDIInputElement.hpp>
 
 
@@ -39,12 +40,14 @@ class MIDIInputElementCC : public MIDIInputElement,
         : MIDIInputElement{address} {
         GUARD_LIST_LOCK;
         elements.append(this);
+        channelIndex.invalidate();
     }
 
     /// Destructor: delete from the linked list.
     virtual ~MIDIInputElementCC() {
         GUARD_LIST_LOCK;
         elements.remove(this);
+        channelIndex.invalidate();
     }
 
     /// Initialize all MIDIInputElementCC elements.
@@ -71,6 +74,14 @@ class MIDIInputElementCC : public MIDIInputElement,
             e.reset();
     }
 
+    /// Reset the MIDIInputElementCC elements that listen to the given MIDI
+    /// channel and cable number. Used for Reset All Controllers messages.
+    /// @see    MIDIInputChannelIndex
+    static void resetAll(Channel channel, uint8_t cable) {
+        GUARD_LIST_LOCK;
+        channelIndex.resetAll(elements, channel, cable);
+    }
+
     /// Update all MIDIInputElementCC elements with a new MIDI message.
     /// @see     MIDIInputElementCC#updateWith
     static void updateAllWith(const ChannelMessageMatcher &midimsg) {
@@ -97,6 +108,7 @@ class MIDIInputElementCC : public MIDIInputElement,
     }
 
     static DoublyLinkedList<MIDIInputElementCC> elements;
+    static MIDIInputChannelIndex channelIndex;
 #ifdef ESP32
     static std::mutex mutex;
 #endif
@@ -4,6 +4,7 @@ BEGIN_CS_NAMESPACE
 
 DoublyLinkedList<MIDIInputElementChannelPressure>
     MIDIInputElementChannelPressure::elements;
+MIDIInputChannelIndex MIDIInputElementChannelPressure::channelIndex;
 #ifdef ESP32
 std::mutex MIDIInputElementChannelPressure::mutex;
 #endif
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "MIDIInputChannelIndex.hpp"
 #include "MIDIInputElement.hpp"
 #include <AH/Containers/LinkedList.hpp>
 
@@ -30,6 +31,7 @@ class MIDIInputElementChannelPressure
         : MIDIInputElement(address) {
         GUARD_LIST_LOCK;
         elements.append(this);
+        channelIndex.invalidate();
     }
 
     /**
@@ -39,6 +41,7 @@ class MIDIInputElementChannelPressure
     virtual ~MIDIInputElementChannelPressure() {
         GUARD_LIST_LOCK;
         elements.remove(this);
+        channelIndex.invalidate();
     }
 
     static void beginAll() {
@@ -59,6 +62,18 @@ class MIDIInputElementChannelPressure
             el.reset();
     }
 
+    /**
+     * @brief   Reset the MIDIInputElementChannelPressure elements that listen 
+     *          to the given MIDI channel and cable number. Used for Reset All
+     *          Controllers messages.
+     * 
+     * @see     MIDIInputChannelIndex
+     */
+    static void resetAll(Channel channel, uint8_t cable) {
+        GUARD_LIST_LOCK;
+        channelIndex.resetAll(elements, channel, cable);
+    }
+
     /**
      * @brief   Update all MIDIInputElementChannelPressure elements.
      */
@@ -105,6 +120,7 @@ class MIDIInputElementChannelPressure
     }
 
     static DoublyLinkedList<MIDIInputElementChannelPressure> elements;
+    static MIDIInputChannelIndex channelIndex;
 #ifdef ESP32
     static std::mutex mutex;
 #endif
@@ -0,0 +1,11 @@
+#include "MIDIInputElementKP.hpp"
+
+BEGIN_CS_NAMESPACE
+
+DoublyLinkedList<MIDIInputElementKP> MIDIInputElementKP::elements;
+MIDIInputChannelIndex MIDIInputElementKP::channelIndex;
+#ifdef ESP32
+std::mutex MIDIInputElementKP::mutex;
+#endif
+
+END_CS_NAMESPACE
\ No newline at end of file
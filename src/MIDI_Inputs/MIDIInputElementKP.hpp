@@ -0,0 +1,131 @@
+#pragma once
+
+#include "MIDIInputChannelIndex.hpp"
+#include "MIDIInputElement.hpp"
+#include <AH/Containers/LinkedList.hpp>
+
+#if defined(ESP32)
+#include <mutex>
+#define GUARD_LIST_LOCK std::lock_guard<std::mutex> guard_(mutex)
+#else
+#define GUARD_LIST_LOCK
+#endif
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Class for objects that listen for incoming MIDI Polyphonic Key
+ *          Pressure events.
+ * 
+ * @ingroup MIDIInputElements
+ */
+class MIDIInputElementKP : public MIDIInputElement,
+                           public DoublyLinkable<MIDIInputElementKP> {
+  protected:
+    /**
+     * @brief   Create a new MIDIInputElementKP that listens on the given
+     *          address.
+     * 
+     * @param   address
+     *          The MIDI address to listen to. (Key number [0, 127],
+     *          Channel [1, 16], Cable Number [0, 15].)
+     */
+    MIDIInputElementKP(const MIDIAddress &address)
+        : MIDIInputElement{address} {
+        GUARD_LIST_LOCK;
+        elements.append(this);
+        channelIndex.invalidate();
+    }
+
+  public:
+    /// Destructor: delete from the linked list.
+    virtual ~MIDIInputElementKP() {
+        GUARD_LIST_LOCK;
+        elements.remove(this);
+        channelIndex.invalidate();
+    }
+
+    /**
+     * @brief   Initialize all MIDIInputElementKP elements.
+     * 
+     * @see     MIDIInputElementKP#begin
+     */
+    static void beginAll() {
+        GUARD_LIST_LOCK;
+        for (MIDIInputElementKP &e : elements)
+            e.begin();
+    }
+
+    /**
+     * @brief   Update all MIDIInputElementKP elements.
+     * 
+     * @see     MIDIInputElementKP#update
+     */
+    static void updateAll() {
+        GUARD_LIST_LOCK;
+        for (MIDIInputElementKP &e : elements)
+            e.update();
+    }
+
+    /** 
+     * @brief   Reset all MIDIInputElementKP elements to their initial state.
+     * 
+     * @see     MIDIInputElementKP#reset
+     */
+    static void resetAll() {
+        GUARD_LIST_LOCK;
+        for (MIDIInputElementKP &e : elements)
+            e.reset();
+    }
+
+    /**
+     * @brief   Reset the MIDIInputElementKP elements that listen to the
+     *          given MIDI channel and cable number. Used for Reset All
+     *          Controllers messages.
+     * 
+     * @see     MIDIInputChannelIndex
+     */
+    static void resetAll(Channel channel, uint8_t cable) {
+        GUARD_LIST_LOCK;
+        channelIndex.resetAll(elements, channel, cable);
+    }
+
+    /**
+     * @brief   Update all MIDIInputElementKP elements with a new MIDI 
+     *          message.
+     * 
+     * @see     MIDIInputElementKP#updateWith
+     */
+    static void updateAllWith(const ChannelMessageMatcher &midimsg) {
+        for (MIDIInputElementKP &e : elements)
+            if (e.updateWith(midimsg)) {
+                e.moveDown();
+                return;
+            }
+        // No mutex required:
+        // e.moveDown may alter the list, but if it does, it always returns,
+        // and we stop iterating, so it doesn't matter.
+    }
+
+  private:
+    /**
+     * @brief   Move down this element in the linked list of elements.
+     * 
+     * This means that the element will be checked earlier on the next
+     * iteration.
+     */
+    void moveDown() {
+        GUARD_LIST_LOCK;
+        elements.moveDown(this);
+    }
+
+    static DoublyLinkedList<MIDIInputElementKP> elements;
+    static MIDIInputChannelIndex channelIndex;
+#ifdef ESP32
+    static std::mutex mutex;
+#endif
+};
+
+#undef GUARD_LIST_LOCK
+
+END_CS_NAMESPACE
\ No newline at end of file
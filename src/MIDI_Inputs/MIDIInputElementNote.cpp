@@ -3,6 +3,7 @@
 BEGIN_CS_NAMESPACE
 
 DoublyLinkedList<MIDIInputElementNote> MIDIInputElementNote::elements;
+MIDIInputChannelIndex MIDIInputElementNote::channelIndex;
 #ifdef ESP32
 std::mutex MIDIInputElementNote::mutex;
 #endif
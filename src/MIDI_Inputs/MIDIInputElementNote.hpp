@@ -1,5 +1,6 @@
 #pragma once
 
+#include "MIDIInputChannelIndex.hpp"
 #include "MIDIInputElement.hpp"
 #include <AH/Containers/LinkedList.hpp>
 
@@ -28,6 +29,7 @@ class MIDIInputElementNote : public MIDIInputElement,
         : MIDIInputElement{address} {
         GUARD_LIST_LOCK;
         elements.append(this);
+        channelIndex.invalidate();
     }
 
   public:
@@ -38,6 +40,7 @@ class MIDIInputElementNote : public MIDIInputElement,
     virtual ~MIDIInputElementNote() {
         GUARD_LIST_LOCK;
         elements.remove(this);
+        channelIndex.invalidate();
     }
 
     /**
@@ -73,6 +76,18 @@ class MIDIInputElementNote : public MIDIInputElement,
             e.reset();
     }
 
+    /**
+     * @brief   Reset the MIDIInputElementNote elements that listen to the
+     *          given MIDI channel and cable number. Used for All Notes Off
+     *          and All Sound Off messages.
+     * 
+     * @see     MIDIInputChannelIndex
+     */
+    static void resetAll(Channel channel, uint8_t cable) {
+        GUARD_LIST_LOCK;
+        channelIndex.resetAll(elements, channel, cable);
+    }
+
     /**
      * @brief   Update all MIDIInputElementNote elements with a new MIDI 
      *          message.
@@ -103,6 +118,7 @@ class MIDIInputElementNote : public MIDIInputElement,
     }
 
     static DoublyLinkedList<MIDIInputElementNote> elements;
+    static MIDIInputChannelIndex channelIndex;
 #ifdef ESP32
     static std::mutex mutex;
 #endif
@@ -0,0 +1,11 @@
+#include "MIDIInputElementPB.hpp"
+
+BEGIN_CS_NAMESPACE
+
+DoublyLinkedList<MIDIInputElementPB> MIDIInputElementPB::elements;
+MIDIInputChannelIndex MIDIInputElementPB::channelIndex;
+#ifdef ESP32
+std::mutex MIDIInputElementPB::mutex;
+#endif
+
+END_CS_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,132 @@
+#pragma once
+
+#include "MIDIInputChannelIndex.hpp"
+#include "MIDIInputElement.hpp"
+#include <AH/Containers/LinkedList.hpp>
+
+#if defined(ESP32)
+#include <mutex>
+#define GUARD_LIST_LOCK std::lock_guard<std::mutex> guard_(mutex)
+#else
+#define GUARD_LIST_LOCK
+#endif
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Class for objects that listen for incoming MIDI Pitch Bend events.
+ * 
+ * The Mackie Control Universal protocol uses Pitch Bend messages for the
+ * positions of the motorized faders.
+ * 
+ * @ingroup MIDIInputElements
+ */
+class MIDIInputElementPB : public MIDIInputElement,
+                           public DoublyLinkable<MIDIInputElementPB> {
+  public:
+    /**
+     * @brief   Create a new MIDIInputElementPB that listens on the given
+     *          address.
+     * 
+     * @param   address
+     *          The MIDI address to listen to. (The address itself is not used,
+     *          only the Channel [1, 16] and Cable Number [0, 15].)
+     */
+    MIDIInputElementPB(const MIDIAddress &address)
+        : MIDIInputElement(address) {
+        GUARD_LIST_LOCK;
+        elements.append(this);
+        channelIndex.invalidate();
+    }
+
+    /// Destructor: delete from the linked list.
+    virtual ~MIDIInputElementPB() {
+        GUARD_LIST_LOCK;
+        elements.remove(this);
+        channelIndex.invalidate();
+    }
+
+    /// Initialize all MIDIInputElementPB elements.
+    static void beginAll() {
+        GUARD_LIST_LOCK;
+        for (MIDIInputElementPB &el : elements)
+            el.begin();
+    }
+
+    /**
+     * @brief   Reset all MIDIInputElementPB elements to their initial state.
+     *
+     * @see     MIDIInputElementPB#reset
+     */
+    static void resetAll() {
+        GUARD_LIST_LOCK;
+        for (MIDIInputElementPB &el : elements)
+            el.reset();
+    }
+
+    /**
+     * @brief   Reset the MIDIInputElementPB elements that listen to the given
+     *          MIDI channel and cable number. Used for Reset All Controllers
+     *          messages.
+     * 
+     * @see     MIDIInputChannelIndex
+     */
+    static void resetAll(Channel channel, uint8_t cable) {
+        GUARD_LIST_LOCK;
+        channelIndex.resetAll(elements, channel, cable);
+    }
+
+    /**
+     * @brief   Update all MIDIInputElementPB elements.
+     */
+    static void updateAll() {
+        GUARD_LIST_LOCK;
+        for (MIDIInputElementPB &el : elements)
+            el.update();
+    }
+
+    /**
+     * @brief   Update all MIDIInputElementPB elements with a new MIDI message.
+     *
+     * @see     MIDIInputElementPB#updateWith
+     */
+    static void updateAllWith(const ChannelMessageMatcher &midimsg) {
+        for (MIDIInputElementPB &e : elements)
+            if (e.updateWith(midimsg)) {
+                e.moveDown();
+                return;
+            }
+        // No mutex required:
+        // e.moveDown may alter the list, but if it does, it always returns,
+        // and we stop iterating, so it doesn't matter.
+    }
+
+  private:
+    /// Pitch Bend doesn't have an address, so the target consists of just the
+    /// channel and the cable number.
+    MIDIAddress
+    getTarget(const ChannelMessageMatcher &midimsg) const override {
+        return {0, Channel(midimsg.channel), midimsg.CN};
+    }
+
+    /**
+     * @brief   Move down this element in the linked list of elements.
+     * 
+     * This means that the element will be checked earlier on the next
+     * iteration.
+     */
+    void moveDown() {
+        GUARD_LIST_LOCK;
+        elements.moveDown(this);
+    }
+
+    static DoublyLinkedList<MIDIInputElementPB> elements;
+    static MIDIInputChannelIndex channelIndex;
+#ifdef ESP32
+    static std::mutex mutex;
+#endif
+};
+
+#undef GUARD_LIST_LOCK
+
+END_CS_NAMESPACE
\ No newline at end of file
@@ -0,0 +1,128 @@
+#include "MIDIInputElementParameter.hpp"
+#include <MIDI_Constants/Control_Change.hpp>
+
+BEGIN_CS_NAMESPACE
+
+DoublyLinkedList<MIDIInputElementParameter> MIDIInputElementParameter::elements;
+MIDIInputElementParameter::ChannelState MIDIInputElementParameter::states[16];
+bool MIDIInputElementParameter::suppressCCs = false;
+
+void MIDIInputElementParameter::beginAll() {
+    for (MIDIInputElementParameter &e : elements)
+        e.begin();
+}
+
+void MIDIInputElementParameter::updateAll() {
+    for (MIDIInputElementParameter &e : elements)
+        e.update();
+}
+
+void MIDIInputElementParameter::resetAll() {
+    for (MIDIInputElementParameter &e : elements)
+        e.reset();
+}
+
+void MIDIInputElementParameter::resetSelection(Channel channel,
+                                               uint8_t cable) {
+    ChannelState &state = states[channel.getRaw()];
+    if (state.cable == cable)
+        state = {};
+}
+
+void MIDIInputElementParameter::select(ChannelState &state, ParameterType type,
+                                       bool msb, uint8_t value, uint8_t cable) {
+    // Switching to another type or cable starts a new parameter number
+    if (state.type != uint8_t(type) || state.cable != cable) {
+        state.numberMSB = 0;
+        state.numberLSB = 0;
+    }
+    state.type = uint8_t(type);
+    state.cable = cable;
+    (msb ? state.numberMSB : state.numberLSB) = value;
+}
+
+bool MIDIInputElementParameter::updateAllWith(
+    const ChannelMessageMatcher &midimsg) {
+    ChannelState &state = states[midimsg.channel];
+    const uint8_t value = midimsg.data2;
+    switch (midimsg.data1) {
+        case MIDI_CC::NRPN_MSB:
+            select(state, ParameterType::NRPN, true, value, midimsg.CN);
+            return suppressCCs;
+        case MIDI_CC::NRPN_LSB:
+            select(state, ParameterType::NRPN, false, value, midimsg.CN);
+            return suppressCCs;
+        case MIDI_CC::RPN_MSB:
+            select(state, ParameterType::RPN, true, value, midimsg.CN);
+            return suppressCCs;
+        case MIDI_CC::RPN_LSB:
+            select(state, ParameterType::RPN, false, value, midimsg.CN);
+            return suppressCCs;
+        case MIDI_CC::Data_Entry_MSB:
+        case MIDI_CC::Data_Entry_MSB_LSB:
+        case MIDI_CC::Data_Increment:
+        case MIDI_CC::Data_Decrement: break;
+        default: return false;
+    }
+
+    // Data Entry without a selected parameter is a normal CC message
+    // (parameter number 0x3FFF is the “null” parameter)
+    if (state.type == 0 || state.cable != midimsg.CN ||
+        state.getNumber() == 0x3FFF)
+        return false;
+
+    ParameterType type = ParameterType(state.type);
+    uint16_t number = state.getNumber();
+    for (MIDIInputElementParameter &e : elements) {
+        if (e.type != type || e.number != number ||
+            e.address.getRawChannel() != midimsg.channel ||
+            e.address.getCableNumber() != midimsg.CN)
+            continue;
+        switch (midimsg.data1) {
+            case MIDI_CC::Data_Entry_MSB: e.receiveMSB(value); break;
+            case MIDI_CC::Data_Entry_MSB_LSB: e.receiveLSB(value); break;
+            case MIDI_CC::Data_Increment: e.receiveIncrement(true); break;
+            case MIDI_CC::Data_Decrement: e.receiveIncrement(false); break;
+            default: break; // LCOV_EXCL_LINE
+        }
+    }
+    return suppressCCs;
+}
+
+void MIDIInputElementParameter::receiveMSB(uint8_t msb) {
+    // A new MSB resets the LSB. The LSB usually follows immediately, if it
+    // doesn't, the callback runs at the end of the loop.
+    value = uint16_t(msb & 0x7F) << 7;
+    pendingCallback = true;
+    markDirty();
+}
+
+void MIDIInputElementParameter::receiveLSB(uint8_t lsb) {
+    value = (value & 0x3F80) | (lsb & 0x7F);
+    deliver();
+}
+
+void MIDIInputElementParameter::receiveIncrement(bool increment) {
+    if (increment && value < 0x3FFF)
+        ++value;
+    else if (!increment && value > 0)
+        --value;
+    deliver();
+}
+
+void MIDIInputElementParameter::deliver() {
+    pendingCallback = true;
+    if (deferUpdate())
+        return;
+    pendingCallback = false;
+    onValueChange();
+}
+
+void MIDIInputElementParameter::flush() {
+    if (!pendingCallback)
+        return;
+    pendingCallback = false;
+    onValueChange();
+}
+
+END_CS_NAMESPACE
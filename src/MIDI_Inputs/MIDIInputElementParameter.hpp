@@ -0,0 +1,159 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <AH/Containers/LinkedList.hpp>
+#include <MIDI_Inputs/MIDIInputElement.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/// The type of a MIDI parameter number.
+enum class ParameterType : uint8_t {
+    NRPN = 1, ///< Non-Registered Parameter Number (CC 99 and 98).
+    RPN = 2,  ///< Registered Parameter Number (CC 101 and 100).
+};
+
+/**
+ * @brief   Class for objects that listen for incoming NRPN or RPN parameter
+ *          updates.
+ * 
+ * A parameter is selected using two CC messages for the 14-bit parameter 
+ * number (CC 99/98 for NRPN, CC 101/100 for RPN), and its 14-bit value is 
+ * then set using the Data Entry MSB and LSB messages (CC 6 and 38), or 
+ * changed using Data Increment and Decrement (CC 96 and 97).  
+ * These CC messages are assembled by a state machine for each MIDI channel.
+ * To save RAM, the channels of different cables share this state machine: 
+ * the selection remembers its cable, and Data Entry messages on other cables
+ * are ignored. Interleaving parameter updates for the same channel on two 
+ * different cables is therefore not supported.
+ * The parameter elements only get a callback when the full value has been
+ * received, instead of one for each of the CC messages: 
+ * 
+ * - When a Data Entry LSB arrives, the callback runs immediately.
+ * - When only a Data Entry MSB arrives (7-bit senders), the callback runs at
+ *   the end of the loop, see @ref MIDIInputElement::flushAll.
+ * 
+ * By default, the CC messages that make up the parameter updates are still 
+ * passed on to the normal MIDIInputElementCC elements as well, this can be 
+ * disabled using @ref setSuppressCCs.
+ * 
+ * @ingroup MIDIInputElements
+ */
+class MIDIInputElementParameter
+    : public MIDIInputElement,
+      public DoublyLinkable<MIDIInputElementParameter> {
+  protected:
+    /**
+     * @brief   Create a new MIDIInputElementParameter that listens for the 
+     *          given parameter.
+     * 
+     * @param   type
+     *          NRPN or RPN.
+     * @param   number
+     *          The 14-bit parameter number [0, 16383].
+     * @param   channelCN
+     *          The MIDI channel [CHANNEL_1, CHANNEL_16] and optional Cable
+     *          Number [0, 15].
+     */
+    MIDIInputElementParameter(ParameterType type, uint16_t number,
+                              const MIDIChannelCN &channelCN)
+        : MIDIInputElement{{0, channelCN}}, type(type), number(number) {
+        elements.append(this);
+    }
+
+  public:
+    /// Destructor: delete from the linked list.
+    virtual ~MIDIInputElementParameter() { elements.remove(this); }
+
+    /// Get the 14-bit value of the parameter.
+    uint16_t getValue() const { return value; }
+    /// Get the type of the parameter.
+    ParameterType getType() const { return type; }
+    /// Get the 14-bit parameter number.
+    uint16_t getNumber() const { return number; }
+
+    /// Reset the value to zero.
+    void reset() override {
+        value = 0;
+        pendingCallback = false;
+        onValueChange();
+    }
+
+    /// Initialize all MIDIInputElementParameter elements.
+    static void beginAll();
+    /// Update all MIDIInputElementParameter elements.
+    static void updateAll();
+    /// Reset all MIDIInputElementParameter elements to their initial state.
+    static void resetAll();
+
+    /**
+     * @brief   Feed a Control Change message to the parameter state machine of
+     *          its channel, and update the parameter elements.
+     * 
+     * @retval  true
+     *          The message is part of an NRPN or RPN update, and it should not
+     *          be passed on to the MIDIInputElementCC elements.
+     * @retval  false
+     *          The CC elements should handle this message as usual.
+     */
+    static bool updateAllWith(const ChannelMessageMatcher &midimsg);
+
+    /**
+     * @brief   Deselect the parameter on the given channel and cable, so the
+     *          following Data Entry messages are ignored. Used for Reset All
+     *          Controllers messages. A parameter selected on another cable is
+     *          left alone.
+     */
+    static void resetSelection(Channel channel, uint8_t cable);
+
+    /// Don't pass the CC messages that make up parameter updates to the 
+    /// normal MIDIInputElementCC elements.
+    static void setSuppressCCs(bool suppress) { suppressCCs = suppress; }
+    /// Check whether parameter CC messages are hidden from the CC elements.
+    static bool getSuppressCCs() { return suppressCCs; }
+
+  private:
+    /// Called when a new value was received.
+    virtual void onValueChange() = 0;
+
+    /// Parameters are not updated by single messages, see @ref updateAllWith.
+    bool updateImpl(const ChannelMessageMatcher &,
+                    const MIDIAddress &) override {
+        return false;
+    }
+
+    void receiveMSB(uint8_t msb);
+    void receiveLSB(uint8_t lsb);
+    void receiveIncrement(bool increment);
+    void deliver();
+    void flush() override;
+
+    /// The state of the parameter selection of one MIDI channel, shared by
+    /// all cables.
+    struct ChannelState {
+        /// ParameterType, or 0 if nothing is selected.
+        uint8_t type = 0;
+        uint8_t cable = 0;
+        uint8_t numberMSB = 0x7F;
+        uint8_t numberLSB = 0x7F;
+        uint16_t getNumber() const { return (numberMSB << 7) | numberLSB; }
+    };
+
+    /// Select the MSB or LSB of a parameter number.
+    static void select(ChannelState &state, ParameterType type, bool msb,
+                       uint8_t value, uint8_t cable);
+
+    const ParameterType type;
+    const uint16_t number;
+    uint16_t value = 0;
+    bool pendingCallback = false;
+
+    static DoublyLinkedList<MIDIInputElementParameter> elements;
+    static ChannelState states[16];
+    static bool suppressCCs;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -2,6 +2,7 @@
 
 BEGIN_CS_NAMESPACE
 DoublyLinkedList<MIDIInputElementSysEx> MIDIInputElementSysEx::elements;
+SysExTrie MIDIInputElementSysEx::trie;
 #ifdef ESP32
 std::mutex MIDIInputElementSysEx::mutex;
 #endif
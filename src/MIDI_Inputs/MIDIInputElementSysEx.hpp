@@ -1,7 +1,9 @@
 #pragma once
 
 #include "MIDIInputElement.hpp"
+#include "SysExTrie.hpp"
 #include <AH/Containers/LinkedList.hpp>
+#include <string.h> // memcmp
 
 #if defined(ESP32)
 #include <mutex>
@@ -27,6 +29,29 @@ class MIDIInputElementSysEx : public DoublyLinkable<MIDIInputElementSysEx> {
         : CN{CN} {
         GUARD_LIST_LOCK;
         elements.append(this);
+        trie.invalidate();
+    }
+
+    /**
+     * @brief   Only receive SysEx messages that start with the given header.
+     * 
+     * Messages are dispatched using a prefix trie of the headers of all 
+     * elements, so elements don't receive messages for other devices, and
+     * adding more elements with different headers doesn't slow down the
+     * other elements.
+     * 
+     * @param   header
+     *          The first bytes of the message, including the SysEx start byte
+     *          `0xF0`. The array is not copied, so it must outlive this
+     *          element.
+     * @param   length
+     *          The length of the header.
+     */
+    void setHeader(const uint8_t *header, uint8_t length) {
+        GUARD_LIST_LOCK;
+        this->header = header;
+        this->headerLength = length;
+        trie.invalidate();
     }
 
   public:
@@ -37,6 +62,7 @@ class MIDIInputElementSysEx : public DoublyLinkable<MIDIInputElementSysEx> {
     virtual ~MIDIInputElementSysEx() {
         GUARD_LIST_LOCK;
         elements.remove(this);
+        trie.invalidate();
     }
 
     /// Initialize the input element.
@@ -82,45 +108,43 @@ class MIDIInputElementSysEx : public DoublyLinkable<MIDIInputElementSysEx> {
     }
 
     /**
-     * @brief   Update all MIDIInputElementSysEx elements with a new MIDI 
-     *          message.
+     * @brief   Update the MIDIInputElementSysEx elements whose header matches
+     *          with a new MIDI message, until one of them returns true.
      * 
      * @see     MIDIInputElementSysEx#updateWith
+     * @see     setHeader
      */
     static void updateAllWith(SysExMessage midimsg) {
-        for (MIDIInputElementSysEx &e : elements)
-            if (e.updateWith(midimsg)) {
-                e.moveDown();
-                return;
-            }
-        // No mutex required:
-        // e.moveDown may alter the list, but if it does, it always returns,
-        // and we stop iterating, so it doesn't matter.
+        GUARD_LIST_LOCK;
+        trie.updateAllWith(elements, midimsg);
     }
 
   private:
-    /// @todo   Documentation.
-    bool updateWith(SysExMessage midimsg) {
-        return midimsg.CN == this->CN && updateImpl(midimsg);
+    /// Check the cable number and the part of the header that was not yet
+    /// matched by the trie, and update the element.
+    bool updateWith(SysExMessage midimsg, uint8_t matched) {
+        if (midimsg.CN != this->CN)
+            return false;
+        if (matched < headerLength &&
+            (midimsg.length < headerLength ||
+             memcmp(midimsg.data + matched, header + matched,
+                    headerLength - matched) != 0))
+            return false;
+        return updateImpl(midimsg);
     }
 
     /// @todo   Documentation.
     virtual bool updateImpl(SysExMessage midimsg) = 0;
 
-    /**
-     * @brief   Move down this element in the linked list of elements.
-     * 
-     * This means that the element will be checked earlier on the next
-     * iteration.
-     */
-    void moveDown() {
-        GUARD_LIST_LOCK;
-        elements.moveDown(this);
-    }
-
     uint8_t CN;
+    const uint8_t *header = nullptr;
+    uint8_t headerLength = 0;
+    MIDIInputElementSysEx *nextInTrie = nullptr;
+
+    friend class SysExTrie;
 
     static DoublyLinkedList<MIDIInputElementSysEx> elements;
+    static SysExTrie trie;
 #ifdef ESP32
     static std::mutex mutex;
 #endif
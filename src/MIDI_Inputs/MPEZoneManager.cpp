@@ -0,0 +1,185 @@
+#include "MPEZoneManager.hpp"
+#include <MIDI_Constants/Control_Change.hpp>
+
+BEGIN_CS_NAMESPACE
+
+DoublyLinkedList<MPEZoneManager> MPEZoneManager::elements;
+
+MPEZoneManager::MPEZoneManager(uint8_t lower, uint8_t upper, uint8_t cable)
+    : MIDIInputElement{{0, CHANNEL_1, cable}},
+      lowerListener{*this, MPEZone::Lower, cable},
+      upperListener{*this, MPEZone::Upper, cable} {
+    setZone({MPEZone::Lower, lower});
+    if (upper > 0)
+        setZone({MPEZone::Upper, upper});
+    elements.append(this);
+}
+
+void MPEZoneManager::setZone(MPEZone zone) {
+    // Both zones together have at most 14 member channels, unless one zone
+    // uses all 15 member channels and the other one is disabled
+    zone.numMembers = zone.numMembers < 15 ? zone.numMembers : 15;
+    MPEZone &other = zones[zone.type == MPEZone::Lower ? MPEZone::Upper
+                                                        : MPEZone::Lower];
+    if (zone.numMembers > 0 && zone.numMembers + other.numMembers > 14)
+        other.numMembers = zone.numMembers < 14 ? 14 - zone.numMembers : 0;
+    zones[zone.type] = zone;
+    clearNotes();
+}
+
+void MPEZoneManager::reset() {
+    clearNotes();
+    for (OutputChannel &output : outputs)
+        output = {};
+}
+
+void MPEZoneManager::clearNotes() {
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+        if (activeChannels & (1 << ch))
+            changed(ch);
+        notes[ch] = {};
+    }
+    activeChannels = 0;
+}
+
+const MPEZone *MPEZoneManager::getZoneOf(Channel channel) const {
+    for (const MPEZone &zone : zones)
+        if (zone.isEnabled() && (zone.getManagerChannel() == channel ||
+                                 zone.isMember(channel)))
+            return &zone;
+    return nullptr;
+}
+
+// -------------------------------------------------------------------------- //
+
+Channel MPEZoneManager::allocate(uint8_t note, MPEZone::Type type,
+                                 uint8_t &stolen) {
+    stolen = 0xFF;
+    const MPEZone &zone = zones[type];
+    if (!zone.isEnabled())
+        return zone.getManagerChannel();
+    // Prefer free channels, and the channel that was used the longest time ago
+    uint8_t best = zone.getMemberChannel(0).getRaw();
+    bool bestFree = outputs[best].note == 0xFF;
+    uint16_t bestAge = clock - outputs[best].lastUsed;
+    for (uint8_t i = 1; i < zone.numMembers; ++i) {
+        uint8_t ch = zone.getMemberChannel(i).getRaw();
+        bool free = outputs[ch].note == 0xFF;
+        uint16_t age = clock - outputs[ch].lastUsed;
+        if ((free && !bestFree) || (free == bestFree && age > bestAge)) {
+            best = ch;
+            bestFree = free;
+            bestAge = age;
+        }
+    }
+    stolen = outputs[best].note;
+    outputs[best].note = note;
+    outputs[best].lastUsed = clock++;
+    return Channel(best);
+}
+
+bool MPEZoneManager::find(uint8_t note, MPEZone::Type type,
+                          Channel &channel) const {
+    // Notes keep their channel when the zones are reconfigured, so also look
+    // outside of the zone, but not in the member channels of the other zone
+    const MPEZone &other = zones[type == MPEZone::Lower ? MPEZone::Upper
+                                                         : MPEZone::Lower];
+    for (uint8_t ch = 0; ch < 16; ++ch) {
+        if (outputs[ch].note == note && !other.isMember(Channel(ch))) {
+            channel = Channel(ch);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MPEZoneManager::release(uint8_t note, MPEZone::Type type,
+                             Channel &channel) {
+    if (!find(note, type, channel))
+        return false;
+    outputs[channel.getRaw()].note = 0xFF;
+    outputs[channel.getRaw()].lastUsed = clock++;
+    return true;
+}
+
+// -------------------------------------------------------------------------- //
+
+void MPEZoneManager::beginAll() {
+    for (MPEZoneManager &e : elements)
+        e.begin();
+}
+
+void MPEZoneManager::updateAllWith(const ChannelMessageMatcher &midimsg) {
+    for (MPEZoneManager &e : elements)
+        e.updateWith(midimsg);
+}
+
+void MPEZoneManager::updateWith(const ChannelMessageMatcher &midimsg) {
+    if (midimsg.CN != address.getCableNumber())
+        return;
+    Channel channel = Channel(midimsg.channel);
+    const MPEZone *zone = getZoneOf(channel);
+    if (zone == nullptr)
+        return;
+
+    // All Notes Off on the manager channel applies to the entire zone
+    if (channel == zone->getManagerChannel()) {
+        if (midimsg.type == CC && (midimsg.data1 == MIDI_CC::All_Notes_Off ||
+                                   midimsg.data1 == MIDI_CC::All_Sound_Off)) {
+            for (uint8_t i = 0; i < zone->numMembers; ++i) {
+                uint8_t ch = zone->getMemberChannel(i).getRaw();
+                if (notes[ch].active) {
+                    notes[ch].active = false;
+                    activeChannels &= ~(1 << ch);
+                    changed(ch);
+                }
+            }
+        }
+        return;
+    }
+
+    uint8_t ch = channel.getRaw();
+    MPENote &n = notes[ch];
+    if (midimsg.type == NOTE_ON && midimsg.data2 != 0) {
+        n.note = midimsg.data1;
+        n.velocity = midimsg.data2;
+        n.active = true;
+        activeChannels |= 1 << ch;
+    } else if (midimsg.type == NOTE_OFF || midimsg.type == NOTE_ON) {
+        if (!n.active || n.note != midimsg.data1)
+            return;
+        n.velocity = midimsg.data2;
+        n.active = false;
+        activeChannels &= ~(1 << ch);
+    } else if (midimsg.type == PITCH_BEND) {
+        n.pitchBend = midimsg.data1 | (uint16_t(midimsg.data2) << 7);
+    } else if (midimsg.type == CHANNEL_PRESSURE) {
+        n.pressure = midimsg.data1;
+    } else if (midimsg.type == CC &&
+               midimsg.data1 == MIDI_CC::Sound_Controller_5) {
+        // Timbre (CC 74)
+        n.timbre = midimsg.data2;
+    } else {
+        return;
+    }
+    changed(ch);
+}
+
+void MPEZoneManager::changed(uint8_t channel) {
+    changedChannels |= 1 << channel;
+    markDirty();
+}
+
+void MPEZoneManager::flush() {
+    uint16_t changed = changedChannels;
+    changedChannels = 0;
+    for (uint8_t ch = 0; changed; ++ch, changed >>= 1)
+        if (changed & 1)
+            onNoteChange(Channel(ch));
+}
+
+void MPEZoneManager::ConfigurationListener::onValueChange() {
+    manager.setZone({type, uint8_t(getValue() >> 7)});
+}
+
+END_CS_NAMESPACE
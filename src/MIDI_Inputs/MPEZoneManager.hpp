@@ -0,0 +1,282 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <AH/Containers/LinkedList.hpp>
+#include <MIDI_Inputs/MIDIInputElement.hpp>
+#include <MIDI_Inputs/MIDIInputElementParameter.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A MIDI Polyphonic Expression zone: a manager channel and a number
+ *          of member channels.
+ *
+ * The Lower Zone uses channel 1 as its manager channel, and channels 2, 3, ...
+ * as its member channels. The Upper Zone uses channel 16 as its manager
+ * channel, and channels 15, 14, ... as its member channels.
+ */
+struct MPEZone {
+    enum Type : uint8_t {
+        Lower = 0, ///< Manager channel 1, member channels counting upwards.
+        Upper = 1, ///< Manager channel 16, member channels counting downwards.
+    };
+
+    constexpr MPEZone(Type type = Lower, uint8_t numMembers = 0)
+        : type(type), numMembers(numMembers) {}
+
+    /// Get the manager channel of the zone.
+    constexpr Channel getManagerChannel() const {
+        return type == Lower ? CHANNEL_1 : CHANNEL_16;
+    }
+    /// Get the member channel with the given index [0, numMembers - 1].
+    constexpr Channel getMemberChannel(uint8_t index) const {
+        return Channel(type == Lower ? 1 + index : 14 - index);
+    }
+    /// Get the index of the given member channel, or a number greater than or
+    /// equal to `numMembers` if it's not a member channel of this zone.
+    constexpr uint8_t getMemberIndex(Channel channel) const {
+        return type == Lower ? uint8_t(channel.getRaw() - 1)
+                             : uint8_t(14 - channel.getRaw());
+    }
+    /// Check if the given channel is a member channel of this zone.
+    constexpr bool isMember(Channel channel) const {
+        return getMemberIndex(channel) < numMembers;
+    }
+    /// Check whether the zone is enabled, i.e. if it has member channels.
+    constexpr bool isEnabled() const { return numMembers > 0; }
+
+    Type type;
+    /// The number of member channels [0, 15].
+    uint8_t numMembers;
+};
+
+/// The expression of a note on an MPE member channel.
+struct MPENote {
+    /// The note number.
+    uint8_t note = 0;
+    /// The note on velocity, or the note off velocity if the note is released.
+    uint8_t velocity = 0;
+    /// Whether the note is currently sounding.
+    bool active = false;
+    /// The per-note Channel Pressure value.
+    uint8_t pressure = 0;
+    /// The per-note timbre (CC 74) value.
+    uint8_t timbre = 0x40;
+    /// The per-note 14-bit Pitch Bend value.
+    uint16_t pitchBend = 0x2000;
+};
+
+/**
+ * @brief   Keeps track of the MPE zones on one MIDI cable: it receives the
+ *          zone configuration from MPE Configuration Messages, tracks the
+ *          notes and expression of all incoming member channels, and allocates
+ *          member channels for outgoing notes.
+ *
+ * ### Input
+ *
+ * The state of every member channel is stored in a table indexed by channel,
+ * so looking up the note of an incoming Pitch Bend, Channel Pressure or CC 74
+ * message doesn't require a search. The expression is saved even if no note is
+ * active on the channel, because MPE senders set the initial expression of a
+ * note before sending the Note On message.
+ * Changes are collected, and @ref onNoteChange is called once per changed
+ * member channel at the end of the loop, see @ref MIDIInputElement::flushAll.
+ *
+ * ### Output
+ *
+ * @ref allocate assigns each new note its own member channel, using the
+ * channel that has been unused for the longest time, so the release of the
+ * previous note on that channel isn't affected by the expression of the new
+ * note. When all member channels are in use, the least recently used one is
+ * stolen.
+ *
+ * Call @ref setZone to configure the zones yourself, incoming MPE
+ * Configuration Messages (RPN 6 on the manager channel) do the same.
+ *
+ * @ingroup MIDIInputElements
+ */
+class MPEZoneManager : public MIDIInputElement,
+                       public DoublyLinkable<MPEZoneManager> {
+  public:
+    /**
+     * @brief   Create a new MPE zone manager.
+     *
+     * @param   lower
+     *          The number of member channels of the Lower Zone [0, 15].
+     * @param   upper
+     *          The number of member channels of the Upper Zone [0, 15].
+     * @param   cable
+     *          The MIDI USB cable number [0, 15].
+     */
+    MPEZoneManager(uint8_t lower = 15, uint8_t upper = 0, uint8_t cable = 0);
+
+    /// Destructor: delete from the linked list.
+    virtual ~MPEZoneManager() { elements.remove(this); }
+
+    /// Configure a zone. If the new zone overlaps with the other zone, the
+    /// other zone is shrunk, as described by the MPE specification. All 
+    /// incoming notes are forgotten. Outgoing notes keep their channel until
+    /// they are released, so their Note Off messages are still sent.
+    void setZone(MPEZone zone);
+    /// Get the configuration of the Lower or the Upper Zone.
+    MPEZone getZone(MPEZone::Type type) const { return zones[type]; }
+    /// Get the MIDI USB cable number of the zones.
+    uint8_t getCableNumber() const { return address.getCableNumber(); }
+
+    /// Forget all notes and expression, for both input and output.
+    void reset() override;
+
+    /// @name   Input
+    /// @{
+
+    /// Get the note and expression of the given member channel.
+    const MPENote &getNote(Channel channel) const {
+        return notes[channel.getRaw()];
+    }
+    /// Get the zone that the given channel belongs to (as manager or member
+    /// channel), or nullptr if it isn't part of an enabled zone.
+    const MPEZone *getZoneOf(Channel channel) const;
+    /// Get the bit mask of member channels with active notes: bit `i` is set
+    /// if a note is sounding on channel `i + 1`.
+    uint16_t getActiveChannels() const { return activeChannels; }
+
+    /// @}
+
+    /// @name   Output
+    /// @{
+
+    /**
+     * @brief   Allocate a member channel for a new outgoing note.
+     *
+     * @param   note
+     *          The note number.
+     * @param   zone
+     *          The zone to allocate a channel in.
+     * @param[out] stolen
+     *          If all member channels were in use, the note that was playing on
+     *          the returned channel, and that should be turned off first.
+     *          Set to 0xFF otherwise.
+     * @return  The member channel to send the note and its expression on, or
+     *          the manager channel if the zone is disabled.
+     */
+    Channel allocate(uint8_t note, MPEZone::Type zone, uint8_t &stolen);
+
+    /**
+     * @brief   Find the member channel of an outgoing note.
+     *
+     * @param   note
+     *          The note number.
+     * @param   zone
+     *          The zone the note was allocated in.
+     * @param[out] channel
+     *          The member channel of the note.
+     * @retval  true
+     *          The note was found.
+     * @retval  false
+     *          The note is not active.
+     */
+    bool find(uint8_t note, MPEZone::Type zone, Channel &channel) const;
+
+    /// Release the member channel of an outgoing note, so it can be reused.
+    /// The arguments and the return value are the same as for @ref find.
+    bool release(uint8_t note, MPEZone::Type zone, Channel &channel);
+
+    /// @}
+
+    /// Initialize all MPE zone managers.
+    static void beginAll();
+
+    /// Update the MPE zone managers with an incoming MIDI message. Doesn't
+    /// consume the message, the normal input elements receive it as well.
+    static void updateAllWith(const ChannelMessageMatcher &midimsg);
+
+  private:
+    /// Called at the end of the loop for every member channel whose note or
+    /// expression changed.
+    virtual void onNoteChange(Channel channel) { (void)channel; }
+
+    /// Messages are handled in @ref updateAllWith.
+    bool updateImpl(const ChannelMessageMatcher &,
+                    const MIDIAddress &) override {
+        return false;
+    }
+
+    void flush() override;
+
+    void updateWith(const ChannelMessageMatcher &midimsg);
+    void changed(uint8_t channel);
+    /// Forget all incoming notes, and notify the callback of all active notes.
+    void clearNotes();
+
+    /// Receives the MPE Configuration Message (RPN 6) of a zone.
+    class ConfigurationListener : public MIDIInputElementParameter {
+      public:
+        ConfigurationListener(MPEZoneManager &manager, MPEZone::Type type,
+                              uint8_t cable)
+            : MIDIInputElementParameter{ParameterType::RPN, 0x0006,
+                                        {MPEZone(type).getManagerChannel(),
+                                         cable}},
+              manager(manager), type(type) {}
+
+        /// The zone configuration is not affected by a reset.
+        void reset() override {}
+
+      private:
+        void onValueChange() override;
+        MPEZoneManager &manager;
+        MPEZone::Type type;
+    };
+
+    /// An outgoing note, see @ref allocate.
+    struct OutputChannel {
+        /// The note number, or 0xFF if the channel is free.
+        uint8_t note = 0xFF;
+        /// The value of @ref clock when the channel was last allocated or
+        /// released.
+        uint16_t lastUsed = 0;
+    };
+
+    MPEZone zones[2] = {{MPEZone::Lower}, {MPEZone::Upper}};
+    MPENote notes[16];
+    uint16_t activeChannels = 0;
+    uint16_t changedChannels = 0;
+
+    /// The outgoing notes, indexed by channel.
+    OutputChannel outputs[16];
+    uint16_t clock = 0;
+
+    ConfigurationListener lowerListener;
+    ConfigurationListener upperListener;
+
+    static DoublyLinkedList<MPEZoneManager> elements;
+};
+
+/**
+ * @brief   MPE zone manager with a callback that is called for every member
+ *          channel whose note or expression changed.
+ *
+ * The callback should have an `update(const MPEZoneManager &, Channel)`
+ * method.
+ */
+template <class Callback>
+class GenericMPEZoneManager : public MPEZoneManager {
+  public:
+    /// @copydoc MPEZoneManager::MPEZoneManager
+    GenericMPEZoneManager(uint8_t lower, uint8_t upper, uint8_t cable,
+                          const Callback &callback)
+        : MPEZoneManager{lower, upper, cable}, callback(callback) {}
+
+  private:
+    void onNoteChange(Channel channel) override {
+        callback.update(*this, channel);
+    }
+
+  public:
+    Callback callback;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,257 @@
+#include "MTCDecoder.hpp"
+#include <AH/Arduino-Wrapper.h> // micros
+#include <MIDI_Parsers/MIDI_Parser.hpp>
+
+BEGIN_CS_NAMESPACE
+
+// -------------------------------------------------------------------------- //
+
+namespace {
+
+/// The number of frames in ten minutes of drop-frame timecode: frames 0 and 1
+/// are skipped at the start of every minute, except for every tenth minute.
+constexpr uint32_t DropFramesPer10Min = 10 * 60 * 30 - 9 * 2;
+/// The number of frames in a minute of drop-frame timecode that doesn't start
+/// at a multiple of ten minutes.
+constexpr uint32_t DropFramesPerMin = 60 * 30 - 2;
+
+} // namespace
+
+uint32_t MTCTimecode::toFrameNumber() const {
+    uint32_t totalMinutes = 60ul * hours + minutes;
+    uint32_t frameNumber =
+        (totalMinutes * 60 + seconds) * getNominalFrameRate(rate) + frames;
+    if (rate == MTCFrameRate::FPS_29_97_DF)
+        frameNumber -= 2 * (totalMinutes - totalMinutes / 10);
+    return frameNumber;
+}
+
+void MTCTimecode::setFrameNumber(uint32_t frameNumber) {
+    frameNumber %= getFramesPerDay(rate);
+    if (rate == MTCFrameRate::FPS_29_97_DF) {
+        // Add the frame numbers that were dropped before this frame
+        uint32_t tens = frameNumber / DropFramesPer10Min;
+        uint32_t rem = frameNumber % DropFramesPer10Min;
+        frameNumber += 18 * tens;
+        if (rem >= 2)
+            frameNumber += 2 * ((rem - 2) / DropFramesPerMin);
+    }
+    uint8_t fps = getNominalFrameRate(rate);
+    frames = frameNumber % fps;
+    frameNumber /= fps;
+    seconds = frameNumber % 60;
+    frameNumber /= 60;
+    minutes = frameNumber % 60;
+    hours = frameNumber / 60;
+}
+
+uint32_t MTCTimecode::getFramesPerDay(MTCFrameRate rate) {
+    return rate == MTCFrameRate::FPS_29_97_DF
+               ? 24ul * 6 * DropFramesPer10Min
+               : 24ul * 60 * 60 * getNominalFrameRate(rate);
+}
+
+// -------------------------------------------------------------------------- //
+
+DoublyLinkedList<MTCDecoder> MTCDecoder::elements;
+
+MTCDecoder::MTCDecoder(uint8_t cable) : cable(cable) { elements.append(this); }
+
+void MTCDecoder::reset() {
+    nextPiece = 0;
+    sequence = 0;
+    locked = false;
+    running = false;
+    quarterFrames = 0;
+}
+
+uint16_t MTCDecoder::getQuarterFramePeriod(MTCFrameRate rate) {
+    // 1/(4 fps) seconds, in thirds of a microsecond (exact for all rates)
+    switch (rate) {
+        case MTCFrameRate::FPS_24: return 31250;
+        case MTCFrameRate::FPS_25: return 30000;
+        case MTCFrameRate::FPS_29_97_DF: return 25025;
+        case MTCFrameRate::FPS_30: return 25000;
+        default: return 25000;
+    }
+}
+
+MTCTimecode MTCDecoder::decodePieces() const {
+    MTCTimecode tc;
+    tc.frames = pieces[0] | (pieces[1] & 0x1) << 4;
+    tc.seconds = pieces[2] | (pieces[3] & 0x3) << 4;
+    tc.minutes = pieces[4] | (pieces[5] & 0x3) << 4;
+    tc.hours = pieces[6] | (pieces[7] & 0x1) << 4;
+    tc.rate = static_cast<MTCFrameRate>((pieces[7] >> 1) & 0x3);
+    return tc;
+}
+
+void MTCDecoder::setPosition(uint32_t quarterFrames, MTCFrameRate rate,
+                             unsigned long now) {
+    this->quarterFrames = quarterFrames;
+    this->rate = rate;
+    this->anchorTime = now;
+    this->anchorRemainder = 0;
+    this->locked = true;
+}
+
+void MTCDecoder::updateQuarterFrame(uint8_t data, unsigned long now) {
+    uint8_t piece = (data >> 4) & 0x7;
+    pieces[piece] = data & 0xF;
+
+    if (piece != nextPiece) {
+        // Pieces are missing, out of order or running in reverse: wait for
+        // the next complete group of eight
+        sequence = 1;
+        running = false;
+        nextPiece = (piece + 1) & 0x7;
+        return;
+    }
+    nextPiece = (piece + 1) & 0x7;
+    if (sequence < 8)
+        ++sequence;
+
+    if (running) {
+        // Advance by one Quarter Frame, and move the anchor towards the
+        // arrival time of this Quarter Frame, to filter out the jitter
+        uint16_t period = getQuarterFramePeriod(rate);
+        uint32_t step = anchorRemainder + period;
+        unsigned long predicted = anchorTime + step / 3;
+        anchorRemainder = step % 3;
+        long error = long(now - predicted);
+        long maxError = period / 3;
+        if (error > maxError || error < -maxError) {
+            // Lost the phase (e.g. the sender stalled), start over
+            anchorTime = now;
+            anchorRemainder = 0;
+        } else {
+            anchorTime = predicted + error / 8;
+        }
+        if (++quarterFrames >= 4 * MTCTimecode::getFramesPerDay(rate))
+            quarterFrames = 0;
+    }
+
+    if (piece == 7 && sequence == 8) {
+        // The eight pieces contain the timecode of the frame at piece 0, the
+        // current position is seven Quarter Frames later
+        MTCTimecode tc = decodePieces();
+        uint32_t position = 4 * tc.toFrameNumber() + 7;
+        if (!running || position != quarterFrames || tc.rate != rate)
+            setPosition(position, tc.rate, now);
+        running = true;
+    }
+}
+
+bool MTCDecoder::isFullFrame(SysExMessage msg) {
+    const uint8_t *data = msg.data;
+    return msg.length == 10 && data[0] == SysExStart && data[1] == 0x7F &&
+           data[3] == 0x01 && data[4] == 0x01 && data[9] == SysExEnd;
+}
+
+bool MTCDecoder::updateFullFrame(SysExMessage msg, unsigned long now) {
+    if (!isFullFrame(msg))
+        return false;
+    MTCTimecode tc;
+    tc.rate = static_cast<MTCFrameRate>((msg.data[5] >> 5) & 0x3);
+    tc.hours = msg.data[5] & 0x1F;
+    tc.minutes = msg.data[6];
+    tc.seconds = msg.data[7];
+    tc.frames = msg.data[8];
+    setPosition(4 * tc.toFrameNumber(), tc.rate, now);
+    // The sender located, wait for new Quarter Frames
+    running = false;
+    sequence = 0;
+    nextPiece = 0;
+    return true;
+}
+
+bool MTCDecoder::isRunning(unsigned long now) const {
+    // Stopped if no Quarter Frames arrived for two frames (the smoothed
+    // anchor can be slightly later than the actual arrival time)
+    return running && long(now - anchorTime) <
+                          long(8ul * getQuarterFramePeriod(rate) / 3);
+}
+
+bool MTCDecoder::isRunning() const { return isRunning(micros()); }
+
+uint32_t MTCDecoder::getSubframes(unsigned long now) const {
+    if (!locked)
+        return 0;
+    // Hundredths of a Quarter Frame since the anchor, but never further than
+    // the next Quarter Frame
+    uint8_t fraction = 0;
+    long elapsed = long(now - anchorTime);
+    if (running && elapsed > 0) {
+        uint16_t period = getQuarterFramePeriod(rate);
+        uint32_t e = uint32_t(elapsed) < period ? uint32_t(elapsed) : period;
+        uint32_t f = e * 3 * 100 / period;
+        fraction = f < 99 ? f : 99;
+    }
+    uint32_t quarters = (quarterFrames % 4) * 100 + fraction;
+    return quarterFrames / 4 * 100 + quarters / 4;
+}
+
+MTCTimecode MTCDecoder::getTimecode(unsigned long now) const {
+    uint32_t subframes = getSubframes(now);
+    MTCTimecode tc;
+    tc.rate = rate;
+    tc.setFrameNumber(subframes / 100);
+    tc.subframes = subframes % 100;
+    return tc;
+}
+
+MTCTimecode MTCDecoder::getTimecode() const { return getTimecode(micros()); }
+
+// -------------------------------------------------------------------------- //
+
+namespace {
+
+char *printTwoDigits(char *buff, uint8_t value) {
+    *buff++ = '0' + value / 10 % 10;
+    *buff++ = '0' + value % 10;
+    *buff = '\0';
+    return buff;
+}
+
+} // namespace
+
+void MTCDecoder::getBars(char *buff) const {
+    MTCTimecode tc = getTimecode();
+    buff = printTwoDigits(buff, tc.hours);
+    *buff++ = ':';
+    printTwoDigits(buff, tc.minutes);
+}
+
+void MTCDecoder::getBeats(char *buff) const {
+    printTwoDigits(buff, getTimecode().seconds);
+}
+
+void MTCDecoder::getFrames(char *buff) const {
+    printTwoDigits(buff, getTimecode().frames);
+}
+
+uint16_t MTCDecoder::getVersion() const {
+    return getSubframes(micros()) / 100;
+}
+
+// -------------------------------------------------------------------------- //
+
+void MTCDecoder::updateAllWith(ChannelMessage msg) {
+    if (elements.getFirst() == nullptr)
+        return;
+    unsigned long now = micros();
+    for (MTCDecoder &e : elements)
+        if (e.cable == msg.CN)
+            e.updateQuarterFrame(msg.data1, now);
+}
+
+void MTCDecoder::updateAllWith(SysExMessage msg) {
+    if (elements.getFirst() == nullptr || !isFullFrame(msg))
+        return;
+    unsigned long now = micros();
+    for (MTCDecoder &e : elements)
+        if (e.cable == msg.CN)
+            e.updateFullFrame(msg, now);
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <AH/Containers/LinkedList.hpp>
+#include <MIDI_Inputs/MCU/TimeDisplay.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/// The SMPTE frame rates of MIDI Time Code.
+enum class MTCFrameRate : uint8_t {
+    FPS_24 = 0,       ///< 24 frames per second (film).
+    FPS_25 = 1,       ///< 25 frames per second (PAL).
+    FPS_29_97_DF = 2, ///< 29.97 frames per second, drop-frame (NTSC).
+    FPS_30 = 3,       ///< 30 frames per second.
+};
+
+/// A SMPTE timecode, with the fractional part of the current frame.
+struct MTCTimecode {
+    uint8_t hours = 0;     ///< [0, 23]
+    uint8_t minutes = 0;   ///< [0, 59]
+    uint8_t seconds = 0;   ///< [0, 59]
+    uint8_t frames = 0;    ///< [0, 23], [0, 24] or [0, 29]
+    uint8_t subframes = 0; ///< Hundredths of a frame [0, 99]
+    MTCFrameRate rate = MTCFrameRate::FPS_24;
+
+    /// The number of frames per second, rounded up for drop-frame timecode.
+    static uint8_t getNominalFrameRate(MTCFrameRate rate) {
+        return rate == MTCFrameRate::FPS_24 ? 24
+               : rate == MTCFrameRate::FPS_25 ? 25 : 30;
+    }
+
+    /// Convert the hours, minutes, seconds and frames to the number of frames
+    /// since 00:00:00:00, skipping the dropped frame numbers of drop-frame
+    /// timecode.
+    uint32_t toFrameNumber() const;
+    /// Set the hours, minutes, seconds and frames to the given number of frames
+    /// since 00:00:00:00 (modulo 24 hours).
+    void setFrameNumber(uint32_t frameNumber);
+    /// The number of frames in 24 hours.
+    static uint32_t getFramesPerDay(MTCFrameRate rate);
+};
+
+/**
+ * @brief   Decodes incoming MIDI Time Code: it assembles Quarter Frame messages
+ *          and Full Frame SysEx messages into a timecode, and interpolates
+ *          between Quarter Frames using `micros()`.
+ *
+ * ### Quarter Frames
+ *
+ * A running MTC sender sends four Quarter Frame messages (`F1 0nnndddd`) per
+ * frame, every one of them carries one nibble of the timecode. Eight of them
+ * make up the full timecode, which is the time of the first one of the eight,
+ * so the decoder locks to the position of the sender when it receives the
+ * eighth piece.
+ * From then on, every Quarter Frame advances the position by a quarter of a
+ * frame, and the timecode of every following group of eight is checked against
+ * this count. If pieces are missing or out of order, the decoder stops running
+ * until it receives the next complete group.
+ *
+ * ### Interpolation
+ *
+ * Between Quarter Frames, the time since the last Quarter Frame is added to
+ * the position. The position is never extrapolated further than the next
+ * Quarter Frame, so it stops when the sender stops, and it is always anchored
+ * to the Quarter Frame count, so it doesn't drift away from the sender.
+ * The arrival times of the Quarter Frames are smoothed by a phase-locked loop
+ * that expects them at the nominal rate, so the jitter of the MIDI transport
+ * doesn't show up in the interpolated time.
+ *
+ * ### Full Frames
+ *
+ * A Full Frame message (`F0 7F <device> 01 01 hr mn sc fr F7`) sets the
+ * position when the sender locates or shuttles. The decoder stops running
+ * until Quarter Frames resume.
+ *
+ * The decoder implements MCU::TimeDisplaySource, so it can be shown on a
+ * display using MCU::TimeDisplayDisplay, as `hh:mm ss ff`.
+ *
+ * @ingroup MIDIInputElements
+ */
+class MTCDecoder : public DoublyLinkable<MTCDecoder>,
+                   public MCU::TimeDisplaySource {
+  public:
+    /**
+     * @brief   Create a new MIDI Time Code decoder.
+     *
+     * @param   cable
+     *          The MIDI USB cable number to listen to [0, 15].
+     */
+    MTCDecoder(uint8_t cable = 0);
+
+    /// Destructor: delete from the linked list.
+    virtual ~MTCDecoder() { elements.remove(this); }
+
+    /// Forget the position, and wait for the next Quarter Frames or Full Frame.
+    void reset();
+
+    /// Handle the data byte of a Quarter Frame message that arrived at the
+    /// given time.
+    void updateQuarterFrame(uint8_t data, unsigned long now);
+    /// Handle a SysEx message that arrived at the given time.
+    /// @return Whether it was a Full Frame message.
+    bool updateFullFrame(SysExMessage msg, unsigned long now);
+
+    /// Check whether a position was received.
+    bool isLocked() const { return locked; }
+    /// Check whether Quarter Frames are being received, i.e. whether the
+    /// sender is running.
+    bool isRunning(unsigned long now) const;
+    /// @copydoc isRunning
+    bool isRunning() const;
+    /// Get the frame rate of the last received timecode.
+    MTCFrameRate getFrameRate() const { return rate; }
+
+    /// Get the interpolated position at the given time, in hundredths of a
+    /// frame since 00:00:00:00.
+    uint32_t getSubframes(unsigned long now) const;
+    /// Get the interpolated timecode at the given time.
+    MTCTimecode getTimecode(unsigned long now) const;
+    /// Get the interpolated timecode at the current time.
+    MTCTimecode getTimecode() const;
+
+    /// Get the hours and minutes as `hh:mm`.
+    void getBars(char *buff) const override;
+    /// Get the seconds as `ss`.
+    void getBeats(char *buff) const override;
+    /// Get the frames as `ff`.
+    void getFrames(char *buff) const override;
+    /// Get the current frame number (truncated to 16 bits), the text only
+    /// changes when the frame changes.
+    uint16_t getVersion() const override;
+
+    /// Get the MIDI USB cable number.
+    uint8_t getCableNumber() const { return cable; }
+
+    /// Update all decoders with an incoming Quarter Frame message.
+    static void updateAllWith(ChannelMessage msg);
+    /// Update all decoders with an incoming SysEx message. Doesn't consume
+    /// the message, the SysEx input elements receive it as well.
+    static void updateAllWith(SysExMessage msg);
+
+    /// Check whether the given SysEx message is an MTC Full Frame message.
+    static bool isFullFrame(SysExMessage msg);
+
+    /// Get the duration of a Quarter Frame, in thirds of a microsecond.
+    static uint16_t getQuarterFramePeriod(MTCFrameRate rate);
+
+  private:
+    /// Decode the eight collected nibbles.
+    MTCTimecode decodePieces() const;
+    /// Set the position to the given Quarter Frame count.
+    void setPosition(uint32_t quarterFrames, MTCFrameRate rate,
+                     unsigned long now);
+
+    /// The nibbles of the last Quarter Frames.
+    uint8_t pieces[8] = {};
+    /// The piece that is expected next.
+    uint8_t nextPiece = 0;
+    /// The number of consecutive pieces received in order (at most 8).
+    uint8_t sequence = 0;
+    uint8_t cable;
+    MTCFrameRate rate = MTCFrameRate::FPS_24;
+    bool locked = false;
+    bool running = false;
+
+    /// The position at @ref anchorTime, in Quarter Frames since 00:00:00:00.
+    uint32_t quarterFrames = 0;
+    /// The smoothed arrival time of the last Quarter Frame.
+    unsigned long anchorTime = 0;
+    /// The fractional part of @ref anchorTime, in thirds of a microsecond.
+    uint8_t anchorRemainder = 0;
+
+    static DoublyLinkedList<MTCDecoder> elements;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
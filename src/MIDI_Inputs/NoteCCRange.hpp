@@ -1,8 +1,11 @@
 #pragma once
 
+#include <AH/Containers/BitArray.hpp>
 #include <Banks/BankableMIDIInput.hpp>
 #include <MIDI_Inputs/MIDIInputElementCC.hpp>
+#include <MIDI_Inputs/MIDIInputElementKP.hpp>
 #include <MIDI_Inputs/MIDIInputElementNote.hpp>
+#include <MIDI_Inputs/NoteCCValueStorage.hpp>
 
 BEGIN_CS_NAMESPACE
 
@@ -53,8 +56,9 @@ struct SimpleNoteCCValueCallback {
     /// Update the given index: called when a new message is received for this
     /// index
     virtual void update(const INoteCCValue &noteccval, uint8_t index) = 0;
-    /// Update all values: called when a bank change causes all values to
-    /// (possibly) change, or when the entire range is reset to zero.
+    /// Update all values: called when the entire range is reset to zero.
+    /// After a bank change, only the indices whose values differ between the
+    /// old and the new bank are updated, using @ref update.
     virtual void updateAll(const INoteCCValue &noteccval) {
         for (uint8_t i = 0; i < noteccval.length(); ++i)
             update(noteccval, i);
@@ -68,8 +72,15 @@ struct SimpleNoteCCValueCallback {
  *          or Control Change messages and saves their values.
  * 
  * Can listen to a range of addresses or a single address.
+ *
+ * @tparam  ValueStorage
+ *          Determines how the values are saved in RAM: @ref ByteValueStorage
+ *          (8 bits per value, the default), @ref SevenBitValueStorage 
+ *          (7 bits per value) or @ref OneBitValueStorage (1 bit per value,
+ *          only on/off, for LEDs).
  */
-template <class MIDIInput_t, uint8_t RangeLen, uint8_t NumBanks, class Callback>
+template <class MIDIInput_t, uint8_t RangeLen, uint8_t NumBanks, class Callback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
 class NoteCCRange : public MIDIInput_t, public INoteCCValue {
   public:
     NoteCCRange(MIDIAddress address, const Callback &callback)
@@ -77,7 +88,7 @@ class NoteCCRange : public MIDIInput_t, public INoteCCValue {
 
     /// @todo   check index bounds
     uint8_t getValue(uint8_t index) const final override {
-        return values[getSelection()][index];
+        return values.get(getSelection() * RangeLen + index);
     }
     using INoteCCValue::getValue;
 
@@ -85,7 +96,7 @@ class NoteCCRange : public MIDIInput_t, public INoteCCValue {
     void begin() override { callback.begin(*this); }
     /// Reset all values to zero
     void reset() override {
-        values = {{}};
+        values.reset();
         callback.updateAll(*this);
     }
 
@@ -104,15 +115,29 @@ class NoteCCRange : public MIDIInput_t, public INoteCCValue {
         // extract the velocity or controller value from the message
         uint8_t value = getValueFromMIDIMessage(midimsg);
         // save the value
-        values[bankIndex][rangeIndex] = value;
+        values.set(bankIndex * RangeLen + rangeIndex, value);
         // if the bank that the message belongs to is the active bank,
-        // update the display
-        if (bankIndex == this->getSelection())
-            callback.update(*this, rangeIndex);
+        // update the display (now, or at the end of the loop)
+        if (bankIndex == this->getSelection()) {
+            if (!this->deferUpdate())
+                callback.update(*this, rangeIndex);
+            else
+                dirty.set(rangeIndex);
+        }
         // event was handled successfully
         return true;
     }
 
+    /// Run the deferred updates for the indices that changed.
+    void flush() override {
+        for (uint8_t i = 0; i < RangeLen; ++i) {
+            if (dirty.get(i)) {
+                dirty.clear(i);
+                callback.update(*this, i);
+            }
+        }
+    }
+
     /// Extract the "value" from a MIDI Note or Control Change message.
     /// For Note On and Control Change, this is simply the second data byte,
     /// for Note Off, it's zero.
@@ -124,6 +149,27 @@ class NoteCCRange : public MIDIInput_t, public INoteCCValue {
     /// Get the active bank selection.
     virtual uint8_t getSelection() const { return 0; }
 
+  protected:
+    /// Reset the values of the given bank to zero.
+    void resetBank(setting_t bank) {
+        for (uint8_t i = 0; i < RangeLen; ++i)
+            values.set(bank * RangeLen + i, 0);
+        if (bank == getSelection())
+            callback.updateAll(*this);
+    }
+
+    /// Update the indices of the range whose values differ between the two
+    /// given banks. Called after a bank change, so the callback doesn't have
+    /// to redraw values that didn't change.
+    void updateChanged(setting_t oldBank, setting_t newBank) {
+        for (uint8_t i = 0; i < RangeLen; ++i)
+            if (values.get(oldBank * RangeLen + i) !=
+                values.get(newBank * RangeLen + i))
+                callback.update(*this, i);
+    }
+
+  private:
+
     /// Get the bank index from a MIDI address.
     virtual setting_t getBankIndex(MIDIAddress target) const {
         // Default implementation for non-bankable version (bank is always 0)
@@ -138,8 +184,11 @@ class NoteCCRange : public MIDIInput_t, public INoteCCValue {
         return target.getAddress() - this->address.getAddress();
     }
 
-    /// A 2D array for saving all values of the range, for all banks.
-    Array<Array<uint8_t, RangeLen>, NumBanks> values = {{}};
+    /// The values of the range, for all banks: the value of index `i` in bank
+    /// `b` is saved at `b * RangeLen + i`.
+    ValueStorage<RangeLen * NumBanks> values;
+    /// The indices with deferred updates.
+    AH::BitArray<RangeLen> dirty;
 
   public:
     /// Callback that is called when a value in the active bank changes.
@@ -151,12 +200,14 @@ class NoteCCRange : public MIDIInput_t, public INoteCCValue {
 // -------------------------------------------------------------------------- //
 
 template <class MIDIInput_t, uint8_t RangeLen,
-          class Callback = NoteCCRangeEmptyCallback>
+          class Callback = NoteCCRangeEmptyCallback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
 class GenericNoteCCRange
-    : public NoteCCRange<MIDIInput_t, RangeLen, 1, Callback> {
+    : public NoteCCRange<MIDIInput_t, RangeLen, 1, Callback, ValueStorage> {
   public:
     GenericNoteCCRange(MIDIAddress address, const Callback &callback)
-        : NoteCCRange<MIDIInput_t, RangeLen, 1, Callback>{address, callback} {}
+        : NoteCCRange<MIDIInput_t, RangeLen, 1, Callback, ValueStorage>{
+              address, callback} {}
 
   private:
     /// Check if the address of the incoming MIDI message is within the range
@@ -167,13 +218,15 @@ class GenericNoteCCRange
     }
 };
 
-template <uint8_t RangeLen, class Callback = NoteCCRangeEmptyCallback>
+template <uint8_t RangeLen, class Callback = NoteCCRangeEmptyCallback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
 using GenericNoteRange =
-    GenericNoteCCRange<MIDIInputElementNote, RangeLen, Callback>;
+    GenericNoteCCRange<MIDIInputElementNote, RangeLen, Callback, ValueStorage>;
 
-template <uint8_t RangeLen, class Callback = NoteCCRangeEmptyCallback>
+template <uint8_t RangeLen, class Callback = NoteCCRangeEmptyCallback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
 using GenericCCRange =
-    GenericNoteCCRange<MIDIInputElementCC, RangeLen, Callback>;
+    GenericNoteCCRange<MIDIInputElementCC, RangeLen, Callback, ValueStorage>;
 
 template <class Callback = NoteCCRangeEmptyCallback>
 using GenericNoteValue = GenericNoteCCRange<MIDIInputElementNote, 1, Callback>;
@@ -181,6 +234,14 @@ using GenericNoteValue = GenericNoteCCRange<MIDIInputElementNote, 1, Callback>;
 template <class Callback = NoteCCRangeEmptyCallback>
 using GenericCCValue = GenericNoteCCRange<MIDIInputElementCC, 1, Callback>;
 
+template <uint8_t RangeLen, class Callback = NoteCCRangeEmptyCallback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
+using GenericKPRange =
+    GenericNoteCCRange<MIDIInputElementKP, RangeLen, Callback, ValueStorage>;
+
+template <class Callback = NoteCCRangeEmptyCallback>
+using GenericKPValue = GenericNoteCCRange<MIDIInputElementKP, 1, Callback>;
+
 /**
  * @brief   MIDI Input Element that listens to a range of notes and saves their
  *          velocity values.
@@ -234,6 +295,31 @@ class CCValue : public GenericCCValue<> {
     CCValue(MIDIAddress address) : GenericCCValue<>{address, {}} {}
 };
 
+/**
+ * @brief   MIDI Input Element that listens to a range of notes and saves their
+ *          Polyphonic Key Pressure (aftertouch) values.
+ * 
+ * @ingroup MIDIInputElements
+ * @tparam  RangeLen 
+ *          The length of the range of notes to listen to.
+ */
+template <uint8_t RangeLen>
+class KPRange : public GenericKPRange<RangeLen> {
+  public:
+    KPRange(MIDIAddress address) : GenericKPRange<RangeLen>{address, {}} {}
+};
+
+/**
+ * @brief   MIDI Input Element that listens to a single note and saves its
+ *          Polyphonic Key Pressure (aftertouch) value.
+ * 
+ * @ingroup MIDIInputElements
+ */
+class KPValue : public GenericKPValue<> {
+  public:
+    KPValue(MIDIAddress address) : GenericKPValue<>{address, {}} {}
+};
+
 // -------------------------------------------------------------------------- //
 
 namespace Bankable {
@@ -242,19 +328,40 @@ namespace Bankable {
 ///         The length of the range.
 /// @tparam NumBanks
 ///         The size of the bank.
+/// @tparam ValueStorage
+///         How the values of all banks are saved, see @ref NoteCCRange.
 template <class MIDIInput_t, uint8_t RangeLen, uint8_t NumBanks,
-          class Callback = NoteCCRangeEmptyCallback>
+          class Callback = NoteCCRangeEmptyCallback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
 class GenericNoteCCRange
-    : public NoteCCRange<MIDIInput_t, RangeLen, NumBanks, Callback>,
+    : public NoteCCRange<MIDIInput_t, RangeLen, NumBanks, Callback,
+                         ValueStorage>,
       public BankableMIDIInput<NumBanks> {
   public:
     GenericNoteCCRange(BankConfig<NumBanks> config,
                        MIDIAddress address,
                        const Callback &callback)
-        : NoteCCRange<MIDIInput_t, RangeLen, NumBanks, Callback>{
+        : NoteCCRange<MIDIInput_t, RangeLen, NumBanks, Callback, ValueStorage>{
             address,
             callback,
-        }, BankableMIDIInput<NumBanks>{config} {}
+        }, BankableMIDIInput<NumBanks>{config},
+          displayedBank(BankableMIDIInput<NumBanks>::getSelection()) {}
+
+    uint16_t getChannelMask() const override {
+        return BankableMIDIInput<NumBanks>::getChannelMask(this->address);
+    }
+
+    uint16_t getCableMask() const override {
+        return BankableMIDIInput<NumBanks>::getCableMask(this->address);
+    }
+
+    /// Reset the values of the banks that listen to the given channel and
+    /// cable, the other banks keep their values.
+    void resetChannel(Channel channel, uint8_t cable) override {
+        for (setting_t b = 0; b < NumBanks; ++b)
+            if (this->bankUsesChannel(b, channel, cable, this->address))
+                this->resetBank(b);
+    }
 
   private:
     /// Check if the address of the incoming MIDI message is within the range
@@ -277,18 +384,27 @@ class GenericNoteCCRange
                                                           this->address);
     }
 
-    void onBankSettingChange() override { this->callback.updateAll(*this); }
+    void onBankSettingChange() override {
+        setting_t newBank = getSelection();
+        this->updateChanged(displayedBank, newBank);
+        displayedBank = newBank;
+    }
+
+    /// The bank whose values are currently shown by the callback.
+    setting_t displayedBank;
 };
 
 template <uint8_t RangeLen, uint8_t NumBanks,
-          class Callback = NoteCCRangeEmptyCallback>
-using GenericNoteRange =
-    GenericNoteCCRange<MIDIInputElementNote, RangeLen, NumBanks, Callback>;
+          class Callback = NoteCCRangeEmptyCallback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
+using GenericNoteRange = GenericNoteCCRange<MIDIInputElementNote, RangeLen,
+                                            NumBanks, Callback, ValueStorage>;
 
 template <uint8_t RangeLen, uint8_t NumBanks,
-          class Callback = NoteCCRangeEmptyCallback>
-using GenericCCRange =
-    GenericNoteCCRange<MIDIInputElementCC, RangeLen, NumBanks, Callback>;
+          class Callback = NoteCCRangeEmptyCallback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
+using GenericCCRange = GenericNoteCCRange<MIDIInputElementCC, RangeLen,
+                                          NumBanks, Callback, ValueStorage>;
 
 template <uint8_t NumBanks, class Callback = NoteCCRangeEmptyCallback>
 using GenericNoteValue =
@@ -298,6 +414,16 @@ template <uint8_t NumBanks, class Callback = NoteCCRangeEmptyCallback>
 using GenericCCValue =
     GenericNoteCCRange<MIDIInputElementCC, 1, NumBanks, Callback>;
 
+template <uint8_t RangeLen, uint8_t NumBanks,
+          class Callback = NoteCCRangeEmptyCallback,
+          template <uint16_t> class ValueStorage = ByteValueStorage>
+using GenericKPRange = GenericNoteCCRange<MIDIInputElementKP, RangeLen,
+                                          NumBanks, Callback, ValueStorage>;
+
+template <uint8_t NumBanks, class Callback = NoteCCRangeEmptyCallback>
+using GenericKPValue =
+    GenericNoteCCRange<MIDIInputElementKP, 1, NumBanks, Callback>;
+
 /**
  * @brief   MIDI Input Element that listens to a range of notes and saves their
  *          velocity values.
@@ -367,6 +493,38 @@ class CCValue : public GenericCCValue<NumBanks> {
         : GenericCCValue<NumBanks>{config, address, {}} {}
 };
 
+/**
+ * @brief   MIDI Input Element that listens to a range of notes and saves their
+ *          Polyphonic Key Pressure (aftertouch) values.
+ * 
+ * @ingroup BankableMIDIInputElements
+ * @tparam  RangeLen 
+ *          The length of the range of notes to listen to.
+ * @tparam  NumBanks 
+ *          The size of the bank.
+ */
+template <uint8_t RangeLen, uint8_t NumBanks>
+class KPRange : public GenericKPRange<RangeLen, NumBanks> {
+  public:
+    KPRange(BankConfig<NumBanks> config, MIDIAddress address)
+        : GenericKPRange<RangeLen, NumBanks>{config, address, {}} {}
+};
+
+/**
+ * @brief   MIDI Input Element that listens to a single note and saves its
+ *          Polyphonic Key Pressure (aftertouch) value.
+ * 
+ * @ingroup BankableMIDIInputElements
+ * @tparam  NumBanks 
+ *          The size of the bank.
+ */
+template <uint8_t NumBanks>
+class KPValue : public GenericKPValue<NumBanks> {
+  public:
+    KPValue(BankConfig<NumBanks> config, MIDIAddress address)
+        : GenericKPValue<NumBanks>{config, address, {}} {}
+};
+
 } // namespace Bankable
 
 END_CS_NAMESPACE
\ No newline at end of file
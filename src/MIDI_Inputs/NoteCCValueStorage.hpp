@@ -0,0 +1,109 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <Settings/NamespaceSettings.hpp>
+#include <stdint.h>
+
+BEGIN_CS_NAMESPACE
+
+// Storage policies for the values of NoteCCRange: they determine how many bits
+// are used to save each velocity or controller value.
+// All policies provide `get(index)`, `set(index, value)` and `reset()`, without
+// any branches or bounds checking.
+
+/**
+ * @brief   Saves each value in a separate byte. This is the default, and the
+ *          fastest option.
+ *
+ * @tparam  N
+ *          The number of values to store.
+ */
+template <uint16_t N>
+class ByteValueStorage {
+  public:
+    uint8_t get(uint16_t index) const { return buffer[index]; }
+    void set(uint16_t index, uint8_t value) { buffer[index] = value; }
+    void reset() {
+        for (uint8_t &b : buffer)
+            b = 0;
+    }
+
+  private:
+    uint8_t buffer[N] = {};
+};
+
+/**
+ * @brief   Packs the 7-bit MIDI values, saving one byte for every eight values.
+ *
+ * The most significant bit of the values is discarded.
+ *
+ * @tparam  N
+ *          The number of values to store.
+ */
+template <uint16_t N>
+class SevenBitValueStorage {
+  public:
+    uint8_t get(uint16_t index) const {
+        uint32_t bit = uint32_t(index) * 7;
+        return (read16(bit / 8) >> (bit % 8)) & 0x7F;
+    }
+    void set(uint16_t index, uint8_t value) {
+        uint32_t bit = uint32_t(index) * 7;
+        uint8_t shift = bit % 8;
+        uint16_t word = read16(bit / 8);
+        word &= ~uint16_t(0x7F << shift);
+        word |= uint16_t((value & 0x7F) << shift);
+        buffer[bit / 8 + 0] = uint8_t(word);
+        buffer[bit / 8 + 1] = uint8_t(word >> 8);
+    }
+    void reset() {
+        for (uint8_t &b : buffer)
+            b = 0;
+    }
+
+  private:
+    uint16_t read16(uint16_t byteIndex) const {
+        return buffer[byteIndex] | (uint16_t(buffer[byteIndex + 1]) << 8);
+    }
+
+    /// A value can span two bytes. The last value always reads the byte after
+    /// it, even if it doesn't use any of its bits, so there's one byte of
+    /// padding.
+    uint8_t buffer[(uint32_t(N) * 7 + 7) / 8 + 1] = {};
+};
+
+/**
+ * @brief   Saves a single bit for each value, only whether it is zero or not.
+ *          For on/off LEDs, for example.
+ *
+ * Nonzero values are saved as 1, and read back as 127.
+ *
+ * @tparam  N
+ *          The number of values to store.
+ */
+template <uint16_t N>
+class OneBitValueStorage {
+  public:
+    uint8_t get(uint16_t index) const {
+        uint8_t bit = (buffer[index / 8] >> (index % 8)) & 1;
+        return -bit & 0x7F;
+    }
+    void set(uint16_t index, uint8_t value) {
+        uint8_t mask = 1 << (index % 8);
+        uint8_t bit = value != 0;
+        buffer[index / 8] = (buffer[index / 8] & ~mask) | (-bit & mask);
+    }
+    void reset() {
+        for (uint8_t &b : buffer)
+            b = 0;
+    }
+
+  private:
+    uint8_t buffer[(N + 7) / 8] = {};
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
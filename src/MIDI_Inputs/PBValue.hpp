@@ -0,0 +1,234 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <AH/Containers/ArrayHelpers.hpp>
+#include <Banks/BankableMIDIInput.hpp>
+#include <MIDI_Inputs/MIDIInputElementPB.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/// Empty callback for Pitch Bend values that does nothing.
+struct PBValueEmptyCallback {
+    template <class T>
+    void begin(const T &) {}
+    template <class T>
+    void update(const T &) {}
+};
+
+/**
+ * @brief   A MIDI input element that saves the 14-bit value of Pitch Bend 
+ *          messages, e.g. the fader positions of the Mackie Control Universal
+ *          protocol.
+ *          This is a base class to both the Bankable and non-Bankable version.
+ * 
+ * DAWs send Pitch Bend messages at high rates (e.g. during fader automation).
+ * If coalesced updates are enabled, the callback is not called for every 
+ * message: the value is saved, and the callback runs once at the end of the 
+ * loop, with the latest value. See 
+ * @ref MIDIInputElement::setCoalescedUpdates.
+ */
+template <uint8_t NumValues, class Callback>
+class PBValue_Base : public MIDIInputElementPB {
+  protected:
+    PBValue_Base(const MIDIChannelCN &channelCN, const Callback &callback)
+        : MIDIInputElementPB{{0, channelCN}}, callback(callback) {}
+
+  public:
+    /// Initialize
+    void begin() override { callback.begin(*this); }
+
+    /// The value of a Pitch Bend wheel at rest, used as the initial value and
+    /// after a Reset All Controllers message.
+    constexpr static uint16_t Center = 0x2000;
+
+    /// Reset all values to the center position.
+    void reset() override {
+        values = AH::fillArray<uint16_t, NumValues>(Center);
+        callback.update(*this);
+    }
+
+    /// Get the 14-bit value of the active bank [0, 16383].
+    uint16_t getValue() const { return values[getSelection()]; }
+
+  protected:
+    /// Reset the value of the given bank to the center position.
+    void resetBank(setting_t bank) {
+        values[bank] = Center;
+        if (bank == getSelection())
+            callback.update(*this);
+    }
+
+  private:
+    bool updateImpl(const ChannelMessageMatcher &midimsg,
+                    const MIDIAddress &target) override {
+        uint8_t index = getBankIndex(target);
+        values[index] = midimsg.data1 | (uint16_t(midimsg.data2) << 7);
+        if (getSelection() == index && !this->deferUpdate())
+            callback.update(*this);
+        return true;
+    }
+
+    void flush() override { callback.update(*this); }
+
+    /// Get the active bank selection
+    virtual uint8_t getSelection() const { return 0; }
+
+    /// Get the bank index from a MIDI address
+    virtual setting_t getBankIndex(const MIDIAddress &target) const {
+        (void)target;
+        return 0;
+    }
+
+    Array<uint16_t, NumValues> values =
+        AH::fillArray<uint16_t, NumValues>(Center);
+
+  public:
+    Callback callback;
+};
+
+// -------------------------------------------------------------------------- //
+
+/**
+ * @brief   A MIDI input element that saves the 14-bit value of Pitch Bend 
+ *          messages. This version is generic to allow for custom callbacks.  
+ *          This version cannot be banked.
+ */
+template <class Callback = PBValueEmptyCallback>
+class GenericPBValue : public PBValue_Base<1, Callback> {
+  public:
+    /**
+     * @brief   Construct a new GenericPBValue object.
+     * 
+     * @param   channelCN
+     *          The MIDI channel [CHANNEL_1, CHANNEL_16] and optional Cable
+     *          Number [0, 15].
+     * @param   callback
+     *          The callback object that is updated when the value changes.
+     */
+    GenericPBValue(const MIDIChannelCN &channelCN, const Callback &callback)
+        : PBValue_Base<1, Callback>{channelCN, callback} {}
+};
+
+/**
+ * @brief   A MIDI input element that saves the 14-bit value of Pitch Bend 
+ *          messages.  
+ *          This version cannot be banked.
+ * 
+ * @ingroup MIDIInputElements
+ */
+class PBValue : public GenericPBValue<> {
+  public:
+    /**
+     * @brief   Construct a new PBValue object.
+     * 
+     * @param   channelCN
+     *          The MIDI channel [CHANNEL_1, CHANNEL_16] and optional Cable
+     *          Number [0, 15].
+     */
+    PBValue(const MIDIChannelCN &channelCN = CHANNEL_1)
+        : GenericPBValue<>{channelCN, {}} {}
+};
+
+// -------------------------------------------------------------------------- //
+
+namespace Bankable {
+
+/**
+ * @brief   A MIDI input element that saves the 14-bit value of Pitch Bend 
+ *          messages. This version is generic to allow for custom callbacks.  
+ *          This version can be banked, using `CHANGE_CHANNEL` or 
+ *          `CHANGE_CABLENB`.
+ * 
+ * @tparam  NumBanks
+ *          The number of banks.
+ */
+template <uint8_t NumBanks, class Callback = PBValueEmptyCallback>
+class GenericPBValue : public PBValue_Base<NumBanks, Callback>,
+                       public BankableMIDIInput<NumBanks> {
+  public:
+    /**
+     * @brief   Construct a new Bankable GenericPBValue object.
+     * 
+     * @param   config
+     *          The bank configuration to use.
+     * @param   channelCN
+     *          The MIDI channel [CHANNEL_1, CHANNEL_16] and optional Cable
+     *          Number [0, 15].
+     * @param   callback
+     *          The callback object that is updated when the value or bank
+     *          changes.
+     */
+    GenericPBValue(BankConfig<NumBanks> config, const MIDIChannelCN &channelCN,
+                   const Callback &callback)
+        : PBValue_Base<NumBanks, Callback>{channelCN, callback},
+          BankableMIDIInput<NumBanks>{config} {}
+
+    uint16_t getChannelMask() const override {
+        return BankableMIDIInput<NumBanks>::getChannelMask(this->address);
+    }
+
+    uint16_t getCableMask() const override {
+        return BankableMIDIInput<NumBanks>::getCableMask(this->address);
+    }
+
+    /// Reset the values of the banks that listen to the given channel and
+    /// cable, the other banks keep their values.
+    void resetChannel(Channel channel, uint8_t cable) override {
+        for (setting_t b = 0; b < NumBanks; ++b)
+            if (this->bankUsesChannel(b, channel, cable, this->address))
+                this->resetBank(b);
+    }
+
+  private:
+    setting_t getSelection() const override {
+        return BankableMIDIInput<NumBanks>::getSelection();
+    };
+
+    uint8_t getBankIndex(const MIDIAddress &target) const override {
+        return BankableMIDIInput<NumBanks>::getBankIndex(target, this->address);
+    }
+
+    /// Check if the address of the incoming MIDI message is in one of the banks
+    /// of this element.
+    bool match(const MIDIAddress &target) const override {
+        return BankableMIDIInput<NumBanks>::matchBankable(target,
+                                                          this->address);
+    }
+
+    void onBankSettingChange() override { this->callback.update(*this); }
+};
+
+/**
+ * @brief   A MIDI input element that saves the 14-bit value of Pitch Bend 
+ *          messages.  
+ *          This version can be banked.
+ * 
+ * @tparam  NumBanks
+ *          The number of banks.
+ * 
+ * @ingroup BankableMIDIInputElements
+ */
+template <uint8_t NumBanks>
+class PBValue : public GenericPBValue<NumBanks> {
+  public:
+    /**
+     * @brief   Construct a new Bankable PBValue object.
+     * 
+     * @param   config
+     *          The bank configuration to use.
+     * @param   channelCN
+     *          The MIDI channel [CHANNEL_1, CHANNEL_16] and optional Cable
+     *          Number [0, 15].
+     */
+    PBValue(BankConfig<NumBanks> config,
+            const MIDIChannelCN &channelCN = CHANNEL_1)
+        : GenericPBValue<NumBanks>{config, channelCN, {}} {}
+};
+
+} // namespace Bankable
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <MIDI_Inputs/MIDIInputElementParameter.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/// Empty callback for parameter values that does nothing.
+struct ParameterValueEmptyCallback {
+    template <class T>
+    void begin(const T &) {}
+    template <class T>
+    void update(const T &) {}
+};
+
+/**
+ * @brief   A MIDI input element that saves the 14-bit value of an NRPN or RPN
+ *          parameter. This version is generic to allow for custom callbacks.
+ * 
+ * The callback's `update` method is called once for every complete parameter
+ * update, not for each of the CC messages it consists of.
+ */
+template <class Callback = ParameterValueEmptyCallback>
+class GenericParameterValue : public MIDIInputElementParameter {
+  public:
+    /**
+     * @brief   Construct a new GenericParameterValue object.
+     * 
+     * @param   type
+     *          NRPN or RPN.
+     * @param   number
+     *          The 14-bit parameter number [0, 16383].
+     * @param   channelCN
+     *          The MIDI channel [CHANNEL_1, CHANNEL_16] and optional Cable
+     *          Number [0, 15].
+     * @param   callback
+     *          The callback object that is updated when the value changes.
+     */
+    GenericParameterValue(ParameterType type, uint16_t number,
+                          const MIDIChannelCN &channelCN,
+                          const Callback &callback)
+        : MIDIInputElementParameter{type, number, channelCN},
+          callback(callback) {}
+
+    void begin() override { callback.begin(*this); }
+
+  private:
+    void onValueChange() override { callback.update(*this); }
+
+  public:
+    Callback callback;
+};
+
+/**
+ * @brief   A MIDI input element that saves the 14-bit value of a 
+ *          Non-Registered Parameter Number (NRPN).
+ * 
+ * @ingroup MIDIInputElements
+ */
+class NRPNValue : public GenericParameterValue<> {
+  public:
+    /**
+     * @brief   Construct a new NRPNValue object.
+     * 
+     * @param   number
+     *          The 14-bit parameter number [0, 16383].
+     * @param   channelCN
+     *          The MIDI channel [CHANNEL_1, CHANNEL_16] and optional Cable
+     *          Number [0, 15].
+     */
+    NRPNValue(uint16_t number, const MIDIChannelCN &channelCN = CHANNEL_1)
+        : GenericParameterValue<>{ParameterType::NRPN, number, channelCN, {}} {
+    }
+};
+
+/**
+ * @brief   A MIDI input element that saves the 14-bit value of a Registered 
+ *          Parameter Number (RPN), e.g. the pitch bend sensitivity (RPN 0).
+ * 
+ * @ingroup MIDIInputElements
+ */
+class RPNValue : public GenericParameterValue<> {
+  public:
+    /**
+     * @brief   Construct a new RPNValue object.
+     * 
+     * @param   number
+     *          The 14-bit parameter number [0, 16383].
+     * @param   channelCN
+     *          The MIDI channel [CHANNEL_1, CHANNEL_16] and optional Cable
+     *          Number [0, 15].
+     */
+    RPNValue(uint16_t number, const MIDIChannelCN &channelCN = CHANNEL_1)
+        : GenericParameterValue<>{ParameterType::RPN, number, channelCN, {}} {}
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,61 @@
+#include "SysExTrie.hpp"
+#include "MIDIInputElementSysEx.hpp"
+
+BEGIN_CS_NAMESPACE
+
+void SysExTrie::updateAllWith(DoublyLinkedList<MIDIInputElementSysEx> &elements,
+                              SysExMessage midimsg) {
+    if (!valid)
+        rebuild(elements);
+    uint8_t node = 0;
+    uint8_t depth = 0;
+    while (true) {
+        for (MIDIInputElementSysEx *e = nodes[node].consumers; e != nullptr;
+             e = e->nextInTrie)
+            if (e->updateWith(midimsg, depth))
+                return;
+        if (depth >= midimsg.length)
+            return;
+        node = findChild(node, midimsg.data[depth]);
+        if (node == 0)
+            return;
+        ++depth;
+    }
+}
+
+void SysExTrie::rebuild(DoublyLinkedList<MIDIInputElementSysEx> &elements) {
+    nodes[0] = {};
+    numNodes = 1;
+    // Insertion prepends, so iterate backwards to keep the order of the list
+    for (auto it = elements.rbegin(); it != elements.rend(); ++it)
+        insert(*it);
+    valid = true;
+}
+
+void SysExTrie::insert(MIDIInputElementSysEx &element) {
+    uint8_t node = 0;
+    for (uint8_t i = 0; i < element.headerLength; ++i) {
+        uint8_t byte = element.header[i];
+        uint8_t child = findChild(node, byte);
+        if (child == 0) {
+            // Out of nodes, the element checks the rest of its header itself
+            if (numNodes == SYSEX_TRIE_CAPACITY)
+                break;
+            child = numNodes++;
+            nodes[child] = {byte, 0, nodes[node].child, nullptr};
+            nodes[node].child = child;
+        }
+        node = child;
+    }
+    element.nextInTrie = nodes[node].consumers;
+    nodes[node].consumers = &element;
+}
+
+uint8_t SysExTrie::findChild(uint8_t node, uint8_t byte) const {
+    uint8_t child = nodes[node].child;
+    while (child != 0 && nodes[child].byte != byte)
+        child = nodes[child].sibling;
+    return child;
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <AH/Containers/LinkedList.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <Settings/SettingsWrapper.hpp>
+
+BEGIN_CS_NAMESPACE
+
+class MIDIInputElementSysEx;
+
+/**
+ * @brief   Prefix trie of the headers of MIDIInputElementSysEx elements.
+ * 
+ * Each node of the trie represents one byte of a header. Elements are stored
+ * in the node where their header ends, so an incoming message only has to 
+ * walk down the trie once, and it only reaches the elements whose header
+ * matches the start of the message, instead of being offered to all elements.
+ * 
+ * The nodes are allocated from a fixed array of @ref SYSEX_TRIE_CAPACITY 
+ * nodes. If it's full, the remaining elements are stored in the deepest node
+ * that is available, and they compare the rest of their header themselves.
+ * 
+ * The trie is built lazily: adding or removing an element, or changing its 
+ * header invalidates it, and it is rebuilt the next time it's used.
+ */
+class SysExTrie {
+  public:
+    /// Mark the trie as outdated, e.g. after adding or removing an element.
+    void invalidate() { valid = false; }
+
+    /**
+     * @brief   Send the message to the elements whose header matches, until
+     *          one of them returns true.
+     * 
+     * Elements with shorter headers get the message first. 
+     * 
+     * @param   elements
+     *          All elements, used to rebuild the trie if it's outdated.
+     * @param   midimsg
+     *          The SysEx message to dispatch.
+     */
+    void updateAllWith(DoublyLinkedList<MIDIInputElementSysEx> &elements,
+                       SysExMessage midimsg);
+
+    /// Get the number of nodes in use, including the root.
+    uint8_t getNumNodes() const { return numNodes; }
+
+  private:
+    void rebuild(DoublyLinkedList<MIDIInputElementSysEx> &elements);
+    void insert(MIDIInputElementSysEx &element);
+    uint8_t findChild(uint8_t node, uint8_t byte) const;
+
+    /// A node of the trie. Index 0 is the root, and it's never a child, so 
+    /// zero is used as the “none” index for `child` and `sibling`.
+    struct Node {
+        uint8_t byte;
+        uint8_t child;
+        uint8_t sibling;
+        MIDIInputElementSysEx *consumers;
+    };
+
+    static_assert(SYSEX_TRIE_CAPACITY >= 1, "The trie needs a root node");
+    Node nodes[SYSEX_TRIE_CAPACITY];
+    uint8_t numNodes = 0;
+    bool valid = false;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
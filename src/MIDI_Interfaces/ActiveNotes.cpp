@@ -0,0 +1,30 @@
+#include "ActiveNotes.hpp"
+#include <MIDI_Parsers/MIDI_Parser.hpp> // NOTE_ON, NOTE_OFF
+
+BEGIN_CS_NAMESPACE
+
+bool ActiveNotes::update(uint8_t m, uint8_t c, uint8_t d1, uint8_t d2,
+                         uint8_t cn) {
+    if (m == NOTE_ON && d2 != 0) {
+        noteOn(cn, c, d1);
+        return true;
+    } else if (m == NOTE_ON || m == NOTE_OFF) {
+        return noteOff(cn, c, d1) || !deduplicate;
+    }
+    return true;
+}
+
+uint16_t ActiveNotes::count() const {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < numCables * 16 * WordsPerChannel; ++i)
+        for (uint32_t bits = words[i]; bits; bits &= bits - 1)
+            ++count;
+    return count;
+}
+
+void ActiveNotes::clear() {
+    for (uint16_t i = 0; i < numCables * 16 * WordsPerChannel; ++i)
+        words[i] = 0;
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,154 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <Def/MIDIAddress.hpp>
+#include <Settings/NamespaceSettings.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Keeps track of the notes that are sounding on the receiving side of
+ *          a MIDI interface: one bit for each note, channel and cable.
+ *
+ * A MIDI interface updates its ActiveNotes for every Note On and Note Off
+ * message it sends (see @ref MIDI_Interface::setActiveNotes). This allows the
+ * interface to turn off exactly the notes that are still sounding when it is
+ * disconnected or when the user panics, instead of sending Note Off messages
+ * for all 2048 notes of all channels, and to drop Note Off messages for notes
+ * that are not sounding.
+ *
+ * The bits of the 128 notes of a channel are stored in four 32-bit words, so
+ * finding the active notes skips 32 inactive notes at a time.
+ *
+ * @see     BasicActiveNotes
+ */
+class ActiveNotes {
+  protected:
+    ActiveNotes(uint32_t *words, uint8_t numCables)
+        : words(words), numCables(numCables) {}
+
+  public:
+    ActiveNotes(const ActiveNotes &) = delete;
+    ActiveNotes &operator=(const ActiveNotes &) = delete;
+
+    /// The number of 32-bit words for the notes of a single channel.
+    constexpr static uint8_t WordsPerChannel = 128 / 32;
+
+    /**
+     * @brief   Update the active notes with a message that is about to be sent.
+     *
+     * A Note On message with a velocity of zero is a Note Off message.
+     *
+     * @return  Whether the message should be sent: false for Note Off messages
+     *          for notes that are not sounding (if deduplication is enabled),
+     *          true for all other messages.
+     */
+    bool update(uint8_t m, uint8_t c, uint8_t d1, uint8_t d2, uint8_t cn);
+
+    /// Mark the given note as sounding.
+    void noteOn(uint8_t cable, uint8_t channel, uint8_t note) {
+        if (cable < numCables)
+            getWord(cable, channel, note) |= getMask(note);
+    }
+    /// Mark the given note as released.
+    /// @return Whether the note was sounding.
+    bool noteOff(uint8_t cable, uint8_t channel, uint8_t note) {
+        if (cable >= numCables)
+            return true;
+        uint32_t &word = getWord(cable, channel, note);
+        bool wasActive = word & getMask(note);
+        word &= ~getMask(note);
+        return wasActive;
+    }
+    /// Check whether the given note is sounding.
+    bool isActive(MIDIAddress address) const {
+        uint8_t cable = address.getCableNumber();
+        uint8_t note = address.getAddress();
+        return cable < numCables &&
+               (getWord(cable, address.getRawChannel(), note) & getMask(note));
+    }
+    /// Get the number of sounding notes.
+    uint16_t count() const;
+
+    /// Forget all notes.
+    void clear();
+
+    /**
+     * @brief   Call the given function for all sounding notes, and forget them.
+     *
+     * @param   f
+     *          Function that is called with the cable number, the channel
+     *          [0, 15] and the note number of every active note.
+     * @return  The number of notes.
+     */
+    template <class F>
+    uint16_t releaseAll(F &&f) {
+        uint16_t count = 0;
+        uint32_t *word = words;
+        for (uint8_t cable = 0; cable < numCables; ++cable)
+            for (uint8_t channel = 0; channel < 16; ++channel)
+                for (uint8_t w = 0; w < WordsPerChannel; ++w, ++word) {
+                    for (uint32_t bits = *word; bits; bits &= bits - 1) {
+                        uint8_t note = 32 * w + ctz(bits);
+                        f(cable, channel, note);
+                        ++count;
+                    }
+                    *word = 0;
+                }
+        return count;
+    }
+
+    /// Don't send Note Off messages for notes that are not sounding.
+    /// Enabled by default.
+    void setDeduplicateNoteOffs(bool deduplicate) {
+        this->deduplicate = deduplicate;
+    }
+    /// Check whether Note Off messages for notes that are not sounding are
+    /// dropped.
+    bool getDeduplicateNoteOffs() const { return deduplicate; }
+
+    /// Get the number of cables that are tracked.
+    uint8_t getNumCables() const { return numCables; }
+
+  private:
+    uint32_t &getWord(uint8_t cable, uint8_t channel, uint8_t note) {
+        return words[(cable * 16 + channel) * WordsPerChannel + note / 32];
+    }
+    const uint32_t &getWord(uint8_t cable, uint8_t channel,
+                            uint8_t note) const {
+        return words[(cable * 16 + channel) * WordsPerChannel + note / 32];
+    }
+    static uint32_t getMask(uint8_t note) { return uint32_t(1) << (note % 32); }
+    static uint8_t ctz(uint32_t bits) {
+        static_assert(sizeof(unsigned long) >= sizeof(uint32_t), "");
+        return __builtin_ctzl(bits);
+    }
+
+    uint32_t *words;
+    uint8_t numCables;
+    bool deduplicate = true;
+};
+
+/**
+ * @brief   @ref ActiveNotes with storage for the given number of cables.
+ *
+ * Every cable uses 256 bytes of RAM.
+ *
+ * @tparam  NumCables
+ *          The number of cables to keep track of, starting at cable 0.
+ *          Messages on other cables are not tracked.
+ */
+template <uint8_t NumCables = 1>
+class BasicActiveNotes : public ActiveNotes {
+  public:
+    BasicActiveNotes() : ActiveNotes(storage, NumCables) {}
+
+  private:
+    uint32_t storage[NumCables * 16 * WordsPerChannel] = {};
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,252 @@
+#include "MIDIFilePlayer.hpp"
+#include <AH/Arduino-Wrapper.h> // micros
+#include <AH/Debug/Debug.hpp>
+#include <string.h> // memcmp, memcpy
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+uint16_t readBE16(const uint8_t *p) { return uint16_t(p[0]) << 8 | p[1]; }
+
+uint32_t readBE32(const uint8_t *p) {
+    return uint32_t(readBE16(p)) << 16 | readBE16(p + 2);
+}
+
+} // namespace
+
+// -------------------------------- LOADING --------------------------------- //
+
+bool MIDIFilePlayerBase::load(const uint8_t *data, size_t length) {
+    this->data = data;
+    this->length = length;
+    if (scan())
+        return true;
+    this->data = nullptr;
+    this->length = 0;
+    numTracks = 0;
+    return false;
+}
+
+bool MIDIFilePlayerBase::scan() {
+    playing = false;
+    heapSize = 0;
+    numTracks = 0;
+    if (data == nullptr || length < 14 || memcmp(data, "MThd", 4) != 0)
+        return false;
+    uint32_t headerLength = readBE32(data + 4);
+    if (headerLength < 6 || headerLength > length - 8)
+        return false;
+    uint16_t format = readBE16(data + 8);
+    uint16_t expectedTracks = readBE16(data + 10);
+    uint16_t timeDivision = readBE16(data + 12);
+    if (format > 1)
+        return false;
+
+    smpte = timeDivision & 0x8000;
+    if (smpte) {
+        // Negative frame rate in the upper byte, ticks per frame in the lower
+        uint8_t fps = -int8_t(timeDivision >> 8);
+        uint8_t ticksPerFrame = timeDivision & 0xFF;
+        // 29 means 30 frames per second drop frame (29.97 fps), so 30 frames
+        // take 1.001 seconds
+        division = (fps == 29 ? 30 : fps) * ticksPerFrame;
+        tempo = fps == 29 ? 1001000 : 1000000;
+    } else {
+        division = timeDivision;
+        tempo = 500000; // 120 bpm
+    }
+    if (division == 0)
+        return false;
+
+    const uint8_t *pos = data + 8 + headerLength;
+    const uint8_t *end = data + length;
+    while (end - pos >= 8 && numTracks < expectedTracks) {
+        const uint8_t *chunk = pos + 8;
+        uint32_t chunkLength = readBE32(pos + 4);
+        if (chunkLength > uint32_t(end - chunk)) // truncated file
+            chunkLength = end - chunk;
+        if (memcmp(pos, "MTrk", 4) == 0) {
+            if (numTracks == maxTracks) {
+                DEBUGFN(F("Too many tracks in MIDI file"));
+                return false;
+            }
+            tracks[numTracks++] = {chunk, chunk + chunkLength, 0, 0};
+        }
+        pos = chunk + chunkLength;
+    }
+    return true;
+}
+
+// -------------------------------- PLAYING --------------------------------- //
+
+void MIDIFilePlayerBase::play() {
+    if (!scan())
+        return;
+    tempoTick = 0;
+    tempoMicros = 0;
+    lastTick = 0;
+    eventCount = 0;
+    for (uint8_t i = 0; i < numTracks; ++i)
+        if (readDeltaTime(tracks[i]))
+            heap[heapSize++] = i;
+    for (uint8_t i = heapSize / 2; i-- > 0;)
+        siftDown(i);
+    startTime = micros();
+    playing = heapSize > 0;
+}
+
+void MIDIFilePlayerBase::update() {
+    if (playing)
+        handleEventsUntil(micros() - startTime);
+}
+
+uint32_t MIDIFilePlayerBase::getMicros(uint32_t tick) const {
+    uint64_t delta = uint64_t(tick - tempoTick) * tempo / division;
+    return tempoMicros + uint32_t(delta);
+}
+
+bool MIDIFilePlayerBase::handleEventsUntil(uint32_t time) {
+    while (heapSize > 0) {
+        Track &track = tracks[heap[0]];
+        if (int32_t(time - getMicros(track.tick)) < 0)
+            return true;
+        if (!handleEvent(track))
+            return false;
+        ++eventCount;
+        if (readDeltaTime(track))
+            siftDown(0);
+        else
+            pop();
+    }
+    playing = false;
+    return true;
+}
+
+// -------------------------------- PARSING --------------------------------- //
+
+bool MIDIFilePlayerBase::readVLQ(const uint8_t *&pos, const uint8_t *end,
+                                 uint32_t &value) {
+    value = 0;
+    for (uint8_t i = 0; i < 4 && pos < end; ++i) {
+        uint8_t byte = *pos++;
+        value = (value << 7) | (byte & 0x7F);
+        if ((byte & 0x80) == 0)
+            return true;
+    }
+    return false;
+}
+
+bool MIDIFilePlayerBase::readDeltaTime(Track &track) {
+    uint32_t delta;
+    if (track.pos >= track.end || !readVLQ(track.pos, track.end, delta)) {
+        endTrack(track);
+        return false;
+    }
+    track.tick += delta;
+    return true;
+}
+
+bool MIDIFilePlayerBase::handleEvent(Track &track) {
+    // Nothing is consumed until the event has been handled, so it can be
+    // retried if the pipe is locked.
+    const uint8_t *pos = track.pos;
+    uint8_t status = pos < track.end ? *pos : 0;
+    if (status & 0x80)
+        ++pos;
+    else
+        status = track.runningStatus;
+    if ((status & 0x80) == 0) { // data byte without running status
+        endTrack(track);
+        return true;
+    }
+    lastTick = track.tick;
+
+    // Channel messages
+    if (status < 0xF0) {
+        uint8_t dataLength = (status & 0xE0) == 0xC0 ? 1 : 2;
+        if (track.end - pos < dataLength) {
+            endTrack(track);
+            return true;
+        }
+        if (!canWrite(cn))
+            return false;
+        track.pos = pos + dataLength;
+        track.runningStatus = status;
+        sourceMIDItoPipe(ChannelMessage{
+            status, pos[0], uint8_t(dataLength == 2 ? pos[1] : 0), cn});
+        return true;
+    }
+
+    // Meta events and System Exclusive
+    uint8_t type = 0;
+    if (status == 0xFF && pos < track.end) {
+        type = *pos++;
+    } else if (status != SysExStart && status != 0xF7) {
+        endTrack(track);
+        return true;
+    }
+    uint32_t eventLength;
+    if (!readVLQ(pos, track.end, eventLength) ||
+        eventLength > uint32_t(track.end - pos)) {
+        endTrack(track);
+        return true;
+    }
+
+    if (status == 0xFF) {
+        if (type == 0x2F) { // End of Track
+            endTrack(track);
+            return true;
+        }
+        if (type == 0x51 && eventLength == 3 && !smpte) { // Set Tempo
+            uint32_t newTempo =
+                uint32_t(pos[0]) << 16 | uint32_t(pos[1]) << 8 | pos[2];
+            if (newTempo > 0) {
+                tempoMicros = getMicros(track.tick);
+                tempoTick = track.tick;
+                tempo = newTempo;
+            }
+        }
+    } else if (status == SysExStart) {
+        if (eventLength < sysexBufferSize) {
+            if (!canWrite(cn))
+                return false;
+            sysexBuffer[0] = SysExStart;
+            memcpy(sysexBuffer + 1, pos, eventLength);
+            sourceMIDItoPipe(SysExMessage{sysexBuffer, eventLength + 1, cn});
+        } else {
+            DEBUGFN(F("SysEx message in MIDI file too long, dropped"));
+        }
+    }
+    // Escaped (0xF7) events are not supported, they are skipped.
+
+    track.pos = pos + eventLength;
+    track.runningStatus = 0;
+    return true;
+}
+
+// --------------------------------- MERGING -------------------------------- //
+
+void MIDIFilePlayerBase::siftDown(uint8_t i) {
+    while (true) {
+        uint8_t smallest = i;
+        unsigned left = 2u * i + 1, right = 2u * i + 2;
+        if (left < heapSize && before(heap[left], heap[smallest]))
+            smallest = left;
+        if (right < heapSize && before(heap[right], heap[smallest]))
+            smallest = right;
+        if (smallest == i)
+            return;
+        uint8_t tmp = heap[i];
+        heap[i] = heap[smallest];
+        heap[smallest] = tmp;
+        i = smallest;
+    }
+}
+
+void MIDIFilePlayerBase::pop() {
+    heap[0] = heap[--heapSize];
+    siftDown(0);
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,198 @@
+#pragma once
+
+#include "MIDI_Pipes.hpp"
+#include <AH/Containers/Updatable.hpp>
+#include <AH/Settings/Warnings.hpp>
+#include <MIDI_Parsers/MIDI_Parser.hpp>
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A MIDI source that plays a Standard MIDI File (format 0 or 1).
+ *
+ * The file is parsed incrementally while it is being played: the player only
+ * keeps a read position for each track, the event list is never loaded into
+ * RAM, and channel messages are read directly from the file data.
+ * The tracks are merged using a small binary heap ordered by the time of
+ * their next event.
+ * Tempo changes are applied as they are encountered, the time of each event
+ * is computed from the last tempo change, so there's no accumulation of
+ * rounding errors.
+ *
+ * The messages are sent to the MIDI pipes connected to this source at the
+ * right `micros()` time, e.g.:
+ *
+ * ~~~cpp
+ * USBMIDI_Interface midi;
+ * MIDIFilePlayer<4> player;
+ * MIDI_PipeFactory<1> pipes;
+ *
+ * void setup() {
+ *     player >> pipes >> midi;
+ *     player.load(data, length);
+ *     Control_Surface.begin();
+ *     player.play();
+ * }
+ * ~~~
+ *
+ * @note    On AVR, the file data has to be in RAM, PROGMEM is not supported.
+ *
+ * @see     MIDIFilePlayer
+ * @ingroup MIDIInterfaces
+ */
+class MIDIFilePlayerBase : public TrueMIDI_Source, public AH::Updatable<> {
+  public:
+    /// The read position in one of the tracks of the file.
+    struct Track {
+        const uint8_t *pos;
+        const uint8_t *end;
+        /// Absolute time (in ticks) of the next event.
+        uint32_t tick;
+        uint8_t runningStatus;
+    };
+
+  protected:
+    MIDIFilePlayerBase(Track *tracks, uint8_t *heap, uint8_t maxTracks,
+                       uint8_t *sysexBuffer, uint8_t sysexBufferSize)
+        : tracks(tracks), heap(heap), maxTracks(maxTracks),
+          sysexBuffer(sysexBuffer), sysexBufferSize(sysexBufferSize) {}
+
+  public:
+    /**
+     * @brief   Load the given Standard MIDI File.
+     *
+     * The data is not copied, it should outlive the player (e.g. a constant
+     * array, a memory-mapped file, or a buffer that is kept alive).
+     *
+     * @param   data
+     *          Pointer to the contents of the file.
+     * @param   length
+     *          The size of the file in bytes.
+     * @retval  true
+     *          The file was loaded successfully.
+     * @retval  false
+     *          The file is not a valid format 0 or 1 MIDI file, or it has
+     *          more tracks than the player supports.
+     */
+    bool load(const uint8_t *data, size_t length);
+
+    /// Start playing from the beginning of the file.
+    void play();
+    /// Stop playing. Resuming is not supported, `play` starts from the
+    /// beginning.
+    void stop() { playing = false; }
+    /// Check whether the file is being played. Returns false when the end of
+    /// all tracks has been reached.
+    bool isPlaying() const { return playing; }
+
+    /// Set the cable number to send all messages on.
+    void setCableNumber(uint8_t cn) { this->cn = cn; }
+
+    /// Does nothing.
+    void begin() override {}
+    /// Send all events that are due.
+    void update() override;
+
+    /// Get the number of tracks in the file.
+    uint8_t getNumberOfTracks() const { return numTracks; }
+    /// Get the current tempo (microseconds per quarter note).
+    uint32_t getTempo() const { return tempo; }
+    /// Get the time (in ticks) of the last event that was handled.
+    uint32_t getTick() const { return lastTick; }
+    /// Get the number of events that have been handled since `play()`.
+    uint32_t getEventCount() const { return eventCount; }
+
+    /// Convert a time in ticks to microseconds since the start of the file,
+    /// using the current tempo. Only valid for ticks after the last tempo
+    /// change.
+    uint32_t getMicros(uint32_t tick) const;
+
+    /**
+     * @brief   Handle all events that are due at the given time (in
+     *          microseconds since the start of the file).
+     * @return  False if the pipe was locked by another source, true otherwise.
+     */
+    bool handleEventsUntil(uint32_t time);
+
+  private:
+    /// Find the tracks in the file and rewind them.
+    bool scan();
+    /// Read a variable-length quantity. Returns false if the data ends first.
+    static bool readVLQ(const uint8_t *&pos, const uint8_t *end,
+                        uint32_t &value);
+    /// Read the delta time of the next event of the given track and add it to
+    /// its tick, or end the track if there are no more events.
+    bool readDeltaTime(Track &track);
+    /// Handle the next event of the given track.
+    /// Returns false if the pipe was locked.
+    bool handleEvent(Track &track);
+    /// Stop reading the given track.
+    static void endTrack(Track &track) { track.pos = track.end; }
+
+    bool before(uint8_t a, uint8_t b) const {
+        return tracks[a].tick < tracks[b].tick ||
+               (tracks[a].tick == tracks[b].tick && a < b);
+    }
+    void siftDown(uint8_t i);
+    void pop();
+
+  private:
+    Track *tracks;
+    uint8_t *heap;
+    uint8_t maxTracks;
+    uint8_t *sysexBuffer;
+    uint8_t sysexBufferSize;
+
+    const uint8_t *data = nullptr;
+    size_t length = 0;
+    uint8_t numTracks = 0;
+    uint8_t heapSize = 0;
+    uint8_t cn = 0;
+    bool playing = false;
+
+    /// Ticks per quarter note, or ticks per second for SMPTE time division.
+    uint16_t division = 96;
+    /// True if the time division is SMPTE-based (tempo events are ignored).
+    bool smpte = false;
+    /// Microseconds per quarter note (or per second for SMPTE).
+    uint32_t tempo = 500000;
+    /// Tick of the last tempo change.
+    uint32_t tempoTick = 0;
+    /// Time of the last tempo change.
+    uint32_t tempoMicros = 0;
+    /// Tick of the last event.
+    uint32_t lastTick = 0;
+
+    unsigned long startTime = 0;
+    uint32_t eventCount = 0;
+};
+
+/**
+ * @brief   A MIDI source that plays a Standard MIDI File (format 0 or 1).
+ *
+ * @copydetails MIDIFilePlayerBase
+ *
+ * @tparam  MaxTracks
+ *          The maximum number of tracks in the file.
+ * @tparam  SysExBufferSize
+ *          The maximum length of a System Exclusive message in the file.
+ *          Longer messages are dropped.
+ */
+template <uint8_t MaxTracks, uint8_t SysExBufferSize = 32>
+class MIDIFilePlayer : public MIDIFilePlayerBase {
+  public:
+    MIDIFilePlayer()
+        : MIDIFilePlayerBase(tracks, heap, MaxTracks, sysexBuffer,
+                             SysExBufferSize) {}
+
+  private:
+    Track tracks[MaxTracks];
+    uint8_t heap[MaxTracks];
+    uint8_t sysexBuffer[SysExBufferSize];
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -5,6 +5,7 @@ BEGIN_CS_NAMESPACE
 MIDI_Interface::~MIDI_Interface() {
     if (getDefault() == this)
         DefaultMIDI_Interface = nullptr;
+    MIDI_Scheduler::cancelInstance(this);
 }
 
 MIDI_Interface *MIDI_Interface::DefaultMIDI_Interface = nullptr;
@@ -25,6 +26,19 @@ MIDI_Interface *MIDI_Interface::getDefault() {
 
 // -------------------------------- SENDING --------------------------------- //
 
+uint16_t MIDI_Interface::releaseActiveNotes(uint8_t velocity) {
+    if (activeNotes == nullptr)
+        return 0;
+    return activeNotes->releaseAll([&](uint8_t cn, uint8_t c, uint8_t note) {
+        sendImpl(NOTE_OFF, c, note, velocity, cn);
+    });
+}
+
+void MIDI_Interface::releaseAllActiveNotes() {
+    for (auto &updatable : updatables)
+        static_cast<MIDI_Interface &>(updatable).releaseActiveNotes();
+}
+
 void MIDI_Interface::sinkMIDIfromPipe(ChannelMessage msg) { send(msg); }
 void MIDI_Interface::sinkMIDIfromPipe(SysExMessage msg) { send(msg); }
 void MIDI_Interface::sinkMIDIfromPipe(RealTimeMessage msg) { send(msg); }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "ActiveNotes.hpp"
 #include "MIDI_Pipes.hpp"
+#include "MIDI_Scheduler.hpp"
 #include <AH/Containers/Updatable.hpp>
 #include <Def/Def.hpp>
 #include <Def/MIDIAddress.hpp>
@@ -118,6 +120,43 @@ class MIDI_Sender {
     void send(uint8_t rt, uint8_t cn = 0);
 
     /// @}
+
+    /// @name Scheduling MIDI
+    /// @{
+
+    /**
+     * @brief   Send a MIDI Channel Message at the given time.
+     *
+     * @param   timestamp
+     *          The time (in milliseconds, see `millis()`) at which to send the
+     *          message. Messages with a timestamp in the past are sent on the
+     *          next update.
+     * @param   message
+     *          The message to send.
+     * @return  True if the message was scheduled, false if the scheduler is
+     *          full.
+     *
+     * @see     MIDI_Scheduler
+     */
+    bool sendAt(unsigned long timestamp, ChannelMessage message);
+    /// Send a MIDI Real-Time message at the given time.
+    /// @see    sendAt(unsigned long, ChannelMessage)
+    bool sendAt(unsigned long timestamp, RealTimeMessage message);
+    /// Send a MIDI Channel Message after the given delay (in milliseconds).
+    /// @see    sendAt(unsigned long, ChannelMessage)
+    bool sendAfter(unsigned long delay, ChannelMessage message);
+    /// Send a MIDI Real-Time message after the given delay (in milliseconds).
+    /// @see    sendAt(unsigned long, ChannelMessage)
+    bool sendAfter(unsigned long delay, RealTimeMessage message);
+    /// Discard all messages this sender has scheduled that haven't been sent
+    /// yet.
+    void cancelScheduled();
+
+    /// @}
+
+  private:
+    /// Send a message that was scheduled using sendAt or sendAfter.
+    static void sendScheduled(void *sender, ChannelMessage message);
 };
 
 /**
@@ -186,6 +225,44 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
     void setCallbacks(MIDI_Callbacks &cb) { setCallbacks(&cb); }
     /// @}
 
+    /// @name   Active Notes
+    /// @{
+    /**
+     * @brief   Keep track of the notes that are sounding on the receiving side
+     *          of this interface, by updating the given @ref ActiveNotes for
+     *          every Note On and Note Off message that is sent.
+     * 
+     * Note Off messages for notes that are not sounding are not sent, see 
+     * @ref ActiveNotes::setDeduplicateNoteOffs.
+     * 
+     * @param   activeNotes
+     *          The active notes to update, or `nullptr` to stop tracking.
+     */
+    void setActiveNotes(ActiveNotes *activeNotes) {
+        this->activeNotes = activeNotes;
+    }
+    /// @copydoc setActiveNotes(ActiveNotes *)
+    void setActiveNotes(ActiveNotes &activeNotes) {
+        setActiveNotes(&activeNotes);
+    }
+    /// Get the active notes of this interface, or `nullptr` if they are not
+    /// tracked.
+    ActiveNotes *getActiveNotes() const { return activeNotes; }
+
+    /**
+     * @brief   Send a Note Off message for every note that is still sounding.
+     * 
+     * @param   velocity
+     *          The release velocity of the Note Off messages.
+     * @return  The number of Note Off messages that were sent.
+     */
+    uint16_t releaseActiveNotes(uint8_t velocity = 0x40);
+
+    /// Send a Note Off message for every note that is still sounding, on all
+    /// MIDI interfaces that keep track of their active notes.
+    static void releaseAllActiveNotes();
+    /// @}
+
   protected:
     friend class MIDI_Sender<MIDI_Interface>;
     /**
@@ -216,6 +293,15 @@ class MIDI_Interface : public TrueMIDI_SinkSource,
     /// Accept an incoming MIDI Real-Time message.
     void sinkMIDIfromPipe(RealTimeMessage) override;
 
+  private:
+    /// Update the active notes before sending a message.
+    /// @return Whether the message should be sent.
+    bool trackNote(uint8_t m, uint8_t c, uint8_t d1, uint8_t d2, uint8_t cn) {
+        return activeNotes == nullptr || activeNotes->update(m, c, d1, d2, cn);
+    }
+
+    ActiveNotes *activeNotes = nullptr;
+
   private:
     static MIDI_Interface *DefaultMIDI_Interface;
 };
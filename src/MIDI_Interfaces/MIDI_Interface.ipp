@@ -1,4 +1,5 @@
 #include "MIDI_Interface.hpp"
+#include <AH/Arduino-Wrapper.h> // millis
 #include <Def/CRTP.hpp>
 
 BEGIN_CS_NAMESPACE
@@ -23,7 +24,8 @@ void MIDI_Sender<Derived>::sendOnCable(uint8_t m, uint8_t c, uint8_t d1,
     d1 &= 0x7F;      // clear msb
     d2 &= 0x7F;      // clear msb
     cn &= 0x0F;      // bitmask low nibble
-    CRTP(Derived).sendImpl(m, c, d1, d2, cn);
+    if (CRTP(Derived).trackNote(m, c, d1, d2, cn))
+        CRTP(Derived).sendImpl(m, c, d1, d2, cn);
 }
 
 template <class Derived>
@@ -47,14 +49,18 @@ void MIDI_Sender<Derived>::sendOnCable(uint8_t r, uint8_t cn) {
 
 template <class Derived>
 void MIDI_Sender<Derived>::sendNoteOn(MIDIAddress address, uint8_t velocity) {
-    if (address)
+    if (address && CRTP(Derived).trackNote(NOTE_ON, address.getRawChannel(),
+                                           address.getAddress(), velocity,
+                                           address.getCableNumber()))
         CRTP(Derived).sendImpl(NOTE_ON, address.getRawChannel(),
                                address.getAddress(), velocity,
                                address.getCableNumber());
 }
 template <class Derived>
 void MIDI_Sender<Derived>::sendNoteOff(MIDIAddress address, uint8_t velocity) {
-    if (address)
+    if (address && CRTP(Derived).trackNote(NOTE_OFF, address.getRawChannel(),
+                                           address.getAddress(), velocity,
+                                           address.getCableNumber()))
         CRTP(Derived).sendImpl(NOTE_OFF, address.getRawChannel(),
                                address.getAddress(), velocity,
                                address.getCableNumber());
@@ -125,10 +131,54 @@ void MIDI_Sender<Derived>::send(ChannelMessage message) {
     uint8_t m = message.header & 0xF0; // message type
     uint8_t c = message.header & 0x0F; // channel
     // TODO: optimize header?
-    if (m != PROGRAM_CHANGE && m != CHANNEL_PRESSURE)
-        CRTP(Derived).sendImpl(m, c, message.data1, message.data2, message.CN);
-    else
+    // MTC Quarter Frames (0xF1) are two-byte messages as well
+    if (m != PROGRAM_CHANGE && m != CHANNEL_PRESSURE &&
+        message.header != MTCQuarterFrame) {
+        if (CRTP(Derived).trackNote(m, c, message.data1, message.data2,
+                                    message.CN))
+            CRTP(Derived).sendImpl(m, c, message.data1, message.data2,
+                                   message.CN);
+    } else
         CRTP(Derived).sendImpl(m, c, message.data1, message.CN);
 }
 
+template <class Derived>
+bool MIDI_Sender<Derived>::sendAt(unsigned long timestamp,
+                                  ChannelMessage message) {
+    return MIDI_Scheduler::getInstance().schedule(
+        timestamp, &CRTP(Derived), &sendScheduled, message);
+}
+
+template <class Derived>
+bool MIDI_Sender<Derived>::sendAt(unsigned long timestamp,
+                                  RealTimeMessage message) {
+    return sendAt(timestamp, ChannelMessage{message.message, 0, 0, message.CN});
+}
+
+template <class Derived>
+bool MIDI_Sender<Derived>::sendAfter(unsigned long delay,
+                                     ChannelMessage message) {
+    return sendAt(millis() + delay, message);
+}
+
+template <class Derived>
+bool MIDI_Sender<Derived>::sendAfter(unsigned long delay,
+                                     RealTimeMessage message) {
+    return sendAt(millis() + delay, message);
+}
+
+template <class Derived>
+void MIDI_Sender<Derived>::cancelScheduled() {
+    MIDI_Scheduler::cancelInstance(&CRTP(Derived));
+}
+
+template <class Derived>
+void MIDI_Sender<Derived>::sendScheduled(void *sender, ChannelMessage message) {
+    Derived &derived = *static_cast<Derived *>(sender);
+    if (message.header >= 0xF8) // Real-Time
+        derived.send(RealTimeMessage{message.header, message.CN});
+    else
+        derived.send(message);
+}
+
 END_CS_NAMESPACE
\ No newline at end of file
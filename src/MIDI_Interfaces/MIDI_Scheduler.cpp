@@ -0,0 +1,37 @@
+#include "MIDI_Scheduler.hpp"
+#include <AH/Arduino-Wrapper.h> // millis
+#include <AH/Error/Error.hpp>
+
+BEGIN_CS_NAMESPACE
+
+MIDI_Scheduler *MIDI_Scheduler::instance = nullptr;
+
+MIDI_Scheduler &MIDI_Scheduler::getInstance() {
+    static MIDI_Scheduler scheduler;
+    return scheduler;
+}
+
+bool MIDI_Scheduler::schedule(unsigned long timestamp, void *sender,
+                              SendFunction send, ChannelMessage message) {
+    // Don't cascade through all ticks since the last update if nothing is
+    // pending
+    if (wheel.empty())
+        wheel.begin(millis());
+    if (!wheel.schedule(timestamp, {sender, send, message})) {
+        ERROR(F("Error: MIDI scheduler full"), 0x5C4E);
+        return false; // LCOV_EXCL_LINE
+    }
+    return true;
+}
+
+void MIDI_Scheduler::update() {
+    wheel.advance(millis(), [](unsigned long, const Event &e) {
+        e.send(e.sender, e.message);
+    });
+}
+
+void MIDI_Scheduler::cancel(const void *sender) {
+    wheel.removeIf([sender](const Event &e) { return e.sender == sender; });
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+#include <AH/Timing/TimerWheel.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <Settings/SettingsWrapper.hpp>
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Keeps track of MIDI messages that have to be sent at a later time,
+ *          and sends them when they are due.
+ *
+ * The messages are stored in a hierarchical timer wheel with a fixed capacity
+ * of @ref MIDI_SCHEDULER_CAPACITY messages, with a resolution of one
+ * millisecond.
+ *
+ * You don't normally use this class directly, use the `sendAt` and `sendAfter`
+ * functions of Control_Surface or of your MIDI interface instead.
+ * Scheduled messages are sent by `Control_Surface.loop()`. If you don't use
+ * the Control_Surface class, call @ref MIDI_Scheduler::updateInstance in your
+ * loop.
+ *
+ * @note    Only Channel Messages and Real-Time messages can be scheduled, the
+ *          data of a System Exclusive message isn't copied, so it might no
+ *          longer exist when the message is due.
+ *
+ * @ingroup MIDIInterfaces
+ */
+class MIDI_Scheduler {
+  public:
+    /// Function that sends the given message using the given sender.
+    using SendFunction = void (*)(void *sender, ChannelMessage message);
+
+    /**
+     * @brief   Schedule a message.
+     *
+     * @param   timestamp
+     *          The time (in milliseconds, see `millis()`) at which to send the
+     *          message.
+     * @param   sender
+     *          The object that will send the message.
+     * @param   send
+     *          The function that will be called with @p sender and
+     *          @p message when the message is due.
+     * @param   message
+     *          The message to send. Real-Time messages are stored as a
+     *          ChannelMessage with the Real-Time message as its header.
+     * @retval  true
+     *          The message was scheduled.
+     * @retval  false
+     *          The scheduler is full.
+     */
+    bool schedule(unsigned long timestamp, void *sender, SendFunction send,
+                  ChannelMessage message);
+
+    /// Send all messages that are due.
+    void update();
+
+    /// Discard all scheduled messages.
+    void clear() { wheel.clear(); }
+
+    /// Discard all scheduled messages of the given sender.
+    void cancel(const void *sender);
+
+    /// Get the number of messages that haven't been sent yet.
+    uint16_t size() const { return wheel.size(); }
+
+    /// Get the scheduler instance. It is created on first use.
+    static MIDI_Scheduler &getInstance();
+
+    /// Send all messages that are due, if the scheduler has been used.
+    static void updateInstance() {
+        if (instance != nullptr && instance->size() > 0)
+            instance->update();
+    }
+
+    /// Discard all scheduled messages of the given sender, if the scheduler
+    /// has been used.
+    static void cancelInstance(const void *sender) {
+        if (instance != nullptr)
+            instance->cancel(sender);
+    }
+
+  private:
+    MIDI_Scheduler() { instance = this; }
+
+    struct Event {
+        void *sender;
+        SendFunction send;
+        ChannelMessage message;
+    };
+
+    AH::TimerWheel<Event, MIDI_SCHEDULER_CAPACITY, 4, 3> wheel;
+
+    static MIDI_Scheduler *instance;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
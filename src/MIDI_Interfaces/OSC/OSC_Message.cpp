@@ -0,0 +1,269 @@
+#include "OSC_Message.hpp"
+#include <string.h> // memcpy, memcmp, memchr, strlen, strchr
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+const char BundleString[8] = {'#', 'b', 'u', 'n', 'd', 'l', 'e', '\0'};
+
+/// Round up to a multiple of four bytes.
+size_t pad4(size_t length) { return (length + 3) & ~size_t(3); }
+
+uint32_t readBE32(const uint8_t *p) {
+    return uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 | uint32_t(p[2]) << 8 |
+           p[3];
+}
+
+uint8_t *writeBE32(uint8_t *p, uint32_t v) {
+    *p++ = v >> 24;
+    *p++ = v >> 16;
+    *p++ = v >> 8;
+    *p++ = v;
+    return p;
+}
+
+/// Get the padded size of the null-terminated string at the start of the
+/// buffer, or zero if it isn't terminated.
+size_t stringSize(const uint8_t *data, size_t length) {
+    const void *end = memchr(data, '\0', length);
+    if (end == nullptr)
+        return 0;
+    size_t size = pad4(static_cast<const uint8_t *>(end) - data + 1);
+    return size <= length ? size : 0;
+}
+
+/// Get the size of the argument with the given type, or zero if it's invalid.
+/// Returns one for types that don't take up any space.
+size_t argumentSize(char type, const uint8_t *data, size_t length) {
+    switch (type) {
+        case 'i':
+        case 'f':
+        case 'c':
+        case 'r':
+        case 'm': return length >= 4 ? 4 : 0;
+        case 'h':
+        case 't':
+        case 'd': return length >= 8 ? 8 : 0;
+        case 's':
+        case 'S': return stringSize(data, length);
+        case 'b': {
+            if (length < 4)
+                return 0;
+            size_t size = 4 + pad4(readBE32(data));
+            return size <= length ? size : 0;
+        }
+        case 'T':
+        case 'F':
+        case 'N':
+        case 'I':
+        case '[':
+        case ']': return 1;
+        default: return 0;
+    }
+}
+
+} // namespace
+
+// --------------------------------- WRITER --------------------------------- //
+
+OSC_Writer::OSC_Writer(uint8_t *buffer, size_t size)
+    : buffer(buffer), size(size) {
+    reset();
+}
+
+void OSC_Writer::reset(uint64_t timetag) {
+    messages = 0;
+    length = 0;
+    if (size < HEADER_SIZE)
+        return;
+    memcpy(buffer, BundleString, sizeof(BundleString));
+    writeBE32(writeBE32(buffer + 8, timetag >> 32), timetag);
+    length = HEADER_SIZE;
+}
+
+bool OSC_Writer::add(const char *address, const OSC_Argument *args,
+                     uint8_t count) {
+    if (length == 0)
+        return false;
+    size_t addressLength = strlen(address);
+    size_t messageSize = pad4(addressLength + 1) + pad4(count + 2);
+    for (uint8_t i = 0; i < count; ++i) {
+        switch (args[i].type) {
+            case 'i':
+            case 'f': messageSize += 4; break;
+            case 'T':
+            case 'F':
+            case 'N':
+            case 'I': break;
+            default: return false;
+        }
+    }
+    if (4 + messageSize > size - length)
+        return false;
+
+    uint8_t *p = writeBE32(buffer + length, messageSize);
+    uint8_t *end = p + messageSize;
+    memset(p, 0, messageSize); // padding
+    memcpy(p, address, addressLength);
+    p += pad4(addressLength + 1);
+    uint8_t *tags = p;
+    *tags++ = ',';
+    for (uint8_t i = 0; i < count; ++i)
+        *tags++ = args[i].type;
+    p += pad4(count + 2);
+    for (uint8_t i = 0; i < count; ++i) {
+        if (args[i].type == 'i') {
+            p = writeBE32(p, uint32_t(args[i].i));
+        } else if (args[i].type == 'f') {
+            uint32_t bits;
+            memcpy(&bits, &args[i].f, sizeof(bits));
+            p = writeBE32(p, bits);
+        }
+    }
+    length = end - buffer;
+    ++messages;
+    return true;
+}
+
+size_t OSC_Writer::getFirstMessageLength() const {
+    return messages > 0 ? readBE32(buffer + HEADER_SIZE) : 0;
+}
+
+// --------------------------------- READER --------------------------------- //
+
+bool OSC_Message::isBundle(const uint8_t *data, size_t length) {
+    return length >= OSC_Writer::HEADER_SIZE &&
+           memcmp(data, BundleString, sizeof(BundleString)) == 0;
+}
+
+bool OSC_Message::parse(const uint8_t *data, size_t length) {
+    count = 0;
+    if (length % 4 != 0 || length == 0 || data[0] != '/')
+        return false;
+    size_t size = stringSize(data, length);
+    if (size == 0)
+        return false;
+    address = reinterpret_cast<const char *>(data);
+    data += size;
+    length -= size;
+
+    // Old implementations may omit the type tag string if there are no
+    // arguments
+    if (length == 0 || data[0] != ',') {
+        typetags = "";
+        arguments = data;
+        argumentsLength = 0;
+        return length == 0;
+    }
+    size = stringSize(data, length);
+    if (size == 0)
+        return false;
+    typetags = reinterpret_cast<const char *>(data) + 1;
+    data += size;
+    length -= size;
+    arguments = data;
+    argumentsLength = length;
+
+    // Check that all arguments are present
+    for (const char *type = typetags; *type; ++type) {
+        size_t argSize = argumentSize(*type, data, length);
+        if (argSize == 0 || count == 0xFF)
+            return false;
+        if (argSize > 1) {
+            data += argSize;
+            length -= argSize;
+        }
+        ++count;
+    }
+    return true;
+}
+
+OSC_Argument OSC_Message::getArgument(uint8_t index) const {
+    const uint8_t *data = arguments;
+    size_t length = argumentsLength;
+    for (uint8_t i = 0; i < index; ++i) {
+        size_t argSize = argumentSize(typetags[i], data, length);
+        if (argSize > 1) {
+            data += argSize;
+            length -= argSize;
+        }
+    }
+    OSC_Argument arg;
+    arg.type = typetags[index];
+    arg.i = 0;
+    if (arg.type == 'i') {
+        arg.i = int32_t(readBE32(data));
+    } else if (arg.type == 'f') {
+        uint32_t bits = readBE32(data);
+        memcpy(&arg.f, &bits, sizeof(bits));
+    }
+    return arg;
+}
+
+// ---------------------------- PATTERN MATCHING ---------------------------- //
+
+bool OSC_Message::matchPattern(const char *pattern, const char *address) {
+    const char *p = pattern, *a = address;
+    while (*p) {
+        switch (*p) {
+            case '?': {
+                if (*a == '\0' || *a == '/')
+                    return false;
+                ++p, ++a;
+            } break;
+            case '*': {
+                while (*p == '*')
+                    ++p;
+                // Try every possible length within the current part
+                for (;; ++a) {
+                    if (matchPattern(p, a))
+                        return true;
+                    if (*a == '\0' || *a == '/')
+                        return false;
+                }
+            }
+            case '[': {
+                ++p;
+                bool negate = *p == '!';
+                if (negate)
+                    ++p;
+                bool match = false;
+                while (*p && *p != ']') {
+                    char low = *p++, high = low;
+                    if (p[0] == '-' && p[1] && p[1] != ']') {
+                        high = p[1];
+                        p += 2;
+                    }
+                    match |= *a >= low && *a <= high;
+                }
+                if (*p != ']' || *a == '\0' || *a == '/' || match == negate)
+                    return false;
+                ++p, ++a;
+            } break;
+            case '{': {
+                const char *end = strchr(p, '}');
+                if (end == nullptr)
+                    return false;
+                const char *alt = p + 1;
+                while (alt <= end) {
+                    const char *altEnd = alt;
+                    while (altEnd < end && *altEnd != ',')
+                        ++altEnd;
+                    size_t n = altEnd - alt;
+                    if (strncmp(alt, a, n) == 0 && matchPattern(end + 1, a + n))
+                        return true;
+                    alt = altEnd + 1;
+                }
+                return false;
+            }
+            default: {
+                if (*p++ != *a++)
+                    return false;
+            }
+        }
+    }
+    return *a == '\0';
+}
+
+END_CS_NAMESPACE
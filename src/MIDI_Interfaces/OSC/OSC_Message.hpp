@@ -0,0 +1,207 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+#include <Settings/NamespaceSettings.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+/// OSC time tag that means "execute immediately".
+constexpr uint64_t OSC_IMMEDIATELY = 1;
+
+/// A single OSC argument. Only 32-bit integers and floats carry a value, the
+/// other types are only identified by their type tag.
+struct OSC_Argument {
+    /// The OSC type tag: 'i' (int32), 'f' (float32), 'T' (true), 'F' (false),
+    /// etc.
+    char type;
+    union {
+        int32_t i;
+        float f;
+    };
+
+    static OSC_Argument Int(int32_t value) {
+        OSC_Argument arg;
+        arg.type = 'i';
+        arg.i = value;
+        return arg;
+    }
+    static OSC_Argument Float(float value) {
+        OSC_Argument arg;
+        arg.type = 'f';
+        arg.f = value;
+        return arg;
+    }
+};
+
+/**
+ * @brief   Encodes OSC messages into an OSC bundle in a user-provided buffer,
+ *          without any dynamic memory allocation.
+ *
+ * ~~~cpp
+ * uint8_t buffer[256];
+ * OSC_Writer writer {buffer, sizeof(buffer)};
+ * writer.add("/mixer/1/fader", OSC_Argument::Float(0.5));
+ * writer.add("/mixer/2/fader", OSC_Argument::Float(0.8));
+ * udp.send(writer.getData(), writer.getLength());
+ * ~~~
+ */
+class OSC_Writer {
+  public:
+    /// Create a writer that writes to the given buffer, and start a new bundle.
+    OSC_Writer(uint8_t *buffer, size_t size);
+
+    /// Discard all messages and start a new bundle with the given time tag.
+    void reset(uint64_t timetag = OSC_IMMEDIATELY);
+
+    /**
+     * @brief   Append a message to the bundle.
+     *
+     * @param   address
+     *          The OSC address of the message.
+     * @param   args
+     *          The arguments of the message. Only 'i', 'f', 'T', 'F', 'N' and
+     *          'I' arguments are supported.
+     * @param   count
+     *          The number of arguments.
+     * @return  True if the message was added, false if it didn't fit in the
+     *          buffer (in which case the bundle is left unchanged).
+     */
+    bool add(const char *address, const OSC_Argument *args, uint8_t count);
+    /// Append a message with a single argument to the bundle.
+    bool add(const char *address, OSC_Argument arg) {
+        return add(address, &arg, 1);
+    }
+
+    /// Get the number of messages in the bundle.
+    uint16_t getMessageCount() const { return messages; }
+    /// Get the encoded bundle.
+    const uint8_t *getData() const { return buffer; }
+    /// Get the length of the encoded bundle.
+    size_t getLength() const { return length; }
+
+    /// Get the first message of the bundle, without the bundle header.
+    /// Useful for sending a bundle with only one message as a bare message.
+    const uint8_t *getFirstMessage() const { return buffer + HEADER_SIZE + 4; }
+    /// Get the length of the first message of the bundle.
+    size_t getFirstMessageLength() const;
+
+    /// The size of the "#bundle" string and the time tag.
+    constexpr static size_t HEADER_SIZE = 16;
+
+  private:
+    uint8_t *buffer;
+    size_t size;
+    size_t length = 0;
+    uint16_t messages = 0;
+};
+
+/**
+ * @brief   A view of an OSC message inside of a received packet. The message
+ *          is validated when it's parsed, no data is copied.
+ */
+class OSC_Message {
+  public:
+    /// Parse and validate the message in the given buffer.
+    /// @return True if the data is a valid OSC message, false otherwise.
+    bool parse(const uint8_t *data, size_t length);
+
+    /// Get the address (pattern) of the message.
+    const char *getAddress() const { return address; }
+    /// Get the type tags of the arguments, without the leading comma.
+    const char *getTypeTags() const { return typetags; }
+    /// Get the number of arguments.
+    uint8_t getArgumentCount() const { return count; }
+    /**
+     * @brief   Get the argument with the given index.
+     *
+     * @param   index
+     *          The index of the argument. Must be less than the number of
+     *          arguments.
+     * @return  The type of the argument, and its value if it is an integer or
+     *          a float.
+     */
+    OSC_Argument getArgument(uint8_t index) const;
+
+    /**
+     * @brief   Call the given callback for each message in an OSC packet,
+     *          which is either a single message or a (nested) bundle.
+     *
+     * @param   data
+     *          The packet.
+     * @param   length
+     *          The length of the packet.
+     * @param   callback
+     *          A callable that takes a `const OSC_Message &`.
+     * @return  False if the packet (or part of it) is malformed. The messages
+     *          before the error are still passed to the callback.
+     */
+    template <class Callback>
+    static bool forEach(const uint8_t *data, size_t length,
+                        Callback &&callback) {
+        return forEach(data, length, callback, 0);
+    }
+
+    /**
+     * @brief   Check whether an OSC address pattern matches the given address.
+     *
+     * Supports the wildcards `?` and `*`, character sets like `[a-z]` and
+     * `[!0-9]`, and alternatives like `{fader,knob}`. Wildcards never match
+     * the `/` separator.
+     */
+    static bool matchPattern(const char *pattern, const char *address);
+
+    /// Check whether the given data starts with the "#bundle" string.
+    static bool isBundle(const uint8_t *data, size_t length);
+
+  private:
+    template <class Callback>
+    static bool forEach(const uint8_t *data, size_t length, Callback &callback,
+                        uint8_t depth);
+
+    const char *address = nullptr;
+    const char *typetags = nullptr;
+    const uint8_t *arguments = nullptr;
+    size_t argumentsLength = 0;
+    uint8_t count = 0;
+
+    /// Maximum nesting depth of bundles.
+    constexpr static uint8_t MAX_DEPTH = 4;
+};
+
+template <class Callback>
+bool OSC_Message::forEach(const uint8_t *data, size_t length,
+                          Callback &callback, uint8_t depth) {
+    if (!isBundle(data, length)) {
+        OSC_Message message;
+        if (!message.parse(data, length))
+            return false;
+        callback(static_cast<const OSC_Message &>(message));
+        return true;
+    }
+    if (depth >= MAX_DEPTH)
+        return false;
+    // Bundle elements: 32-bit big-endian size followed by the element
+    size_t pos = OSC_Writer::HEADER_SIZE;
+    while (pos < length) {
+        if (length - pos < 4)
+            return false;
+        const uint8_t *p = data + pos;
+        uint32_t size = uint32_t(p[0]) << 24 | uint32_t(p[1]) << 16 |
+                        uint32_t(p[2]) << 8 | p[3];
+        pos += 4;
+        if (size % 4 != 0 || size > length - pos)
+            return false;
+        if (!forEach(data + pos, size, callback, depth + 1))
+            return false;
+        pos += size;
+    }
+    return true;
+}
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
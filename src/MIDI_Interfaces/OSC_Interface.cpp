@@ -0,0 +1,182 @@
+#if !defined(ARDUINO) || defined(ESP32)
+
+#include "OSC_Interface.hpp"
+#include <AH/Debug/Debug.hpp>
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+/// Check whether the MIDI message type has an address (note or controller
+/// number) in its first data byte.
+bool hasAddress(uint8_t type) {
+    return type == NOTE_ON || type == KEY_PRESSURE || type == CONTROL_CHANGE;
+}
+
+uint16_t maxValue(uint8_t type) { return type == PITCH_BEND ? 16383 : 127; }
+
+} // namespace
+
+OSC_Interface::OSC_Interface(const OSC_Mapping *mappings, size_t count,
+                             uint16_t port, UDP_Endpoint remote)
+    : Parsing_MIDI_Interface(parser), mappings(mappings), mappingCount(count),
+      port(port), remote(remote), writer(txBuffer, TX_BUFFER_SIZE) {}
+
+void OSC_Interface::begin() {
+    if (!socket.begin(port))
+        DEBUGFN(F("Failed to open the OSC socket on port ") << port);
+}
+
+void OSC_Interface::update() {
+    flush();
+    Parsing_MIDI_Interface::update();
+}
+
+// -------------------------------- SENDING --------------------------------- //
+
+const OSC_Mapping *OSC_Interface::find(uint8_t type, uint8_t channel,
+                                       uint8_t address, uint8_t cn) const {
+    bool addressed = hasAddress(type);
+    for (const OSC_Mapping *m = mappings; m != mappings + mappingCount; ++m) {
+        if (m->type == type &&
+            m->midiAddress.getRawChannel() == channel &&
+            m->midiAddress.getCableNumber() == cn &&
+            (!addressed || m->midiAddress.getAddress() == address))
+            return m;
+    }
+    return nullptr;
+}
+
+void OSC_Interface::sendMapped(uint8_t type, uint8_t channel,
+                               uint8_t address, uint16_t value, uint8_t cn) {
+    const OSC_Mapping *mapping = find(type, channel, address, cn);
+    if (mapping == nullptr)
+        return;
+    OSC_Argument arg =
+        mapping->format == OSC_Mapping::Int
+            ? OSC_Argument::Int(value)
+            : OSC_Argument::Float(float(value) / maxValue(type));
+    if (writer.add(mapping->address, arg))
+        return;
+    // The bundle is full, send it and start a new one
+    flush();
+    if (!writer.add(mapping->address, arg))
+        DEBUGFN(F("OSC message too long: ") << mapping->address);
+}
+
+void OSC_Interface::sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t d2,
+                             uint8_t cn) {
+    switch (m) {
+        case NOTE_OFF: sendMapped(NOTE_ON, c, d1, 0, cn); break;
+        case PITCH_BEND:
+            sendMapped(m, c, 0, d1 | uint16_t(d2) << 7, cn);
+            break;
+        default: sendMapped(m, c, d1, d2, cn);
+    }
+}
+
+void OSC_Interface::sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t cn) {
+    sendMapped(m, c, 0, d1, cn);
+}
+
+void OSC_Interface::sendImpl(const uint8_t *data, size_t length, uint8_t cn) {
+    (void)data, (void)length, (void)cn; // System Exclusive is not mapped
+}
+
+void OSC_Interface::sendImpl(uint8_t rt, uint8_t cn) {
+    (void)rt, (void)cn; // Real-Time messages are not mapped
+}
+
+void OSC_Interface::flush() {
+    uint16_t messages = writer.getMessageCount();
+    if (messages == 0)
+        return;
+    const UDP_Endpoint &to = remote.port != 0 ? remote : lastSender;
+    if (to.port != 0) {
+        // A single message doesn't need the overhead of a bundle
+        if (messages == 1)
+            socket.send(to, writer.getFirstMessage(),
+                        writer.getFirstMessageLength());
+        else
+            socket.send(to, writer.getData(), writer.getLength());
+        ++packetsSent;
+        messagesSent += messages;
+    }
+    writer.reset();
+}
+
+// ------------------------------- RECEIVING -------------------------------- //
+
+MIDI_read_t OSC_Interface::read() {
+    while (true) {
+        if (rxQueueIndex < rxQueueLength) {
+            parser.setMessage(rxQueue[rxQueueIndex++]);
+            return CHANNEL_MESSAGE;
+        }
+        rxQueueIndex = rxQueueLength = 0;
+        UDP_Endpoint from;
+        size_t length = socket.receive(rxBuffer, RX_BUFFER_SIZE, from);
+        if (length == 0)
+            return NO_MESSAGE;
+        lastSender = from;
+        ++packetsReceived;
+        auto handle = [this](const OSC_Message &msg) { handleMessage(msg); };
+        if (!OSC_Message::forEach(rxBuffer, length, handle))
+            DEBUGFN(F("Invalid OSC packet"));
+    }
+}
+
+void OSC_Interface::handleMessage(const OSC_Message &message) {
+    if (message.getArgumentCount() == 0)
+        return;
+    // Convert the first argument to a number
+    OSC_Argument arg = message.getArgument(0);
+    switch (arg.type) {
+        case 'i':
+        case 'f':
+        case 'T':
+        case 'F': break;
+        default: return;
+    }
+
+    const char *pattern = message.getAddress();
+    for (const OSC_Mapping *m = mappings; m != mappings + mappingCount; ++m) {
+        if (!OSC_Message::matchPattern(pattern, m->address))
+            continue;
+        if (rxQueueLength == RX_QUEUE_SIZE) {
+            DEBUGFN(F("OSC receive queue full"));
+            return;
+        }
+        ++messagesReceived;
+        // Scale and clamp the value to the range of the MIDI message
+        int32_t max = maxValue(m->type);
+        int32_t value = 0;
+        if (arg.type == 'i')
+            value = arg.i;
+        else if (arg.type == 'f')
+            value = m->format == OSC_Mapping::Float
+                        ? int32_t(arg.f * max + 0.5f)
+                        : int32_t(arg.f);
+        else if (arg.type == 'T')
+            value = max;
+        value = value < 0 ? 0 : value > max ? max : value;
+
+        uint8_t type = m->type;
+        uint8_t header = type | m->midiAddress.getRawChannel();
+        uint8_t cn = m->midiAddress.getCableNumber();
+        uint8_t address = m->midiAddress.getAddress();
+        ChannelMessage &msg = rxQueue[rxQueueLength++];
+        if (type == NOTE_ON && value == 0)
+            msg = {uint8_t(NOTE_OFF | (header & 0x0F)), address, 0x40, cn};
+        else if (type == PITCH_BEND)
+            msg = {header, uint8_t(value & 0x7F), uint8_t(value >> 7), cn};
+        else if (hasAddress(type))
+            msg = {header, address, uint8_t(value), cn};
+        else
+            msg = {header, uint8_t(value), 0, cn};
+    }
+}
+
+END_CS_NAMESPACE
+
+#endif
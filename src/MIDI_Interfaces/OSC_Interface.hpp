@@ -0,0 +1,206 @@
+#pragma once
+
+#include "MIDI_Interface.hpp"
+#include "OSC/OSC_Message.hpp"
+#include "UDP/UDP_Socket.hpp"
+#include <Def/MIDIAddress.hpp>
+#include <MIDI_Parsers/MIDI_Parser.hpp>
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Maps a MIDI message type and address to an OSC address.
+ *
+ * For Program Change, Channel Pressure and Pitch Bend messages, only the
+ * channel and cable number of the MIDI address are used.
+ */
+struct OSC_Mapping {
+    /// How MIDI values are represented in OSC.
+    enum Format : uint8_t {
+        /// A float argument in [0, 1] (7-bit values are divided by 127,
+        /// Pitch Bend values by 16383).
+        Float,
+        /// An integer argument with the raw MIDI value.
+        Int,
+    };
+
+    /**
+     * @param   address
+     *          The OSC address, e.g. `"/mixer/1/fader"`. Must not contain
+     *          any wildcards.
+     * @param   type
+     *          The MIDI message type: @ref NOTE_ON, @ref KEY_PRESSURE,
+     *          @ref CONTROL_CHANGE, @ref PROGRAM_CHANGE,
+     *          @ref CHANNEL_PRESSURE or @ref PITCH_BEND. Note Off messages
+     *          use the mapping of the Note On messages, with a value of zero.
+     * @param   midiAddress
+     *          The MIDI address (note or controller number, channel and
+     *          cable number).
+     * @param   format
+     *          The representation of the value in OSC.
+     */
+    constexpr OSC_Mapping(const char *address, uint8_t type,
+                          MIDIAddress midiAddress, Format format = Float)
+        : address(address), type(type), midiAddress(midiAddress),
+          format(format) {}
+
+    const char *address;
+    uint8_t type;
+    MIDIAddress midiAddress;
+    Format format;
+};
+
+/// MIDI parser that holds the messages decoded from OSC.
+class OSC_MIDI_Parser : public MIDI_Parser {
+  public:
+    void setMessage(ChannelMessage message) { midimsg = message; }
+    uint8_t getCN() const override { return midimsg.CN; }
+#if !IGNORE_SYSEX
+    SysExMessage getSysEx() const override { return {}; }
+#endif
+};
+
+/**
+ * @brief   MIDI interface that bridges MIDI messages to OSC (Open Sound
+ *          Control) messages over UDP, for the ESP32 (WiFi) and for the
+ *          computer.
+ *
+ * A table of @ref OSC_Mapping "mappings" defines which MIDI messages
+ * correspond to which OSC addresses. Messages that are sent to this interface
+ * are translated to OSC messages with a single argument, and all messages
+ * that are sent within one call to @ref update (i.e. one iteration of the
+ * main loop) are packed into a single OSC bundle. Other MIDI messages are
+ * dropped.
+ *
+ * Incoming OSC messages (either bare or in bundles) are matched against the
+ * addresses in the table, using the OSC pattern matching rules, and are
+ * translated to MIDI messages. Their first argument is used as the value, it
+ * can be an integer, a float, or true/false.
+ *
+ * Messages are encoded and decoded in place, without any dynamic memory
+ * allocation.
+ *
+ * ~~~cpp
+ * const OSC_Mapping mappings[] {
+ *     {"/mixer/1/fader", CONTROL_CHANGE, {7, CHANNEL_1}},
+ *     {"/mixer/2/fader", CONTROL_CHANGE, {7, CHANNEL_2}},
+ *     {"/master/fader", PITCH_BEND, CHANNEL_16},
+ *     {"/cue/go", NOTE_ON, {MIDI_Notes::C(4), CHANNEL_1}, OSC_Mapping::Int},
+ * };
+ * OSC_Interface midi {mappings, 8000, {{192, 168, 1, 2}, 9000}};
+ * ~~~
+ *
+ * @ingroup MIDIInterfaces
+ */
+class OSC_Interface : public Parsing_MIDI_Interface {
+  public:
+    /**
+     * @brief   Create an OSC interface.
+     *
+     * @param   mappings
+     *          The table of mappings. It is not copied, so it should outlive
+     *          the interface.
+     * @param   count
+     *          The number of mappings in the table.
+     * @param   port
+     *          The local UDP port to listen on.
+     * @param   remote
+     *          The address and port to send the OSC messages to. If the
+     *          port is zero, messages are sent to the same port as the last
+     *          incoming message, at the address it came from.
+     */
+    OSC_Interface(const OSC_Mapping *mappings, size_t count, uint16_t port,
+                  UDP_Endpoint remote);
+    /// @copydoc OSC_Interface(const OSC_Mapping *, size_t, uint16_t, UDP_Endpoint)
+    template <size_t N>
+    OSC_Interface(const OSC_Mapping (&mappings)[N], uint16_t port,
+                  UDP_Endpoint remote)
+        : OSC_Interface(mappings, N, port, remote) {}
+
+    OSC_Interface(const OSC_Interface &) = delete;
+    OSC_Interface &operator=(const OSC_Interface &) = delete;
+
+    /// Open the UDP socket.
+    void begin() override;
+    /// Send the OSC bundle with all messages since the last update, and
+    /// read the incoming messages.
+    void update() override;
+
+    /// Send the buffered OSC messages now.
+    void flush();
+
+    /// Change the address and port the OSC messages are sent to.
+    void setRemote(UDP_Endpoint remote) { this->remote = remote; }
+    /// Get the address and port the OSC messages are sent to.
+    UDP_Endpoint getRemote() const { return remote; }
+
+    /// @name   Statistics
+    /// @{
+
+    /// Get the number of UDP datagrams that were sent.
+    uint32_t getPacketsSent() const { return packetsSent; }
+    /// Get the number of OSC messages that were sent.
+    uint32_t getMessagesSent() const { return messagesSent; }
+    /// Get the number of UDP datagrams that were received.
+    uint32_t getPacketsReceived() const { return packetsReceived; }
+    /// Get the number of incoming OSC messages that matched a mapping.
+    uint32_t getMessagesReceived() const { return messagesReceived; }
+
+    /// @}
+
+    MIDI_read_t read() override;
+
+  protected:
+    void sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t d2,
+                  uint8_t cn) override;
+    void sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t cn) override;
+    void sendImpl(const uint8_t *data, size_t length, uint8_t cn) override;
+    void sendImpl(uint8_t rt, uint8_t cn) override;
+
+  public:
+    /// Maximum size of an outgoing datagram.
+    constexpr static size_t TX_BUFFER_SIZE = 1024;
+    /// Maximum size of an incoming datagram.
+    constexpr static size_t RX_BUFFER_SIZE = 1536;
+    /// Maximum number of MIDI messages that one incoming datagram can result
+    /// in.
+    constexpr static uint8_t RX_QUEUE_SIZE = 64;
+
+  private:
+    /// Find the mapping for the given MIDI message, or nullptr if there is
+    /// none.
+    const OSC_Mapping *find(uint8_t type, uint8_t channel, uint8_t address,
+                            uint8_t cn) const;
+    /// Encode a MIDI message as an OSC message and add it to the bundle.
+    void sendMapped(uint8_t type, uint8_t channel, uint8_t address,
+                    uint16_t value, uint8_t cn);
+    /// Translate an incoming OSC message to MIDI messages.
+    void handleMessage(const OSC_Message &message);
+
+  private:
+    const OSC_Mapping *mappings;
+    size_t mappingCount;
+    uint16_t port;
+    UDP_Endpoint remote;
+    UDP_Endpoint lastSender = {{0, 0, 0, 0}, 0};
+    UDP_Socket socket;
+    OSC_MIDI_Parser parser;
+
+    uint8_t txBuffer[TX_BUFFER_SIZE];
+    OSC_Writer writer;
+    uint8_t rxBuffer[RX_BUFFER_SIZE];
+    ChannelMessage rxQueue[RX_QUEUE_SIZE];
+    uint8_t rxQueueLength = 0;
+    uint8_t rxQueueIndex = 0;
+
+    uint32_t packetsSent = 0;
+    uint32_t messagesSent = 0;
+    uint32_t packetsReceived = 0;
+    uint32_t messagesReceived = 0;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
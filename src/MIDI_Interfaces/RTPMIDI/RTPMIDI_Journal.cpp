@@ -0,0 +1,342 @@
+#include "RTPMIDI_Journal.hpp"
+#include <MIDI_Parsers/MIDI_Parser.hpp> // NOTE_ON etc.
+#include <string.h> // memset
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+// Table of contents of a channel journal
+constexpr uint8_t ChapterP = 0x80;
+constexpr uint8_t ChapterC = 0x40;
+constexpr uint8_t ChapterM = 0x20;
+constexpr uint8_t ChapterW = 0x10;
+constexpr uint8_t ChapterN = 0x08;
+
+bool getBit(const uint32_t (&bits)[4], uint8_t i) {
+    return bits[i >> 5] & (uint32_t(1) << (i & 31));
+}
+void setBit(uint32_t (&bits)[4], uint8_t i) {
+    bits[i >> 5] |= uint32_t(1) << (i & 31);
+}
+bool anyBit(const uint32_t (&bits)[4]) {
+    return (bits[0] | bits[1] | bits[2] | bits[3]) != 0;
+}
+
+} // namespace
+
+// -------------------------------- SENDING --------------------------------- //
+
+void RTPMIDI_JournalSender::reset() {
+    memset(channels, 0, sizeof(channels));
+    for (Channel &channel : channels)
+        channel.pitchBend = 0x2000;
+    activeChannels = 0;
+    checkpoint = 0;
+}
+
+void RTPMIDI_JournalSender::record(ChannelMessage msg, uint16_t seqnum) {
+    uint8_t c = msg.header & 0x0F;
+    Channel &channel = channels[c];
+    switch (msg.header & 0xF0) {
+        case NOTE_OFF:
+            channel.velocities[msg.data1] = 0;
+            setBit(channel.dirtyNotes, msg.data1);
+            break;
+        case NOTE_ON:
+            channel.velocities[msg.data1] = msg.data2;
+            setBit(channel.dirtyNotes, msg.data1);
+            break;
+        case CONTROL_CHANGE:
+            channel.controllers[msg.data1] = msg.data2;
+            setBit(channel.dirtyControllers, msg.data1);
+            break;
+        case PROGRAM_CHANGE:
+            channel.program = msg.data1;
+            channel.dirtyChapters |= ChapterP;
+            break;
+        case PITCH_BEND:
+            channel.pitchBend = msg.data1 | uint16_t(msg.data2) << 7;
+            channel.dirtyChapters |= ChapterW;
+            break;
+        default: return; // not journalled
+    }
+    if (activeChannels == 0)
+        checkpoint = seqnum;
+    activeChannels |= 1u << c;
+    channel.lastSeqnum = seqnum;
+}
+
+void RTPMIDI_JournalSender::acknowledge(uint16_t seqnum) {
+    for (uint8_t c = 0; c < 16; ++c) {
+        Channel &channel = channels[c];
+        if (!(activeChannels & (1u << c)))
+            continue;
+        if (int16_t(seqnum - channel.lastSeqnum) < 0)
+            continue; // the channel has newer history
+        memset(channel.dirtyControllers, 0, sizeof(channel.dirtyControllers));
+        memset(channel.dirtyNotes, 0, sizeof(channel.dirtyNotes));
+        channel.dirtyChapters = 0;
+        activeChannels &= ~(1u << c);
+    }
+    if (activeChannels != 0 && int16_t(seqnum + 1 - checkpoint) > 0)
+        checkpoint = seqnum + 1;
+}
+
+size_t RTPMIDI_JournalSender::encode(uint8_t *buffer, size_t size) const {
+    if (activeChannels == 0 || size < 3)
+        return 0;
+    // Recovery journal header: S Y A H TOTCHAN, checkpoint packet seqnum
+    uint8_t totchan = 0;
+    for (uint8_t c = 0; c < 16; ++c)
+        totchan += (activeChannels >> c) & 1;
+    buffer[0] = 0x20 | (totchan - 1);
+    buffer[1] = checkpoint >> 8;
+    buffer[2] = checkpoint & 0xFF;
+    size_t length = 3;
+    for (uint8_t c = 0; c < 16; ++c) {
+        if (!(activeChannels & (1u << c)))
+            continue;
+        size_t channelLength = encode(c, buffer + length, size - length);
+        if (channelLength == 0)
+            return 0;
+        length += channelLength;
+    }
+    return length;
+}
+
+size_t RTPMIDI_JournalSender::encode(uint8_t c, uint8_t *buffer,
+                                     size_t size) const {
+    const Channel &channel = channels[c];
+    uint8_t *out = buffer + 3;
+    uint8_t *end = buffer + size;
+    uint8_t toc = 0;
+    if (size < 3)
+        return 0;
+
+    // Chapter P: program, bank MSB and LSB (unused)
+    if (channel.dirtyChapters & ChapterP) {
+        if (end - out < 3)
+            return 0;
+        *out++ = channel.program;
+        *out++ = 0x00;
+        *out++ = 0x00;
+        toc |= ChapterP;
+    }
+    // Chapter C: a list of controller numbers and values
+    if (anyBit(channel.dirtyControllers)) {
+        if (end - out < 1)
+            return 0;
+        uint8_t *header = out++;
+        uint8_t count = 0;
+        for (uint8_t i = 0; i < 128; ++i) {
+            if (!getBit(channel.dirtyControllers, i))
+                continue;
+            if (end - out < 2)
+                return 0;
+            *out++ = i;
+            *out++ = channel.controllers[i];
+            ++count;
+        }
+        *header = count - 1;
+        toc |= ChapterC;
+    }
+    // Chapter W: pitch bend LSB and MSB
+    if (channel.dirtyChapters & ChapterW) {
+        if (end - out < 2)
+            return 0;
+        *out++ = channel.pitchBend & 0x7F;
+        *out++ = channel.pitchBend >> 7;
+        toc |= ChapterW;
+    }
+    // Chapter N: a log of the notes that are on, followed by a bit field of
+    // the notes that were turned off
+    if (anyBit(channel.dirtyNotes)) {
+        if (end - out < 2)
+            return 0;
+        uint8_t *header = out;
+        out += 2;
+        uint8_t logs = 0, low = 15, high = 0;
+        for (uint8_t i = 0; i < 128; ++i) {
+            if (!getBit(channel.dirtyNotes, i))
+                continue;
+            uint8_t velocity = channel.velocities[i];
+            if (velocity == 0) {
+                low = low < i / 8 ? low : i / 8;
+                high = high > i / 8 ? high : i / 8;
+                continue;
+            }
+            if (end - out < 2)
+                return 0;
+            *out++ = i;
+            *out++ = 0x80 | velocity; // Y: recommended to play
+            ++logs;
+        }
+        if (low <= high) {
+            if (end - out < high - low + 1)
+                return 0;
+            for (uint8_t octet = low; octet <= high; ++octet) {
+                uint8_t bits = 0;
+                for (uint8_t j = 0; j < 8; ++j) {
+                    uint8_t i = octet * 8 + j;
+                    if (getBit(channel.dirtyNotes, i) &&
+                        channel.velocities[i] == 0)
+                        bits |= 0x80 >> j;
+                }
+                *out++ = bits;
+            }
+        } else if (logs == 127) {
+            // LOW = 15 and HIGH = 0 with LEN = 127 means 128 logs
+            high = 1;
+        }
+        header[0] = logs == 128 ? 127 : logs;
+        header[1] = low << 4 | high;
+        toc |= ChapterN;
+    }
+
+    // Channel journal header: S CHAN H LENGTH, table of contents
+    size_t length = out - buffer;
+    buffer[0] = c << 3 | length >> 8;
+    buffer[1] = length & 0xFF;
+    buffer[2] = toc;
+    return length;
+}
+
+// ------------------------------- RECEIVING -------------------------------- //
+
+void RTPMIDI_JournalReceiver::reset() {
+    for (Channel &channel : channels) {
+        memset(channel.controllers, 0xFF, sizeof(channel.controllers));
+        memset(channel.velocities, 0x00, sizeof(channel.velocities));
+        channel.pitchBend = 0xFFFF;
+        channel.program = 0xFF;
+    }
+}
+
+void RTPMIDI_JournalReceiver::update(ChannelMessage msg) {
+    Channel &channel = channels[msg.header & 0x0F];
+    switch (msg.header & 0xF0) {
+        case NOTE_OFF: channel.velocities[msg.data1] = 0; break;
+        case NOTE_ON: channel.velocities[msg.data1] = msg.data2; break;
+        case CONTROL_CHANGE:
+            channel.controllers[msg.data1] = msg.data2;
+            break;
+        case PROGRAM_CHANGE: channel.program = msg.data1; break;
+        case PITCH_BEND:
+            channel.pitchBend = msg.data1 | uint16_t(msg.data2) << 7;
+            break;
+        default: break;
+    }
+}
+
+size_t RTPMIDI_JournalReceiver::recover(const uint8_t *journal, size_t length,
+                                        uint8_t *out, size_t size) {
+    const uint8_t *pos = journal;
+    const uint8_t *end = journal + length;
+    size_t written = 0;
+    auto emit = [&](uint8_t header, uint8_t data1, uint8_t data2) {
+        bool twoBytes = (header & 0xE0) == 0xC0;
+        if (size - written < (twoBytes ? 2u : 3u))
+            return;
+        out[written++] = header;
+        out[written++] = data1;
+        if (!twoBytes)
+            out[written++] = data2;
+        update({header, data1, data2, 0});
+    };
+
+    if (length < 3)
+        return 0;
+    uint8_t header = pos[0];
+    pos += 3;
+    // Skip the system journal
+    if (header & 0x40) {
+        if (end - pos < 2)
+            return 0;
+        size_t systemLength = (pos[0] & 0x03) << 8 | pos[1];
+        if (systemLength > size_t(end - pos))
+            return 0;
+        pos += systemLength;
+    }
+    if (!(header & 0x20))
+        return 0;
+
+    uint8_t totchan = (header & 0x0F) + 1;
+    for (uint8_t i = 0; i < totchan && end - pos >= 3; ++i) {
+        uint8_t c = (pos[0] >> 3) & 0x0F;
+        size_t channelLength = (pos[0] & 0x03) << 8 | pos[1];
+        uint8_t toc = pos[2];
+        if (channelLength < 3 || channelLength > size_t(end - pos))
+            break;
+        const uint8_t *q = pos + 3;
+        const uint8_t *channelEnd = pos + channelLength;
+        pos = channelEnd;
+        Channel &channel = channels[c];
+
+        if (toc & ChapterP) {
+            if (channelEnd - q < 3)
+                continue;
+            uint8_t program = q[0] & 0x7F;
+            q += 3;
+            if (channel.program != program)
+                emit(PROGRAM_CHANGE | c, program, 0);
+        }
+        if (toc & ChapterC) {
+            if (channelEnd - q < 1)
+                continue;
+            uint8_t count = (*q++ & 0x7F) + 1;
+            if (channelEnd - q < 2 * count)
+                continue;
+            for (uint8_t j = 0; j < count; ++j, q += 2) {
+                uint8_t controller = q[0] & 0x7F;
+                uint8_t value = q[1] & 0x7F;
+                bool alternative = q[1] & 0x80; // toggle/count, not supported
+                if (!alternative && channel.controllers[controller] != value)
+                    emit(CONTROL_CHANGE | c, controller, value);
+            }
+        }
+        if (toc & ChapterM) {
+            if (channelEnd - q < 2)
+                continue;
+            q += (q[0] & 0x03) << 8 | q[1];
+        }
+        if (toc & ChapterW) {
+            if (channelEnd - q < 2)
+                continue;
+            uint16_t pitchBend = (q[0] & 0x7F) | uint16_t(q[1] & 0x7F) << 7;
+            q += 2;
+            if (channel.pitchBend != pitchBend)
+                emit(PITCH_BEND | c, pitchBend & 0x7F, pitchBend >> 7);
+        }
+        if (toc & ChapterN) {
+            if (channelEnd - q < 2)
+                continue;
+            uint8_t len = q[0] & 0x7F;
+            uint8_t low = q[1] >> 4, high = q[1] & 0x0F;
+            q += 2;
+            uint8_t logs = len;
+            bool allLogs = len == 127 && low == 15 && high == 0;
+            if (channelEnd - q < 2 * logs + allLogs * 2)
+                continue;
+            for (uint8_t j = 0; j < logs + allLogs; ++j, q += 2) {
+                uint8_t note = q[0] & 0x7F;
+                uint8_t velocity = q[1] & 0x7F;
+                if (velocity > 0 && channel.velocities[note] == 0)
+                    emit(NOTE_ON | c, note, velocity);
+            }
+            if (low > high || channelEnd - q < high - low + 1)
+                continue;
+            for (uint8_t octet = low; octet <= high; ++octet) {
+                uint8_t bits = *q++;
+                for (uint8_t j = 0; j < 8; ++j) {
+                    uint8_t note = octet * 8 + j;
+                    if ((bits & (0x80 >> j)) && channel.velocities[note] != 0)
+                        emit(NOTE_OFF | c, note, 0x40);
+                }
+            }
+        }
+    }
+    return written;
+}
+
+END_CS_NAMESPACE
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+#include <MIDI_Parsers/MIDI_MessageTypes.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   The sending side of the RTP-MIDI recovery journal (RFC 6295).
+ *
+ * Keeps track of the channel messages that were sent since the last
+ * checkpoint, i.e. the last packet the receiver has acknowledged, so they can
+ * be added to every new packet. This allows the receiver to repair its state
+ * when packets are lost.
+ *
+ * Only the chapters for Program Change (P), Control Change (C), Pitch Wheel
+ * (W) and Note On/Off (N) are supported, the other messages are not
+ * journalled.
+ */
+class RTPMIDI_JournalSender {
+  public:
+    RTPMIDI_JournalSender() { reset(); }
+
+    /// Forget all history.
+    void reset();
+
+    /**
+     * @brief   Add a channel message to the journal.
+     *
+     * @param   msg
+     *          The message that was sent.
+     * @param   seqnum
+     *          The RTP sequence number of the packet it was sent in.
+     */
+    void record(ChannelMessage msg, uint16_t seqnum);
+
+    /// Drop the history of all packets up to and including the given sequence
+    /// number, because the receiver has received them.
+    void acknowledge(uint16_t seqnum);
+
+    /// Check whether there's any history to send.
+    bool empty() const { return activeChannels == 0; }
+
+    /**
+     * @brief   Encode the journal.
+     *
+     * @param   buffer
+     *          The buffer to write the journal to.
+     * @param   size
+     *          The size of the buffer.
+     * @return  The length of the journal, or zero if it is empty or if it
+     *          doesn't fit in the buffer.
+     */
+    size_t encode(uint8_t *buffer, size_t size) const;
+
+  private:
+    struct Channel {
+        uint8_t controllers[128];
+        uint8_t velocities[128];
+        uint32_t dirtyControllers[4];
+        uint32_t dirtyNotes[4];
+        uint16_t pitchBend;
+        uint16_t lastSeqnum;
+        uint8_t program;
+        uint8_t dirtyChapters;
+    };
+
+    size_t encode(uint8_t c, uint8_t *buffer, size_t size) const;
+
+    Channel channels[16];
+    /// Bit mask of the channels that have history.
+    uint16_t activeChannels;
+    /// Sequence number of the oldest packet in the journal.
+    uint16_t checkpoint;
+};
+
+/**
+ * @brief   The receiving side of the RTP-MIDI recovery journal (RFC 6295).
+ *
+ * Keeps track of the state of all channels, so the difference with the state
+ * in the journal of a packet can be computed after packets have been lost.
+ *
+ * @see     RTPMIDI_JournalSender
+ */
+class RTPMIDI_JournalReceiver {
+  public:
+    RTPMIDI_JournalReceiver() { reset(); }
+
+    /// Forget the state of all channels.
+    void reset();
+
+    /// Update the state with a channel message that was received.
+    void update(ChannelMessage msg);
+
+    /**
+     * @brief   Compare the state in the given journal to the current state,
+     *          and write the MIDI messages that are required to repair it.
+     *
+     * @param   journal
+     *          The recovery journal of the first packet after the loss.
+     * @param   length
+     *          The length of the journal.
+     * @param   out
+     *          The buffer to write the MIDI messages to (with status bytes).
+     * @param   size
+     *          The size of the buffer. Messages that don't fit are dropped.
+     * @return  The number of bytes written to @p out.
+     */
+    size_t recover(const uint8_t *journal, size_t length, uint8_t *out,
+                   size_t size);
+
+    /// Get the last known value of the given controller (0xFF if unknown).
+    uint8_t getController(uint8_t channel, uint8_t controller) const {
+        return channels[channel].controllers[controller];
+    }
+    /// Get the velocity of the given note (0 if it is off).
+    uint8_t getVelocity(uint8_t channel, uint8_t note) const {
+        return channels[channel].velocities[note];
+    }
+
+  private:
+    struct Channel {
+        uint8_t controllers[128];
+        uint8_t velocities[128];
+        uint16_t pitchBend;
+        uint8_t program;
+    };
+
+    Channel channels[16];
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,542 @@
+#if !defined(ARDUINO) || defined(ESP32)
+
+#include "RTPMIDI_Interface.hpp"
+#include <AH/Arduino-Wrapper.h> // micros
+#include <AH/Debug/Debug.hpp>
+#include <string.h> // memcpy, strncpy
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+uint16_t readBE16(const uint8_t *p) { return uint16_t(p[0]) << 8 | p[1]; }
+uint32_t readBE32(const uint8_t *p) {
+    return uint32_t(readBE16(p)) << 16 | readBE16(p + 2);
+}
+uint64_t readBE64(const uint8_t *p) {
+    return uint64_t(readBE32(p)) << 32 | readBE32(p + 4);
+}
+uint8_t *writeBE16(uint8_t *p, uint16_t v) {
+    *p++ = v >> 8;
+    *p++ = v & 0xFF;
+    return p;
+}
+uint8_t *writeBE32(uint8_t *p, uint32_t v) {
+    return writeBE16(writeBE16(p, v >> 16), v & 0xFFFF);
+}
+uint8_t *writeBE64(uint8_t *p, uint64_t v) {
+    return writeBE32(writeBE32(p, v >> 32), v & 0xFFFFFFFF);
+}
+
+/// Make a pseudo-random 32-bit number from the given seed.
+uint32_t mix(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7FEB352D;
+    x ^= x >> 15;
+    x *= 0x846CA68B;
+    x ^= x >> 16;
+    return x;
+}
+
+// The RTP payload type used by Apple, and the flags of the MIDI command
+// section header.
+constexpr uint8_t PayloadType = 0x61;
+constexpr uint8_t FlagB = 0x80; ///< Long header (12-bit length)
+constexpr uint8_t FlagJ = 0x40; ///< Recovery journal present
+constexpr uint8_t FlagZ = 0x20; ///< First command has a delta time
+
+constexpr uint16_t command(char c1, char c2) {
+    return uint16_t(uint8_t(c1)) << 8 | uint8_t(c2);
+}
+
+/**
+ * Call the callback for each command in the MIDI list of an RTP-MIDI packet,
+ * with its status, a pointer to its data bytes and the number of data bytes.
+ * The data of System Exclusive segments includes the status byte that ends
+ * the segment (0xF0, 0xF7 or 0xF4).
+ */
+template <class Callback>
+void forEachCommand(const uint8_t *pos, const uint8_t *end, bool delta,
+                    uint8_t &runningStatus, Callback &&callback) {
+    while (pos < end) {
+        if (delta) // Skip the delta time (variable length quantity)
+            for (uint8_t i = 0; i < 4 && pos < end; ++i)
+                if ((*pos++ & 0x80) == 0)
+                    break;
+        delta = true;
+        if (pos >= end)
+            return;
+        uint8_t status = *pos;
+        if (status & 0x80)
+            ++pos;
+        else if (runningStatus != 0)
+            status = runningStatus;
+        else
+            return; // data byte without running status
+        const uint8_t *data = pos;
+        if (status < 0xF0) {
+            runningStatus = status;
+            pos += (status & 0xE0) == 0xC0 ? 1 : 2;
+        } else if (status == SysExStart || status == SysExEnd) {
+            while (pos < end && (*pos & 0x80) == 0)
+                ++pos;
+            ++pos; // status byte that ends the segment
+        } else if (status == 0xF2) { // Song Position Pointer
+            pos += 2;
+        } else if (status == 0xF1 || status == 0xF3) { // MTC, Song Select
+            pos += 1;
+        }
+        if (pos > end)
+            return;
+        callback(status, data, size_t(pos - data));
+    }
+}
+
+} // namespace
+
+RTPMIDI_Interface::RTPMIDI_Interface(const char *name, uint16_t port)
+    : Parsing_MIDI_Interface(parser), name(name), port(port) {}
+
+RTPMIDI_Interface::~RTPMIDI_Interface() { disconnect(); }
+
+void RTPMIDI_Interface::begin() {
+    if (!controlSocket.begin(port) || !dataSocket.begin(port + 1))
+        DEBUGFN(F("Failed to open the RTP-MIDI sockets on port ") << port);
+    ssrc = mix(uint32_t(micros()) ^ uint32_t(uintptr_t(this)));
+}
+
+uint64_t RTPMIDI_Interface::getSessionTime() {
+    uint32_t now = micros();
+    if (now < lastMicros)
+        microsHigh += uint64_t(1) << 32;
+    lastMicros = now;
+    return (microsHigh + now) / 100;
+}
+
+// -------------------------------- SESSION --------------------------------- //
+
+void RTPMIDI_Interface::connect(UDP_Endpoint peer) {
+    disconnect();
+    peerControl = peer;
+    peerData = {{peer.address[0], peer.address[1], peer.address[2],
+                 peer.address[3]},
+                uint16_t(peer.port + 1)};
+    initiator = true;
+    token = mix(ssrc ^ uint32_t(micros()));
+    state = InvitingControl;
+    inviteAttempts = 0;
+    sendInvitation();
+}
+
+void RTPMIDI_Interface::disconnect() {
+    if (state != Idle && state != InvitingControl)
+        sendSessionCommand(false, peerControl, command('B', 'Y'), token);
+    resetSession();
+}
+
+void RTPMIDI_Interface::resetSession() {
+    state = Idle;
+    peerSSRC = 0;
+    peerName[0] = '\0';
+    commandLength = 0;
+}
+
+void RTPMIDI_Interface::onConnect() {
+    state = Connected;
+    journalSender.reset();
+    journalReceiver.reset();
+    receivedAny = false;
+    feedbackPending = false;
+    rxRunningStatus = 0;
+    commandLength = 0;
+    txSeqnum = mix(ssrc + 1) & 0xFFFF;
+    lastSync = lastFeedback = micros();
+    if (initiator)
+        sendSync(0, getSessionTime(), 0, 0);
+}
+
+void RTPMIDI_Interface::update() {
+    uint32_t now = micros();
+    if (state == InvitingControl || state == InvitingData) {
+        if (now - lastInvite >= INVITE_INTERVAL) {
+            if (++inviteAttempts >= INVITE_ATTEMPTS) {
+                DEBUGFN(F("RTP-MIDI peer did not respond"));
+                resetSession();
+            } else {
+                sendInvitation();
+            }
+        }
+    } else if (state == Connected) {
+        if (initiator && now - lastSync >= SYNC_INTERVAL) {
+            lastSync = now;
+            sendSync(0, getSessionTime(), 0, 0);
+        }
+        if (feedbackPending && now - lastFeedback >= FEEDBACK_INTERVAL)
+            sendFeedback();
+        if (commandLength > 0 && now - batchStart >= batchTime)
+            flush();
+    }
+    Parsing_MIDI_Interface::update();
+}
+
+void RTPMIDI_Interface::sendSessionCommand(bool dataPort,
+                                           const UDP_Endpoint &to,
+                                           uint16_t cmd,
+                                           uint32_t initiatorToken) {
+    // Exchange packet: signature, command, protocol version, initiator token,
+    // SSRC, name
+    uint8_t buffer[16 + NAME_SIZE];
+    uint8_t *p = writeBE16(buffer, 0xFFFF);
+    p = writeBE16(p, cmd);
+    p = writeBE32(p, 2);
+    p = writeBE32(p, initiatorToken);
+    p = writeBE32(p, ssrc);
+    if (cmd != command('B', 'Y')) {
+        strncpy(reinterpret_cast<char *>(p), name, NAME_SIZE - 1);
+        p[NAME_SIZE - 1] = '\0';
+        p += strlen(reinterpret_cast<char *>(p)) + 1;
+    }
+    (dataPort ? dataSocket : controlSocket).send(to, buffer, p - buffer);
+}
+
+void RTPMIDI_Interface::sendInvitation() {
+    lastInvite = micros();
+    bool dataPort = state == InvitingData;
+    sendSessionCommand(dataPort, dataPort ? peerData : peerControl,
+                       command('I', 'N'), token);
+}
+
+void RTPMIDI_Interface::sendSync(uint8_t count, uint64_t ts1, uint64_t ts2,
+                                 uint64_t ts3) {
+    uint8_t buffer[36] = {};
+    uint8_t *p = writeBE16(buffer, 0xFFFF);
+    p = writeBE16(p, command('C', 'K'));
+    p = writeBE32(p, ssrc);
+    *p = count;
+    p += 4;
+    p = writeBE64(p, ts1);
+    p = writeBE64(p, ts2);
+    p = writeBE64(p, ts3);
+    dataSocket.send(peerData, buffer, sizeof(buffer));
+}
+
+void RTPMIDI_Interface::sendFeedback() {
+    // Receiver feedback: acknowledges all packets up to the given seqnum, so
+    // the sender can trim its recovery journal
+    uint8_t buffer[12] = {};
+    uint8_t *p = writeBE16(buffer, 0xFFFF);
+    p = writeBE16(p, command('R', 'S'));
+    p = writeBE32(p, ssrc);
+    writeBE16(p, lastReceivedSeqnum);
+    controlSocket.send(peerControl, buffer, sizeof(buffer));
+    feedbackPending = false;
+    lastFeedback = micros();
+}
+
+bool RTPMIDI_Interface::handleSessionPacket(const uint8_t *data, size_t length,
+                                            const UDP_Endpoint &from,
+                                            bool dataPort) {
+    if (length < 4 || readBE16(data) != 0xFFFF)
+        return false;
+    uint16_t cmd = readBE16(data + 2);
+
+    if (cmd == command('C', 'K')) {
+        handleSync(data, length);
+    } else if (cmd == command('R', 'S')) {
+        if (length >= 10 && readBE32(data + 4) == peerSSRC)
+            journalSender.acknowledge(readBE16(data + 8));
+    } else if (length >= 16) {
+        uint32_t theirToken = readBE32(data + 8);
+        uint32_t theirSSRC = readBE32(data + 12);
+        auto copyName = [&] {
+            size_t nameLength = length - 16;
+            nameLength = nameLength < NAME_SIZE - 1 ? nameLength : NAME_SIZE - 1;
+            memcpy(peerName, data + 16, nameLength);
+            peerName[nameLength] = '\0';
+        };
+        if (cmd == command('I', 'N')) {
+            if (!dataPort && (state == Idle || theirSSRC == peerSSRC)) {
+                // Accept the invitation on the control port
+                initiator = false;
+                peerControl = from;
+                peerSSRC = theirSSRC;
+                token = theirToken;
+                copyName();
+                state = state == Connected ? Connected : AwaitingData;
+                sendSessionCommand(false, from, command('O', 'K'), token);
+            } else if (dataPort && state >= AwaitingData && !initiator &&
+                       theirSSRC == peerSSRC && from.sameAddress(peerControl)) {
+                // Accept the invitation on the data port
+                peerData = from;
+                sendSessionCommand(true, from, command('O', 'K'), token);
+                if (state == AwaitingData)
+                    onConnect();
+            } else {
+                // Already in a session with someone else
+                sendSessionCommand(dataPort, from, command('N', 'O'),
+                                   theirToken);
+            }
+        } else if (cmd == command('O', 'K') && theirToken == token) {
+            if (!dataPort && state == InvitingControl) {
+                peerSSRC = theirSSRC;
+                copyName();
+                state = InvitingData;
+                inviteAttempts = 0;
+                sendInvitation();
+            } else if (dataPort && state == InvitingData &&
+                       theirSSRC == peerSSRC) {
+                onConnect();
+            }
+        } else if (cmd == command('N', 'O') && theirToken == token) {
+            if (state == InvitingControl || state == InvitingData) {
+                DEBUGFN(F("RTP-MIDI invitation rejected"));
+                resetSession();
+            }
+        } else if (cmd == command('B', 'Y') && theirSSRC == peerSSRC) {
+            resetSession();
+        }
+    }
+    return true;
+}
+
+void RTPMIDI_Interface::handleSync(const uint8_t *data, size_t length) {
+    if (length < 36 || state != Connected || readBE32(data + 4) != peerSSRC)
+        return;
+    uint8_t count = data[8];
+    uint64_t ts1 = readBE64(data + 12);
+    uint64_t ts2 = readBE64(data + 20);
+    uint64_t ts3 = readBE64(data + 28);
+    uint64_t now = getSessionTime();
+    if (count == 0) {
+        sendSync(1, ts1, now, 0);
+    } else if (count == 1) {
+        // We sent ts1 and receive ts3 in our clock, the peer received ts2 in
+        // its clock halfway
+        sendSync(2, ts1, ts2, now);
+        latency = uint32_t(now - ts1) * 50;
+        clockOffset = (int64_t(ts2) - int64_t((ts1 + now) / 2)) * 100;
+    } else if (count == 2) {
+        latency = uint32_t(now - ts2) * 50;
+        clockOffset = (int64_t((ts1 + ts3) / 2) - int64_t(ts2)) * 100;
+    }
+}
+
+// ------------------------------- RECEIVING -------------------------------- //
+
+MIDI_read_t RTPMIDI_Interface::read() {
+    while (true) {
+        while (rxIndex < rxLength) {
+            MIDI_read_t event = parser.parse(rxBuffer[rxIndex++]);
+            if (event != NO_MESSAGE)
+                return event;
+        }
+        if (!receive())
+            return NO_MESSAGE;
+    }
+}
+
+bool RTPMIDI_Interface::receive() {
+    UDP_Endpoint from;
+    size_t length;
+    while ((length = controlSocket.receive(datagram, PACKET_SIZE, from)) > 0)
+        handleSessionPacket(datagram, length, from, false);
+    while ((length = dataSocket.receive(datagram, PACKET_SIZE, from)) > 0)
+        if (!handleSessionPacket(datagram, length, from, true) &&
+            handleRTPPacket(datagram, length))
+            return true;
+    return false;
+}
+
+bool RTPMIDI_Interface::handleRTPPacket(const uint8_t *data, size_t length) {
+    if (state != Connected || length < 13 || (data[0] & 0xC0) != 0x80 ||
+        (data[1] & 0x7F) != PayloadType || readBE32(data + 8) != peerSSRC)
+        return false;
+    uint16_t seqnum = readBE16(data + 2);
+    uint8_t flags = data[12];
+    size_t pos = 13;
+    size_t commandsLength = flags & 0x0F;
+    if (flags & FlagB) {
+        if (length < 14)
+            return false;
+        commandsLength = commandsLength << 8 | data[13];
+        pos = 14;
+    }
+    if (commandsLength > length - pos)
+        return false;
+
+    rxIndex = rxLength = 0;
+    if (receivedAny) {
+        int16_t gap = seqnum - expectedSeqnum;
+        if (gap < 0) // duplicate or out of order
+            return false;
+        if (gap > 0) {
+            packetsLost += gap;
+            if (flags & FlagJ) {
+                size_t journal = pos + commandsLength;
+                rxLength = journalReceiver.recover(
+                    data + journal, length - journal, rxBuffer, RX_BUFFER_SIZE);
+                ++recoveries;
+            }
+        }
+    }
+    receivedAny = true;
+    expectedSeqnum = seqnum + 1;
+    lastReceivedSeqnum = seqnum;
+    feedbackPending = true;
+    ++packetsReceived;
+    decodeCommands(data + pos, commandsLength, flags & FlagZ);
+    return true;
+}
+
+void RTPMIDI_Interface::decodeCommands(const uint8_t *data, size_t length,
+                                       bool delta) {
+    auto handle = [this](uint8_t status, const uint8_t *cmd, size_t len) {
+        if (status == SysExStart || status == SysExEnd) {
+            // A segment ends in 0xF7, or in 0xF0 if the message continues in
+            // the next packet. Continuation segments start with 0xF7.
+            bool last = cmd[len - 1] != SysExStart;
+            if (status == SysExStart)
+                putReceived(SysExStart);
+            for (size_t i = 0; i + 1 < len; ++i)
+                putReceived(cmd[i]);
+            if (last)
+                putReceived(SysExEnd);
+            return;
+        }
+        putReceived(status);
+        for (size_t i = 0; i < len; ++i)
+            putReceived(cmd[i]);
+        if (status < 0xF0)
+            journalReceiver.update({status, cmd[0],
+                                    uint8_t(len > 1 ? cmd[1] : 0), 0});
+    };
+    forEachCommand(data, data + length, delta, rxRunningStatus, handle);
+}
+
+// -------------------------------- SENDING --------------------------------- //
+
+void RTPMIDI_Interface::sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t d2,
+                                 uint8_t cn) {
+    (void)cn;
+    uint8_t msg[3] = {uint8_t(m | c), d1, d2};
+    addCommand(msg, 3);
+}
+
+void RTPMIDI_Interface::sendImpl(uint8_t m, uint8_t c, uint8_t d1,
+                                 uint8_t cn) {
+    (void)cn;
+    uint8_t msg[2] = {uint8_t(m | c), d1};
+    addCommand(msg, 2);
+}
+
+void RTPMIDI_Interface::sendImpl(const uint8_t *data, size_t length,
+                                 uint8_t cn) {
+    (void)cn;
+    addCommand(data, length);
+}
+
+void RTPMIDI_Interface::sendImpl(uint8_t rt, uint8_t cn) {
+    (void)cn;
+    addCommand(&rt, 1);
+}
+
+void RTPMIDI_Interface::addCommand(const uint8_t *data, size_t length) {
+#if defined(ESP32) || !defined(ARDUINO)
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+    if (state != Connected || length == 0)
+        return;
+    // Up to 4 bytes for the delta time
+    if (length + 4 > COMMAND_BUFFER_SIZE) {
+        DEBUGFN(F("MIDI message too long for RTP-MIDI packet"));
+        return;
+    }
+    if (commandLength + length + 4 > COMMAND_BUFFER_SIZE)
+        flushImpl();
+
+    uint64_t timestamp = getSessionTime();
+    if (commandLength == 0) {
+        // The first command has no delta time, its time is the RTP timestamp
+        batchTimestamp = timestamp;
+        batchStart = lastMicros;
+        txRunningStatus = 0;
+    } else {
+        uint32_t delta = timestamp - lastCommandTimestamp;
+        delta = delta < 0x0FFFFFFF ? delta : 0x0FFFFFFF;
+        for (uint8_t shift = 21; shift > 0; shift -= 7)
+            if (delta >> shift)
+                commands[commandLength++] = 0x80 | ((delta >> shift) & 0x7F);
+        commands[commandLength++] = delta & 0x7F;
+    }
+    lastCommandTimestamp = timestamp;
+
+    uint8_t status = data[0];
+    if (status < 0xF0 && status == txRunningStatus) {
+        ++data; // running status
+        --length;
+    } else if (status < 0xF8) { // real-time messages don't affect it
+        txRunningStatus = status < 0xF0 ? status : 0;
+    }
+    memcpy(commands + commandLength, data, length);
+    commandLength += length;
+
+    if (batchTime == 0)
+        flushImpl();
+}
+
+void RTPMIDI_Interface::flush() {
+#if defined(ESP32) || !defined(ARDUINO)
+    std::lock_guard<std::mutex> lock(mutex);
+#endif
+    flushImpl();
+}
+
+void RTPMIDI_Interface::flushImpl() {
+    if (commandLength == 0)
+        return;
+    // RTP header: version 2, payload type, sequence number, timestamp, SSRC
+    uint8_t *p = txPacket;
+    *p++ = 0x80;
+    *p++ = PayloadType;
+    p = writeBE16(p, txSeqnum);
+    p = writeBE32(p, uint32_t(batchTimestamp));
+    p = writeBE32(p, ssrc);
+    // MIDI command section header
+    uint8_t *flags = p;
+    if (commandLength <= 0x0F) {
+        *p++ = commandLength;
+    } else {
+        *p++ = FlagB | commandLength >> 8;
+        *p++ = commandLength & 0xFF;
+    }
+    memcpy(p, commands, commandLength);
+    p += commandLength;
+    // Recovery journal with the history up to the previous packet
+    size_t journalLength =
+        journalSender.encode(p, txPacket + PACKET_SIZE - p);
+    if (journalLength > 0)
+        *flags |= FlagJ;
+    else if (!journalSender.empty())
+        DEBUGFN(F("RTP-MIDI recovery journal too large, not sent"));
+    p += journalLength;
+    dataSocket.send(peerData, txPacket, p - txPacket);
+
+    // Add the commands of this packet to the journal of the next ones
+    uint8_t runningStatus = 0;
+    forEachCommand(commands, commands + commandLength, false, runningStatus,
+                   [this](uint8_t status, const uint8_t *data, size_t length) {
+                       if (status >= 0xF0)
+                           return;
+                       journalSender.record(
+                           {status, data[0],
+                            uint8_t(length > 1 ? data[1] : 0), 0},
+                           txSeqnum);
+                   });
+    ++txSeqnum;
+    ++packetsSent;
+    commandLength = 0;
+}
+
+END_CS_NAMESPACE
+
+#endif
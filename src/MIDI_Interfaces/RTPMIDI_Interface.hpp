@@ -0,0 +1,253 @@
+#pragma once
+
+#include "MIDI_Interface.hpp"
+#include "RTPMIDI/RTPMIDI_Journal.hpp"
+#include "UDP/UDP_Socket.hpp"
+#include <MIDI_Parsers/SerialMIDI_Parser.hpp>
+
+#if defined(ESP32) || !defined(ARDUINO)
+#include <mutex>
+#endif
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   MIDI interface for RTP-MIDI (AppleMIDI) network sessions over UDP,
+ *          for the ESP32 (WiFi) and for the computer.
+ *
+ * The interface listens for session invitations on the given control port and
+ * on the data port right after it (port + 1), and it can invite another
+ * participant itself using @ref connect. Only a single peer is supported.
+ *
+ * Outgoing messages are batched: all messages that are sent within the batch
+ * time (see @ref setBatchTime) are sent in a single packet, with their delta
+ * times and using running status. Every packet carries a recovery journal
+ * with the state of the Note, Control Change, Program Change and Pitch Bend
+ * messages the peer hasn't acknowledged yet, so it can repair its state when
+ * packets are lost. The journal of incoming packets is used in the same way.
+ *
+ * Incoming messages are handled as soon as they arrive, their delta times
+ * are not taken into account.
+ *
+ * ~~~cpp
+ * RTPMIDI_Interface midi {"Control Surface", 5004};
+ *
+ * void setup() {
+ *     WiFi.begin(ssid, password);
+ *     while (WiFi.status() != WL_CONNECTED) delay(100);
+ *     Control_Surface.begin(); // Starts listening for invitations
+ *     // Or invite a session yourself:
+ *     midi.connect({{192, 168, 1, 2}, 5004});
+ * }
+ * ~~~
+ *
+ * @note    The interface uses around 15 KiB of RAM for its buffers and the
+ *          recovery journals.
+ *
+ * @ingroup MIDIInterfaces
+ */
+class RTPMIDI_Interface : public Parsing_MIDI_Interface {
+  public:
+    /**
+     * @brief   Create an RTP-MIDI interface.
+     *
+     * @param   name
+     *          The name of this participant that's shown to the peer.
+     * @param   port
+     *          The UDP control port. The data port is the next port.
+     */
+    RTPMIDI_Interface(const char *name = "Control Surface",
+                      uint16_t port = 5004);
+    /// Ends the session and closes the sockets.
+    ~RTPMIDI_Interface();
+
+    RTPMIDI_Interface(const RTPMIDI_Interface &) = delete;
+    RTPMIDI_Interface &operator=(const RTPMIDI_Interface &) = delete;
+
+    /// Open the UDP sockets.
+    void begin() override;
+    /// Handle the session protocol, send the batched messages that are due,
+    /// and read the incoming messages.
+    void update() override;
+
+    /// @name   Session management
+    /// @{
+
+    /// Invite the participant at the given endpoint (its control port).
+    void connect(UDP_Endpoint peer);
+    /// End the session.
+    void disconnect();
+    /// Check whether a session has been established.
+    bool isConnected() const { return state == Connected; }
+    /// Get the name of the peer.
+    const char *getPeerName() const { return peerName; }
+    /// Get the control endpoint of the peer.
+    UDP_Endpoint getPeer() const { return peerControl; }
+    /// Get the synchronization source identifier of this participant.
+    uint32_t getSSRC() const { return ssrc; }
+
+    /// @}
+
+    /// @name   Batching
+    /// @{
+
+    /// Set the maximum time (in microseconds) outgoing messages are buffered
+    /// before they are sent. Zero sends every message in its own packet.
+    void setBatchTime(unsigned long batchTime) { this->batchTime = batchTime; }
+    /// Send the buffered messages now.
+    void flush();
+
+    /// @}
+
+    /// @name   Statistics
+    /// @{
+
+    /// Get the one-way network latency measured during the last clock
+    /// synchronization, in microseconds.
+    uint32_t getLatency() const { return latency; }
+    /// Get the difference between the clock of the peer and the local clock
+    /// measured during the last synchronization, in microseconds.
+    int64_t getClockOffset() const { return clockOffset; }
+    /// Get the number of RTP-MIDI packets that were sent.
+    uint32_t getPacketsSent() const { return packetsSent; }
+    /// Get the number of RTP-MIDI packets that were received.
+    uint32_t getPacketsReceived() const { return packetsReceived; }
+    /// Get the number of incoming packets that were lost.
+    uint32_t getPacketsLost() const { return packetsLost; }
+    /// Get the number of times the recovery journal was used to repair the
+    /// state after packets were lost.
+    uint32_t getRecoveries() const { return recoveries; }
+
+    /// @}
+
+    MIDI_read_t read() override;
+
+  protected:
+    void sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t d2,
+                  uint8_t cn) override;
+    void sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t cn) override;
+    void sendImpl(const uint8_t *data, size_t length, uint8_t cn) override;
+    void sendImpl(uint8_t rt, uint8_t cn) override;
+
+  public:
+    /// Maximum size of a UDP datagram.
+    constexpr static size_t PACKET_SIZE = 1280;
+    /// Maximum size of the MIDI commands in one packet.
+    constexpr static size_t COMMAND_BUFFER_SIZE = 512;
+    /// Size of the buffer for incoming MIDI data (including the messages
+    /// generated by the recovery journal).
+    constexpr static size_t RX_BUFFER_SIZE = 2048;
+    /// Maximum length of the name of the peer.
+    constexpr static size_t NAME_SIZE = 32;
+    /// Time between two invitations (microseconds).
+    constexpr static uint32_t INVITE_INTERVAL = 1000000;
+    /// Number of invitations before giving up.
+    constexpr static uint8_t INVITE_ATTEMPTS = 12;
+    /// Time between two clock synchronizations (microseconds).
+    constexpr static uint32_t SYNC_INTERVAL = 10000000;
+    /// Time between two receiver feedback messages (microseconds).
+    constexpr static uint32_t FEEDBACK_INTERVAL = 1000000;
+    /// Default maximum time outgoing messages are buffered (microseconds).
+    constexpr static unsigned long DEFAULT_BATCH_TIME = 1000;
+
+  private:
+    enum State : uint8_t {
+        Idle,
+        InvitingControl,
+        InvitingData,
+        AwaitingData,
+        Connected,
+    };
+
+    /// Get the session time, in units of 100 µs.
+    uint64_t getSessionTime();
+
+    /// Read all pending datagrams until an RTP-MIDI packet is found.
+    bool receive();
+    bool handleSessionPacket(const uint8_t *data, size_t length,
+                             const UDP_Endpoint &from, bool dataPort);
+    bool handleRTPPacket(const uint8_t *data, size_t length);
+    void handleSync(const uint8_t *data, size_t length);
+    void decodeCommands(const uint8_t *data, size_t length, bool delta);
+    void putReceived(uint8_t byte) {
+        if (rxLength < RX_BUFFER_SIZE)
+            rxBuffer[rxLength++] = byte;
+    }
+
+    void sendSessionCommand(bool dataPort, const UDP_Endpoint &to,
+                            uint16_t cmd, uint32_t initiatorToken);
+    void sendInvitation();
+    void sendSync(uint8_t count, uint64_t ts1, uint64_t ts2, uint64_t ts3);
+    void sendFeedback();
+    void addCommand(const uint8_t *data, size_t length);
+    void flushImpl();
+    void onConnect();
+    void resetSession();
+
+  private:
+    const char *name;
+    uint16_t port;
+    UDP_Socket controlSocket;
+    UDP_Socket dataSocket;
+    SerialMIDI_Parser parser;
+    RTPMIDI_JournalSender journalSender;
+    RTPMIDI_JournalReceiver journalReceiver;
+
+    // Session
+    State state = Idle;
+    bool initiator = false;
+    UDP_Endpoint peerControl = {{0, 0, 0, 0}, 0};
+    UDP_Endpoint peerData = {{0, 0, 0, 0}, 0};
+    uint32_t ssrc = 0;
+    uint32_t peerSSRC = 0;
+    uint32_t token = 0;
+    char peerName[NAME_SIZE] = {};
+    uint8_t inviteAttempts = 0;
+    uint32_t lastInvite = 0;
+    uint32_t lastSync = 0;
+    uint32_t lastFeedback = 0;
+
+    // Clock
+    uint32_t lastMicros = 0;
+    uint64_t microsHigh = 0;
+    int64_t clockOffset = 0;
+    uint32_t latency = 0;
+
+    // Sending
+    uint8_t commands[COMMAND_BUFFER_SIZE];
+    uint16_t commandLength = 0;
+    uint8_t txRunningStatus = 0;
+    uint16_t txSeqnum = 0;
+    uint64_t batchTimestamp = 0;
+    uint64_t lastCommandTimestamp = 0;
+    uint32_t batchStart = 0;
+    unsigned long batchTime = DEFAULT_BATCH_TIME;
+    uint8_t txPacket[PACKET_SIZE];
+
+    // Receiving
+    uint8_t datagram[PACKET_SIZE];
+    uint8_t rxBuffer[RX_BUFFER_SIZE];
+    uint16_t rxLength = 0;
+    uint16_t rxIndex = 0;
+    uint8_t rxRunningStatus = 0;
+    uint16_t expectedSeqnum = 0;
+    uint16_t lastReceivedSeqnum = 0;
+    bool receivedAny = false;
+    bool feedbackPending = false;
+
+    // Statistics
+    uint32_t packetsSent = 0;
+    uint32_t packetsReceived = 0;
+    uint32_t packetsLost = 0;
+    uint32_t recoveries = 0;
+
+#if defined(ESP32) || !defined(ARDUINO)
+    std::mutex mutex;
+#endif
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,136 @@
+#if !defined(ARDUINO) && !defined(_WIN32)
+
+#include "SharedMemoryRing.hpp"
+#include <new>      // placement new
+#include <string.h> // memcpy
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#else
+#include <chrono>
+#include <thread>
+#endif
+
+BEGIN_CS_NAMESPACE
+
+void SharedMemoryRing::initialize(void *memory, uint32_t capacity) {
+    Header *header = new (memory) Header;
+    header->capacity = capacity;
+    header->head.store(0, std::memory_order_relaxed);
+    header->tail.store(0, std::memory_order_relaxed);
+    header->sequence.store(0, std::memory_order_relaxed);
+    header->waiting.store(0, std::memory_order_release);
+}
+
+void SharedMemoryRing::attach(void *memory) {
+    header = static_cast<Header *>(memory);
+    buffer = static_cast<uint8_t *>(memory) + sizeof(Header);
+}
+
+// -------------------------------- PRODUCER -------------------------------- //
+
+bool SharedMemoryRing::write(uint8_t type, uint8_t cable, const uint8_t *data,
+                             uint16_t length) {
+    uint32_t capacity = header->capacity;
+    uint32_t head = header->head.load(std::memory_order_relaxed);
+    uint32_t tail = header->tail.load(std::memory_order_acquire);
+    uint32_t size = recordSize(length);
+    uint32_t contiguous = capacity - (head & (capacity - 1));
+    uint32_t needed = size <= contiguous ? size : contiguous + size;
+    if (needed > capacity - (head - tail))
+        return false;
+
+    if (size > contiguous) {
+        // Fill the rest of the buffer with padding and wrap around
+        Record padding = {uint16_t(contiguous - sizeof(Record)), PaddingType,
+                          0};
+        memcpy(at(head), &padding, sizeof(padding));
+        head += contiguous;
+    }
+    Record record = {length, type, cable};
+    memcpy(at(head), &record, sizeof(record));
+    memcpy(at(head) + sizeof(record), data, length);
+    // Sequentially consistent, so the consumer either sees the new head, or
+    // we see that it's waiting (see wait)
+    header->head.store(head + size, std::memory_order_seq_cst);
+    if (header->waiting.load(std::memory_order_seq_cst))
+        wake();
+    return true;
+}
+
+// -------------------------------- CONSUMER -------------------------------- //
+
+bool SharedMemoryRing::empty() const {
+    return header->tail.load(std::memory_order_relaxed) ==
+           header->head.load(std::memory_order_acquire);
+}
+
+const SharedMemoryRing::Record *SharedMemoryRing::peek() {
+    uint32_t tail = header->tail.load(std::memory_order_relaxed);
+    uint32_t head = header->head.load(std::memory_order_acquire);
+    if (tail == head)
+        return nullptr;
+    auto record = reinterpret_cast<const Record *>(at(tail));
+    if (record->type != PaddingType)
+        return record;
+    // Skip the padding at the end of the buffer
+    tail += recordSize(record->length);
+    header->tail.store(tail, std::memory_order_release);
+    if (tail == head)
+        return nullptr;
+    return reinterpret_cast<const Record *>(at(tail));
+}
+
+void SharedMemoryRing::pop() {
+    uint32_t tail = header->tail.load(std::memory_order_relaxed);
+    auto record = reinterpret_cast<const Record *>(at(tail));
+    header->tail.store(tail + recordSize(record->length),
+                       std::memory_order_release);
+}
+
+#ifdef __linux__
+
+void SharedMemoryRing::wake() {
+    header->sequence.fetch_add(1, std::memory_order_seq_cst);
+    syscall(SYS_futex, &header->sequence, FUTEX_WAKE, 1, nullptr, nullptr, 0);
+}
+
+bool SharedMemoryRing::wait(unsigned long timeout) {
+    header->waiting.store(1, std::memory_order_seq_cst);
+    uint32_t sequence = header->sequence.load(std::memory_order_seq_cst);
+    if (header->head.load(std::memory_order_seq_cst) ==
+        header->tail.load(std::memory_order_relaxed)) {
+        timespec ts;
+        ts.tv_sec = timeout / 1000000;
+        ts.tv_nsec = long(timeout % 1000000) * 1000;
+        // Returns immediately if the producer changed the sequence number
+        // after we loaded it
+        syscall(SYS_futex, &header->sequence, FUTEX_WAIT, sequence, &ts,
+                nullptr, 0);
+    }
+    header->waiting.store(0, std::memory_order_relaxed);
+    return !empty();
+}
+
+#else
+
+void SharedMemoryRing::wake() {
+    header->sequence.fetch_add(1, std::memory_order_seq_cst);
+}
+
+bool SharedMemoryRing::wait(unsigned long timeout) {
+    using namespace std::chrono;
+    auto end = steady_clock::now() + microseconds(timeout);
+    while (empty() && steady_clock::now() < end)
+        std::this_thread::sleep_for(microseconds(50));
+    return !empty();
+}
+
+#endif
+
+END_CS_NAMESPACE
+
+#endif
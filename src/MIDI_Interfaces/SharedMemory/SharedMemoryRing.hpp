@@ -0,0 +1,147 @@
+#pragma once
+
+#if defined(ARDUINO) || defined(_WIN32)
+#error "Shared memory MIDI is only supported on POSIX systems"
+#endif
+
+#include <AH/Settings/Warnings.hpp>
+#include <Settings/NamespaceSettings.hpp>
+#include <atomic>
+#include <stddef.h>
+#include <stdint.h>
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+static_assert(ATOMIC_INT_LOCK_FREE == 2,
+              "Shared memory rings require lock-free atomic integers");
+
+/**
+ * @brief   A lock-free single-producer, single-consumer ring buffer of
+ *          variable-length records, that lives in memory that can be shared
+ *          between processes.
+ *
+ * Every record has a 4-byte header (length, type and cable number) and is
+ * padded to a multiple of four bytes. Records are never split: if a record
+ * doesn't fit in the space before the end of the buffer, that space is
+ * filled with a padding record and the record is written at the start.
+ *
+ * Writing and reading are wait-free and don't need any system calls. A
+ * consumer that has nothing to do can block in @ref wait, in which case the
+ * producer wakes it up using a futex (Linux only, other systems poll).
+ */
+class SharedMemoryRing {
+  public:
+    /// The shared state of the ring, followed by the buffer with the records.
+    struct Header {
+        uint32_t capacity;
+        /// Total number of bytes written (only written by the producer).
+        alignas(64) std::atomic<uint32_t> head;
+        /// Total number of bytes read (only written by the consumer).
+        alignas(64) std::atomic<uint32_t> tail;
+        /// Incremented by the producer to wake up the consumer (futex word).
+        alignas(64) std::atomic<uint32_t> sequence;
+        /// Set by the consumer while it's waiting for new records.
+        std::atomic<uint32_t> waiting;
+    };
+
+    /// The header of a single record.
+    struct Record {
+        uint16_t length; ///< Length of the data, excluding this header.
+        uint8_t type;
+        uint8_t cable;
+        /// Get the data of the record, right after the header.
+        const uint8_t *data() const {
+            return reinterpret_cast<const uint8_t *>(this + 1);
+        }
+    };
+
+    /// Record type reserved for the padding at the end of the buffer.
+    constexpr static uint8_t PaddingType = 0xFF;
+
+    /// Get the number of bytes of shared memory needed for a ring with the
+    /// given capacity.
+    static size_t getSize(uint32_t capacity) {
+        return sizeof(Header) + capacity;
+    }
+
+    /**
+     * @brief   Initialize a new ring in the given memory. Must be called by
+     *          only one of the processes, before any of them use the ring.
+     *
+     * @param   memory
+     *          Memory of at least @ref getSize(capacity) bytes, aligned to
+     *          64 bytes.
+     * @param   capacity
+     *          The size of the record buffer, must be a power of two.
+     */
+    static void initialize(void *memory, uint32_t capacity);
+
+    SharedMemoryRing() = default;
+    /// Use the (initialized) ring in the given memory.
+    explicit SharedMemoryRing(void *memory) { attach(memory); }
+    /// Use the (initialized) ring in the given memory.
+    void attach(void *memory);
+
+    /// @name   Producer
+    /// @{
+
+    /**
+     * @brief   Append a record.
+     *
+     * @return  False if there's not enough free space.
+     */
+    bool write(uint8_t type, uint8_t cable, const uint8_t *data,
+               uint16_t length);
+
+    /// @}
+
+    /// @name   Consumer
+    /// @{
+
+    /**
+     * @brief   Get the oldest record without consuming it.
+     *
+     * The record stays valid until @ref pop is called.
+     *
+     * @return  The record, or nullptr if the ring is empty.
+     */
+    const Record *peek();
+    /// Consume the record returned by @ref peek.
+    void pop();
+    /// Check whether there are records to read.
+    bool empty() const;
+
+    /**
+     * @brief   Block until a record is available, or until the timeout
+     *          expires.
+     *
+     * @param   timeout
+     *          The maximum time to wait, in microseconds.
+     * @return  True if a record is available.
+     */
+    bool wait(unsigned long timeout);
+
+    /// @}
+
+    /// Get the size of the record buffer.
+    uint32_t getCapacity() const { return header ? header->capacity : 0; }
+
+  private:
+    /// Get the size a record with the given data length takes up.
+    static uint32_t recordSize(uint16_t length) {
+        return (sizeof(Record) + length + 3) & ~uint32_t(3);
+    }
+    uint8_t *at(uint32_t position) const {
+        return buffer + (position & (header->capacity - 1));
+    }
+    void wake();
+
+    Header *header = nullptr;
+    uint8_t *buffer = nullptr;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
@@ -0,0 +1,201 @@
+#if !defined(ARDUINO) && !defined(_WIN32)
+
+#include "SharedMemoryMIDI_Interface.hpp"
+#include <AH/Debug/Debug.hpp>
+
+#include <fcntl.h>
+#include <new> // placement new
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+/// The start of the shared memory region, followed by the two rings.
+struct alignas(64) RegionHeader {
+    std::atomic<uint32_t> magic;
+    uint32_t capacity;
+};
+
+/// Written when the region is fully initialized.
+constexpr uint32_t Magic = 0x4353524D; // "CSRM"
+
+size_t regionSizeFor(uint32_t capacity) {
+    return sizeof(RegionHeader) + 2 * SharedMemoryRing::getSize(capacity);
+}
+
+} // namespace
+
+SharedMemoryMIDI_Interface::SharedMemoryMIDI_Interface(const char *name,
+                                                       Side side,
+                                                       uint32_t capacity)
+    : Parsing_MIDI_Interface(parser), name(name), side(side),
+      capacity(capacity) {}
+
+SharedMemoryMIDI_Interface::~SharedMemoryMIDI_Interface() { end(); }
+
+void SharedMemoryMIDI_Interface::begin() {
+    end();
+    int fd = -1;
+    size_t size = 0;
+    if (side == Server) {
+        if (capacity < 64 || (capacity & (capacity - 1)) != 0) {
+            DEBUGFN(F("Capacity must be a power of two"));
+            return;
+        }
+        // Start from scratch, the old region might still be in use by a
+        // client of a previous server
+        shm_unlink(name);
+        fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+        size = regionSizeFor(capacity);
+        if (fd >= 0 && ftruncate(fd, size) != 0) {
+            close(fd);
+            fd = -1;
+        }
+    } else {
+        fd = shm_open(name, O_RDWR, 0);
+        struct stat st;
+        if (fd >= 0 && fstat(fd, &st) == 0)
+            size = st.st_size;
+    }
+    if (fd < 0 || size < sizeof(RegionHeader)) {
+        if (fd >= 0)
+            close(fd);
+        if (side == Server)
+            DEBUGFN(F("Failed to create shared memory ") << name);
+        return;
+    }
+    void *memory =
+        mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd); // The mapping stays valid
+    if (memory == MAP_FAILED)
+        return;
+
+    auto header = static_cast<RegionHeader *>(memory);
+    uint8_t *rings = static_cast<uint8_t *>(memory) + sizeof(RegionHeader);
+    if (side == Server) {
+        new (header) RegionHeader;
+        header->capacity = capacity;
+        SharedMemoryRing::initialize(rings, capacity);
+        SharedMemoryRing::initialize(rings + SharedMemoryRing::getSize(capacity),
+                                     capacity);
+        header->magic.store(Magic, std::memory_order_release);
+    } else if (header->magic.load(std::memory_order_acquire) != Magic ||
+               regionSizeFor(header->capacity) != size) {
+        // The server hasn't finished initializing the region yet
+        munmap(memory, size);
+        return;
+    }
+
+    // The server sends on the first ring, the client on the second one
+    uint32_t ringSize = SharedMemoryRing::getSize(header->capacity);
+    tx.attach(rings + (side == Server ? 0 : ringSize));
+    rx.attach(rings + (side == Server ? ringSize : 0));
+    region = memory;
+    regionSize = size;
+    pending = false;
+}
+
+void SharedMemoryMIDI_Interface::end() {
+    if (region == nullptr)
+        return;
+    munmap(region, regionSize);
+    region = nullptr;
+    if (side == Server)
+        shm_unlink(name);
+}
+
+void SharedMemoryMIDI_Interface::update() {
+    if (!isOpen() && side == Client)
+        begin();
+    Parsing_MIDI_Interface::update();
+}
+
+bool SharedMemoryMIDI_Interface::wait(unsigned long timeout) {
+    if (!isOpen())
+        return false;
+    if (pending) {
+        rx.pop();
+        pending = false;
+    }
+    return rx.wait(timeout);
+}
+
+// -------------------------------- SENDING --------------------------------- //
+
+void SharedMemoryMIDI_Interface::write(RecordType type, uint8_t cn,
+                                       const uint8_t *data, uint16_t length) {
+    if (!isOpen() || !tx.write(type, cn, data, length))
+        ++dropped;
+}
+
+void SharedMemoryMIDI_Interface::sendImpl(uint8_t m, uint8_t c, uint8_t d1,
+                                          uint8_t d2, uint8_t cn) {
+    uint8_t data[3] = {uint8_t(m | c), d1, d2};
+    write(ChannelRecord, cn, data, 3);
+}
+
+void SharedMemoryMIDI_Interface::sendImpl(uint8_t m, uint8_t c, uint8_t d1,
+                                          uint8_t cn) {
+    uint8_t data[3] = {uint8_t(m | c), d1, 0};
+    write(ChannelRecord, cn, data, 3);
+}
+
+void SharedMemoryMIDI_Interface::sendImpl(const uint8_t *data, size_t length,
+                                          uint8_t cn) {
+    // SysExMessage can't represent longer messages
+    if (length > 0xFF) {
+        DEBUGFN(F("SysEx message too long for shared memory interface"));
+        ++dropped;
+        return;
+    }
+    write(SysExRecord, cn, data, length);
+}
+
+void SharedMemoryMIDI_Interface::sendImpl(uint8_t rt, uint8_t cn) {
+    write(RealTimeRecord, cn, &rt, 1);
+}
+
+// ------------------------------- RECEIVING -------------------------------- //
+
+MIDI_read_t SharedMemoryMIDI_Interface::read() {
+    if (!isOpen())
+        return NO_MESSAGE;
+    // The previous record was used in place, now it can be released
+    if (pending) {
+        rx.pop();
+        pending = false;
+    }
+    while (const SharedMemoryRing::Record *record = rx.peek()) {
+        pending = true;
+        const uint8_t *data = record->data();
+        switch (record->type) {
+            case ChannelRecord:
+                if (record->length < 3)
+                    break;
+                parser.setChannelMessage(
+                    {data[0], data[1], data[2], record->cable});
+                return CHANNEL_MESSAGE;
+            case SysExRecord:
+                parser.setSysExMessage(
+                    {data, uint8_t(record->length), record->cable});
+                return SYSEX_MESSAGE;
+            case RealTimeRecord:
+                if (record->length < 1)
+                    break;
+                parser.setCN(record->cable);
+                return static_cast<MIDI_read_t>(data[0]);
+            default: break;
+        }
+        // Unknown record, skip it
+        rx.pop();
+        pending = false;
+    }
+    return NO_MESSAGE;
+}
+
+END_CS_NAMESPACE
+
+#endif
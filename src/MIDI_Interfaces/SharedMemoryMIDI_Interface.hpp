@@ -0,0 +1,152 @@
+#pragma once
+
+#include "MIDI_Interface.hpp"
+#include "SharedMemory/SharedMemoryRing.hpp"
+#include <MIDI_Parsers/MIDI_Parser.hpp>
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+/// MIDI parser that holds the framed messages read from shared memory.
+class SharedMemoryMIDI_Parser : public MIDI_Parser {
+  public:
+    void setChannelMessage(ChannelMessage message) { midimsg = message; }
+    void setSysExMessage(SysExMessage message) {
+        sysex = message;
+        midimsg.CN = message.CN;
+    }
+    void setCN(uint8_t cn) { midimsg.CN = cn; }
+    uint8_t getCN() const override { return midimsg.CN; }
+#if !IGNORE_SYSEX
+    SysExMessage getSysEx() const override { return sysex; }
+#endif
+
+  private:
+    SysExMessage sysex;
+};
+
+/**
+ * @brief   MIDI interface for communication with another process on the same
+ *          computer, using shared memory.
+ *
+ * The shared memory region (see `shm_open`) contains two lock-free rings,
+ * one for each direction. Messages are stored as framed records, so they
+ * don't have to be serialized or parsed, and sending and receiving don't
+ * need any system calls.
+ *
+ * One of the processes creates the region (the @ref Server), the other one
+ * opens it (the @ref Client). If the client is started first, it keeps
+ * trying to open the region in @ref update.
+ *
+ * A process that has nothing else to do can block in @ref wait until a
+ * message arrives. On Linux, it is woken up using a futex in the shared
+ * memory, the sender only makes a system call when the receiver is actually
+ * waiting.
+ *
+ * ~~~cpp
+ * // Process 1
+ * SharedMemoryMIDI_Interface midi {"/control-surface",
+ *                                  SharedMemoryMIDI_Interface::Server};
+ * // Process 2
+ * SharedMemoryMIDI_Interface midi {"/control-surface",
+ *                                  SharedMemoryMIDI_Interface::Client};
+ * ~~~
+ *
+ * @note    Only available on POSIX systems, not on Arduino boards.
+ *
+ * @ingroup MIDIInterfaces
+ */
+class SharedMemoryMIDI_Interface : public Parsing_MIDI_Interface {
+  public:
+    /// Which side of the connection this interface is.
+    enum Side : uint8_t {
+        Server, ///< Creates (and removes) the shared memory region.
+        Client, ///< Opens an existing shared memory region.
+    };
+
+    /**
+     * @brief   Create a shared memory MIDI interface.
+     *
+     * @param   name
+     *          The name of the shared memory object, starting with a slash,
+     *          e.g. `"/control-surface"`.
+     * @param   side
+     *          Whether to create the region or open an existing one.
+     * @param   capacity
+     *          The size of the ring buffer in each direction, in bytes. Must
+     *          be a power of two. Only used by the server.
+     */
+    SharedMemoryMIDI_Interface(const char *name, Side side,
+                               uint32_t capacity = DEFAULT_CAPACITY);
+    /// Unmaps the shared memory, and removes it if this is the server.
+    ~SharedMemoryMIDI_Interface();
+
+    SharedMemoryMIDI_Interface(const SharedMemoryMIDI_Interface &) = delete;
+    SharedMemoryMIDI_Interface &
+    operator=(const SharedMemoryMIDI_Interface &) = delete;
+
+    /// Create or open the shared memory region.
+    void begin() override;
+    /// Read the incoming messages. If the client couldn't open the region yet,
+    /// it tries again.
+    void update() override;
+
+    /// Unmap the shared memory, and remove it if this is the server.
+    void end();
+    /// Check whether the shared memory region is open.
+    bool isOpen() const { return region != nullptr; }
+
+    /**
+     * @brief   Block until a message arrives, or until the timeout expires.
+     *
+     * @param   timeout
+     *          The maximum time to wait, in microseconds.
+     * @return  True if there are messages to read.
+     */
+    bool wait(unsigned long timeout);
+
+    /// Get the number of messages that were dropped because the ring buffer
+    /// was full, or because the other side wasn't connected yet.
+    uint32_t getDroppedMessages() const { return dropped; }
+
+    MIDI_read_t read() override;
+
+  protected:
+    void sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t d2,
+                  uint8_t cn) override;
+    void sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t cn) override;
+    void sendImpl(const uint8_t *data, size_t length, uint8_t cn) override;
+    void sendImpl(uint8_t rt, uint8_t cn) override;
+
+  public:
+    /// Default size of the ring buffers.
+    constexpr static uint32_t DEFAULT_CAPACITY = 1 << 16;
+
+  private:
+    /// The types of the records in the rings.
+    enum RecordType : uint8_t {
+        ChannelRecord = 1,
+        SysExRecord = 2,
+        RealTimeRecord = 3,
+    };
+
+    void write(RecordType type, uint8_t cn, const uint8_t *data,
+               uint16_t length);
+
+  private:
+    const char *name;
+    Side side;
+    uint32_t capacity;
+    void *region = nullptr;
+    size_t regionSize = 0;
+    SharedMemoryRing tx, rx;
+    SharedMemoryMIDI_Parser parser;
+    /// Whether the current record still has to be popped from the ring.
+    bool pending = false;
+    uint32_t dropped = 0;
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
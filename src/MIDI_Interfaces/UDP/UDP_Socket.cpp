@@ -0,0 +1,109 @@
+#if !defined(ARDUINO) || defined(ESP32)
+
+#include "UDP_Socket.hpp"
+
+#ifndef ARDUINO
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+BEGIN_CS_NAMESPACE
+
+#ifdef ARDUINO
+
+bool UDP_Socket::begin(uint16_t port) {
+    end();
+    open = udp.begin(port) == 1;
+    return open;
+}
+
+void UDP_Socket::end() {
+    if (open)
+        udp.stop();
+    open = false;
+}
+
+bool UDP_Socket::send(const UDP_Endpoint &to, const uint8_t *data,
+                      size_t length) {
+    IPAddress ip(to.address[0], to.address[1], to.address[2], to.address[3]);
+    if (!open || !udp.beginPacket(ip, to.port))
+        return false;
+    udp.write(data, length);
+    return udp.endPacket() == 1;
+}
+
+size_t UDP_Socket::receive(uint8_t *buffer, size_t size, UDP_Endpoint &from) {
+    if (!open || udp.parsePacket() <= 0)
+        return 0;
+    IPAddress ip = udp.remoteIP();
+    from = {{ip[0], ip[1], ip[2], ip[3]}, udp.remotePort()};
+    int length = udp.read(buffer, size);
+    return length > 0 ? length : 0;
+}
+
+#else
+
+bool UDP_Socket::begin(uint16_t port) {
+    end();
+    fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (fd < 0)
+        return false;
+    int reuse = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(port);
+    if (bind(fd, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)) < 0 ||
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK) < 0) {
+        end();
+        return false;
+    }
+    return true;
+}
+
+void UDP_Socket::end() {
+    if (fd >= 0)
+        close(fd);
+    fd = -1;
+}
+
+bool UDP_Socket::send(const UDP_Endpoint &to, const uint8_t *data,
+                      size_t length) {
+    if (fd < 0)
+        return false;
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(uint32_t(to.address[0]) << 24 |
+                                 uint32_t(to.address[1]) << 16 |
+                                 uint32_t(to.address[2]) << 8 | to.address[3]);
+    addr.sin_port = htons(to.port);
+    auto sent = sendto(fd, data, length, 0,
+                       reinterpret_cast<sockaddr *>(&addr), sizeof(addr));
+    return sent == ssize_t(length);
+}
+
+size_t UDP_Socket::receive(uint8_t *buffer, size_t size, UDP_Endpoint &from) {
+    if (fd < 0)
+        return 0;
+    sockaddr_in addr = {};
+    socklen_t addrlen = sizeof(addr);
+    auto length = recvfrom(fd, buffer, size, 0,
+                           reinterpret_cast<sockaddr *>(&addr), &addrlen);
+    if (length <= 0)
+        return 0;
+    uint32_t ip = ntohl(addr.sin_addr.s_addr);
+    from = {{uint8_t(ip >> 24), uint8_t(ip >> 16), uint8_t(ip >> 8),
+             uint8_t(ip)},
+            ntohs(addr.sin_port)};
+    return length;
+}
+
+#endif
+
+END_CS_NAMESPACE
+
+#endif
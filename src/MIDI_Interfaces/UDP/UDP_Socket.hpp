@@ -0,0 +1,84 @@
+#pragma once
+
+#if defined(ARDUINO) && !defined(ESP32)
+#error "UDP sockets are only supported on ESP32 boards"
+#endif
+
+#include <AH/Settings/Warnings.hpp>
+#include <Settings/NamespaceSettings.hpp>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef ARDUINO
+#include <WiFiUdp.h>
+#endif
+
+AH_DIAGNOSTIC_WERROR()
+
+BEGIN_CS_NAMESPACE
+
+/// An IPv4 address and a UDP port.
+struct UDP_Endpoint {
+    uint8_t address[4];
+    uint16_t port;
+
+    /// Check whether both endpoints have the same IP address.
+    bool sameAddress(const UDP_Endpoint &other) const {
+        return address[0] == other.address[0] &&
+               address[1] == other.address[1] &&
+               address[2] == other.address[2] &&
+               address[3] == other.address[3];
+    }
+    bool operator==(const UDP_Endpoint &other) const {
+        return sameAddress(other) && port == other.port;
+    }
+    bool operator!=(const UDP_Endpoint &other) const {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @brief   A non-blocking UDP socket, using the WiFiUDP class on ESP32, and
+ *          POSIX sockets on the computer.
+ */
+class UDP_Socket {
+  public:
+    UDP_Socket() = default;
+    UDP_Socket(const UDP_Socket &) = delete;
+    UDP_Socket &operator=(const UDP_Socket &) = delete;
+    ~UDP_Socket() { end(); }
+
+    /// Start listening on the given port (on all interfaces).
+    bool begin(uint16_t port);
+    /// Close the socket.
+    void end();
+
+    /// Send a datagram to the given endpoint.
+    bool send(const UDP_Endpoint &to, const uint8_t *data, size_t length);
+
+    /**
+     * @brief   Read a datagram, if one is available.
+     *
+     * @param   buffer
+     *          The buffer to read the datagram into. Datagrams that are larger
+     *          than the buffer are truncated.
+     * @param   size
+     *          The size of the buffer.
+     * @param   from
+     *          Output: the endpoint that sent the datagram.
+     * @return  The length of the datagram, or zero if none was available.
+     */
+    size_t receive(uint8_t *buffer, size_t size, UDP_Endpoint &from);
+
+  private:
+#ifdef ARDUINO
+    WiFiUDP udp;
+    bool open = false;
+#else
+    int fd = -1;
+#endif
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
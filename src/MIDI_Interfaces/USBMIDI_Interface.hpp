@@ -81,7 +81,12 @@ class USBMIDI_Interface : public Parsing_MIDI_Interface {
     }
 
     void sendImpl(uint8_t m, uint8_t c, uint8_t d1, uint8_t cn) override {
-        sendImpl(m, c, d1, 0, cn);
+        if (m == 0xF0) { // Two-byte System Common (MTC Quarter Frame)
+            writeUSBPacket(cn, 0x2, (m | c), d1, 0);
+            flushUSB();
+        } else {
+            sendImpl(m, c, d1, 0, cn);
+        }
     }
 
     void sendImpl(const uint8_t *data, size_t length, uint8_t cn) override {
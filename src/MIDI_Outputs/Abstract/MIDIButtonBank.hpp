@@ -0,0 +1,77 @@
+#pragma once
+
+#include <AH/Hardware/ButtonBank.hpp>
+#include <Def/Def.hpp>
+#include <MIDI_Outputs/Abstract/MIDIOutputElement.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   An abstract class for banks of momentary push buttons that send MIDI
+ *          events.
+ *
+ * Like MIDIButtons, but all buttons are read using a single bulk read and
+ * debounced at once by an AH::ButtonBank.
+ *
+ * @see     AH::ButtonBank
+ */
+template <class Sender, uint8_t NumButtons>
+class MIDIButtonBank : public MIDIOutputElement {
+  protected:
+    /**
+     * @brief   Construct a new MIDIButtonBank.
+     *
+     * @param   pins
+     *          The digital input pins with the buttons connected.
+     * @param   baseAddress
+     *          The MIDI address of the first button.
+     * @param   incrementAddress
+     *          The number of addresses to increment for each next button.
+     * @param   sender
+     *          The MIDI sender to use.
+     */
+    MIDIButtonBank(const PinList<NumButtons> &pins,
+                   const MIDIAddress &baseAddress,
+                   const RelativeMIDIAddress &incrementAddress,
+                   const Sender &sender)
+        : pins(pins), baseAddress(baseAddress),
+          incrementAddress(incrementAddress), sender(sender) {}
+
+  public:
+    using Mask = typename AH::ButtonBank<NumButtons>::Mask;
+
+    void begin() final override {
+        for (pin_t pin : pins)
+            AH::ExtIO::pinMode(pin, INPUT_PULLUP);
+    }
+    void update() final override {
+        Mask changed = buttons.update(buttons.read(pins));
+        Mask states = buttons.getStates();
+        MIDIAddress address = baseAddress;
+        uint8_t addressIndex = 0;
+        while (changed) {
+            uint8_t index = buttons.popFirst(changed);
+            for (; addressIndex < index; ++addressIndex)
+                address += incrementAddress;
+            if ((states >> index) & 1)
+                sender.sendOff(address);
+            else
+                sender.sendOn(address);
+        }
+    }
+
+    AH::Button::State getButtonState(size_t index) const {
+        return buttons.getState(index);
+    }
+
+  private:
+    const PinList<NumButtons> pins;
+    AH::ButtonBank<NumButtons> buttons;
+    const MIDIAddress baseAddress;
+    const RelativeMIDIAddress incrementAddress;
+
+  public:
+    Sender sender;
+};
+
+END_CS_NAMESPACE
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <MIDI_Outputs/Abstract/MIDIButtonBank.hpp>
+#include <MIDI_Senders/DigitalCCSender.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A class of MIDIOutputElement%s that read the input of a **bank of
+ *          momentary push buttons or switches**, and send out MIDI **Control
+ *          Change** events.
+ *
+ * A value of 0x7F is sent when a button is pressed, and a value of 0x00 is sent
+ * when a button is released.  
+ * Like CCButtons, but all buttons are read in a single bulk read, and
+ * debounced at once, which is much cheaper for large numbers of buttons.  
+ * This version cannot be banked.
+ *
+ * @tparam  NumButtons
+ *          The number of buttons in the bank [1, 64].
+ *
+ * @see     AH::ButtonBank
+ *
+ * @ingroup MIDIOutputElements
+ */
+template <uint8_t NumButtons>
+class CCButtonBank : public MIDIButtonBank<DigitalCCSender, NumButtons> {
+  public:
+    /**
+     * @brief   Create a new CCButtonBank object with the given pins,
+     *          the given controller number and channel.
+     *
+     * @param   pins
+     *          A list of digital input pins with the buttons connected.  
+     *          The internal pull-up resistors will be enabled.
+     * @param   baseAddress
+     *          The MIDI address of the first button, containing the controller
+     *          number [0, 119], channel [CHANNEL_1, CHANNEL_16], and optional 
+     *          cable number [0, 15].
+     * @param   incrementAddress
+     *          The number of addresses to increment for each next button.
+     * @param   sender
+     *          The MIDI sender to use.
+     */
+    CCButtonBank(const PinList<NumButtons> &pins,
+                 const MIDIAddress &baseAddress,
+                 const RelativeMIDIAddress &incrementAddress = 1,
+                 const DigitalCCSender &sender = {})
+        : MIDIButtonBank<DigitalCCSender, NumButtons>(
+              pins, baseAddress, incrementAddress, sender) {}
+};
+
+END_CS_NAMESPACE
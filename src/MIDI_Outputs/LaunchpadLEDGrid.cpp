@@ -0,0 +1,121 @@
+#include "LaunchpadLEDGrid.hpp"
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Parsers/MIDI_Parser.hpp> // SysExStart, SysExEnd
+#include <string.h>                    // memcpy
+
+BEGIN_CS_NAMESPACE
+
+namespace {
+
+const uint8_t LaunchpadMK2Header[] = {0x00, 0x20, 0x29, 0x02, 0x18, 0x0A};
+const uint8_t LaunchpadXHeader[] = {0x00, 0x20, 0x29, 0x02, 0x0C, 0x03};
+const uint8_t LaunchpadProMK3Header[] = {0x00, 0x20, 0x29, 0x02, 0x0E, 0x03};
+
+} // namespace
+
+const LaunchpadSysExFormat LaunchpadSysExFormat::MK2 = {
+    LaunchpadMK2Header, sizeof(LaunchpadMK2Header), 0xFF, 80};
+const LaunchpadSysExFormat LaunchpadSysExFormat::X = {
+    LaunchpadXHeader, sizeof(LaunchpadXHeader), 0x00, 81};
+const LaunchpadSysExFormat LaunchpadSysExFormat::ProMK3 = {
+    LaunchpadProMK3Header, sizeof(LaunchpadProMK3Header), 0x00, 81};
+
+// -------------------------------------------------------------------------- //
+
+void LaunchpadLEDGrid_Base::fill(uint8_t color) {
+    for (uint16_t i = 0; i < uint16_t(rows * cols); ++i)
+        colors[i] = color & 0x7F;
+}
+
+void LaunchpadLEDGrid_Base::setColors(const uint8_t *colors) {
+    for (uint16_t i = 0; i < uint16_t(rows * cols); ++i)
+        this->colors[i] = colors[i] & 0x7F;
+}
+
+void LaunchpadLEDGrid_Base::invalidate() {
+    for (uint16_t i = 0; i < uint16_t(rows * cols); ++i)
+        sent[i] = 0xFF;
+}
+
+uint16_t LaunchpadLEDGrid_Base::getNumChanges() const {
+    uint16_t count = 0;
+    for (uint16_t i = 0; i < uint16_t(rows * cols); ++i)
+        count += colors[i] != sent[i];
+    return count;
+}
+
+uint8_t LaunchpadLEDGrid_Base::getLEDsPerMessage() const {
+    uint8_t fit = (SysExBufferSize - 2 - format.headerLength) /
+                  format.getBytesPerLED();
+    return fit < format.maxLEDs ? fit : format.maxLEDs;
+}
+
+uint16_t LaunchpadLEDGrid_Base::getSysExCost(uint16_t numPads) const {
+    uint8_t perMessage = getLEDsPerMessage();
+    uint16_t messages = (numPads + perMessage - 1) / perMessage;
+    return messages * (2 + format.headerLength) +
+           numPads * format.getBytesPerLED();
+}
+
+uint16_t LaunchpadLEDGrid_Base::sendChanges() {
+    uint16_t changes = getNumChanges();
+    if (changes == 0)
+        return 0;
+    uint16_t noteCost = getNoteCost(changes);
+    uint16_t sysExCost = getSysExCost(changes);
+    if (noteCost <= sysExCost) {
+        sendNotes();
+        return noteCost;
+    } else {
+        sendSysEx();
+        return sysExCost;
+    }
+}
+
+void LaunchpadLEDGrid_Base::sendNotes() {
+    for (uint8_t row = 0; row < rows; ++row) {
+        for (uint8_t col = 0; col < cols; ++col) {
+            uint16_t i = row * cols + col;
+            if (colors[i] == sent[i])
+                continue;
+            Control_Surface.sendNoteOn({getNote(row, col), channelCN},
+                                       colors[i]);
+            sent[i] = colors[i];
+        }
+    }
+}
+
+void LaunchpadLEDGrid_Base::sendSysEx() {
+    uint8_t buffer[SysExBufferSize];
+    buffer[0] = SysExStart;
+    memcpy(buffer + 1, format.header, format.headerLength);
+    const uint8_t start = 1 + format.headerLength;
+    const uint8_t perMessage = getLEDsPerMessage();
+    uint8_t length = start;
+    uint8_t count = 0;
+    auto flush = [&] {
+        buffer[length++] = SysExEnd;
+        Control_Surface.send(
+            SysExMessage{buffer, length, channelCN.getCableNumber()});
+        length = start;
+        count = 0;
+    };
+    for (uint8_t row = 0; row < rows; ++row) {
+        for (uint8_t col = 0; col < cols; ++col) {
+            uint16_t i = row * cols + col;
+            if (colors[i] == sent[i])
+                continue;
+            if (format.ledPrefix != 0xFF)
+                buffer[length++] = format.ledPrefix;
+            buffer[length++] = getNote(row, col);
+            buffer[length++] = colors[i];
+            sent[i] = colors[i];
+            if (++count == perMessage)
+                flush();
+        }
+    }
+    if (count > 0)
+        flush();
+}
+
+END_CS_NAMESPACE
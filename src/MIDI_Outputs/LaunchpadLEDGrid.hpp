@@ -0,0 +1,185 @@
+#pragma once
+
+#include <AH/Settings/Warnings.hpp>
+AH_DIAGNOSTIC_WERROR()
+
+#include <Def/MIDIAddress.hpp>
+#include <MIDI_Outputs/Abstract/MIDIOutputElement.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   The SysEx message that sets the palette colors of multiple LEDs of a
+ *          Novation Launchpad: `F0 <header> [<prefix>] <led> <color> ... F7`.
+ */
+struct LaunchpadSysExFormat {
+    /// The bytes between `F0` and the first LED.
+    const uint8_t *header;
+    /// The number of bytes of @ref header.
+    uint8_t headerLength;
+    /// The byte in front of every LED (the lighting type), or 0xFF if there is
+    /// none.
+    uint8_t ledPrefix;
+    /// The maximum number of LEDs in a single message.
+    uint8_t maxLEDs;
+
+    /// The number of bytes per LED.
+    uint8_t getBytesPerLED() const { return ledPrefix == 0xFF ? 2 : 3; }
+
+    /// Launchpad MK2: `F0 00 20 29 02 18 0A <led> <color> ... F7`.
+    static const LaunchpadSysExFormat MK2;
+    /// Launchpad X: `F0 00 20 29 02 0C 03 00 <led> <color> ... F7`.
+    /// This takes as many bytes per pad as Note On messages, plus the header,
+    /// so @ref LaunchpadLEDGrid_Base always sends Note On messages instead.
+    static const LaunchpadSysExFormat X;
+    /// Launchpad Pro MK3: `F0 00 20 29 02 0E 03 00 <led> <color> ... F7`.
+    static const LaunchpadSysExFormat ProMK3;
+};
+
+/**
+ * @brief   Keeps the palette colors of the pads of a Novation Launchpad-style
+ *          LED grid, and sends only the pads that changed since the last
+ *          update.
+ *
+ * The pads can be set using Note On messages (the velocity is the palette
+ * color), or using SysEx messages that set multiple LEDs at once. Every update
+ * uses the one that takes the fewest bytes: a Note On message takes three
+ * bytes per pad, a SysEx message takes two or three bytes per pad, plus the
+ * header. Changing a few pads is cheaper using notes, lighting the whole grid
+ * after a bank or scene change is cheaper using SysEx.
+ *
+ * The pads are numbered like the programmer layout of the Launchpads: row 0 is
+ * the bottom row, the note of a pad is `10 * (row + 1) + (column + 1)`.
+ * A different layout can be used with @ref setLayout.
+ *
+ * @see     LaunchpadLEDGrid
+ */
+class LaunchpadLEDGrid_Base : public MIDIOutputElement {
+  public:
+    /// Function that returns the note number (LED index) of a pad.
+    using Layout = uint8_t (*)(uint8_t row, uint8_t col);
+
+    /// The size of the buffer for the SysEx messages. Larger updates are split
+    /// into multiple messages.
+    constexpr static uint8_t SysExBufferSize = 64;
+
+  protected:
+    LaunchpadLEDGrid_Base(uint8_t *colors, uint8_t *sent, uint8_t rows,
+                          uint8_t cols, MIDIChannelCN channelCN,
+                          const LaunchpadSysExFormat &format)
+        : colors(colors), sent(sent), rows(rows), cols(cols),
+          channelCN(channelCN), format(format) {}
+
+  public:
+    LaunchpadLEDGrid_Base(const LaunchpadLEDGrid_Base &) = delete;
+    LaunchpadLEDGrid_Base &operator=(const LaunchpadLEDGrid_Base &) = delete;
+
+    /// Send all pads on the next update.
+    void begin() override { invalidate(); }
+    /// Send the pads that changed.
+    void update() override { sendChanges(); }
+
+    /// Set the color of the given pad. Sent on the next update.
+    void setColor(uint8_t row, uint8_t col, uint8_t color) {
+        colors[row * cols + col] = color & 0x7F;
+    }
+    /// Get the color of the given pad.
+    uint8_t getColor(uint8_t row, uint8_t col) const {
+        return colors[row * cols + col];
+    }
+    /// Set all pads to the given color.
+    void fill(uint8_t color);
+    /// Set the colors of all pads, row by row, starting with the bottom row.
+    void setColors(const uint8_t *colors);
+
+    /// Forget which colors were sent (e.g. after the Launchpad was connected),
+    /// so the next update sends all pads.
+    void invalidate();
+    /// Get the number of pads that changed since the last update.
+    uint16_t getNumChanges() const;
+
+    /**
+     * @brief   Send the pads that changed since the last update, using Note On
+     *          or SysEx messages, whichever takes fewer bytes.
+     *
+     * @return  The number of bytes that were sent.
+     */
+    uint16_t sendChanges();
+
+    /// The number of bytes it takes to set the given number of pads using Note
+    /// On messages.
+    static uint16_t getNoteCost(uint16_t numPads) { return 3 * numPads; }
+    /// The number of bytes it takes to set the given number of pads using SysEx
+    /// messages.
+    uint16_t getSysExCost(uint16_t numPads) const;
+
+    /// Set the function that returns the note number of a pad.
+    void setLayout(Layout layout) { this->layout = layout; }
+    /// Get the note number of the given pad.
+    uint8_t getNote(uint8_t row, uint8_t col) const { return layout(row, col); }
+    /// The note numbers of the programmer layout of the Launchpads.
+    static uint8_t programmerLayout(uint8_t row, uint8_t col) {
+        return 10 * (row + 1) + col + 1;
+    }
+
+    uint8_t getRows() const { return rows; }
+    uint8_t getColumns() const { return cols; }
+
+  private:
+    /// The number of pads per SysEx message.
+    uint8_t getLEDsPerMessage() const;
+    void sendNotes();
+    void sendSysEx();
+
+    /// The colors that should be displayed.
+    uint8_t *colors;
+    /// The colors that were last sent, 0xFF if unknown.
+    uint8_t *sent;
+    uint8_t rows;
+    uint8_t cols;
+    MIDIChannelCN channelCN;
+    LaunchpadSysExFormat format;
+    Layout layout = programmerLayout;
+};
+
+/**
+ * @brief   @ref LaunchpadLEDGrid_Base with storage for the given number of
+ *          pads.
+ *
+ * Uses two bytes of RAM per pad.
+ *
+ * @tparam  Rows
+ *          The number of rows of pads.
+ * @tparam  Cols
+ *          The number of columns of pads.
+ *
+ * @ingroup MIDIOutputElements
+ */
+template <uint8_t Rows = 8, uint8_t Cols = 8>
+class LaunchpadLEDGrid : public LaunchpadLEDGrid_Base {
+  public:
+    /**
+     * @brief   Create a new Launchpad LED grid output.
+     *
+     * @param   channelCN
+     *          The MIDI channel and cable number of the Note On messages, and
+     *          the cable number of the SysEx messages.
+     * @param   format
+     *          The SysEx message of the Launchpad model.
+     */
+    LaunchpadLEDGrid(MIDIChannelCN channelCN = CHANNEL_1,
+                     const LaunchpadSysExFormat &format =
+                         LaunchpadSysExFormat::MK2)
+        : LaunchpadLEDGrid_Base(colorStorage, sentStorage, Rows, Cols,
+                                channelCN, format) {
+        invalidate();
+    }
+
+  private:
+    uint8_t colorStorage[Rows * Cols] = {};
+    uint8_t sentStorage[Rows * Cols];
+};
+
+END_CS_NAMESPACE
+
+AH_DIAGNOSTIC_POP()
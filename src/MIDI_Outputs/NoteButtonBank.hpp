@@ -0,0 +1,62 @@
+#pragma once
+
+#include <MIDI_Outputs/Abstract/MIDIButtonBank.hpp>
+#include <MIDI_Senders/DigitalNoteSender.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   A class of MIDIOutputElement%s that read the input of a **bank of
+ *          momentary push buttons or switches**, and send out MIDI **Note**
+ *          events.
+ *
+ * A Note On event is sent when a button is pressed, and a Note Off event is
+ * sent when a button is released.  
+ * Like NoteButtons, but all buttons are read in a single bulk read, and
+ * debounced at once, which is much cheaper for large numbers of buttons.  
+ * This version cannot be banked.
+ *
+ * @tparam  NumButtons
+ *          The number of buttons in the bank [1, 64].
+ *
+ * @see     AH::ButtonBank
+ *
+ * @ingroup MIDIOutputElements
+ */
+template <uint8_t NumButtons>
+class NoteButtonBank : public MIDIButtonBank<DigitalNoteSender, NumButtons> {
+  public:
+    /**
+     * @brief   Create a new NoteButtonBank object with the given pins,
+     *          the given note number and channel.
+     *
+     * @param   pins
+     *          A list of digital input pins with the buttons connected.  
+     *          The internal pull-up resistors will be enabled.
+     * @param   baseAddress
+     *          The MIDI address of the first button, containing the note
+     *          number [0, 127], channel [CHANNEL_1, CHANNEL_16], and optional 
+     *          cable number [0, 15].
+     * @param   incrementAddress
+     *          The number of addresses to increment for each next button.
+     * @param   velocity
+     *          The velocity of the MIDI Note events.
+     */
+    NoteButtonBank(const PinList<NumButtons> &pins,
+                   const MIDIAddress &baseAddress,
+                   const RelativeMIDIAddress &incrementAddress = 1,
+                   uint8_t velocity = 0x7F)
+        : MIDIButtonBank<DigitalNoteSender, NumButtons>{
+              pins,
+              baseAddress,
+              incrementAddress,
+              {velocity},
+          } {}
+
+    /// Set the velocity of the MIDI Note events.
+    void setVelocity(uint8_t velocity) { this->sender.setVelocity(velocity); }
+    /// Get the velocity of the MIDI Note events.
+    uint8_t getVelocity() const { return this->sender.getVelocity(); }
+};
+
+END_CS_NAMESPACE
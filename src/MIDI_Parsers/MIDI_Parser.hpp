@@ -22,6 +22,7 @@ const uint8_t PITCH_BEND = 0xE0;
 const uint8_t SysExStart = 0xF0;
 const uint8_t SysExEnd = 0xF7;
 
+const uint8_t MTCQuarterFrame = 0xF1;
 const uint8_t TuneRequest = 0xF6;
 
 enum MIDI_read_t : uint8_t {
@@ -16,6 +16,13 @@ MIDI_read_t SerialMIDI_Parser::parse(uint8_t midiByte) {
         addSysExByte(SysExStart);
     }
 #endif
+    // A Quarter Frame has no running status. Its header can only be cleared
+    // now, after the user has read the previous message, so stray data
+    // bytes aren't reported as more Quarter Frames.
+    if (quarterFrameDone) {
+        midimsg.header = 0;
+        quarterFrameDone = false;
+    }
     if (isStatus(midiByte)) {
         // If it's a status byte (first byte)
         if (midiByte >= 0xF8) {
@@ -53,7 +60,7 @@ MIDI_read_t SerialMIDI_Parser::parse(uint8_t midiByte) {
             return CHANNEL_MESSAGE;
         } else {
             // Second byte (data 1) or SysEx data
-            if (midimsg.header < 0xC0 || midimsg.header == 0xE0) {
+            if (midimsg.header < 0xC0 || (midimsg.header & 0xF0) == 0xE0) {
                 // Note, Aftertouch, CC or Pitch Bend
                 midimsg.data1 = midiByte;
                 thirdByte = true;
@@ -61,6 +68,13 @@ MIDI_read_t SerialMIDI_Parser::parse(uint8_t midiByte) {
                 // Program Change or Channel Pressure
                 midimsg.data1 = midiByte;
                 return CHANNEL_MESSAGE;
+            } else if (midimsg.header == MTCQuarterFrame) {
+                // MIDI Time Code Quarter Frame (System Common), passed on as
+                // a channel message with header 0xF1
+                midimsg.data1 = midiByte;
+                midimsg.data2 = 0;
+                quarterFrameDone = true;
+                return CHANNEL_MESSAGE;
             }
 #if !IGNORE_SYSEX
             else if (midimsg.header == SysExStart) {
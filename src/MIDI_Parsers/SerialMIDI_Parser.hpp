@@ -26,6 +26,7 @@ class SerialMIDI_Parser : public MIDI_Parser {
 
   private:
     bool thirdByte = false;
+    bool quarterFrameDone = false;
 };
 
 END_CS_NAMESPACE
\ No newline at end of file
@@ -90,13 +90,22 @@ MIDI_read_t USBMIDI_Parser::parse(uint8_t *packet) {
     }
 #endif // IGNORE_SYSEX
 
+    else if (CIN == 0x20 && packet[1] == MTCQuarterFrame) {
+        // Two-byte System Common message: MIDI Time Code Quarter Frame
+        // (other System Common messages are not implemented)
+        // It is passed on as a channel message with header 0xF1.
+        midimsg.header = packet[1];
+        midimsg.data1 = packet[2];
+        midimsg.data2 = 0;
+        midimsg.CN = this->CN;
+        return CHANNEL_MESSAGE;
+    }
+
     /*
     else if (CIN == 0x00) // Miscellaneous function codes. Reserved for future extensions. (not implemented)
       ;
     else if (CIN == 0x10) // Cable events. Reserved for future expansion. (not implemented)
       ;
-    else if (CIN == 0x20) // Two-byte System Common message (not implemented)
-      ;
     else if (CIN == 0x30) // Three-byte System Common message (not implemented)
       ;
   */
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Constants/Control_Change.hpp>
+#include <MIDI_Inputs/MPEZoneManager.hpp>
+
+BEGIN_CS_NAMESPACE
+
+/**
+ * @brief   Class that sends MIDI Polyphonic Expression notes: every note gets
+ *          its own member channel, allocated by an @ref MPEZoneManager, and
+ *          its Pitch Bend, pressure and timbre are sent on that channel.
+ * 
+ * @ingroup MIDI_Senders
+ */
+class MPENoteSender {
+  public:
+    /**
+     * @brief   Create a new MPE note sender.
+     * 
+     * @param   manager
+     *          The zone manager that allocates the member channels.
+     * @param   zone
+     *          The zone to send the notes in.
+     */
+    MPENoteSender(MPEZoneManager &manager, MPEZone::Type zone = MPEZone::Lower)
+        : manager(manager), zone(zone) {}
+
+    /// Send the MPE Configuration Message (RPN 6) for the zone of this sender,
+    /// so the receiver uses the same member channels.
+    void sendConfiguration() {
+        MPEZone z = manager.getZone(zone);
+        Channel channel = z.getManagerChannel();
+        uint8_t cable = manager.getCableNumber();
+        Control_Surface.sendCC({MIDI_CC::RPN_MSB, channel, cable}, 0x00);
+        Control_Surface.sendCC({MIDI_CC::RPN_LSB, channel, cable}, 0x06);
+        Control_Surface.sendCC({MIDI_CC::Data_Entry_MSB, channel, cable},
+                               z.numMembers);
+    }
+
+    /**
+     * @brief   Allocate a member channel for the given note, send its initial
+     *          expression, and then the Note On message.
+     * 
+     * If all member channels are in use, the oldest note is turned off first.
+     * 
+     * @return  The member channel of the note.
+     */
+    Channel sendOn(uint8_t note, uint8_t velocity = 0x7F,
+                   uint16_t pitchBend = 0x2000, uint8_t pressure = 0x00,
+                   uint8_t timbre = 0x40) {
+        uint8_t stolen;
+        Channel channel = manager.allocate(note, zone, stolen);
+        uint8_t cable = manager.getCableNumber();
+        if (stolen != 0xFF)
+            Control_Surface.sendNoteOff({stolen, channel, cable}, 0x40);
+        Control_Surface.sendPB({channel, cable}, pitchBend);
+        Control_Surface.sendCC({MIDI_CC::Sound_Controller_5, channel, cable},
+                               timbre);
+        Control_Surface.sendCP({channel, cable}, pressure);
+        Control_Surface.sendNoteOn({note, channel, cable}, velocity);
+        return channel;
+    }
+
+    /// Send a Note Off message for the given note, and release its member
+    /// channel. Does nothing if the note is not active.
+    void sendOff(uint8_t note, uint8_t velocity = 0x40) {
+        Channel channel = CHANNEL_1;
+        if (manager.release(note, zone, channel))
+            Control_Surface.sendNoteOff(
+                {note, channel, manager.getCableNumber()}, velocity);
+    }
+
+    /// Send the 14-bit Pitch Bend value of the given note.
+    void sendPitchBend(uint8_t note, uint16_t value) {
+        Channel channel = CHANNEL_1;
+        if (manager.find(note, zone, channel))
+            Control_Surface.sendPB({channel, manager.getCableNumber()}, value);
+    }
+
+    /// Send the pressure of the given note.
+    void sendPressure(uint8_t note, uint8_t value) {
+        Channel channel = CHANNEL_1;
+        if (manager.find(note, zone, channel))
+            Control_Surface.sendCP({channel, manager.getCableNumber()}, value);
+    }
+
+    /// Send the timbre (CC 74) of the given note.
+    void sendTimbre(uint8_t note, uint8_t value) {
+        Channel channel = CHANNEL_1;
+        if (manager.find(note, zone, channel))
+            Control_Surface.sendCC({MIDI_CC::Sound_Controller_5, channel,
+                                    manager.getCableNumber()},
+                                   value);
+    }
+
+  private:
+    MPEZoneManager &manager;
+    MPEZone::Type zone;
+};
+
+END_CS_NAMESPACE
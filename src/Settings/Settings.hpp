@@ -59,6 +59,34 @@ constexpr unsigned long HAIRLESS_BAUD = 115200;
 /// The maximum frame rate of the displays.
 constexpr uint8_t MAX_FPS = 60;
 
+/// The maximum number of MIDI messages that can be scheduled using `sendAt`
+/// and `sendAfter` at any given time.
+constexpr uint8_t MIDI_SCHEDULER_CAPACITY = 32;
+
+/// The maximum number of MCU VU meters that are decayed together by the VU
+/// decay engine. Bankable VU meters use one meter for each bank. VU meters 
+/// that don't fit (and meters without decay) decay their own values. Each 
+/// meter uses five bytes of RAM: about 90 bytes on AVR, 350 bytes on other
+/// boards, allocated when the first decaying VU meter is created.
+#ifdef __AVR__
+constexpr uint8_t VU_DECAY_ENGINE_CAPACITY = 16;
+#else
+constexpr uint8_t VU_DECAY_ENGINE_CAPACITY = 64;
+#endif
+
+/// The maximum number of nodes of the trie that is used to dispatch SysEx
+/// messages to the right MIDIInputElementSysEx elements. Each byte of the
+/// headers that is not shared with another header uses one node, of three
+/// bytes and a pointer. All nodes are allocated statically, even if there are
+/// no SysEx elements: 60 bytes of RAM on AVR, 320 bytes on 32-bit boards.
+/// Elements that don't fit compare their header themselves, a capacity of 1
+/// disables the trie altogether.
+#ifdef __AVR__
+constexpr uint8_t SYSEX_TRIE_CAPACITY = 12;
+#else
+constexpr uint8_t SYSEX_TRIE_CAPACITY = 40;
+#endif
+
 // ========================================================================== //
 
 END_CS_NAMESPACE
\ No newline at end of file
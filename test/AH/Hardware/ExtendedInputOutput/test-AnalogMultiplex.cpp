@@ -3,7 +3,12 @@
 #include <AH/Hardware/ExtendedInputOutput/AnalogMultiplex.hpp>
 #include <AH/Hardware/ExtendedInputOutput/ExtendedInputOutput.hpp>
 
+#include <string>
+#include <vector>
+
 USING_AH_NAMESPACE;
+using ::testing::_;
+using ::testing::AnyNumber;
 
 TEST(AnalogMultiplex, analogReadNoEnable) {
     AnalogMultiplex<4> mux = {A0, {2, 3, 4, 5}};
@@ -260,4 +265,139 @@ TEST(AnalogMultiplex, pinModeBuffered) {
     ExtIO::pinModeBuffered(mux.pin(0b1111), INPUT_PULLUP);
 
     ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
-}
\ No newline at end of file
+}
+// -------------------------------------------------------------------------- //
+
+namespace {
+
+/// A multiplexer with address lines on pins 2-5 and the enable pin on pin 6,
+/// connected to the mocked Arduino pins. Every input reads 100 + its address.
+struct MockedMux {
+    MockedMux() {
+        auto &arduino = ArduinoMock::getInstance();
+        EXPECT_CALL(arduino, digitalWrite(_, _))
+            .Times(AnyNumber())
+            .WillRepeatedly([this](pin_t pin, PinStatus_t state) {
+                ++writes;
+                levels[pin] = state;
+            });
+        EXPECT_CALL(arduino, analogRead(A0))
+            .Times(AnyNumber())
+            .WillRepeatedly([this](pin_t) {
+                EXPECT_EQ(levels[6], LOW); // enabled
+                conversions.push_back(address());
+                return 100 + address();
+            });
+    }
+    ~MockedMux() {
+        ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    }
+
+    uint8_t address() const {
+        return levels[2] | levels[3] << 1 | levels[4] << 2 | levels[5] << 3;
+    }
+
+    int levels[7] = {0, 0, 0, 0, 0, 0, HIGH};
+    unsigned writes = 0;
+    std::vector<uint8_t> conversions;
+};
+
+unsigned popcount(unsigned x) {
+    unsigned count = 0;
+    for (; x; x &= x - 1)
+        ++count;
+    return count;
+}
+
+} // namespace
+
+TEST(ScanningAnalogMultiplex, grayCodeScan) {
+    MockedMux mock;
+    ScanningAnalogMultiplex<4> mux = {A0, {2, 3, 4, 5}, 6};
+    mux.scan();
+
+    // First reading is discarded, then every input is read once
+    ASSERT_EQ(mock.conversions.size(), 17u);
+    EXPECT_EQ(mock.conversions[0], mock.conversions[1]);
+    std::vector<bool> visited(16);
+    for (size_t i = 1; i < mock.conversions.size(); ++i) {
+        visited[mock.conversions[i]] = true;
+        if (i == 1)
+            continue;
+        // Only a single address line toggles between two inputs
+        unsigned toggled = mock.conversions[i] ^ mock.conversions[i - 1];
+        EXPECT_EQ(popcount(toggled), 1u);
+    }
+    EXPECT_EQ(visited, std::vector<bool>(16, true));
+    // Address, enable, 15 single address lines, disable
+    EXPECT_EQ(mock.writes, 4u + 1u + 15u + 1u);
+    EXPECT_EQ(mock.levels[6], HIGH);
+
+    // Reading returns the buffered value, without accessing the multiplexer
+    mock.conversions.clear();
+    mock.writes = 0;
+    for (pin_t pin = 0; pin < 16; ++pin) {
+        EXPECT_EQ(ExtIO::analogRead(mux.pin(pin)), 100 + pin);
+        EXPECT_EQ(ExtIO::analogReadBuffered(mux.pin(pin)), 100 + pin);
+    }
+    EXPECT_TRUE(mock.conversions.empty());
+    EXPECT_EQ(mock.writes, 0u);
+}
+
+TEST(ScanningAnalogMultiplex, scanInterval) {
+    MockedMux mock;
+    ScanningAnalogMultiplex<3> mux = {A0, {2, 3, 4}, 6};
+    mux.setScanInterval(1000);
+
+    auto updateAt = [&](unsigned long now) {
+        EXPECT_CALL(ArduinoMock::getInstance(), micros())
+            .WillOnce(::testing::Return(now));
+        mock.conversions.clear();
+        ExtendedIOElement::updateAllBufferedInputs();
+        return mock.conversions.size();
+    };
+    EXPECT_EQ(updateAt(1000), 9u);
+    EXPECT_EQ(updateAt(1500), 0u);
+    EXPECT_EQ(updateAt(2000), 9u);
+    EXPECT_EQ(ExtIO::analogRead(mux.pin(0b101)), 105);
+}
+
+// Counts the writes to the address and enable pins and the ADC conversions
+// per scan of all 16 inputs of a 74HC4067, compared to reading every input
+// using AnalogMultiplex.
+TEST(ScanningAnalogMultiplex, benchmarkScan) {
+    constexpr unsigned Scans = 100;
+    unsigned perInputWrites, perInputConversions;
+    {
+        MockedMux mock;
+        AnalogMultiplex<4> mux = {A0, {2, 3, 4, 5}, 6};
+        for (unsigned s = 0; s < Scans; ++s)
+            for (pin_t pin = 0; pin < 16; ++pin)
+                EXPECT_EQ(ExtIO::analogRead(mux.pin(pin)), 100 + pin);
+        perInputWrites = mock.writes / Scans;
+        perInputConversions = mock.conversions.size() / Scans;
+    }
+    unsigned scanWrites, scanConversions;
+    {
+        MockedMux mock;
+        ScanningAnalogMultiplex<4> mux = {A0, {2, 3, 4, 5}, 6};
+        for (unsigned s = 0; s < Scans; ++s) {
+            mux.scan();
+            for (pin_t pin = 0; pin < 16; ++pin)
+                EXPECT_EQ(ExtIO::analogRead(mux.pin(pin)), 100 + pin);
+        }
+        scanWrites = mock.writes / Scans;
+        scanConversions = mock.conversions.size() / Scans;
+    }
+    EXPECT_EQ(perInputWrites, 16u * (4 + 2));
+    EXPECT_EQ(perInputConversions, 32u);
+    EXPECT_EQ(scanWrites, 21u);
+    EXPECT_EQ(scanConversions, 17u);
+
+    RecordProperty("per_input_writes_per_scan", std::to_string(perInputWrites));
+    RecordProperty("per_input_conversions_per_scan",
+                   std::to_string(perInputConversions));
+    RecordProperty("gray_code_writes_per_scan", std::to_string(scanWrites));
+    RecordProperty("gray_code_conversions_per_scan",
+                   std::to_string(scanConversions));
+}
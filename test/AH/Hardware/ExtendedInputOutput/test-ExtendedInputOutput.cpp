@@ -2,7 +2,11 @@
 
 #include <AH/Hardware/ExtendedInputOutput/ExtendedInputOutput.hpp>
 #include <AH/Hardware/ExtendedInputOutput/ExtendedIOElement.hpp>
+#include <chrono>
+#include <memory>
+#include <string>
 #include <type_traits>
+#include <vector>
 
 using namespace ::testing;
 USING_AH_NAMESPACE;
@@ -491,4 +495,157 @@ TEST(ExtendedIOElement, updateAllBufferedOutputs) {
     EXPECT_CALL(el1, updateBufferedOutputs());
     EXPECT_CALL(el2, updateBufferedOutputs());
     ExtendedIOElement::updateAllBufferedOutputs();
-}
\ No newline at end of file
+}
+TEST(ExtendedInputOutput, digitalWriteMask) {
+    MockExtIOElement el_1 = {10};
+    MockExtIOElement el_2 = {10};
+    const pin_t pins[] = {
+        0, el_1.pin(3), el_1.pin(4), NO_PIN, el_2.pin(0), el_1.pin(9),
+    };
+
+    InSequence seq;
+
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(0, HIGH));
+    EXPECT_CALL(el_1, digitalWriteBuffered(3, LOW));
+    EXPECT_CALL(el_1, digitalWriteBuffered(4, HIGH));
+    EXPECT_CALL(el_1, updateBufferedOutputs());
+    EXPECT_CALL(el_2, digitalWriteBuffered(0, HIGH));
+    EXPECT_CALL(el_2, updateBufferedOutputs());
+    EXPECT_CALL(el_1, digitalWriteBuffered(9, LOW));
+    EXPECT_CALL(el_1, updateBufferedOutputs());
+    ExtIO::digitalWriteMask(pins, 6, 0b011101);
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+TEST(ExtendedInputOutput, digitalReadMask) {
+    MockExtIOElement el_1 = {10};
+    MockExtIOElement el_2 = {10};
+    const pin_t pins[] = {
+        0, el_1.pin(2), el_1.pin(3), el_1.pin(4), NO_PIN, el_2.pin(0),
+        el_1.pin(9),
+    };
+
+    InSequence seq;
+
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalRead(0))
+        .WillOnce(Return(HIGH));
+    EXPECT_CALL(el_1, updateBufferedInputs());
+    EXPECT_CALL(el_1, digitalReadBuffered(2)).WillOnce(Return(LOW));
+    EXPECT_CALL(el_1, digitalReadBuffered(3)).WillOnce(Return(HIGH));
+    EXPECT_CALL(el_1, digitalReadBuffered(4)).WillOnce(Return(HIGH));
+    EXPECT_CALL(el_2, updateBufferedInputs());
+    EXPECT_CALL(el_2, digitalReadBuffered(0)).WillOnce(Return(LOW));
+    EXPECT_CALL(el_1, updateBufferedInputs());
+    EXPECT_CALL(el_1, digitalReadBuffered(9)).WillOnce(Return(HIGH));
+    EXPECT_EQ(ExtIO::digitalReadMask(pins, 7), 0b1001101u);
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+namespace {
+
+/// ExtIO element that reads and writes a buffer in memory.
+class MemoryExtIOElement : public ExtendedIOElement {
+  public:
+    MemoryExtIOElement(pin_t length) : ExtendedIOElement(length) {}
+
+    void pinModeBuffered(pin_t, PinMode_t) override {}
+    void digitalWriteBuffered(pin_t pin, PinStatus_t state) override {
+        buffer[pin % 32] = state;
+    }
+    int digitalReadBuffered(pin_t pin) override { return buffer[pin % 32]; }
+    analog_t analogReadBuffered(pin_t) override { return 0; }
+    void analogWriteBuffered(pin_t, analog_t) override {}
+    void begin() override {}
+    void updateBufferedOutputs() override {}
+    void updateBufferedInputs() override {}
+
+    uint8_t buffer[32] = {};
+};
+
+/// Finds the element of a pin like getIOElementOfPin did before the lookup
+/// table: linear search through all elements.
+ExtendedIOElement *findLinear(pin_t pin) {
+    for (auto &el : ExtendedIOElement::getAll())
+        if (pin >= el.getStart() && pin < el.getEnd())
+            return &el;
+    return nullptr;
+}
+
+} // namespace
+
+TEST(ExtendedIOElement, lookupTable) {
+    // More elements than fit in the table
+    constexpr uint8_t NumElements = EXTIO_LOOKUP_TABLE_SIZE + 8;
+    std::vector<std::unique_ptr<MemoryExtIOElement>> elements;
+    for (uint8_t i = 0; i < NumElements; ++i)
+        elements.emplace_back(new MemoryExtIOElement(1 + i % 5));
+    pin_t first = elements.front()->getStart();
+    pin_t last = elements.back()->getEnd();
+
+    auto check = [&] {
+        for (auto &el : elements) {
+            if (!el)
+                continue;
+            for (pin_t p = 0; p < el->getLength(); ++p)
+                EXPECT_EQ(ExtendedIOElement::find(el->pin(p)), el.get());
+        }
+        EXPECT_EQ(ExtendedIOElement::find(first - 1), nullptr);
+        EXPECT_EQ(ExtendedIOElement::find(last), nullptr);
+    };
+    check();
+
+    // Delete elements from the table and after the table
+    pin_t removed[] = {elements[5]->pin(0), elements[NumElements - 2]->pin(0)};
+    elements[5].reset();
+    elements[NumElements - 2].reset();
+    check();
+    for (pin_t pin : removed)
+        EXPECT_EQ(ExtendedIOElement::find(pin), nullptr);
+
+    // Disabled elements can still be found
+    elements[0]->disable();
+    EXPECT_EQ(ExtendedIOElement::find(first), elements[0].get());
+    elements[0]->enable();
+    check();
+}
+
+// Measures the cost of a digitalRead of an extended IO pin, with 1, 8 and 32
+// elements of 8 pins, compared to a linear search through all elements.
+TEST(ExtendedIOElement, benchmarkLookup) {
+    using namespace std::chrono;
+    constexpr unsigned Reads = 200000;
+    for (uint8_t numElements : {1, 8, 32}) {
+        std::vector<std::unique_ptr<MemoryExtIOElement>> elements;
+        for (uint8_t i = 0; i < numElements; ++i)
+            elements.emplace_back(new MemoryExtIOElement(8));
+        pin_t first = elements.front()->getStart();
+        pin_t numPins = 8 * numElements;
+
+        // Pseudo-random pins, so the search can't be predicted
+        std::vector<pin_t> pins;
+        uint32_t x = 1;
+        for (unsigned i = 0; i < 1024; ++i) {
+            x = x * 1103515245 + 12345;
+            pins.push_back(first + (x >> 16) % numPins);
+        }
+
+        int sum = 0;
+        auto start = steady_clock::now();
+        for (unsigned i = 0; i < Reads; ++i) {
+            pin_t pin = pins[i % pins.size()];
+            ExtendedIOElement &el = *findLinear(pin);
+            sum += el.digitalRead(pin - el.getStart());
+        }
+        auto linear = steady_clock::now() - start;
+        start = steady_clock::now();
+        for (unsigned i = 0; i < Reads; ++i)
+            sum += ExtIO::digitalRead(pins[i % pins.size()]);
+        auto table = steady_clock::now() - start;
+        EXPECT_EQ(sum, 0);
+
+        auto ns = [](nanoseconds t) { return std::to_string(t.count() / Reads); };
+        std::string n = std::to_string(numElements);
+        RecordProperty("linear_ns_per_read_" + n, ns(linear));
+        RecordProperty("table_ns_per_read_" + n, ns(table));
+    }
+}
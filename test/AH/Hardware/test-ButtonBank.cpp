@@ -0,0 +1,159 @@
+#include <AH/Hardware/ButtonBank.hpp>
+#include <AH/Hardware/ExtendedInputOutput/StaticSizeExtendedIOElement.hpp>
+#include <gtest-wrapper.h>
+
+#include <chrono>
+#include <string>
+
+USING_AH_NAMESPACE;
+using ::testing::AnyNumber;
+using ::testing::Mock;
+using ::testing::Return;
+
+TEST(ButtonBank, debounce) {
+    ButtonBank<3> bank;
+    EXPECT_EQ(bank.getStates(), 0b111u);
+    EXPECT_EQ(bank.update(0b111, 1000), 0u);
+
+    // The first edge of a stable button is reported immediately
+    EXPECT_EQ(bank.update(0b101, 1001), 0b010u);
+    EXPECT_EQ(bank.getFalling(), 0b010u);
+    EXPECT_EQ(bank.getRising(), 0u);
+    EXPECT_EQ(bank.getState(1), Button::Falling);
+    EXPECT_EQ(bank.getState(0), Button::Released);
+
+    // The bounces that follow are ignored, other buttons are still stable
+    EXPECT_EQ(bank.update(0b111, 1002), 0u);
+    EXPECT_EQ(bank.update(0b100, 1003), 0b001u);
+    EXPECT_EQ(bank.getState(1), Button::Pressed);
+    EXPECT_EQ(bank.update(0b110, 1004), 0u);
+    EXPECT_EQ(bank.getStates(), 0b100u);
+
+    // Button 1 was released while it was bouncing, this is reported when it
+    // has been stable for the debounce time
+    unsigned long t = 1005;
+    for (; bank.update(0b110, t) == 0; ++t)
+        ASSERT_LT(t, 1005 + 2 * BUTTON_DEBOUNCE_TIME);
+    EXPECT_GE(t, 1004 + BUTTON_DEBOUNCE_TIME);
+    EXPECT_EQ(bank.getRising(), 0b010u);
+    EXPECT_EQ(bank.getState(1), Button::Rising);
+}
+
+TEST(ButtonBank, popFirst) {
+    using Bank = ButtonBank<40>;
+    static_assert(sizeof(Bank::Mask) == 8, "");
+    Bank::Mask allButtons = Bank::AllButtons;
+    EXPECT_EQ(allButtons, 0xFFFFFFFFFFu);
+
+    Bank::Mask mask = (Bank::Mask(1) << 39) | (1u << 31) | (1u << 2) | 1u;
+    EXPECT_EQ(Bank::popFirst(mask), 0);
+    EXPECT_EQ(Bank::popFirst(mask), 2);
+    EXPECT_EQ(Bank::popFirst(mask), 31);
+    EXPECT_EQ(Bank::popFirst(mask), 39);
+    EXPECT_EQ(mask, 0u);
+
+    Bank bank;
+    EXPECT_EQ(bank.update(~(Bank::Mask(1) << 35), 1000),
+              Bank::Mask(1) << 35);
+}
+
+namespace {
+
+/// ExtIO element with 64 buttons connected to it, that counts the number of
+/// times the inputs are read from the device.
+class ButtonsExtIO : public StaticSizeExtendedIOElement<64> {
+  public:
+    void pinModeBuffered(pin_t, PinMode_t) override {}
+    void digitalWriteBuffered(pin_t, PinStatus_t) override {}
+    int digitalReadBuffered(pin_t pin) override { return !pressed[pin]; }
+    analog_t analogReadBuffered(pin_t) override { return 0; }
+    void analogWriteBuffered(pin_t, analog_t) override {}
+    void begin() override {}
+    void updateBufferedOutputs() override {}
+    void updateBufferedInputs() override { ++transactions; }
+
+    bool pressed[64] = {};
+    unsigned transactions = 0;
+};
+
+} // namespace
+
+// Measures the cost of debouncing 64 buttons on an ExtIO element, using 64
+// Button objects compared to a single ButtonBank, while the buttons are
+// pressed and released one after the other.
+TEST(ButtonBank, benchmark64Buttons) {
+    using namespace std::chrono;
+    constexpr unsigned Scans = 20000;
+    ButtonsExtIO io;
+    PinList<64> pins = io.pins();
+
+    unsigned long now = 0;
+    unsigned clockReads = 0;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly([&] {
+            ++clockReads;
+            return now;
+        });
+    // Scan every millisecond, toggle the next button every 7 ms
+    auto run = [&](auto scan) {
+        for (bool &p : io.pressed)
+            p = false;
+        io.transactions = clockReads = 0;
+        unsigned edges = 0;
+        auto start = steady_clock::now();
+        for (unsigned i = 0; i < Scans; ++i) {
+            now = 1000 + i;
+            if (i % 7 == 0)
+                io.pressed[i / 7 % 64] ^= true;
+            edges += scan();
+        }
+        return std::make_pair(steady_clock::now() - start, edges);
+    };
+
+    Button buttons[64];
+    for (uint8_t i = 0; i < 64; ++i)
+        buttons[i] = Button(pins[i]);
+    auto individual = run([&] {
+        unsigned edges = 0;
+        for (Button &b : buttons) {
+            Button::State state = b.update();
+            edges += state == Button::Falling || state == Button::Rising;
+        }
+        return edges;
+    });
+    unsigned individualClockReads = clockReads;
+    unsigned individualTransactions = io.transactions;
+
+    ButtonBank<64> bank;
+    auto bulk = run([&] {
+        unsigned edges = 0;
+        ButtonBank<64>::Mask changed = bank.update(bank.read(pins));
+        while (changed) {
+            bank.popFirst(changed);
+            ++edges;
+        }
+        return edges;
+    });
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    EXPECT_EQ(individual.second, (Scans + 6) / 7);
+    EXPECT_EQ(bulk.second, individual.second);
+    EXPECT_EQ(individualClockReads, 64 * Scans);
+    EXPECT_EQ(clockReads, Scans);
+    EXPECT_EQ(individualTransactions, 64 * Scans);
+    EXPECT_EQ(io.transactions, 2 * Scans); // 32 pins per ExtIO read
+
+    auto ns = [](nanoseconds t) { return std::to_string(t.count() / Scans); };
+    RecordProperty("edges", std::to_string(bulk.second));
+    RecordProperty("individual_clock_reads_per_scan",
+                   std::to_string(individualClockReads / Scans));
+    RecordProperty("bank_clock_reads_per_scan",
+                   std::to_string(clockReads / Scans));
+    RecordProperty("individual_transactions_per_scan",
+                   std::to_string(individualTransactions / Scans));
+    RecordProperty("bank_transactions_per_scan",
+                   std::to_string(io.transactions / Scans));
+    RecordProperty("individual_ns_per_scan", ns(individual.first));
+    RecordProperty("bank_ns_per_scan", ns(bulk.first));
+}
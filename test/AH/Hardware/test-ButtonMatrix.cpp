@@ -0,0 +1,398 @@
+#include <AH/Hardware/ButtonMatrix.hpp>
+#include <AH/Hardware/ExtendedInputOutput/StaticSizeExtendedIOElement.hpp>
+#include <gtest-wrapper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+USING_AH_NAMESPACE;
+using ::testing::AnyNumber;
+using ::testing::Mock;
+using ::testing::Return;
+
+namespace {
+
+/// ExtIO element with an 8×8 button matrix connected to it: the rows are
+/// connected to pins 0-7, the columns to pins 8-15. It counts the number of
+/// times the inputs are read from the device.
+/// The switches bounce: until @ref bounceUntil, every read of a switch returns
+/// a random state.
+class MatrixExtIO : public StaticSizeExtendedIOElement<16> {
+  public:
+    void pinModeBuffered(pin_t pin, PinMode_t mode) override {
+        if (pin < 8 && mode == OUTPUT)
+            activeRow = pin;
+        else if (pin == activeRow)
+            activeRow = NoRow;
+    }
+    void digitalWriteBuffered(pin_t, PinStatus_t) override {}
+    int digitalReadBuffered(pin_t pin) override { return buffer[pin]; }
+    analog_t analogReadBuffered(pin_t) override { return 0; }
+    void analogWriteBuffered(pin_t, analog_t) override {}
+    void begin() override {}
+    void updateBufferedOutputs() override {}
+    void updateBufferedInputs() override {
+        ++transactions;
+        for (uint8_t col = 0; col < 8; ++col)
+            buffer[8 + col] = activeRow != NoRow && isClosed(activeRow, col)
+                                  ? LOW
+                                  : HIGH;
+    }
+
+    bool isClosed(uint8_t row, uint8_t col) {
+        if (now < bounceUntil[row][col])
+            return rng() & 1;
+        return pressed[row][col];
+    }
+
+    PinList<8> rows() const { return pins().slice<0, 7>(); }
+    PinList<8> cols() const { return pins().slice<8, 15>(); }
+
+    constexpr static uint8_t NoRow = 0xFF;
+    uint8_t activeRow = NoRow;
+    bool pressed[8][8] = {};
+    uint8_t buffer[16] = {};
+    unsigned transactions = 0;
+    unsigned long now = 0;
+    unsigned long bounceUntil[8][8] = {};
+    std::minstd_rand rng;
+};
+
+struct Event {
+    uint8_t row, col;
+    bool state;
+    bool operator==(const Event &o) const {
+        return row == o.row && col == o.col && state == o.state;
+    }
+};
+
+class TestMatrix : public ButtonMatrix<8, 8> {
+  public:
+    TestMatrix(const PinList<8> &rows, const PinList<8> &cols)
+        : ButtonMatrix<8, 8>(rows, cols) {}
+    void onButtonChanged(uint8_t row, uint8_t col, bool state) override {
+        events.push_back({row, col, state});
+    }
+    std::vector<Event> events;
+};
+
+/// Scans the matrix like ButtonMatrix did before the columns were read as a
+/// single mask: one read per button.
+unsigned scanPerPin(const PinList<8> &rows, const PinList<8> &cols) {
+    unsigned pressed = 0;
+    for (pin_t row : rows) {
+        ExtIO::pinMode(row, OUTPUT);
+        for (pin_t col : cols)
+            pressed += ExtIO::digitalRead(col) == LOW;
+        ExtIO::pinMode(row, INPUT);
+    }
+    return pressed;
+}
+
+/// Reads the matrix like ButtonMatrix did before the buttons were debounced
+/// separately: the whole matrix is only scanned every BUTTON_DEBOUNCE_TIME.
+class GlobalDebounceMatrix {
+  public:
+    GlobalDebounceMatrix(const PinList<8> &rows, const PinList<8> &cols)
+        : rows(rows), cols(cols) {}
+    void update() {
+        unsigned long now = millis();
+        if (now - prevRefresh < BUTTON_DEBOUNCE_TIME)
+            return;
+        for (uint8_t row = 0; row < 8; ++row) {
+            ExtIO::pinMode(rows[row], OUTPUT);
+            for (uint8_t col = 0; col < 8; ++col) {
+                bool state = ExtIO::digitalRead(cols[col]);
+                if (state != prevStates[row][col]) {
+                    events.push_back({row, col, state});
+                    prevStates[row][col] = state;
+                }
+            }
+            prevRefresh = now;
+            ExtIO::pinMode(rows[row], INPUT);
+        }
+    }
+    std::vector<Event> events;
+
+  private:
+    PinList<8> rows, cols;
+    unsigned long prevRefresh = 0;
+    bool prevStates[8][8] = {
+        {1, 1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 1, 1, 1, 1},
+        {1, 1, 1, 1, 1, 1, 1, 1}, {1, 1, 1, 1, 1, 1, 1, 1},
+    };
+};
+
+struct BounceResults {
+    unsigned edges = 0;
+    unsigned detected = 0;
+    unsigned falseTriggers = 0;
+    unsigned long totalLatency = 0;
+    unsigned long maxLatency = 0;
+};
+
+/// Presses and releases some buttons of the matrix at random times for a
+/// minute, with random bounces, and scans the matrix every millisecond.
+/// Every edge should be reported once: the latency is the time between the
+/// edge and the event, all other events are false triggers.
+template <class Matrix>
+BounceResults simulateBounces(MatrixExtIO &io, Matrix &matrix) {
+    constexpr unsigned long Duration = 60000;
+    const std::pair<uint8_t, uint8_t> keys[] = {
+        {0, 0}, {1, 4}, {3, 7}, {5, 2}, {7, 6},
+    };
+    std::minstd_rand rng;
+    unsigned long nextEdge[8][8] = {};
+    unsigned long edgeTime[8][8] = {};
+    bool reported[8][8] = {};
+    BounceResults res;
+
+    unsigned long now = 0;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly([&] { return now; });
+    for (now = 1000; now < Duration; ++now) {
+        io.now = now;
+        for (auto key : keys) {
+            uint8_t r = key.first, c = key.second;
+            if (now < nextEdge[r][c])
+                continue;
+            // Most bounces are short, some switches bounce for a long time
+            unsigned long bounce = rng() % 10 == 0 ? 30 : 1 + rng() % 5;
+            io.pressed[r][c] = !io.pressed[r][c];
+            io.bounceUntil[r][c] = now + bounce;
+            edgeTime[r][c] = now;
+            nextEdge[r][c] = now + 60 + rng() % 200;
+            reported[r][c] = false;
+            ++res.edges;
+        }
+        matrix.events.clear();
+        matrix.update();
+        for (const Event &e : matrix.events) {
+            bool expected = !io.pressed[e.row][e.col];
+            if (e.state != expected || reported[e.row][e.col]) {
+                ++res.falseTriggers;
+                continue;
+            }
+            reported[e.row][e.col] = true;
+            unsigned long latency = now - edgeTime[e.row][e.col];
+            res.totalLatency += latency;
+            res.maxLatency = std::max(res.maxLatency, latency);
+            ++res.detected;
+        }
+    }
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    return res;
+}
+
+} // namespace
+
+TEST(ButtonMatrix, debounceBouncingButton) {
+    MatrixExtIO io;
+    TestMatrix matrix = {io.rows(), io.cols()};
+    unsigned long now = 1000;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly([&] { return now; });
+    matrix.begin();
+    matrix.update();
+
+    // The first edge of a stable button is reported immediately
+    io.pressed[4][3] = true;
+    matrix.update();
+    std::vector<Event> expected = {{4, 3, false}};
+    EXPECT_EQ(matrix.events, expected);
+    // The bounces that follow are ignored
+    for (int i = 0; i < 10; ++i) {
+        io.pressed[4][3] = !io.pressed[4][3];
+        ++now;
+        matrix.update();
+    }
+    EXPECT_EQ(matrix.events, expected);
+    // The button was released while it was bouncing, this is reported when
+    // it is stable again
+    io.pressed[4][3] = false;
+    for (int i = 0; i < 30; ++i) {
+        ++now;
+        matrix.update();
+    }
+    expected.push_back({4, 3, true});
+    EXPECT_EQ(matrix.events, expected);
+
+    // Long stable periods saturate the counters
+    now += 100000;
+    matrix.update();
+    io.pressed[4][3] = true;
+    matrix.update();
+    expected.push_back({4, 3, false});
+    EXPECT_EQ(matrix.events, expected);
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+namespace {
+
+/// ExtIO element with a single row on pin 0 and 32 columns on pins 1-32.
+class WideMatrixExtIO : public StaticSizeExtendedIOElement<33> {
+  public:
+    void pinModeBuffered(pin_t pin, PinMode_t mode) override {
+        if (pin == 0)
+            active = mode == OUTPUT;
+    }
+    void digitalWriteBuffered(pin_t, PinStatus_t) override {}
+    int digitalReadBuffered(pin_t pin) override {
+        return !(active && ((pressed >> (pin - 1)) & 1));
+    }
+    analog_t analogReadBuffered(pin_t) override { return 0; }
+    void analogWriteBuffered(pin_t, analog_t) override {}
+    void begin() override {}
+    void updateBufferedOutputs() override {}
+    void updateBufferedInputs() override {}
+
+    bool active = false;
+    uint32_t pressed = 0;
+};
+
+class WideMatrix : public ButtonMatrix<1, 32> {
+  public:
+    WideMatrix(const PinList<1> &rows, const PinList<32> &cols)
+        : ButtonMatrix<1, 32>(rows, cols) {}
+    void onButtonChanged(uint8_t row, uint8_t col, bool state) override {
+        events.push_back({row, col, state});
+    }
+    std::vector<Event> events;
+};
+
+} // namespace
+
+TEST(ButtonMatrix, thirtyTwoColumns) {
+    WideMatrixExtIO io;
+    WideMatrix matrix = {io.pins().slice<0, 0>(), io.pins().slice<1, 32>()};
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(1000));
+    matrix.update();
+    EXPECT_TRUE(matrix.events.empty());
+
+    io.pressed = 0x80000001;
+    matrix.update();
+    std::vector<Event> expected = {{0, 0, false}, {0, 31, false}};
+    EXPECT_EQ(matrix.events, expected);
+    EXPECT_FALSE(matrix.getPrevState(31, 0));
+    EXPECT_TRUE(matrix.getPrevState(30, 0));
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+TEST(ButtonMatrix, changesOnExtIO) {
+    MatrixExtIO io;
+    TestMatrix matrix = {io.rows(), io.cols()};
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(1000));
+    matrix.begin();
+    matrix.update();
+    EXPECT_TRUE(matrix.events.empty());
+
+    io.pressed[2][5] = true;
+    io.pressed[7][0] = true;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(2000));
+    matrix.update();
+    std::vector<Event> expected = {{2, 5, false}, {7, 0, false}};
+    EXPECT_EQ(matrix.events, expected);
+    EXPECT_FALSE(matrix.getPrevState(5, 2));
+    EXPECT_TRUE(matrix.getPrevState(4, 2));
+    matrix.events.clear();
+
+    io.pressed[2][5] = false;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(3000));
+    matrix.update();
+    expected = {{2, 5, true}};
+    EXPECT_EQ(matrix.events, expected);
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+// Counts the number of times the inputs of the ExtIO element are read per
+// scan of an 8×8 matrix, compared to reading every button separately.
+TEST(ButtonMatrix, benchmarkTransactions) {
+    using namespace std::chrono;
+    constexpr unsigned Scans = 10000;
+    MatrixExtIO io;
+    TestMatrix matrix = {io.rows(), io.cols()};
+    matrix.begin();
+    io.pressed[1][1] = io.pressed[6][3] = true;
+
+    io.transactions = 0;
+    unsigned pressed = 0;
+    auto start = steady_clock::now();
+    for (unsigned i = 0; i < Scans; ++i)
+        pressed += scanPerPin(io.rows(), io.cols());
+    auto perPin = steady_clock::now() - start;
+    unsigned perPinTransactions = io.transactions;
+    EXPECT_EQ(pressed, 2 * Scans);
+
+    unsigned long now = 0;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly([&] { return now += 1000; });
+    io.transactions = 0;
+    start = steady_clock::now();
+    for (unsigned i = 0; i < Scans; ++i)
+        matrix.update();
+    auto bulk = steady_clock::now() - start;
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    EXPECT_EQ(matrix.events.size(), 2u);
+    EXPECT_EQ(perPinTransactions, 64 * Scans);
+    EXPECT_EQ(io.transactions, 8 * Scans);
+
+    auto ns = [](nanoseconds t) { return std::to_string(t.count() / Scans); };
+    RecordProperty("per_pin_transactions_per_scan",
+                   std::to_string(perPinTransactions / Scans));
+    RecordProperty("bulk_transactions_per_scan",
+                   std::to_string(io.transactions / Scans));
+    RecordProperty("per_pin_ns_per_scan", ns(perPin));
+    RecordProperty("bulk_ns_per_scan", ns(bulk));
+}
+
+// Measures the latency between the edges of bouncing buttons and the events,
+// and the number of false triggers, compared to debouncing the whole matrix
+// with a single timer.
+TEST(ButtonMatrix, benchmarkBounce) {
+    BounceResults global, perKey;
+    {
+        MatrixExtIO io;
+        GlobalDebounceMatrix matrix = {io.rows(), io.cols()};
+        global = simulateBounces(io, matrix);
+    }
+    {
+        MatrixExtIO io;
+        TestMatrix matrix = {io.rows(), io.cols()};
+        matrix.begin();
+        perKey = simulateBounces(io, matrix);
+    }
+    EXPECT_EQ(perKey.edges, global.edges);
+    EXPECT_EQ(perKey.detected, perKey.edges);
+    EXPECT_EQ(perKey.falseTriggers, 0u);
+    EXPECT_LT(perKey.totalLatency, global.totalLatency);
+
+    auto record = [this](const std::string &name, const BounceResults &res) {
+        RecordProperty(name + "_detected", std::to_string(res.detected));
+        RecordProperty(name + "_false_triggers",
+                       std::to_string(res.falseTriggers));
+        RecordProperty(name + "_mean_latency_us",
+                       std::to_string(1000 * res.totalLatency /
+                                      std::max(res.detected, 1u)));
+        RecordProperty(name + "_max_latency_ms",
+                       std::to_string(res.maxLatency));
+    };
+    RecordProperty("edges", std::to_string(perKey.edges));
+    record("global", global);
+    record("per_key", perKey);
+}
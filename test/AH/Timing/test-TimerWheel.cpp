@@ -0,0 +1,148 @@
+#include <gtest-wrapper.h>
+
+#include <AH/Timing/TimerWheel.hpp>
+#include <algorithm>
+#include <functional>
+#include <random>
+#include <utility>
+#include <vector>
+
+USING_AH_NAMESPACE;
+
+using Expired = std::vector<std::pair<unsigned long, int>>;
+
+TEST(TimerWheel, expireInOrder) {
+    TimerWheel<int, 8> wheel;
+    wheel.begin(100);
+    EXPECT_TRUE(wheel.schedule(105, 1));
+    EXPECT_TRUE(wheel.schedule(102, 2));
+    EXPECT_TRUE(wheel.schedule(103, 3));
+    EXPECT_EQ(wheel.size(), 3);
+    Expired expired;
+    auto cb = [&](unsigned long t, int i) { expired.push_back({t, i}); };
+    wheel.advance(101, cb);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(103, cb);
+    EXPECT_EQ(expired, (Expired{{102, 2}, {103, 3}}));
+    wheel.advance(110, cb);
+    EXPECT_EQ(expired, (Expired{{102, 2}, {103, 3}, {105, 1}}));
+    EXPECT_TRUE(wheel.empty());
+}
+
+TEST(TimerWheel, sameTickFIFO) {
+    // The first event is scheduled in a higher level, the last one directly in
+    // the lowest level, and they should still expire in scheduling order.
+    TimerWheel<int, 8, 2, 3> wheel;
+    wheel.begin(0);
+    Expired expired;
+    auto cb = [&](unsigned long t, int i) { expired.push_back({t, i}); };
+    EXPECT_TRUE(wheel.schedule(30, 1));
+    wheel.advance(17, cb);
+    EXPECT_TRUE(wheel.schedule(30, 2));
+    wheel.advance(29, cb);
+    EXPECT_TRUE(wheel.schedule(30, 3));
+    wheel.advance(30, cb);
+    EXPECT_EQ(expired, (Expired{{30, 1}, {30, 2}, {30, 3}}));
+}
+
+TEST(TimerWheel, pastEventsExpireImmediately) {
+    TimerWheel<int, 4> wheel;
+    wheel.begin(1000);
+    EXPECT_TRUE(wheel.schedule(10, 1));
+    Expired expired;
+    wheel.advance(1000, [&](unsigned long t, int i) {
+        expired.push_back({t, i});
+    });
+    EXPECT_EQ(expired, (Expired{{1000, 1}}));
+}
+
+TEST(TimerWheel, full) {
+    TimerWheel<int, 2> wheel;
+    wheel.begin(0);
+    EXPECT_TRUE(wheel.schedule(1, 1));
+    EXPECT_TRUE(wheel.schedule(2, 2));
+    EXPECT_TRUE(wheel.full());
+    EXPECT_FALSE(wheel.schedule(3, 3));
+    wheel.advance(1, [](unsigned long, int) {});
+    EXPECT_TRUE(wheel.schedule(3, 3));
+}
+
+TEST(TimerWheel, overflowAndWrapAround) {
+    // 3 levels of 4 slots: 64 ticks before events go to the overflow list
+    TimerWheel<int, 8, 2, 3> wheel;
+    unsigned long start = 0xFFFFFFFF - 200;
+    wheel.begin(start);
+    EXPECT_TRUE(wheel.schedule(start + 1000, 1)); // wraps around zero
+    EXPECT_TRUE(wheel.schedule(start + 70, 2));
+    Expired expired;
+    auto cb = [&](unsigned long t, int i) { expired.push_back({t, i}); };
+    wheel.advance(start + 69, cb);
+    EXPECT_TRUE(expired.empty());
+    wheel.advance(start + 999, cb);
+    EXPECT_EQ(expired, (Expired{{start + 70, 2}}));
+    wheel.advance(start + 1000, cb);
+    EXPECT_EQ(expired, (Expired{{start + 70, 2}, {start + 1000, 1}}));
+}
+
+TEST(TimerWheel, callbackSchedulesNewEvents) {
+    TimerWheel<int, 4> wheel;
+    wheel.begin(0);
+    EXPECT_TRUE(wheel.schedule(1, 3));
+    Expired expired;
+    std::function<void(unsigned long, int)> cb = [&](unsigned long t, int i) {
+        expired.push_back({t, i});
+        if (i > 0)
+            wheel.schedule(t + 10 * i, i - 1);
+    };
+    wheel.advance(100, cb);
+    EXPECT_EQ(expired, (Expired{{1, 3}, {31, 2}, {51, 1}, {61, 0}}));
+}
+
+TEST(TimerWheel, removeIf) {
+    TimerWheel<int, 8> wheel;
+    wheel.begin(0);
+    for (int i = 0; i < 8; ++i)
+        wheel.schedule(i * 500, i);
+    wheel.removeIf([](int i) { return i % 2 == 1; });
+    EXPECT_EQ(wheel.size(), 4);
+    Expired expired;
+    wheel.advance(10000, [&](unsigned long t, int i) {
+        expired.push_back({t, i});
+    });
+    EXPECT_EQ(expired, (Expired{{0, 0}, {1000, 2}, {2000, 4}, {3000, 6}}));
+}
+
+TEST(TimerWheel, thousandPendingEvents) {
+    constexpr uint16_t N = 1000;
+    TimerWheel<uint16_t, N, 5, 3> wheel;
+    std::mt19937 rng(0x5EED);
+    std::uniform_int_distribution<unsigned long> dist(0, 60000);
+    unsigned long start = 123456;
+    wheel.begin(start);
+    std::vector<std::pair<unsigned long, uint16_t>> expected;
+    for (uint16_t i = 0; i < N; ++i) {
+        unsigned long t = start + dist(rng);
+        ASSERT_TRUE(wheel.schedule(t, i));
+        expected.push_back({t, i});
+    }
+    EXPECT_TRUE(wheel.full());
+    std::stable_sort(expected.begin(), expected.end(),
+                     [](const std::pair<unsigned long, uint16_t> &a,
+                        const std::pair<unsigned long, uint16_t> &b) {
+                         return a.first < b.first;
+                     });
+
+    // Advance in irregular steps, like a main loop would, and check that
+    // every event expires exactly at its tick, in order.
+    std::vector<std::pair<unsigned long, uint16_t>> expired;
+    unsigned long now = start;
+    std::uniform_int_distribution<unsigned long> step(0, 7);
+    while (!wheel.empty()) {
+        now += step(rng);
+        wheel.advance(now, [&](unsigned long t, uint16_t i) {
+            EXPECT_LE(t, now);
+            expired.push_back({t, i});
+        });
+    }
+    EXPECT_EQ(expired, expected);
+}
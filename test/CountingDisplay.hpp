@@ -0,0 +1,38 @@
+#pragma once
+
+#include <Display/DisplayInterface.hpp>
+
+#include <string>
+
+/// A display that only counts how often it is cleared, drawn to and
+/// displayed, and keeps the text that was written to it.
+class CountingDisplay : public CS::DisplayInterface {
+  public:
+    void clear() override { ++clears; }
+    void display() override { ++displays; }
+    void drawPixel(int16_t, int16_t, uint16_t) override {}
+    void setTextColor(uint16_t) override {}
+    void setTextSize(uint8_t) override {}
+    void setCursor(int16_t, int16_t) override {}
+    size_t write(uint8_t c) override {
+        ++writes;
+        text += char(c);
+        return 1;
+    }
+    void drawLine(int16_t, int16_t, int16_t, int16_t, uint16_t) override {}
+    void drawFastVLine(int16_t, int16_t, int16_t, uint16_t) override {}
+    void drawFastHLine(int16_t, int16_t, int16_t, uint16_t) override {}
+    void drawXBitmap(int16_t, int16_t, const uint8_t[], int16_t, int16_t,
+                     uint16_t) override {}
+    void fillRect(int16_t, int16_t, int16_t, int16_t, uint16_t) override {
+        ++fills;
+    }
+
+    void reset() {
+        clears = displays = writes = fills = 0;
+        text.clear();
+    }
+
+    unsigned clears = 0, displays = 0, writes = 0, fills = 0;
+    std::string text;
+};
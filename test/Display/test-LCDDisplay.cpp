@@ -0,0 +1,152 @@
+#include <gtest-wrapper.h>
+
+#include <Banks/Bank.hpp>
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <CountingDisplay.hpp>
+#include <Display/MCU/LCDDisplay.hpp>
+
+#include <memory>
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// An element that doesn't keep track of its changes.
+class StaticText : public DisplayElement {
+  public:
+    StaticText(DisplayInterface &display) : DisplayElement(display) {}
+    void draw() override { display.print("Static"); }
+};
+
+/// Send the given text to the MCU LCD at the given offset.
+void sendText(uint8_t offset, const std::string &text) {
+    std::vector<uint8_t> sysex = {0xF0, 0x00, 0x00, 0x66, 0x14, 0x12, offset};
+    sysex.insert(sysex.end(), text.begin(), text.end());
+    sysex.push_back(0xF7);
+    MIDIInputElementSysEx::updateAllWith(sysex);
+}
+
+} // namespace
+
+TEST(LCD, versionAndDirtyRange) {
+    MCU::LCD<> lcd;
+    EXPECT_EQ(lcd.getVersion(), 0);
+    sendText(7, "Snare ");
+    EXPECT_EQ(lcd.getVersion(), 1);
+    EXPECT_EQ(lcd.getDirtyBegin(), 7);
+    EXPECT_EQ(lcd.getDirtyEnd(), 12);
+    // Resending the same text doesn't change anything
+    sendText(0, std::string(7, ' ') + "Snare ");
+    EXPECT_EQ(lcd.getVersion(), 1);
+    sendText(0, std::string(7, ' ') + "Snore ");
+    EXPECT_EQ(lcd.getVersion(), 2);
+    EXPECT_EQ(lcd.getDirtyBegin(), 9);
+    EXPECT_EQ(lcd.getDirtyEnd(), 10);
+}
+
+TEST(LCDDisplay, onlyRedrawChanges) {
+    Bank<2> bank(4);
+    MCU::LCD<> lcd;
+    CountingDisplay display;
+    MCU::LCDDisplay track1 = {display, lcd, bank, 1, {0, 0}, 1, 1};
+
+    // The first frame draws everything
+    sendText(0, "Kick  ");
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.clears, 1u);
+    EXPECT_EQ(display.displays, 1u);
+    EXPECT_EQ(display.text, "Kick  ");
+    display.reset();
+
+    // Nothing changed
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.displays, 0u);
+
+    // Another track changed
+    sendText(7, "Snare ");
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.displays, 0u);
+    EXPECT_EQ(display.writes, 0u);
+
+    // Two characters of this track changed
+    sendText(0, "Kicks ");
+    sendText(2, "ck");
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.clears, 0u);
+    EXPECT_EQ(display.displays, 1u);
+    EXPECT_EQ(display.fills, 1u);
+    EXPECT_EQ(display.text, "s");
+    display.reset();
+
+    // Changing the bank redraws the text of the new track
+    bank.select(1);
+    sendText(28, "Toms  ");
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.clears, 0u);
+    EXPECT_EQ(display.displays, 1u);
+    EXPECT_EQ(display.text, "Toms ");
+    display.reset();
+
+    // A message across all tracks blanks the text
+    sendText(0, std::string(56, '-'));
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.text, "    ");
+}
+
+TEST(LCDDisplay, fullRedrawWithOtherElements) {
+    Bank<1> bank;
+    MCU::LCD<> lcd;
+    CountingDisplay display;
+    MCU::LCDDisplay track1 = {display, lcd, bank, 1, {0, 0}, 1, 1};
+    StaticText other = {display};
+    Control_Surface.updateDisplays();
+    display.reset();
+
+    // The static element is always dirty and can't draw its changes, so the
+    // entire display is redrawn
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.clears, 1u);
+    EXPECT_EQ(display.displays, 1u);
+    EXPECT_EQ(display.writes, 12u);
+}
+
+// Counts the characters drawn while a DAW streams the names of eight tracks,
+// resending the entire line of the LCD for every change, with a frame after
+// every message.
+TEST(LCDDisplay, benchmarkDrawCalls) {
+    Bank<1> bank;
+    MCU::LCD<> lcd;
+    CountingDisplay displays[8];
+    std::vector<std::unique_ptr<MCU::LCDDisplay>> tracks;
+    for (uint8_t i = 0; i < 8; ++i)
+        tracks.emplace_back(new MCU::LCDDisplay {
+            displays[i], lcd, bank, uint8_t(i + 1), {0, 0}, 1, 1});
+    Control_Surface.updateDisplays();
+
+    constexpr unsigned Messages = 64;
+    std::string line(56, ' ');
+    unsigned frames = 0, writes = 0;
+    for (unsigned m = 0; m < Messages; ++m) {
+        // Rename a single track, e.g. while the user is typing
+        line[7 * (m % 8) + (m / 8) % 6] = 'a' + m % 26;
+        sendText(0, line);
+        for (auto &d : displays)
+            d.reset();
+        Control_Surface.updateDisplays();
+        for (auto &d : displays) {
+            frames += d.displays;
+            writes += d.writes;
+        }
+    }
+    // Without dirty tracking, every frame redraws all six characters of all
+    // eight displays
+    unsigned fullWrites = Messages * 8 * 6;
+    EXPECT_EQ(frames, Messages);
+    EXPECT_EQ(writes, Messages);
+    RecordProperty("full_redraw_chars", std::to_string(fullWrites));
+    RecordProperty("dirty_redraw_chars", std::to_string(writes));
+    RecordProperty("full_redraw_frames", std::to_string(Messages * 8));
+    RecordProperty("dirty_redraw_frames", std::to_string(frames));
+}
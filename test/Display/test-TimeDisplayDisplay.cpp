@@ -0,0 +1,152 @@
+#include <gtest-wrapper.h>
+
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <CountingDisplay.hpp>
+#include <Display/MCU/TimeDisplayDisplay.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// Draws the time display like TimeDisplayDisplay did before the text was
+/// cached: split the characters into fields on every frame, and redraw every
+/// frame.
+class UncachedTimeDisplayDisplay : public DisplayElement {
+  public:
+    UncachedTimeDisplayDisplay(DisplayInterface &display,
+                               const MCU::TimeDisplay &timedisplay)
+        : DisplayElement(display), timedisplay(timedisplay) {}
+
+    void draw() override {
+        char barStr[6], beatStr[3], frameStr[4];
+        uint8_t bars = timedisplay.getCharacterAt(5) == ' '   ? 3
+                       : timedisplay.getCharacterAt(6) == ' ' ? 4
+                                                              : 5;
+        getText(barStr, 0, bars);
+        getText(beatStr, bars, 2);
+        getText(frameStr, bars == 3 ? 7 : bars == 4 ? 8 : 9, 6 - bars);
+        display.print(barStr);
+        display.print(' ');
+        display.print(beatStr);
+        display.print(' ');
+        display.print(frameStr);
+    }
+
+  private:
+    void getText(char *buff, uint8_t offset, uint8_t length) const {
+        for (uint8_t i = 0; i < length; ++i)
+            buff[i] = timedisplay.getCharacterAt(offset + i);
+        buff[length] = '\0';
+    }
+
+    const MCU::TimeDisplay &timedisplay;
+};
+
+void sendCharacter(Channel channel, uint8_t index, char c) {
+    MIDI_Sink &sink = Control_Surface;
+    sink.sinkMIDIfromPipe(ChannelMessage{
+        uint8_t(CONTROL_CHANGE | channel.getRaw()),
+        uint8_t(MCU::TimeDisplayAddress + MCU::TimeDisplayLength - 1 - index),
+        uint8_t(c), 0});
+}
+
+void sendText(Channel channel, const char *text) {
+    for (uint8_t i = 0; i < MCU::TimeDisplayLength; ++i)
+        sendCharacter(channel, i, text[i]);
+}
+
+} // namespace
+
+TEST(TimeDisplayDisplay, onlyRedrawChanges) {
+    MCU::TimeDisplay timedisplay = {CHANNEL_1};
+    CountingDisplay display;
+    MCU::TimeDisplayDisplay tdd = {display, timedisplay, {0, 0}, 1, 1};
+
+    sendText(CHANNEL_1, "  103  000");
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.displays, 1u);
+    EXPECT_EQ(display.text, "  1 03 000");
+    display.reset();
+
+    // The DAW resends the same text
+    sendText(CHANNEL_1, "  103  000");
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.displays, 0u);
+
+    sendCharacter(CHANNEL_1, 9, '1');
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.displays, 1u);
+    EXPECT_EQ(display.text, "  1 03 001");
+    display.reset();
+
+    // Moving the element redraws it
+    tdd.setX(10);
+    Control_Surface.updateDisplays();
+    EXPECT_EQ(display.displays, 1u);
+}
+
+// Measures the cost per frame of drawing eight time displays on eight
+// displays, while the DAW changes one character of one time display per frame,
+// and keeps resending the unchanged characters of the others.
+TEST(TimeDisplayDisplay, benchmarkMultiDisplay) {
+    using namespace std::chrono;
+    constexpr uint8_t NumDisplays = 8;
+    constexpr unsigned Frames = 20000;
+    std::vector<std::unique_ptr<MCU::TimeDisplay>> timedisplays;
+    CountingDisplay displays[NumDisplays];
+    for (uint8_t i = 0; i < NumDisplays; ++i) {
+        timedisplays.emplace_back(new MCU::TimeDisplay{Channel(i)});
+        sendText(Channel(i), "  103  000");
+    }
+
+    auto run = [&] {
+        unsigned redraws = 0;
+        auto start = steady_clock::now();
+        for (unsigned f = 0; f < Frames; ++f) {
+            uint8_t changed = f % NumDisplays;
+            sendCharacter(Channel(changed), 9, '1' + f / NumDisplays % 10);
+            sendCharacter(Channel((changed + 1) % NumDisplays), 0, ' ');
+            Control_Surface.updateDisplays();
+        }
+        auto time = steady_clock::now() - start;
+        for (auto &d : displays) {
+            redraws += d.displays;
+            d.reset();
+        }
+        return std::make_pair(duration_cast<nanoseconds>(time) / Frames,
+                              redraws);
+    };
+
+    std::pair<nanoseconds, unsigned> uncached, cached;
+    {
+        std::vector<std::unique_ptr<UncachedTimeDisplayDisplay>> elements;
+        for (uint8_t i = 0; i < NumDisplays; ++i)
+            elements.emplace_back(new UncachedTimeDisplayDisplay{
+                displays[i], *timedisplays[i]});
+        uncached = run();
+    }
+    {
+        std::vector<std::unique_ptr<MCU::TimeDisplayDisplay>> elements;
+        for (uint8_t i = 0; i < NumDisplays; ++i)
+            elements.emplace_back(new MCU::TimeDisplayDisplay{
+                displays[i], *timedisplays[i], {0, 0}, 1, 1});
+        Control_Surface.updateDisplays();
+        for (auto &d : displays)
+            d.reset();
+        cached = run();
+    }
+    EXPECT_EQ(uncached.second, Frames * NumDisplays);
+    EXPECT_EQ(cached.second, Frames);
+
+    RecordProperty("displays", std::to_string(NumDisplays));
+    RecordProperty("uncached_ns_per_frame",
+                   std::to_string(uncached.first.count()));
+    RecordProperty("cached_ns_per_frame", std::to_string(cached.first.count()));
+    RecordProperty("uncached_redraws", std::to_string(uncached.second));
+    RecordProperty("cached_redraws", std::to_string(cached.second));
+}
@@ -0,0 +1,263 @@
+#include <gtest-wrapper.h>
+
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Inputs/LEDs/NoteCCRangeLEDs.hpp>
+#include <MIDI_Inputs/MCU/VPotRing.hpp>
+#include <MIDI_Inputs/MCU/VU.hpp>
+
+#include <chrono>
+#include <map>
+#include <memory>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using ::testing::_;
+using ::testing::AnyNumber;
+using ::testing::Return;
+
+namespace {
+
+struct CountingVPotCallback {
+    CountingVPotCallback(unsigned &count) : count(&count) {}
+    template <class T>
+    void begin(const T &) {}
+    template <class T>
+    void update(const T &vpot) {
+        ++*count;
+        position = vpot.getPosition();
+    }
+    unsigned *count;
+    uint8_t position = 0;
+};
+
+struct CountingVUCallback {
+    CountingVUCallback(unsigned &count) : count(&count) {}
+    template <class T>
+    void begin(T &) {}
+    template <class T>
+    void update(T &) {
+        ++*count;
+    }
+    unsigned *count;
+};
+
+/// Enables coalescing for the duration of a test.
+struct CoalescedUpdates {
+    CoalescedUpdates() { MIDIInputElement::setCoalescedUpdates(true); }
+    ~CoalescedUpdates() { MIDIInputElement::setCoalescedUpdates(false); }
+};
+
+void sendCC(uint8_t address, uint8_t value, Channel channel = CHANNEL_1) {
+    ChannelMessageMatcher midimsg = {CONTROL_CHANGE, channel, address, value};
+    MIDIInputElementCC::updateAllWith(midimsg);
+}
+
+/// Records the last state of each pin, and counts the writes.
+struct PinStates {
+    PinStates() {
+        EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(_, _))
+            .Times(AnyNumber())
+            .WillRepeatedly([this](pin_t pin, uint8_t state) {
+                states[pin] = state;
+                ++writes;
+            });
+    }
+    std::map<pin_t, uint8_t> states;
+    unsigned writes = 0;
+};
+
+} // namespace
+
+TEST(CoalescedUpdates, disabledByDefault) {
+    EXPECT_FALSE(MIDIInputElement::hasCoalescedUpdates());
+    unsigned count = 0;
+    MCU::GenericVPotRing<CountingVPotCallback> vpot = {1, CHANNEL_1, {count}};
+    sendCC(MCU::VPotRingAddress, 0x05);
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(vpot.callback.position, 5);
+}
+
+TEST(CoalescedUpdates, VPotRing) {
+    CoalescedUpdates coalesced;
+    unsigned count = 0;
+    MCU::GenericVPotRing<CountingVPotCallback> vpot1 = {1, CHANNEL_1, {count}};
+    MCU::GenericVPotRing<CountingVPotCallback> vpot2 = {2, CHANNEL_1, {count}};
+    for (uint8_t i = 0; i < 128; ++i)
+        sendCC(MCU::VPotRingAddress, i % 12);
+    sendCC(MCU::VPotRingAddress + 1, 0x03);
+    EXPECT_EQ(count, 0u);
+    EXPECT_EQ(vpot1.getPosition(), 127 % 12);
+
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(count, 2u);
+    EXPECT_EQ(vpot1.callback.position, 127 % 12);
+    EXPECT_EQ(vpot2.callback.position, 3);
+
+    // Nothing left to flush
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(count, 2u);
+}
+
+TEST(CoalescedUpdates, VU) {
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(0));
+    CoalescedUpdates coalesced;
+    unsigned count = 0;
+    MCU::GenericVU<CountingVUCallback> vu = {1, CHANNEL_1, 0, {count}};
+    for (uint8_t i = 0; i < 10; ++i) {
+        ChannelMessageMatcher midimsg = {CHANNEL_PRESSURE, CHANNEL_1, i, 0};
+        MIDIInputElementChannelPressure::updateAllWith(midimsg);
+    }
+    EXPECT_EQ(count, 0u);
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(vu.getValue(), 9);
+    testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+TEST(CoalescedUpdates, disableFlushes) {
+    MIDIInputElement::setCoalescedUpdates(true);
+    unsigned count = 0;
+    MCU::GenericVPotRing<CountingVPotCallback> vpot = {1, CHANNEL_1, {count}};
+    sendCC(MCU::VPotRingAddress, 0x07);
+    EXPECT_EQ(count, 0u);
+    MIDIInputElement::setCoalescedUpdates(false);
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(vpot.callback.position, 7);
+}
+
+TEST(CoalescedUpdates, destroyDirtyElement) {
+    CoalescedUpdates coalesced;
+    unsigned count = 0;
+    MCU::GenericVPotRing<CountingVPotCallback> vpot1 = {1, CHANNEL_1, {count}};
+    {
+        MCU::GenericVPotRing<CountingVPotCallback> vpot2 = {2, CHANNEL_1,
+                                                            {count}};
+        MCU::GenericVPotRing<CountingVPotCallback> vpot3 = {3, CHANNEL_1,
+                                                            {count}};
+        sendCC(MCU::VPotRingAddress + 0, 0x01);
+        sendCC(MCU::VPotRingAddress + 1, 0x02);
+        sendCC(MCU::VPotRingAddress + 2, 0x03);
+    }
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(count, 1u);
+    EXPECT_EQ(vpot1.callback.position, 1);
+}
+
+TEST(CoalescedUpdates, NoteCCRangeLEDsSameFinalState) {
+    auto burst = [] {
+        // The DAW resends all values, some of them multiple times
+        for (uint8_t r = 0; r < 4; ++r)
+            for (uint8_t i = 0; i < 8; ++i)
+                sendCC(0x10 + i, (i + r) % 3 == 0 ? 0x7F : 0x00);
+    };
+
+    PinStates immediate;
+    {
+        CCRangeLEDs<8> leds = {{0, 1, 2, 3, 4, 5, 6, 7}, {0x10, CHANNEL_1}};
+        burst();
+    }
+    testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    PinStates coalesced;
+    {
+        CoalescedUpdates enable;
+        CCRangeLEDs<8> leds = {{0, 1, 2, 3, 4, 5, 6, 7}, {0x10, CHANNEL_1}};
+        burst();
+        EXPECT_EQ(coalesced.writes, 0u);
+        MIDIInputElement::flushAll();
+    }
+    testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    EXPECT_EQ(immediate.states, coalesced.states);
+    EXPECT_EQ(immediate.writes, 32u);
+    EXPECT_EQ(coalesced.writes, 8u);
+}
+
+TEST(CoalescedUpdates, NoteCCRangeOnlyDirtyIndices) {
+    CoalescedUpdates coalesced;
+    PinStates pins;
+    CCRangeLEDs<8> leds = {{0, 1, 2, 3, 4, 5, 6, 7}, {0x10, CHANNEL_1}};
+    sendCC(0x12, 0x7F);
+    sendCC(0x14, 0x7F);
+    sendCC(0x12, 0x00);
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(pins.writes, 2u); // only indices 2 and 4
+    EXPECT_EQ(pins.states[2], LOW);
+    EXPECT_EQ(pins.states[4], HIGH);
+    testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+TEST(CoalescedUpdates, NoteCCRangeFarApart) {
+    struct RecordingCallback : NoteCCRangeEmptyCallback {
+        void update(const INoteCCValue &, uint8_t index) {
+            indices.push_back(index);
+        }
+        std::vector<uint8_t> indices;
+    };
+    CoalescedUpdates coalesced;
+    GenericCCRange<128, RecordingCallback> range = {{0x00, CHANNEL_1}, {}};
+    sendCC(0x7F, 0x11);
+    sendCC(0x00, 0x22);
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(range.callback.indices, (std::vector<uint8_t>{0, 127}));
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(range.callback.indices.size(), 2u);
+}
+
+// Measures the callbacks and the time it takes to handle a burst of 128 CC
+// messages for each of 8 V-Pot rings, and flush them in Control_Surface.loop.
+TEST(CoalescedUpdates, benchmarkBurst) {
+    using namespace std::chrono;
+    constexpr uint8_t NumVPots = 8;
+    constexpr unsigned BurstLength = 128, Loops = 100;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(0));
+    EXPECT_CALL(ArduinoMock::getInstance(), micros())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(0));
+
+    unsigned count = 0;
+    using VPot = MCU::GenericVPotRing<CountingVPotCallback>;
+    std::unique_ptr<VPot> vpots[NumVPots];
+    for (uint8_t i = 0; i < NumVPots; ++i)
+        vpots[i].reset(new VPot {uint8_t(i + 1), CHANNEL_1, {count}});
+
+    auto run = [&] {
+        count = 0;
+        auto start = steady_clock::now();
+        for (unsigned l = 0; l < Loops; ++l) {
+            for (unsigned j = 0; j < BurstLength; ++j)
+                for (uint8_t i = 0; i < NumVPots; ++i)
+                    sendCC(MCU::VPotRingAddress + i, (i + j) % 12);
+            Control_Surface.loop();
+        }
+        return duration_cast<nanoseconds>(steady_clock::now() - start);
+    };
+
+    auto immediate = run();
+    unsigned immediateCount = count;
+    nanoseconds coalesced;
+    {
+        CoalescedUpdates enable;
+        coalesced = run();
+    }
+    unsigned coalescedCount = count;
+    for (uint8_t i = 0; i < NumVPots; ++i)
+        EXPECT_EQ(vpots[i]->callback.position, (i + BurstLength - 1) % 12);
+
+    EXPECT_EQ(immediateCount, Loops * BurstLength * NumVPots);
+    EXPECT_EQ(coalescedCount, Loops * NumVPots);
+    RecordProperty("immediate_callbacks_per_loop",
+                   std::to_string(immediateCount / Loops));
+    RecordProperty("coalesced_callbacks_per_loop",
+                   std::to_string(coalescedCount / Loops));
+    RecordProperty("immediate_ns_per_loop",
+                   std::to_string(immediate.count() / Loops));
+    RecordProperty("coalesced_ns_per_loop",
+                   std::to_string(coalesced.count() / Loops));
+    testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
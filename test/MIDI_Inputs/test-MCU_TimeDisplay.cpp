@@ -247,4 +247,39 @@ TEST(MCUTimeDisplay, getBarsGetBeatsGetFramesSpacesOnly) {
     EXPECT_STREQ(beatStr, "  ");
     EXPECT_STREQ(frameStr, "   ");
     EXPECT_STREQ(text, "          ");
-}
\ No newline at end of file
+}
+
+TEST(MCUTimeDisplay, cachedFields) {
+    constexpr Channel channel = CHANNEL_2;
+    MCU::TimeDisplay tdisp(channel);
+    const char *text = "259301  76";
+    for (uint8_t i = 0; i < 10; ++i)
+        tdisp.updateWith({CONTROL_CHANGE, channel, uint8_t(0x40 + 9 - i),
+                          uint8_t(text[i])});
+    EXPECT_STREQ(tdisp.getText(), text);
+    EXPECT_STREQ(tdisp.getFormattedText(), "2593 01 76");
+    EXPECT_EQ(tdisp.getBarsValue(), 2593u);
+    EXPECT_EQ(tdisp.getBeatsValue(), 1);
+    EXPECT_EQ(tdisp.getFramesValue(), 76);
+
+    // Switching to 3-digit bars changes the layout of all fields
+    tdisp.updateWith({CONTROL_CHANGE, channel, 0x40 + 4, ' '});
+    EXPECT_STREQ(tdisp.getFormattedText(), "259 30  76");
+    EXPECT_EQ(tdisp.getBeatsValue(), 30);
+}
+
+TEST(MCUTimeDisplay, versionOnlyChangesWithText) {
+    constexpr Channel channel = CHANNEL_2;
+    MCU::TimeDisplay tdisp(channel);
+    EXPECT_EQ(tdisp.getVersion(), 0);
+    tdisp.updateWith({CONTROL_CHANGE, channel, 0x40 + 0, '1'});
+    EXPECT_EQ(tdisp.getVersion(), 1);
+    // The DAW resends the same character
+    tdisp.updateWith({CONTROL_CHANGE, channel, 0x40 + 0, '1'});
+    EXPECT_EQ(tdisp.getVersion(), 1);
+    // Only the decimal point changes
+    tdisp.updateWith({CONTROL_CHANGE, channel, 0x40 + 0, '1' | 0x40});
+    EXPECT_EQ(tdisp.getVersion(), 2);
+    EXPECT_EQ(tdisp.getCharacterAt(9), '1');
+    EXPECT_TRUE(tdisp.getDecimalPointAt(9));
+}
@@ -0,0 +1,142 @@
+#include <gtest-wrapper.h>
+
+#include <Banks/Bank.hpp>
+#include <MIDI_Inputs/MCU/VU.hpp>
+#include <MIDI_Inputs/NoteCCRange.hpp>
+
+USING_CS_NAMESPACE;
+
+using ::testing::AnyNumber;
+using ::testing::Return;
+
+namespace {
+
+void sendCC(uint8_t address, Channel channel, uint8_t cable, uint8_t value) {
+    ChannelMessageMatcher midimsg = {CONTROL_CHANGE, channel, address, value,
+                                     cable};
+    MIDIInputElementCC::updateAllWith(midimsg);
+}
+
+void sendNote(uint8_t address, Channel channel, uint8_t cable, uint8_t value) {
+    ChannelMessageMatcher midimsg = {NOTE_ON, channel, address, value, cable};
+    MIDIInputElementNote::updateAllWith(midimsg);
+}
+
+} // namespace
+
+TEST(MIDIInputChannelIndex, resetOnlyMatchingChannelAndCable) {
+    CCValue a = {{0x10, CHANNEL_1}};
+    CCValue b = {{0x10, CHANNEL_2}};
+    CCValue c = {{0x10, CHANNEL_1, 1}};
+    sendCC(0x10, CHANNEL_1, 0, 0x11);
+    sendCC(0x10, CHANNEL_2, 0, 0x22);
+    sendCC(0x10, CHANNEL_1, 1, 0x33);
+
+    MIDIInputElementCC::resetAll(CHANNEL_1, 0);
+    EXPECT_EQ(a.getValue(), 0x00);
+    EXPECT_EQ(b.getValue(), 0x22);
+    EXPECT_EQ(c.getValue(), 0x33);
+
+    MIDIInputElementCC::resetAll(CHANNEL_1, 1);
+    EXPECT_EQ(b.getValue(), 0x22);
+    EXPECT_EQ(c.getValue(), 0x00);
+}
+
+TEST(MIDIInputChannelIndex, addAndRemoveElements) {
+    CCValue a = {{0x10, CHANNEL_3}};
+    sendCC(0x10, CHANNEL_3, 0, 0x11);
+    MIDIInputElementCC::resetAll(CHANNEL_3, 0); // builds the index
+    EXPECT_EQ(a.getValue(), 0x00);
+    {
+        CCValue b = {{0x11, CHANNEL_3}};
+        sendCC(0x10, CHANNEL_3, 0, 0x11);
+        sendCC(0x11, CHANNEL_3, 0, 0x22);
+        MIDIInputElementCC::resetAll(CHANNEL_3, 0);
+        EXPECT_EQ(a.getValue(), 0x00);
+        EXPECT_EQ(b.getValue(), 0x00);
+    }
+    // The destroyed element must no longer be in the index
+    sendCC(0x10, CHANNEL_3, 0, 0x11);
+    MIDIInputElementCC::resetAll(CHANNEL_3, 0);
+    EXPECT_EQ(a.getValue(), 0x00);
+}
+
+TEST(MIDIInputChannelIndex, bankableChangeChannel) {
+    Bank<4> bank(2);
+    // Listens to channels 3, 5, 7 and 9
+    Bankable::CCValue<4> cc = {{bank, CHANGE_CHANNEL}, {0x10, CHANNEL_3}};
+    EXPECT_EQ(cc.getChannelMask(), 0b101010100);
+    EXPECT_EQ(cc.getCableMask(), 0b1);
+
+    sendCC(0x10, CHANNEL_5, 0, 0x55);
+    sendCC(0x10, CHANNEL_3, 0, 0x33);
+    bank.select(1);
+    EXPECT_EQ(cc.getValue(), 0x55);
+    MIDIInputElementCC::resetAll(CHANNEL_4, 0);
+    EXPECT_EQ(cc.getValue(), 0x55);
+    MIDIInputElementCC::resetAll(CHANNEL_5, 1);
+    EXPECT_EQ(cc.getValue(), 0x55);
+    // Only the bank on channel 3 is reset
+    MIDIInputElementCC::resetAll(CHANNEL_3, 0);
+    EXPECT_EQ(cc.getValue(), 0x55);
+    bank.select(0);
+    EXPECT_EQ(cc.getValue(), 0x00);
+    bank.select(1);
+    MIDIInputElementCC::resetAll(CHANNEL_5, 0);
+    EXPECT_EQ(cc.getValue(), 0x00);
+}
+
+TEST(MIDIInputChannelIndex, bankableChangeCable) {
+    Bank<3> bank(1);
+    // Listens to cables 2, 3 and 4, on channel 6
+    Bankable::NoteValue<3> note = {{bank, CHANGE_CABLENB},
+                                   {0x3C, CHANNEL_6, 1}};
+    EXPECT_EQ(note.getChannelMask(), 1 << 5);
+    EXPECT_EQ(note.getCableMask(), 0b1110);
+
+    sendNote(0x3C, CHANNEL_6, 3, 0x7F);
+    sendNote(0x3C, CHANNEL_6, 1, 0x11);
+    bank.select(2);
+    EXPECT_EQ(note.getValue(), 0x7F);
+    MIDIInputElementNote::resetAll(CHANNEL_6, 0);
+    MIDIInputElementNote::resetAll(CHANNEL_7, 3);
+    EXPECT_EQ(note.getValue(), 0x7F);
+    MIDIInputElementNote::resetAll(CHANNEL_6, 3);
+    EXPECT_EQ(note.getValue(), 0x00);
+    // The bank on cable 1 keeps its value
+    bank.select(0);
+    EXPECT_EQ(note.getValue(), 0x11);
+}
+
+TEST(MIDIInputChannelIndex, bankableChangeAddress) {
+    Bank<4> bank(8);
+    Bankable::CCRange<8, 4> cc = {bank, {0x10, CHANNEL_9}};
+    EXPECT_EQ(cc.getChannelMask(), 1 << 8);
+    sendCC(0x12, CHANNEL_9, 0, 0x42);
+    MIDIInputElementCC::resetAll(CHANNEL_10, 0);
+    EXPECT_EQ(cc.getValue(2), 0x42);
+    MIDIInputElementCC::resetAll(CHANNEL_9, 0);
+    EXPECT_EQ(cc.getValue(2), 0x00);
+}
+
+TEST(MIDIInputChannelIndex, channelPressure) {
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(0));
+    Bank<2> bank(1);
+    MCU::Bankable::VU<2> vu = {{bank, CHANGE_CHANNEL}, 1, CHANNEL_1, 0};
+    EXPECT_EQ(vu.getChannelMask(), 0b11);
+    ChannelMessageMatcher midimsg = {CHANNEL_PRESSURE, CHANNEL_2, 0x0A, 0};
+    MIDIInputElementChannelPressure::updateAllWith(midimsg);
+    midimsg = {CHANNEL_PRESSURE, CHANNEL_1, 0x05, 0};
+    MIDIInputElementChannelPressure::updateAllWith(midimsg);
+    bank.select(1);
+    EXPECT_EQ(vu.getValue(), 0x0A);
+    MIDIInputElementChannelPressure::resetAll(CHANNEL_3, 0);
+    EXPECT_EQ(vu.getValue(), 0x0A);
+    MIDIInputElementChannelPressure::resetAll(CHANNEL_2, 0);
+    EXPECT_EQ(vu.getValue(), 0x00);
+    bank.select(0);
+    EXPECT_EQ(vu.getValue(), 0x05);
+    testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
@@ -0,0 +1,304 @@
+#include <gtest-wrapper.h>
+
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Constants/Control_Change.hpp>
+#include <MIDI_Inputs/MPEZoneManager.hpp>
+#include <MIDI_Senders/MPENoteSender.hpp>
+#include <MockMIDI_Interface.hpp>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+using ::testing::InSequence;
+
+namespace {
+
+/// Records the channels of all updates.
+struct RecordingCallback {
+    void update(const MPEZoneManager &, Channel channel) {
+        channels.push_back(channel.getRaw() + 1);
+    }
+    std::vector<int> channels;
+};
+
+void send(uint8_t header, Channel channel, uint8_t data1, uint8_t data2 = 0,
+          uint8_t cable = 0) {
+    MIDI_Sink &sink = Control_Surface;
+    uint8_t status = header | channel.getRaw();
+    sink.sinkMIDIfromPipe(ChannelMessage{status, data1, data2, cable});
+}
+
+void sendPB(Channel channel, uint16_t value) {
+    send(PITCH_BEND, channel, value & 0x7F, value >> 7);
+}
+
+} // namespace
+
+TEST(MPEZone, channels) {
+    MPEZone lower = {MPEZone::Lower, 3};
+    EXPECT_EQ(lower.getManagerChannel(), CHANNEL_1);
+    EXPECT_EQ(lower.getMemberChannel(0), CHANNEL_2);
+    EXPECT_EQ(lower.getMemberChannel(2), CHANNEL_4);
+    EXPECT_FALSE(lower.isMember(CHANNEL_1));
+    EXPECT_TRUE(lower.isMember(CHANNEL_4));
+    EXPECT_FALSE(lower.isMember(CHANNEL_5));
+
+    MPEZone upper = {MPEZone::Upper, 2};
+    EXPECT_EQ(upper.getManagerChannel(), CHANNEL_16);
+    EXPECT_EQ(upper.getMemberChannel(0), CHANNEL_15);
+    EXPECT_EQ(upper.getMemberChannel(1), CHANNEL_14);
+    EXPECT_FALSE(upper.isMember(CHANNEL_16));
+    EXPECT_TRUE(upper.isMember(CHANNEL_14));
+    EXPECT_FALSE(upper.isMember(CHANNEL_13));
+}
+
+TEST(MPEZoneManager, overlappingZones) {
+    MPEZoneManager mpe;
+    EXPECT_EQ(mpe.getZone(MPEZone::Lower).numMembers, 15);
+    EXPECT_EQ(mpe.getZone(MPEZone::Upper).numMembers, 0);
+    EXPECT_EQ(mpe.getZoneOf(CHANNEL_16)->type, MPEZone::Lower);
+    mpe.setZone({MPEZone::Upper, 3});
+    EXPECT_EQ(mpe.getZone(MPEZone::Lower).numMembers, 11);
+    EXPECT_EQ(mpe.getZoneOf(CHANNEL_12)->type, MPEZone::Lower);
+    EXPECT_EQ(mpe.getZoneOf(CHANNEL_13)->type, MPEZone::Upper);
+    EXPECT_EQ(mpe.getZoneOf(CHANNEL_16)->type, MPEZone::Upper);
+    mpe.setZone({MPEZone::Lower, 0});
+    EXPECT_EQ(mpe.getZoneOf(CHANNEL_1), nullptr);
+    EXPECT_EQ(mpe.getZone(MPEZone::Upper).numMembers, 3);
+}
+
+TEST(MPEZoneManager, disableZoneKeepsOtherZone) {
+    MPEZoneManager mpe = {15, 0};
+    // Disabling a zone that is already disabled doesn't shrink the other one
+    mpe.setZone({MPEZone::Upper, 0});
+    EXPECT_EQ(mpe.getZone(MPEZone::Lower).numMembers, 15);
+    mpe.setZone({MPEZone::Lower, 0});
+    mpe.setZone({MPEZone::Upper, 15});
+    mpe.setZone({MPEZone::Lower, 0});
+    EXPECT_EQ(mpe.getZone(MPEZone::Upper).numMembers, 15);
+}
+
+TEST(MPEZoneManager, configurationMessage) {
+    MPEZoneManager mpe;
+    send(CONTROL_CHANGE, CHANNEL_16, MIDI_CC::RPN_MSB, 0x00);
+    send(CONTROL_CHANGE, CHANNEL_16, MIDI_CC::RPN_LSB, 0x06);
+    send(CONTROL_CHANGE, CHANNEL_16, MIDI_CC::Data_Entry_MSB, 0x05);
+    // The configuration is applied at the end of the loop
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(mpe.getZone(MPEZone::Upper).numMembers, 5);
+    EXPECT_EQ(mpe.getZone(MPEZone::Lower).numMembers, 9);
+    MIDIInputElementParameter::resetSelection(CHANNEL_16, 0);
+}
+
+TEST(MPEZoneManager, expression) {
+    GenericMPEZoneManager<RecordingCallback> mpe = {4, 0, 0, {}};
+    // The initial expression is sent before the note
+    sendPB(CHANNEL_3, 0x2100);
+    send(CONTROL_CHANGE, CHANNEL_3, MIDI_CC::Sound_Controller_5, 0x20);
+    send(NOTE_ON, CHANNEL_3, 0x3C, 0x64);
+    send(CHANNEL_PRESSURE, CHANNEL_3, 0x30);
+    send(NOTE_ON, CHANNEL_4, 0x40, 0x50);
+    // Not a member channel
+    send(NOTE_ON, CHANNEL_7, 0x41, 0x50);
+    EXPECT_TRUE(mpe.callback.channels.empty());
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(mpe.callback.channels, (std::vector<int>{3, 4}));
+
+    const MPENote &note = mpe.getNote(CHANNEL_3);
+    EXPECT_EQ(note.note, 0x3C);
+    EXPECT_EQ(note.velocity, 0x64);
+    EXPECT_TRUE(note.active);
+    EXPECT_EQ(note.pitchBend, 0x2100);
+    EXPECT_EQ(note.timbre, 0x20);
+    EXPECT_EQ(note.pressure, 0x30);
+    EXPECT_EQ(mpe.getActiveChannels(), 0b1100);
+
+    // Note off for another note is ignored
+    send(NOTE_OFF, CHANNEL_3, 0x3D, 0x40);
+    EXPECT_TRUE(note.active);
+    send(NOTE_ON, CHANNEL_3, 0x3C, 0x00);
+    EXPECT_FALSE(note.active);
+    EXPECT_EQ(mpe.getActiveChannels(), 0b1000);
+
+    // All Notes Off on the manager channel ends all notes of the zone
+    mpe.callback.channels.clear();
+    MIDIInputElement::flushAll();
+    send(CONTROL_CHANGE, CHANNEL_1, MIDI_CC::All_Notes_Off, 0);
+    EXPECT_EQ(mpe.getActiveChannels(), 0);
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(mpe.callback.channels, (std::vector<int>{3, 4}));
+}
+
+TEST(MPEZoneManager, allocateLeastRecentlyUsed) {
+    MPEZoneManager mpe = {4};
+    uint8_t stolen;
+    EXPECT_EQ(mpe.allocate(60, MPEZone::Lower, stolen), CHANNEL_2);
+    EXPECT_EQ(mpe.allocate(61, MPEZone::Lower, stolen), CHANNEL_3);
+    EXPECT_EQ(mpe.allocate(62, MPEZone::Lower, stolen), CHANNEL_4);
+    EXPECT_EQ(stolen, 0xFF);
+    Channel channel = CHANNEL_1;
+    EXPECT_TRUE(mpe.release(61, MPEZone::Lower, channel));
+    EXPECT_EQ(channel, CHANNEL_3);
+    EXPECT_FALSE(mpe.release(61, MPEZone::Lower, channel));
+
+    // Channel 5 was never used, channel 3 was just released
+    EXPECT_EQ(mpe.allocate(63, MPEZone::Lower, stolen), CHANNEL_5);
+    EXPECT_EQ(mpe.allocate(64, MPEZone::Lower, stolen), CHANNEL_3);
+    EXPECT_EQ(stolen, 0xFF);
+    // All channels are in use, steal the oldest note
+    EXPECT_EQ(mpe.allocate(65, MPEZone::Lower, stolen), CHANNEL_2);
+    EXPECT_EQ(stolen, 60);
+    EXPECT_TRUE(mpe.find(64, MPEZone::Lower, channel));
+    EXPECT_EQ(channel, CHANNEL_3);
+    EXPECT_FALSE(mpe.find(60, MPEZone::Lower, channel));
+
+    // Disabled zones use the manager channel
+    EXPECT_EQ(mpe.allocate(66, MPEZone::Upper, stolen), CHANNEL_16);
+}
+
+TEST(MPENoteSender, sendNotes) {
+    MockMIDI_Interface midi;
+    Control_Surface.connectDefaultMIDI_Interface();
+    MPEZoneManager mpe = {2, 0, 3};
+    MPENoteSender sender = mpe;
+
+    InSequence seq;
+    EXPECT_CALL(midi, sendImpl(CONTROL_CHANGE, 0, MIDI_CC::RPN_MSB, 0, 3));
+    EXPECT_CALL(midi, sendImpl(CONTROL_CHANGE, 0, MIDI_CC::RPN_LSB, 6, 3));
+    EXPECT_CALL(midi,
+                sendImpl(CONTROL_CHANGE, 0, MIDI_CC::Data_Entry_MSB, 2, 3));
+    sender.sendConfiguration();
+
+    EXPECT_CALL(midi, sendImpl(PITCH_BEND, 1, 0x00, 0x40, 3));
+    EXPECT_CALL(midi, sendImpl(CONTROL_CHANGE, 1, MIDI_CC::Sound_Controller_5,
+                               0x40, 3));
+    EXPECT_CALL(midi, sendImpl(CHANNEL_PRESSURE, 1, 0x00, 3));
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 1, 60, 0x7F, 3));
+    EXPECT_EQ(sender.sendOn(60), CHANNEL_2);
+
+    EXPECT_CALL(midi, sendImpl(PITCH_BEND, 1, 0x7F, 0x7F, 3));
+    sender.sendPitchBend(60, 0x3FFF);
+    EXPECT_CALL(midi, sendImpl(CHANNEL_PRESSURE, 1, 0x11, 3));
+    sender.sendPressure(60, 0x11);
+    EXPECT_CALL(midi, sendImpl(CONTROL_CHANGE, 1, MIDI_CC::Sound_Controller_5,
+                               0x22, 3));
+    sender.sendTimbre(60, 0x22);
+    // Unknown notes are ignored
+    sender.sendPitchBend(61, 0x3FFF);
+
+    EXPECT_CALL(midi, sendImpl(PITCH_BEND, 2, 0x00, 0x40, 3));
+    EXPECT_CALL(midi, sendImpl(CONTROL_CHANGE, 2, MIDI_CC::Sound_Controller_5,
+                               0x40, 3));
+    EXPECT_CALL(midi, sendImpl(CHANNEL_PRESSURE, 2, 0x00, 3));
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 2, 62, 0x7F, 3));
+    sender.sendOn(62);
+
+    // Both channels are in use, the first note is stolen
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 1, 60, 0x40, 3));
+    EXPECT_CALL(midi, sendImpl(PITCH_BEND, 1, 0x00, 0x40, 3));
+    EXPECT_CALL(midi, sendImpl(CONTROL_CHANGE, 1, MIDI_CC::Sound_Controller_5,
+                               0x40, 3));
+    EXPECT_CALL(midi, sendImpl(CHANNEL_PRESSURE, 1, 0x00, 3));
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 1, 64, 0x7F, 3));
+    sender.sendOn(64);
+
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 2, 62, 0x40, 3));
+    sender.sendOff(62);
+    sender.sendOff(62);
+
+    // Outgoing notes survive a reconfiguration of the zone
+    mpe.setZone({MPEZone::Lower, 0});
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 1, 64, 0x40, 3));
+    sender.sendOff(64);
+    sender.sendOff(64);
+}
+
+// Plays dense chords on all fifteen member channels of the Lower Zone, and
+// measures the cost of allocating and releasing the channels of outgoing notes,
+// and of finding the note of incoming expression messages, compared to a
+// search through a list of active notes.
+TEST(MPEZoneManager, benchmark) {
+    using namespace std::chrono;
+    constexpr unsigned Chords = 2000;
+    constexpr uint8_t Voices = 15;
+
+    MPEZoneManager mpe;
+    auto start = steady_clock::now();
+    unsigned steals = 0;
+    for (unsigned c = 0; c < Chords; ++c) {
+        uint8_t stolen;
+        // One extra voice, so one note is stolen for every chord
+        for (uint8_t v = 0; v <= Voices; ++v) {
+            mpe.allocate((c + 5 * v) % 128, MPEZone::Lower, stolen);
+            steals += stolen != 0xFF;
+        }
+        Channel channel = CHANNEL_1;
+        for (uint8_t v = 0; v <= Voices; ++v)
+            mpe.release((c + 5 * v) % 128, MPEZone::Lower, channel);
+    }
+    auto allocation = steady_clock::now() - start;
+    EXPECT_EQ(steals, Chords);
+
+    // Incoming expression: every voice sends Pitch Bend, pressure and timbre
+    constexpr unsigned Frames = 2000;
+    for (uint8_t v = 0; v < Voices; ++v)
+        MPEZoneManager::updateAllWith(
+            {NOTE_ON, Channel(1 + v), uint8_t(40 + v), 0x7F});
+    uint32_t checksum = 0;
+    start = steady_clock::now();
+    for (unsigned f = 0; f < Frames; ++f) {
+        for (uint8_t v = 0; v < Voices; ++v) {
+            Channel ch = Channel(1 + v);
+            MPEZoneManager::updateAllWith(
+                {PITCH_BEND, ch, uint8_t(f & 0x7F), 0x40});
+            MPEZoneManager::updateAllWith({CHANNEL_PRESSURE, ch, 0x20, 0});
+            MPEZoneManager::updateAllWith(
+                {CC, ch, MIDI_CC::Sound_Controller_5, uint8_t(v)});
+            checksum += mpe.getNote(ch).pitchBend;
+        }
+        MIDIInputElement::flushAll();
+    }
+    auto lookup = steady_clock::now() - start;
+    EXPECT_EQ(mpe.getNote(CHANNEL_16).timbre, 14);
+
+    // Baseline: search the list of active notes for every message
+    struct ActiveNote {
+        uint8_t channel, note;
+        uint16_t pitchBend;
+        uint8_t pressure, timbre;
+    };
+    std::vector<ActiveNote> active;
+    for (uint8_t v = 0; v < Voices; ++v)
+        active.push_back({uint8_t(1 + v), uint8_t(40 + v), 0x2000, 0, 0x40});
+    auto findNote = [&](uint8_t channel) -> ActiveNote & {
+        for (auto &n : active)
+            if (n.channel == channel)
+                return n;
+        return active.front(); // LCOV_EXCL_LINE
+    };
+    uint32_t baselineChecksum = 0;
+    start = steady_clock::now();
+    for (unsigned f = 0; f < Frames; ++f) {
+        for (uint8_t v = 0; v < Voices; ++v) {
+            findNote(1 + v).pitchBend = (f & 0x7F) | 0x40 << 7;
+            findNote(1 + v).pressure = 0x20;
+            findNote(1 + v).timbre = v;
+            baselineChecksum += findNote(1 + v).pitchBend;
+        }
+    }
+    auto baseline = steady_clock::now() - start;
+    EXPECT_EQ(checksum, baselineChecksum);
+    mpe.reset();
+    MIDIInputElement::flushAll();
+
+    unsigned allocations = Chords * (Voices + 1);
+    unsigned messages = Frames * Voices * 3;
+    auto ns = [](nanoseconds t, unsigned n) {
+        return std::to_string(t.count() / n);
+    };
+    RecordProperty("ns_per_allocation", ns(allocation, allocations));
+    RecordProperty("table_ns_per_message", ns(lookup, messages));
+    RecordProperty("search_ns_per_message", ns(baseline, messages));
+}
@@ -0,0 +1,342 @@
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Inputs/MTCDecoder.hpp>
+#include <gmock-wrapper.h>
+#include <gtest-wrapper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+using ::testing::AnyNumber;
+using ::testing::Mock;
+using ::testing::Return;
+
+namespace {
+
+/// Real frame rate, in frames per second.
+double getRealFrameRate(MTCFrameRate rate) {
+    return rate == MTCFrameRate::FPS_29_97_DF
+               ? 30000. / 1001
+               : MTCTimecode::getNominalFrameRate(rate);
+}
+
+/// Count one frame, like a timecode generator, independently of
+/// MTCTimecode::setFrameNumber.
+void nextFrame(MTCTimecode &tc) {
+    if (++tc.frames < MTCTimecode::getNominalFrameRate(tc.rate))
+        return;
+    tc.frames = 0;
+    if (++tc.seconds == 60) {
+        tc.seconds = 0;
+        if (++tc.minutes == 60) {
+            tc.minutes = 0;
+            if (++tc.hours == 24)
+                tc.hours = 0;
+        }
+        // Drop frame numbers 0 and 1, except in every tenth minute
+        if (tc.rate == MTCFrameRate::FPS_29_97_DF && tc.minutes % 10 != 0)
+            tc.frames = 2;
+    }
+}
+
+/// Get the data byte of the given Quarter Frame piece of the given timecode.
+uint8_t getPiece(const MTCTimecode &tc, uint8_t piece) {
+    uint8_t nibble = 0;
+    switch (piece) {
+        case 0: nibble = tc.frames & 0xF; break;
+        case 1: nibble = tc.frames >> 4; break;
+        case 2: nibble = tc.seconds & 0xF; break;
+        case 3: nibble = tc.seconds >> 4; break;
+        case 4: nibble = tc.minutes & 0xF; break;
+        case 5: nibble = tc.minutes >> 4; break;
+        case 6: nibble = tc.hours & 0xF; break;
+        default: // 7
+            nibble = tc.hours >> 4 | static_cast<uint8_t>(tc.rate) << 1;
+            break;
+    }
+    return piece << 4 | nibble;
+}
+
+/// Deterministic uniform noise in [-amplitude, amplitude].
+struct Jitter {
+    double operator()(double amplitude) {
+        state = state * 1103515245 + 12345;
+        double u = double((state >> 8) & 0xFFFF) / 0xFFFF;
+        return (2 * u - 1) * amplitude;
+    }
+    uint32_t state = 1;
+};
+
+MTCTimecode makeTimecode(uint8_t h, uint8_t m, uint8_t s, uint8_t f,
+                         MTCFrameRate rate) {
+    MTCTimecode tc;
+    tc.hours = h, tc.minutes = m, tc.seconds = s, tc.frames = f;
+    tc.rate = rate;
+    return tc;
+}
+
+void expectLabel(const MTCTimecode &actual, const MTCTimecode &expected) {
+    EXPECT_EQ(actual.hours, expected.hours);
+    EXPECT_EQ(actual.minutes, expected.minutes);
+    EXPECT_EQ(actual.seconds, expected.seconds);
+    EXPECT_EQ(actual.frames, expected.frames);
+    EXPECT_EQ(actual.rate, expected.rate);
+}
+
+/**
+ * Simulates an MTC sender that runs for the given number of frames, starting
+ * at the given timecode, with Quarter Frames that arrive with random jitter.
+ * The stream starts in the middle of a group of eight Quarter Frames.
+ * Checks the timecode every time a group is complete, and returns the maximum
+ * difference between the interpolated time and the exact time of the sender,
+ * in microseconds, at three moments between every two Quarter Frames.
+ */
+double runStream(MTCTimecode start, unsigned numFrames, double jitter) {
+    MTCDecoder decoder;
+    const MTCFrameRate rate = start.rate;
+    const double frameTime = 1e6 / getRealFrameRate(rate);
+    const double qfTime = frameTime / 4;
+    const double t0 = 1e6;
+    const double startFrame = start.toFrameNumber();
+    const double framesPerDay = MTCTimecode::getFramesPerDay(rate);
+    Jitter noise;
+
+    MTCTimecode group = start;
+    const unsigned first = 3, last = 4 * numFrames;
+    double arrival = t0 + first * qfTime + noise(jitter);
+    double maxError = 0;
+    for (unsigned k = first; k < last; ++k) {
+        uint8_t piece = k % 8;
+        decoder.updateQuarterFrame(getPiece(group, piece),
+                                   (unsigned long)arrival);
+        double nextArrival = t0 + (k + 1) * qfTime + noise(jitter);
+        if (piece == 7) {
+            // The sender moves on to the timecode two frames later
+            nextFrame(group);
+            if (k < 8) {
+                // The first group was incomplete
+                EXPECT_FALSE(decoder.isLocked());
+            } else {
+                EXPECT_TRUE(decoder.isRunning((unsigned long)arrival));
+                // The position is 7/4 frames after the start of the group
+                expectLabel(decoder.getTimecode((unsigned long)arrival),
+                            group);
+            }
+            nextFrame(group);
+        }
+        if (decoder.isLocked()) {
+            for (double u : {0.05, 0.5, 0.95}) {
+                double t = arrival + u * (nextArrival - arrival);
+                double decoded = decoder.getSubframes((unsigned long)t);
+                double frame = startFrame + (t - t0) / frameTime;
+                double exact = 100 * std::fmod(frame, framesPerDay);
+                double error = std::abs(decoded - exact) / 100 * frameTime;
+                // Around midnight
+                error = std::min(error, framesPerDay * frameTime - error);
+                maxError = std::max(maxError, error);
+            }
+        }
+        arrival = nextArrival;
+    }
+    EXPECT_TRUE(decoder.isLocked());
+    return maxError;
+}
+
+constexpr double Jitter_us = 1000;
+constexpr double MaxError_us = 1500;
+
+void sendQuarterFrame(uint8_t data, uint8_t cable, unsigned long time) {
+    EXPECT_CALL(ArduinoMock::getInstance(), micros())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(time));
+    MIDI_Sink &sink = Control_Surface;
+    sink.sinkMIDIfromPipe(ChannelMessage{MTCQuarterFrame, data, 0, cable});
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+} // namespace
+
+TEST(MTCTimecode, dropFrameRoundTrip) {
+    MTCTimecode tc = makeTimecode(0, 0, 0, 0, MTCFrameRate::FPS_29_97_DF);
+    MTCTimecode label = tc;
+    uint32_t frames = MTCTimecode::getFramesPerDay(tc.rate);
+    EXPECT_EQ(frames, 2589408u);
+    for (uint32_t n = 0; n < frames; ++n) {
+        tc.setFrameNumber(n);
+        if (tc.frames != label.frames || tc.seconds != label.seconds ||
+            tc.minutes != label.minutes || tc.hours != label.hours) {
+            FAIL() << "frame " << n;
+        }
+        ASSERT_EQ(tc.toFrameNumber(), n);
+        nextFrame(label);
+    }
+    tc.setFrameNumber(frames);
+    expectLabel(tc, makeTimecode(0, 0, 0, 0, MTCFrameRate::FPS_29_97_DF));
+}
+
+TEST(MTCDecoder, stream24) {
+    auto start = makeTimecode(1, 59, 59, 20, MTCFrameRate::FPS_24);
+    double error = runStream(start, 24 * 60, Jitter_us);
+    EXPECT_LT(error, MaxError_us);
+    RecordProperty("max_error_us", std::to_string(std::lround(error)));
+}
+
+TEST(MTCDecoder, stream25) {
+    auto start = makeTimecode(10, 20, 30, 0, MTCFrameRate::FPS_25);
+    double error = runStream(start, 25 * 60, Jitter_us);
+    EXPECT_LT(error, MaxError_us);
+    RecordProperty("max_error_us", std::to_string(std::lround(error)));
+}
+
+TEST(MTCDecoder, stream29_97DropFrame) {
+    // Ten minutes, across minutes with and without dropped frame numbers
+    auto start = makeTimecode(0, 8, 59, 20, MTCFrameRate::FPS_29_97_DF);
+    double error = runStream(start, 17982, Jitter_us);
+    EXPECT_LT(error, MaxError_us);
+    RecordProperty("max_error_us", std::to_string(std::lround(error)));
+}
+
+TEST(MTCDecoder, stream30) {
+    // Across midnight
+    auto start = makeTimecode(23, 59, 58, 0, MTCFrameRate::FPS_30);
+    double error = runStream(start, 30 * 60, Jitter_us);
+    EXPECT_LT(error, MaxError_us);
+    RecordProperty("max_error_us", std::to_string(std::lround(error)));
+}
+
+TEST(MTCDecoder, streamWithoutJitter) {
+    auto start = makeTimecode(0, 0, 0, 0, MTCFrameRate::FPS_30);
+    double error = runStream(start, 30 * 60 * 10, 0);
+    // Only the resolution of the subframes
+    EXPECT_LT(error, 1e6 / 30 / 100 + 1);
+}
+
+TEST(MTCDecoder, missingPiece) {
+    MTCDecoder decoder;
+    auto tc = makeTimecode(1, 2, 3, 4, MTCFrameRate::FPS_25);
+    unsigned long t = 0;
+    for (uint8_t piece = 0; piece < 8; ++piece)
+        decoder.updateQuarterFrame(getPiece(tc, piece), t += 10000);
+    EXPECT_TRUE(decoder.isRunning(t));
+    nextFrame(tc), nextFrame(tc);
+    decoder.updateQuarterFrame(getPiece(tc, 0), t += 10000);
+    decoder.updateQuarterFrame(getPiece(tc, 2), t += 20000);
+    EXPECT_FALSE(decoder.isRunning(t));
+    // The last known position is kept
+    EXPECT_TRUE(decoder.isLocked());
+    EXPECT_EQ(decoder.getTimecode(t).frames, 6);
+    for (uint8_t piece = 3; piece < 8; ++piece)
+        decoder.updateQuarterFrame(getPiece(tc, piece), t += 10000);
+    EXPECT_FALSE(decoder.isRunning(t));
+    nextFrame(tc), nextFrame(tc);
+    for (uint8_t piece = 0; piece < 8; ++piece)
+        decoder.updateQuarterFrame(getPiece(tc, piece), t += 10000);
+    EXPECT_TRUE(decoder.isRunning(t));
+    nextFrame(tc);
+    expectLabel(decoder.getTimecode(t), tc);
+}
+
+TEST(MTCDecoder, stopped) {
+    MTCDecoder decoder;
+    auto tc = makeTimecode(0, 0, 10, 0, MTCFrameRate::FPS_25);
+    unsigned long t = 0;
+    for (uint8_t piece = 0; piece < 8; ++piece)
+        decoder.updateQuarterFrame(getPiece(tc, piece), t += 10000);
+    // 10:01 + 3/4 frame
+    EXPECT_EQ(decoder.getSubframes(t), 25 * 10 * 100 + 175);
+    EXPECT_EQ(decoder.getSubframes(t + 5000), 25 * 10 * 100 + 187);
+    // Never further than the next Quarter Frame
+    EXPECT_EQ(decoder.getSubframes(t + 15000), 25 * 10 * 100 + 199);
+    EXPECT_EQ(decoder.getSubframes(t + 1000000), 25 * 10 * 100 + 199);
+    EXPECT_TRUE(decoder.isRunning(t + 70000));
+    EXPECT_FALSE(decoder.isRunning(t + 90000));
+}
+
+TEST(MTCDecoder, controlSurfaceQuarterFrames) {
+    MTCDecoder decoder(2), other(3);
+    auto tc = makeTimecode(12, 34, 56, 7, MTCFrameRate::FPS_30);
+    unsigned long t = 1000;
+    for (uint8_t piece = 0; piece < 8; ++piece)
+        sendQuarterFrame(getPiece(tc, piece), 2, t += 8333);
+    EXPECT_TRUE(decoder.isLocked());
+    EXPECT_FALSE(other.isLocked());
+    nextFrame(tc);
+    EXPECT_CALL(ArduinoMock::getInstance(), micros())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(t));
+    expectLabel(decoder.getTimecode(), tc);
+    EXPECT_TRUE(decoder.isRunning());
+    char bars[6], beats[3], frames[4];
+    decoder.getBars(bars);
+    decoder.getBeats(beats);
+    decoder.getFrames(frames);
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    EXPECT_STREQ(bars, "12:34");
+    EXPECT_STREQ(beats, "56");
+    EXPECT_STREQ(frames, "08");
+}
+
+TEST(MTCDecoder, controlSurfaceFullFrame) {
+    MTCDecoder decoder;
+    // 25 fps, 02:03:04:05
+    const uint8_t fullFrame[] = {0xF0, 0x7F, 0x7F, 0x01, 0x01,
+                                 0x22, 0x03, 0x04, 0x05, 0xF7};
+    EXPECT_CALL(ArduinoMock::getInstance(), micros())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(5000));
+    MIDI_Sink &sink = Control_Surface;
+    sink.sinkMIDIfromPipe(SysExMessage{fullFrame, sizeof(fullFrame), 0});
+    EXPECT_TRUE(decoder.isLocked());
+    EXPECT_FALSE(decoder.isRunning());
+    MTCTimecode tc = decoder.getTimecode();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    expectLabel(tc, makeTimecode(2, 3, 4, 5, MTCFrameRate::FPS_25));
+    EXPECT_EQ(tc.subframes, 0);
+    // Not interpolated while stopped
+    EXPECT_EQ(decoder.getSubframes(1000000), decoder.getSubframes(5000));
+
+    const uint8_t other[] = {0xF0, 0x7F, 0x7F, 0x01, 0x02,
+                             0x22, 0x03, 0x04, 0x06, 0xF7};
+    EXPECT_FALSE(MTCDecoder::isFullFrame({other, sizeof(other), 0}));
+    EXPECT_FALSE(decoder.updateFullFrame({other, sizeof(other), 0}, 0));
+}
+
+// Measures the cost of decoding one frame (four Quarter Frames), and of getting
+// the interpolated timecode, e.g. to draw it on a display once per frame.
+TEST(MTCDecoder, benchmarkPerFrame) {
+    using namespace std::chrono;
+    constexpr unsigned Frames = 200000;
+    MTCDecoder decoder;
+    auto tc = makeTimecode(0, 0, 0, 0, MTCFrameRate::FPS_29_97_DF);
+    Jitter noise;
+    std::vector<uint8_t> data;
+    std::vector<unsigned long> times;
+    const double qfTime = 1e6 / getRealFrameRate(tc.rate) / 4;
+    for (unsigned k = 0; k < 4 * Frames; ++k) {
+        data.push_back(getPiece(tc, k % 8));
+        times.push_back((unsigned long)(k * qfTime + 1000 + noise(500)));
+        if (k % 8 == 7)
+            nextFrame(tc), nextFrame(tc);
+    }
+
+    auto start = steady_clock::now();
+    for (unsigned k = 0; k < 4 * Frames; ++k)
+        decoder.updateQuarterFrame(data[k], times[k]);
+    auto decode = steady_clock::now() - start;
+    EXPECT_TRUE(decoder.isRunning(times.back()));
+
+    uint32_t checksum = 0;
+    start = steady_clock::now();
+    for (unsigned f = 0; f < Frames; ++f)
+        checksum += decoder.getTimecode(times.back() + f % 8000).frames;
+    auto get = steady_clock::now() - start;
+    EXPECT_GT(checksum, 0u);
+
+    auto ns = [](nanoseconds t) { return std::to_string(t.count() / Frames); };
+    RecordProperty("frames", std::to_string(Frames));
+    RecordProperty("decode_ns_per_frame", ns(decode));
+    RecordProperty("get_timecode_ns", ns(get));
+}
@@ -0,0 +1,174 @@
+#include <gtest-wrapper.h>
+
+#include <Banks/Bank.hpp>
+#include <MIDI_Inputs/LEDs/NoteCCRangeLEDs.hpp>
+#include <MIDI_Inputs/NoteCCRange.hpp>
+
+#include <memory>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using ::testing::_;
+using ::testing::AnyNumber;
+
+namespace {
+
+/// Records the indices that were updated.
+struct RecordingCallback : SimpleNoteCCValueCallback {
+    RecordingCallback(std::vector<uint8_t> &updated) : updated(&updated) {}
+    void update(const INoteCCValue &, uint8_t index) override {
+        updated->push_back(index);
+    }
+    std::vector<uint8_t> *updated;
+};
+
+template <uint8_t RangeLen, uint8_t NumBanks>
+using RecordingCCRange =
+    Bankable::GenericCCRange<RangeLen, NumBanks, RecordingCallback>;
+
+void sendCC(uint8_t address, Channel channel, uint8_t value) {
+    ChannelMessageMatcher midimsg = {CONTROL_CHANGE, channel, address, value};
+    MIDIInputElementCC::updateAllWith(midimsg);
+}
+
+} // namespace
+
+TEST(NoteCCRangeBankable, bankChangeOnlyUpdatesChangedValues) {
+    std::vector<uint8_t> updated;
+    Bank<3> bank(4);
+    RecordingCCRange<4, 3> range = {bank, {0x10, CHANNEL_1}, {updated}};
+
+    sendCC(0x10 + 4 + 1, CHANNEL_1, 0x20); // bank 1, index 1
+    sendCC(0x10 + 4 + 3, CHANNEL_1, 0x30); // bank 1, index 3
+    sendCC(0x10 + 8 + 3, CHANNEL_1, 0x30); // bank 2, index 3
+    EXPECT_TRUE(updated.empty()); // not the active bank
+
+    bank.select(1);
+    EXPECT_EQ(updated, (std::vector<uint8_t>{1, 3}));
+    EXPECT_EQ(range.getValue(1), 0x20);
+    EXPECT_EQ(range.getValue(3), 0x30);
+
+    // Index 3 has the same value in bank 2
+    updated.clear();
+    bank.select(2);
+    EXPECT_EQ(updated, (std::vector<uint8_t>{1}));
+
+    // Selecting the same bank again doesn't update anything
+    updated.clear();
+    bank.select(2);
+    EXPECT_TRUE(updated.empty());
+
+    updated.clear();
+    bank.select(0);
+    EXPECT_EQ(updated, (std::vector<uint8_t>{3}));
+}
+
+TEST(NoteCCRangeBankable, bankChangeChannel) {
+    std::vector<uint8_t> updated;
+    Bank<2> bank(1);
+    RecordingCCRange<2, 2> range = {
+        {bank, CHANGE_CHANNEL}, {0x10, CHANNEL_1}, {updated}};
+
+    sendCC(0x11, CHANNEL_2, 0x7F);
+    EXPECT_TRUE(updated.empty());
+    bank.select(1);
+    EXPECT_EQ(updated, (std::vector<uint8_t>{1}));
+    EXPECT_EQ(range.getValue(1), 0x7F);
+
+    // Active bank: updated immediately, and not again on the next bank change
+    updated.clear();
+    sendCC(0x10, CHANNEL_2, 0x01);
+    EXPECT_EQ(updated, (std::vector<uint8_t>{0}));
+    updated.clear();
+    bank.select(0);
+    EXPECT_EQ(updated, (std::vector<uint8_t>{0, 1}));
+}
+
+TEST(NoteCCRangeBankable, initialSelection) {
+    std::vector<uint8_t> updated;
+    Bank<2> bank(4, 1);
+    RecordingCCRange<4, 2> range = {bank, {0x10, CHANNEL_1}, {updated}};
+    sendCC(0x10 + 2, CHANNEL_1, 0x40); // bank 0, index 2
+    EXPECT_TRUE(updated.empty());
+    bank.select(0);
+    EXPECT_EQ(updated, (std::vector<uint8_t>{2}));
+    EXPECT_EQ(range.getValue(2), 0x40);
+}
+
+TEST(NoteCCRangeBankable, LEDsBankChange) {
+    Bank<2> bank(4);
+    Bankable::CCRangeLEDs<4, 2> leds = {bank, {0, 1, 2, 3}, {0x10, CHANNEL_1}};
+
+    sendCC(0x10 + 4 + 2, CHANNEL_1, 0x7F);
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(2, HIGH));
+    bank.select(1);
+    testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(2, LOW));
+    bank.select(0);
+    testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+// Counts the callbacks and the digitalWrite calls for bank switches on a
+// typical mixer layout: 8 channel strips with 8 LEDs each, where only a few of
+// the values differ between banks.
+TEST(NoteCCRangeBankable, benchmarkBankSwitch) {
+    constexpr uint8_t Strips = 8, RangeLen = 8, NumBanks = 4;
+    constexpr unsigned Switches = 100;
+    Bank<NumBanks> bank(RangeLen);
+
+    std::vector<uint8_t> updated;
+    using Range = RecordingCCRange<RangeLen, NumBanks>;
+    std::vector<std::unique_ptr<Range>> ranges;
+    for (uint8_t s = 0; s < Strips; ++s)
+        ranges.emplace_back(new Range {
+            bank, {0x00, Channel(s)}, RecordingCallback {updated}});
+
+    unsigned writes = 0;
+    Bankable::CCRangeLEDs<RangeLen, NumBanks> leds = {
+        bank, {0, 1, 2, 3, 4, 5, 6, 7}, {0x00, CHANNEL_16}};
+    EXPECT_CALL(ArduinoMock::getInstance(), digitalWrite(_, _))
+        .Times(AnyNumber())
+        .WillRepeatedly([&](pin_t, uint8_t) { ++writes; });
+
+    // One button per strip is on in each bank (e.g. a mute button)
+    for (uint8_t b = 0; b < NumBanks; ++b) {
+        for (uint8_t s = 0; s < Strips; ++s)
+            sendCC(b * RangeLen + (s + b) % RangeLen, Channel(s), 0x7F);
+        sendCC(b * RangeLen + b, CHANNEL_16, 0x7F);
+    }
+    updated.clear();
+    writes = 0;
+
+    for (unsigned i = 1; i <= Switches; ++i)
+        bank.select(i % NumBanks);
+    unsigned diffCallbacks = updated.size();
+    unsigned diffWrites = writes;
+
+    // What a full refresh of every element would cost
+    updated.clear();
+    writes = 0;
+    for (unsigned i = 1; i <= Switches; ++i) {
+        for (auto &range : ranges)
+            range->callback.updateAll(*range);
+        leds.callback.updateAll(leds);
+    }
+    unsigned fullCallbacks = updated.size();
+    unsigned fullWrites = writes;
+
+    EXPECT_EQ(fullCallbacks, Switches * Strips * RangeLen);
+    EXPECT_EQ(fullWrites, Switches * RangeLen);
+    // Each switch turns one LED off and another one on per element
+    EXPECT_EQ(diffCallbacks, Switches * Strips * 2);
+    EXPECT_EQ(diffWrites, Switches * 2);
+
+    RecordProperty("full_callbacks_per_switch",
+                   std::to_string(fullCallbacks / Switches));
+    RecordProperty("diff_callbacks_per_switch",
+                   std::to_string(diffCallbacks / Switches));
+    RecordProperty("full_writes_per_switch",
+                   std::to_string(fullWrites / Switches));
+    RecordProperty("diff_writes_per_switch",
+                   std::to_string(diffWrites / Switches));
+}
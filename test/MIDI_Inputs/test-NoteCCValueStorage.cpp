@@ -0,0 +1,141 @@
+#include <gtest-wrapper.h>
+
+#include <Banks/Bank.hpp>
+#include <MIDI_Inputs/NoteCCRange.hpp>
+
+#include <chrono>
+#include <string>
+
+USING_CS_NAMESPACE;
+
+static_assert(sizeof(ByteValueStorage<1024>) == 1024, "");
+static_assert(sizeof(SevenBitValueStorage<1024>) == 897, "");
+static_assert(sizeof(OneBitValueStorage<1024>) == 128, "");
+
+template <class Storage>
+class NoteCCValueStorageTest : public ::testing::Test {};
+
+using Storages =
+    ::testing::Types<ByteValueStorage<37>, SevenBitValueStorage<37>>;
+TYPED_TEST_SUITE(NoteCCValueStorageTest, Storages, );
+
+TYPED_TEST(NoteCCValueStorageTest, setGet) {
+    TypeParam storage;
+    for (uint16_t i = 0; i < 37; ++i)
+        EXPECT_EQ(storage.get(i), 0);
+    for (uint16_t i = 0; i < 37; ++i)
+        storage.set(i, (i * 29 + 3) & 0x7F);
+    for (uint16_t i = 0; i < 37; ++i)
+        EXPECT_EQ(storage.get(i), (i * 29 + 3) & 0x7F) << i;
+    // Overwriting a value doesn't affect its neighbors
+    storage.set(20, 0x7F);
+    storage.set(21, 0x00);
+    EXPECT_EQ(storage.get(19), (19 * 29 + 3) & 0x7F);
+    EXPECT_EQ(storage.get(20), 0x7F);
+    EXPECT_EQ(storage.get(21), 0x00);
+    EXPECT_EQ(storage.get(22), (22 * 29 + 3) & 0x7F);
+    storage.reset();
+    for (uint16_t i = 0; i < 37; ++i)
+        EXPECT_EQ(storage.get(i), 0);
+}
+
+TEST(SevenBitValueStorage, largeIndices) {
+    // The bit offsets of these values don't fit in 16 bits
+    static SevenBitValueStorage<10000> storage;
+    storage.set(9362, 0x11);
+    storage.set(9363, 0x7F);
+    storage.set(9999, 0x55);
+    EXPECT_EQ(storage.get(9361), 0x00);
+    EXPECT_EQ(storage.get(9362), 0x11);
+    EXPECT_EQ(storage.get(9363), 0x7F);
+    EXPECT_EQ(storage.get(9364), 0x00);
+    EXPECT_EQ(storage.get(9999), 0x55);
+    // Not aliased to the values at the truncated offsets
+    EXPECT_EQ(storage.get(0), 0x00);
+    EXPECT_EQ(storage.get(1), 0x00);
+    EXPECT_EQ(storage.get(637), 0x00);
+}
+
+TEST(OneBitValueStorage, setGet) {
+    OneBitValueStorage<21> storage;
+    for (uint16_t i = 0; i < 21; ++i)
+        storage.set(i, i % 3 == 0 ? 0 : i);
+    for (uint16_t i = 0; i < 21; ++i)
+        EXPECT_EQ(storage.get(i), i % 3 == 0 ? 0 : 0x7F) << i;
+    storage.set(3, 1);
+    storage.set(4, 0);
+    EXPECT_EQ(storage.get(2), 0x7F);
+    EXPECT_EQ(storage.get(3), 0x7F);
+    EXPECT_EQ(storage.get(4), 0x00);
+    EXPECT_EQ(storage.get(5), 0x7F);
+    storage.reset();
+    for (uint16_t i = 0; i < 21; ++i)
+        EXPECT_EQ(storage.get(i), 0);
+}
+
+TEST(NoteCCValueStorage, bankableNoteRange) {
+    Bank<2> bank(16);
+    Bankable::GenericNoteRange<16, 2, NoteCCRangeEmptyCallback,
+                               OneBitValueStorage>
+        bits = {bank, {0x20, CHANNEL_2}, {}};
+    Bankable::GenericNoteRange<16, 2, NoteCCRangeEmptyCallback,
+                               SevenBitValueStorage>
+        sevenBits = {bank, {0x20, CHANNEL_3}, {}};
+
+    for (Channel c : {CHANNEL_2, CHANNEL_3}) {
+        ChannelMessageMatcher on = {NOTE_ON, c, 0x20 + 16 + 5, 0x33};
+        MIDIInputElementNote::updateAllWith(on);
+    }
+    EXPECT_EQ(bits.getValue(5), 0x00);
+    EXPECT_EQ(sevenBits.getValue(5), 0x00);
+    bank.select(1);
+    EXPECT_EQ(bits.getValue(5), 0x7F);
+    EXPECT_EQ(sevenBits.getValue(5), 0x33);
+    EXPECT_EQ(sevenBits.getValue(4), 0x00);
+
+    for (Channel c : {CHANNEL_2, CHANNEL_3}) {
+        ChannelMessageMatcher off = {NOTE_OFF, c, 0x20 + 16 + 5, 0x40};
+        MIDIInputElementNote::updateAllWith(off);
+    }
+    EXPECT_EQ(bits.getValue(5), 0x00);
+    EXPECT_EQ(sevenBits.getValue(5), 0x00);
+}
+
+// Reports the RAM used by a bankable range of all 128 notes in 8 banks, and
+// the time it takes to set and get all of its values.
+template <template <uint16_t> class ValueStorage>
+void benchmarkStorage(const char *name) {
+    using namespace std::chrono;
+    constexpr uint16_t N = 128 * 8;
+    constexpr unsigned Repeat = 1000;
+    static ValueStorage<N> storage;
+
+    auto start = steady_clock::now();
+    for (unsigned r = 0; r < Repeat; ++r)
+        for (uint16_t i = 0; i < N; ++i)
+            storage.set(i, uint8_t(i + r) & 0x7F);
+    auto set = steady_clock::now() - start;
+
+    unsigned sum = 0;
+    start = steady_clock::now();
+    for (unsigned r = 0; r < Repeat; ++r)
+        for (uint16_t i = 0; i < N; ++i)
+            sum += storage.get(i);
+    auto get = steady_clock::now() - start;
+    EXPECT_NE(sum, 0u);
+
+    auto ps = [](nanoseconds t) {
+        return std::to_string(t.count() * 1000 / (N * Repeat));
+    };
+    std::string prefix = name;
+    ::testing::Test::RecordProperty(prefix + "_bytes",
+                                    std::to_string(sizeof(storage)));
+    ::testing::Test::RecordProperty(prefix + "_set_ps", ps(set));
+    ::testing::Test::RecordProperty(prefix + "_get_ps", ps(get));
+}
+
+TEST(NoteCCValueStorage, benchmark) {
+    benchmarkStorage<ByteValueStorage>("byte");
+    benchmarkStorage<SevenBitValueStorage>("seven_bit");
+    benchmarkStorage<OneBitValueStorage>("one_bit");
+}
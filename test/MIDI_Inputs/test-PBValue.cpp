@@ -0,0 +1,198 @@
+#include <gtest-wrapper.h>
+
+#include <Banks/Bank.hpp>
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Constants/Control_Change.hpp>
+#include <MIDI_Inputs/NoteCCRange.hpp>
+#include <MIDI_Inputs/PBValue.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// Records the values of all updates.
+struct RecordingCallback {
+    template <class T>
+    void begin(const T &) {}
+    template <class T>
+    void update(const T &pb) {
+        values.push_back(pb.getValue());
+    }
+    std::vector<uint16_t> values;
+};
+
+/// Only counts the updates.
+struct CountingCallback {
+    template <class T>
+    void begin(const T &) {}
+    template <class T>
+    void update(const T &) {
+        ++count;
+    }
+    unsigned count = 0;
+};
+
+void send(uint8_t header, Channel channel, uint8_t data1, uint8_t data2,
+          uint8_t cable = 0) {
+    MIDI_Sink &sink = Control_Surface;
+    sink.sinkMIDIfromPipe(
+        ChannelMessage{uint8_t(header | channel.getRaw()), data1, data2, cable});
+}
+
+void sendPB(Channel channel, uint16_t value, uint8_t cable = 0) {
+    send(PITCH_BEND, channel, value & 0x7F, value >> 7, cable);
+}
+
+} // namespace
+
+TEST(PBValue, value14Bit) {
+    PBValue pb = {CHANNEL_3};
+    EXPECT_EQ(pb.getValue(), 0x2000);
+    sendPB(CHANNEL_3, 0x3FFF);
+    EXPECT_EQ(pb.getValue(), 0x3FFF);
+    sendPB(CHANNEL_3, 0x1234);
+    EXPECT_EQ(pb.getValue(), 0x1234);
+    sendPB(CHANNEL_4, 0x0000);
+    sendPB(CHANNEL_3, 0x0000, 1);
+    EXPECT_EQ(pb.getValue(), 0x1234);
+    MIDIInputElement::flushAll();
+}
+
+TEST(PBValue, callbackPerMessage) {
+    GenericPBValue<RecordingCallback> pb = {CHANNEL_1, {}};
+    sendPB(CHANNEL_1, 0x0100);
+    sendPB(CHANNEL_1, 0x0200);
+    EXPECT_EQ(pb.callback.values, (std::vector<uint16_t>{0x0100, 0x0200}));
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(pb.callback.values.size(), 2u);
+}
+
+TEST(PBValue, callbackOncePerLoop) {
+    MIDIInputElement::setCoalescedUpdates(true);
+    GenericPBValue<RecordingCallback> pb = {CHANNEL_1, {}};
+    sendPB(CHANNEL_1, 0x0100);
+    sendPB(CHANNEL_1, 0x0200);
+    sendPB(CHANNEL_1, 0x0300);
+    EXPECT_TRUE(pb.callback.values.empty());
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(pb.callback.values, std::vector<uint16_t>{0x0300});
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(pb.callback.values.size(), 1u);
+    MIDIInputElement::setCoalescedUpdates(false);
+}
+
+TEST(PBValue, bankableChangeChannel) {
+    Bank<4> bank(4);
+    Bankable::GenericPBValue<4, RecordingCallback> pb = {
+        {bank, CHANGE_CHANNEL}, CHANNEL_2, {}};
+    sendPB(CHANNEL_6, 0x0123);
+    MIDIInputElement::flushAll();
+    // Not the active bank
+    EXPECT_TRUE(pb.callback.values.empty());
+    EXPECT_EQ(pb.getValue(), 0x2000);
+    bank.select(1);
+    EXPECT_EQ(pb.callback.values, std::vector<uint16_t>{0x0123});
+    sendPB(CHANNEL_6, 0x0456);
+    sendPB(CHANNEL_7, 0x0789);
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(pb.callback.values, (std::vector<uint16_t>{0x0123, 0x0456}));
+}
+
+TEST(PBValue, resetAllControllers) {
+    GenericPBValue<RecordingCallback> pb = {CHANNEL_8, {}};
+    PBValue other = {CHANNEL_9};
+    KPValue kp = {{0x3C, CHANNEL_8}};
+    sendPB(CHANNEL_8, 0x0000);
+    sendPB(CHANNEL_9, 0x0000);
+    send(KEY_PRESSURE, CHANNEL_8, 0x3C, 0x55);
+    EXPECT_EQ(kp.getValue(), 0x55);
+    MIDIInputElement::flushAll();
+    send(CONTROL_CHANGE, CHANNEL_8, MIDI_CC::Reset_All_Controllers, 0);
+    EXPECT_EQ(pb.getValue(), 0x2000);
+    EXPECT_EQ(pb.callback.values, (std::vector<uint16_t>{0x0000, 0x2000}));
+    EXPECT_EQ(other.getValue(), 0x0000);
+    EXPECT_EQ(kp.getValue(), 0x00);
+}
+
+TEST(PBValue, bankableResetAllControllers) {
+    Bank<2> bank(4);
+    Bankable::GenericPBValue<2, RecordingCallback> pb = {
+        {bank, CHANGE_CHANNEL}, CHANNEL_2, {}};
+    sendPB(CHANNEL_2, 0x0123);
+    sendPB(CHANNEL_6, 0x0456);
+    MIDIInputElement::flushAll();
+    // Only the bank on channel 6 is reset
+    send(CONTROL_CHANGE, CHANNEL_6, MIDI_CC::Reset_All_Controllers, 0);
+    EXPECT_EQ(pb.getValue(), 0x0123);
+    EXPECT_EQ(pb.callback.values, std::vector<uint16_t>{0x0123});
+    bank.select(1);
+    EXPECT_EQ(pb.getValue(), 0x2000);
+    send(CONTROL_CHANGE, CHANNEL_2, MIDI_CC::Reset_All_Controllers, 0);
+    bank.select(0);
+    EXPECT_EQ(pb.getValue(), 0x2000);
+}
+
+TEST(KPValue, keyPressure) {
+    KPValue c4 = {{0x3C, CHANNEL_1}};
+    KPRange<4> range = {{0x40, CHANNEL_1}};
+    NoteValue note = {{0x3C, CHANNEL_1}};
+    send(NOTE_ON, CHANNEL_1, 0x3C, 0x7F);
+    send(KEY_PRESSURE, CHANNEL_1, 0x3C, 0x20);
+    send(KEY_PRESSURE, CHANNEL_1, 0x42, 0x30);
+    send(KEY_PRESSURE, CHANNEL_2, 0x3C, 0x40);
+    EXPECT_EQ(c4.getValue(), 0x20);
+    EXPECT_EQ(range.getValue(2), 0x30);
+    EXPECT_EQ(note.getValue(), 0x7F);
+}
+
+TEST(KPValue, bankable) {
+    Bank<2> bank(12);
+    Bankable::KPValue<2> kp = {{bank, CHANGE_ADDRESS}, {0x3C, CHANNEL_1}};
+    send(KEY_PRESSURE, CHANNEL_1, 0x48, 0x11);
+    EXPECT_EQ(kp.getValue(), 0x00);
+    bank.select(1);
+    EXPECT_EQ(kp.getValue(), 0x11);
+}
+
+// Streams fader automation on eight channels, as a DAW does with the motorized
+// faders of a Mackie Control Universal: every loop iteration receives a number
+// of Pitch Bend messages per channel, and counts how often the callbacks run.
+TEST(PBValue, benchmarkFaderStream) {
+    using namespace std::chrono;
+    constexpr unsigned Loops = 1000;
+    constexpr unsigned MessagesPerLoop = 4;
+    constexpr uint8_t Channels = 8;
+    MIDIInputElement::setCoalescedUpdates(true);
+    std::vector<std::unique_ptr<GenericPBValue<CountingCallback>>> faders;
+    for (uint8_t c = 0; c < Channels; ++c)
+        faders.emplace_back(
+            new GenericPBValue<CountingCallback>{Channel(c), {}});
+
+    uint16_t value = 0;
+    auto start = steady_clock::now();
+    for (unsigned l = 0; l < Loops; ++l) {
+        for (unsigned m = 0; m < MessagesPerLoop; ++m)
+            for (uint8_t c = 0; c < Channels; ++c)
+                sendPB(Channel(c), value++ & 0x3FFF);
+        MIDIInputElement::flushAll();
+    }
+    auto time = steady_clock::now() - start;
+
+    unsigned messages = Loops * MessagesPerLoop * Channels;
+    unsigned callbacks = 0;
+    for (auto &f : faders)
+        callbacks += f->callback.count;
+    EXPECT_EQ(callbacks, Loops * Channels);
+    EXPECT_EQ(faders.back()->getValue(), (value - 1) & 0x3FFF);
+    MIDIInputElement::setCoalescedUpdates(false);
+
+    auto ns = duration_cast<nanoseconds>(time).count() / messages;
+    RecordProperty("messages", std::to_string(messages));
+    RecordProperty("callbacks", std::to_string(callbacks));
+    RecordProperty("ns_per_message", std::to_string(ns));
+}
@@ -0,0 +1,186 @@
+#include <gtest-wrapper.h>
+
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Constants/Control_Change.hpp>
+#include <MIDI_Inputs/NoteCCRange.hpp>
+#include <MIDI_Inputs/ParameterValue.hpp>
+
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// Records the values of all updates.
+struct RecordingCallback {
+    template <class T>
+    void begin(const T &) {}
+    template <class T>
+    void update(const T &param) {
+        values.push_back(param.getValue());
+    }
+    std::vector<uint16_t> values;
+};
+
+using RecordingParameter = GenericParameterValue<RecordingCallback>;
+
+void sendCC(Channel channel, uint8_t controller, uint8_t value,
+            uint8_t cable = 0) {
+    MIDI_Sink &sink = Control_Surface;
+    sink.sinkMIDIfromPipe(ChannelMessage{
+        uint8_t(CONTROL_CHANGE | channel.getRaw()), controller, value, cable});
+}
+
+void sendNRPN(Channel channel, uint16_t number, uint16_t value) {
+    sendCC(channel, MIDI_CC::NRPN_MSB, number >> 7);
+    sendCC(channel, MIDI_CC::NRPN_LSB, number & 0x7F);
+    sendCC(channel, MIDI_CC::Data_Entry_MSB, value >> 7);
+    sendCC(channel, MIDI_CC::Data_Entry_MSB_LSB, value & 0x7F);
+}
+
+} // namespace
+
+TEST(ParameterValue, NRPNFullSequence) {
+    RecordingParameter param = {ParameterType::NRPN, 0x1234, CHANNEL_2, {}};
+    RecordingParameter other = {ParameterType::NRPN, 0x1235, CHANNEL_2, {}};
+    sendNRPN(CHANNEL_2, 0x1234, 0x2ABC);
+    EXPECT_EQ(param.getValue(), 0x2ABC);
+    EXPECT_EQ(param.callback.values, std::vector<uint16_t>{0x2ABC});
+    MIDIInputElement::flushAll();
+    // Only a single callback for all four messages
+    EXPECT_EQ(param.callback.values.size(), 1u);
+    EXPECT_TRUE(other.callback.values.empty());
+}
+
+TEST(ParameterValue, MSBOnlyAtEndOfLoop) {
+    RecordingParameter param = {ParameterType::NRPN, 0x0010, CHANNEL_1, {}};
+    sendCC(CHANNEL_1, MIDI_CC::NRPN_MSB, 0x00);
+    sendCC(CHANNEL_1, MIDI_CC::NRPN_LSB, 0x10);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB, 0x40);
+    EXPECT_EQ(param.getValue(), 0x40 << 7);
+    EXPECT_TRUE(param.callback.values.empty());
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(param.callback.values, std::vector<uint16_t>{0x40 << 7});
+
+    // The LSB alone keeps the previous MSB
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB_LSB, 0x05);
+    EXPECT_EQ(param.getValue(), (0x40 << 7) | 0x05);
+    EXPECT_EQ(param.callback.values.size(), 2u);
+}
+
+TEST(ParameterValue, interleavedChannels) {
+    RecordingParameter a = {ParameterType::NRPN, 0x0101, CHANNEL_1, {}};
+    RecordingParameter b = {ParameterType::NRPN, 0x0101, CHANNEL_2, {}};
+    RecordingParameter c = {ParameterType::NRPN, 0x0202, CHANNEL_3, {}};
+    sendCC(CHANNEL_1, MIDI_CC::NRPN_MSB, 0x02);
+    sendCC(CHANNEL_2, MIDI_CC::NRPN_MSB, 0x02);
+    sendCC(CHANNEL_3, MIDI_CC::NRPN_MSB, 0x04);
+    sendCC(CHANNEL_1, MIDI_CC::NRPN_LSB, 0x01);
+    sendCC(CHANNEL_3, MIDI_CC::NRPN_LSB, 0x02);
+    sendCC(CHANNEL_2, MIDI_CC::NRPN_LSB, 0x01);
+    sendCC(CHANNEL_2, MIDI_CC::Data_Entry_MSB, 0x22);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB, 0x11);
+    sendCC(CHANNEL_3, MIDI_CC::Data_Entry_MSB, 0x33);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB_LSB, 0x01);
+    sendCC(CHANNEL_3, MIDI_CC::Data_Entry_MSB_LSB, 0x03);
+    sendCC(CHANNEL_2, MIDI_CC::Data_Entry_MSB_LSB, 0x02);
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(a.callback.values, std::vector<uint16_t>{0x11 << 7 | 0x01});
+    EXPECT_EQ(b.callback.values, std::vector<uint16_t>{0x22 << 7 | 0x02});
+    EXPECT_EQ(c.callback.values, std::vector<uint16_t>{0x33 << 7 | 0x03});
+
+    // The selection is kept for the next value
+    sendCC(CHANNEL_2, MIDI_CC::Data_Entry_MSB, 0x01);
+    sendCC(CHANNEL_2, MIDI_CC::Data_Entry_MSB_LSB, 0x00);
+    EXPECT_EQ(b.getValue(), 0x01 << 7);
+    EXPECT_EQ(a.callback.values.size(), 1u);
+}
+
+TEST(ParameterValue, cableNumbers) {
+    RecordingParameter a = {ParameterType::NRPN, 0x05, {CHANNEL_1, 0}, {}};
+    RecordingParameter b = {ParameterType::NRPN, 0x05, {CHANNEL_1, 1}, {}};
+    sendCC(CHANNEL_1, MIDI_CC::NRPN_MSB, 0x00, 1);
+    sendCC(CHANNEL_1, MIDI_CC::NRPN_LSB, 0x05, 1);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB, 0x01, 1);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB_LSB, 0x02, 1);
+    EXPECT_EQ(a.getValue(), 0);
+    EXPECT_EQ(b.getValue(), 0x01 << 7 | 0x02);
+
+    // Reset All Controllers on another cable keeps the selection
+    sendCC(CHANNEL_1, MIDI_CC::Reset_All_Controllers, 0x00, 0);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB, 0x03, 1);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB_LSB, 0x04, 1);
+    EXPECT_EQ(a.getValue(), 0);
+    EXPECT_EQ(b.getValue(), 0x03 << 7 | 0x04);
+
+    // Reset All Controllers on the same cable deselects the parameter
+    sendCC(CHANNEL_1, MIDI_CC::Reset_All_Controllers, 0x00, 1);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB, 0x05, 1);
+    sendCC(CHANNEL_1, MIDI_CC::Data_Entry_MSB_LSB, 0x06, 1);
+    EXPECT_EQ(b.getValue(), 0x03 << 7 | 0x04);
+    MIDIInputElement::flushAll();
+}
+
+TEST(ParameterValue, RPNIncrementDecrement) {
+    RPNValue bendRange = {0x0000, CHANNEL_4};
+    NRPNValue nrpn = {0x0000, CHANNEL_4};
+    sendCC(CHANNEL_4, MIDI_CC::RPN_MSB, 0x00);
+    sendCC(CHANNEL_4, MIDI_CC::RPN_LSB, 0x00);
+    sendCC(CHANNEL_4, MIDI_CC::Data_Entry_MSB, 0x02);
+    sendCC(CHANNEL_4, MIDI_CC::Data_Entry_MSB_LSB, 0x00);
+    EXPECT_EQ(bendRange.getValue(), 0x0100);
+    sendCC(CHANNEL_4, MIDI_CC::Data_Increment, 0x00);
+    sendCC(CHANNEL_4, MIDI_CC::Data_Increment, 0x00);
+    sendCC(CHANNEL_4, MIDI_CC::Data_Decrement, 0x00);
+    EXPECT_EQ(bendRange.getValue(), 0x0101);
+    EXPECT_EQ(nrpn.getValue(), 0);
+    MIDIInputElement::flushAll();
+}
+
+TEST(ParameterValue, nullParameterAndSuppression) {
+    RecordingParameter param = {ParameterType::RPN, 0x0001, CHANNEL_5, {}};
+    CCValue dataEntry = {{MIDI_CC::Data_Entry_MSB, CHANNEL_5}};
+    CCValue rpnMSB = {{MIDI_CC::RPN_MSB, CHANNEL_5}};
+
+    // Without suppression, the CC elements see all messages
+    sendCC(CHANNEL_5, MIDI_CC::RPN_MSB, 0x00);
+    sendCC(CHANNEL_5, MIDI_CC::RPN_LSB, 0x01);
+    sendCC(CHANNEL_5, MIDI_CC::Data_Entry_MSB, 0x10);
+    EXPECT_EQ(dataEntry.getValue(), 0x10);
+    EXPECT_EQ(param.getValue(), 0x10 << 7);
+
+    MIDIInputElementParameter::setSuppressCCs(true);
+    sendCC(CHANNEL_5, MIDI_CC::RPN_MSB, 0x00);
+    sendCC(CHANNEL_5, MIDI_CC::Data_Entry_MSB, 0x20);
+    EXPECT_EQ(rpnMSB.getValue(), 0x00);
+    EXPECT_EQ(dataEntry.getValue(), 0x10);
+    EXPECT_EQ(param.getValue(), 0x20 << 7);
+
+    // After the null RPN, Data Entry is a normal CC again
+    sendCC(CHANNEL_5, MIDI_CC::RPN_MSB, 0x7F);
+    sendCC(CHANNEL_5, MIDI_CC::RPN_LSB, 0x7F);
+    sendCC(CHANNEL_5, MIDI_CC::Data_Entry_MSB, 0x30);
+    EXPECT_EQ(dataEntry.getValue(), 0x30);
+    EXPECT_EQ(param.getValue(), 0x20 << 7);
+
+    // Reset All Controllers deselects the parameter as well
+    sendCC(CHANNEL_5, MIDI_CC::RPN_MSB, 0x00);
+    sendCC(CHANNEL_5, MIDI_CC::RPN_LSB, 0x01);
+    sendCC(CHANNEL_5, MIDI_CC::Reset_All_Controllers, 0x00);
+    sendCC(CHANNEL_5, MIDI_CC::Data_Entry_MSB, 0x40);
+    EXPECT_EQ(dataEntry.getValue(), 0x40);
+    EXPECT_EQ(param.getValue(), 0x20 << 7);
+    MIDIInputElementParameter::setSuppressCCs(false);
+    MIDIInputElement::flushAll();
+}
+
+TEST(ParameterValue, coalesced) {
+    MIDIInputElement::setCoalescedUpdates(true);
+    RecordingParameter param = {ParameterType::NRPN, 0x0042, CHANNEL_6, {}};
+    sendNRPN(CHANNEL_6, 0x0042, 0x0100);
+    sendNRPN(CHANNEL_6, 0x0042, 0x0200);
+    EXPECT_TRUE(param.callback.values.empty());
+    MIDIInputElement::flushAll();
+    EXPECT_EQ(param.callback.values, std::vector<uint16_t>{0x0200});
+    MIDIInputElement::setCoalescedUpdates(false);
+}
@@ -0,0 +1,171 @@
+#include <gtest-wrapper.h>
+
+#include <MIDI_Inputs/MIDIInputElementSysEx.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+namespace {
+
+/// Accepts the messages that start with its header. The header is only
+/// registered for the trie if `useTrie` is true, otherwise the element checks
+/// it itself, like the elements did before the trie was added.
+class Consumer : public MIDIInputElementSysEx {
+  public:
+    Consumer(std::vector<uint8_t> hdr, bool useTrie = true, uint8_t CN = 0)
+        : MIDIInputElementSysEx(CN), hdr(std::move(hdr)) {
+        if (useTrie)
+            setHeader(this->hdr.data(), this->hdr.size());
+    }
+
+    bool updateImpl(SysExMessage midimsg) override {
+        ++calls;
+        if (midimsg.length < hdr.size() ||
+            memcmp(midimsg.data, hdr.data(), hdr.size()) != 0)
+            return false;
+        ++received;
+        return accept;
+    }
+
+    std::vector<uint8_t> hdr;
+    unsigned calls = 0, received = 0;
+    bool accept = true;
+};
+
+void send(std::vector<uint8_t> data, uint8_t CN = 0) {
+    MIDIInputElementSysEx::updateAllWith({data, CN});
+}
+
+} // namespace
+
+TEST(SysExTrie, onlyMatchingHeaders) {
+    Consumer mackie = {{0xF0, 0x00, 0x00, 0x66}};
+    Consumer novation = {{0xF0, 0x00, 0x20, 0x29}};
+    Consumer roland = {{0xF0, 0x41}};
+
+    send({0xF0, 0x00, 0x20, 0x29, 0x02, 0x0E, 0xF7});
+    EXPECT_EQ(mackie.calls, 0u);
+    EXPECT_EQ(novation.received, 1u);
+    EXPECT_EQ(roland.calls, 0u);
+
+    send({0xF0, 0x41, 0x10, 0xF7});
+    EXPECT_EQ(roland.received, 1u);
+
+    // Matches the first bytes of two headers, but neither completely
+    send({0xF0, 0x00, 0x20, 0x30, 0xF7});
+    send({0xF0, 0x00});
+    EXPECT_EQ(mackie.calls, 0u);
+    EXPECT_EQ(novation.calls, 1u);
+    EXPECT_EQ(roland.calls, 1u);
+}
+
+TEST(SysExTrie, shorterHeadersFirst) {
+    Consumer specific = {{0xF0, 0x7D, 0x01}};
+    Consumer any = {{}};
+    Consumer general = {{0xF0, 0x7D}};
+    any.accept = false;
+    general.accept = false;
+
+    send({0xF0, 0x7D, 0x01, 0xF7});
+    EXPECT_EQ(any.calls, 1u);
+    EXPECT_EQ(general.received, 1u);
+    EXPECT_EQ(specific.received, 1u);
+
+    // Stops at the first element that returns true
+    general.accept = true;
+    send({0xF0, 0x7D, 0x01, 0xF7});
+    EXPECT_EQ(general.received, 2u);
+    EXPECT_EQ(specific.received, 1u);
+}
+
+TEST(SysExTrie, cableNumber) {
+    Consumer cable0 = {{0xF0, 0x7D}, true, 0};
+    Consumer cable3 = {{0xF0, 0x7D}, true, 3};
+    send({0xF0, 0x7D, 0xF7}, 3);
+    EXPECT_EQ(cable0.received, 0u);
+    EXPECT_EQ(cable3.received, 1u);
+}
+
+TEST(SysExTrie, addRemove) {
+    Consumer a = {{0xF0, 0x7D, 0x01}};
+    send({0xF0, 0x7D, 0x01, 0xF7});
+    EXPECT_EQ(a.received, 1u);
+    {
+        Consumer b = {{0xF0, 0x7D, 0x02}};
+        send({0xF0, 0x7D, 0x02, 0xF7});
+        EXPECT_EQ(b.received, 1u);
+    }
+    send({0xF0, 0x7D, 0x02, 0xF7});
+    send({0xF0, 0x7D, 0x01, 0xF7});
+    EXPECT_EQ(a.calls, 2u);
+    EXPECT_EQ(a.received, 2u);
+}
+
+TEST(SysExTrie, moreNodesThanCapacity) {
+    // Every header needs two extra nodes, so the last ones don't fit
+    std::vector<std::unique_ptr<Consumer>> consumers;
+    for (uint8_t i = 0; i < SYSEX_TRIE_CAPACITY; ++i)
+        consumers.emplace_back(new Consumer {{0xF0, 0x7D, i, 0x55}});
+    for (uint8_t i = 0; i < SYSEX_TRIE_CAPACITY; ++i)
+        send({0xF0, 0x7D, i, 0x55, 0xF7});
+    send({0xF0, 0x7D, SYSEX_TRIE_CAPACITY - 1, 0x56, 0xF7});
+    for (auto &c : consumers)
+        EXPECT_EQ(c->received, 1u);
+    // The elements that didn't fit check the rest of their header themselves
+    EXPECT_EQ(consumers.back()->calls, 1u);
+}
+
+// Sends one message to each of the given number of consumers, which all have
+// a different header from the same manufacturer, and counts how often a
+// consumer has to look at a message.
+template <uint8_t NumConsumers>
+void benchmarkDispatch() {
+    using namespace std::chrono;
+    constexpr unsigned Repeat = 1000;
+    std::vector<std::vector<uint8_t>> messages;
+    for (uint8_t i = 0; i < NumConsumers; ++i)
+        messages.push_back({0xF0, 0x00, 0x20, 0x29, i, 0x01, 0x02, 0xF7});
+
+    auto run = [&](bool useTrie, unsigned &calls) {
+        std::vector<std::unique_ptr<Consumer>> consumers;
+        for (uint8_t i = 0; i < NumConsumers; ++i)
+            consumers.emplace_back(
+                new Consumer {{0xF0, 0x00, 0x20, 0x29, i}, useTrie});
+        auto start = steady_clock::now();
+        for (unsigned r = 0; r < Repeat; ++r)
+            for (auto &msg : messages)
+                MIDIInputElementSysEx::updateAllWith(msg);
+        auto time = steady_clock::now() - start;
+        calls = 0;
+        for (auto &c : consumers) {
+            EXPECT_EQ(c->received, Repeat);
+            calls += c->calls;
+        }
+        return duration_cast<nanoseconds>(time);
+    };
+
+    unsigned broadcastCalls, trieCalls;
+    auto broadcast = run(false, broadcastCalls);
+    auto trie = run(true, trieCalls);
+    EXPECT_EQ(trieCalls, Repeat * NumConsumers);
+
+    unsigned numMessages = Repeat * NumConsumers;
+    std::string prefix = "consumers_" + std::to_string(NumConsumers);
+    auto record = [&](const std::string &key, unsigned long long value) {
+        ::testing::Test::RecordProperty(prefix + key, std::to_string(value));
+    };
+    record("_broadcast_calls_per_msg", broadcastCalls / numMessages);
+    record("_trie_calls_per_msg", trieCalls / numMessages);
+    record("_broadcast_ns_per_msg", broadcast.count() / numMessages);
+    record("_trie_ns_per_msg", trie.count() / numMessages);
+}
+
+TEST(SysExTrie, benchmark) {
+    benchmarkDispatch<1>();
+    benchmarkDispatch<8>();
+    benchmarkDispatch<32>();
+}
@@ -0,0 +1,200 @@
+#include <gtest-wrapper.h>
+
+#include <MIDI_Inputs/MCU/VUDecayEngine.hpp>
+
+#include <chrono>
+#include <memory>
+#include <string>
+
+USING_CS_NAMESPACE;
+
+using ::testing::AnyNumber;
+using ::testing::Return;
+
+namespace {
+
+struct CountingClient : MCU::VUDecayClient {
+    void onDecay() override { ++count; }
+    unsigned count = 0;
+};
+
+} // namespace
+
+TEST(VUDecayEngine, allocate) {
+    MCU::BasicVUDecayEngine<8> engine;
+    CountingClient a, b, c;
+    engine.add(a, 3, 100);
+    engine.add(b, 4, 100);
+    EXPECT_EQ(a.firstMeter, 0);
+    EXPECT_EQ(a.numMeters, 3);
+    EXPECT_EQ(b.firstMeter, 3);
+    EXPECT_EQ(b.numMeters, 4);
+    EXPECT_EQ(engine.size(), 7);
+
+    // Freed meters are reused
+    engine.remove(a);
+    EXPECT_EQ(engine.size(), 4);
+    engine.add(c, 2, 100);
+    EXPECT_EQ(c.firstMeter, 0);
+    EXPECT_EQ(engine.size(), 6);
+}
+
+TEST(VUDecayEngine, full) {
+    MCU::BasicVUDecayEngine<8> engine;
+    CountingClient a, b;
+    EXPECT_TRUE(engine.add(a, 6, 100));
+    EXPECT_FALSE(engine.add(b, 3, 100));
+    EXPECT_EQ(engine.size(), 6);
+    EXPECT_TRUE(engine.isFirstClient(a));
+    EXPECT_FALSE(engine.isFirstClient(b));
+}
+
+TEST(VUDecayEngine, decay) {
+    MCU::BasicVUDecayEngine<8> engine;
+    CountingClient a, b;
+    engine.add(a, 2, 100);
+    engine.add(b, 1, 250);
+
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .WillOnce(Return(1000))
+        .WillOnce(Return(1000))
+        .WillOnce(Return(1000));
+    engine.setLevel(a.firstMeter + 0, 3);
+    engine.setLevel(a.firstMeter + 1, 1);
+    engine.setLevel(b.firstMeter, 2);
+
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .WillOnce(Return(1099))
+        .WillOnce(Return(1100))
+        .WillOnce(Return(1200))
+        .WillOnce(Return(1250))
+        .WillOnce(Return(1300))
+        .WillOnce(Return(1500));
+    EXPECT_EQ(engine.update(), 0);
+    EXPECT_EQ(engine.update(), 2);
+    EXPECT_EQ(engine.getLevel(a.firstMeter + 0), 2);
+    EXPECT_EQ(engine.getLevel(a.firstMeter + 1), 0);
+    EXPECT_EQ(a.count, 1u);
+    EXPECT_EQ(b.count, 0u);
+    EXPECT_EQ(engine.update(), 1);
+    EXPECT_EQ(engine.getLevel(a.firstMeter + 0), 1);
+    EXPECT_EQ(engine.update(), 1);
+    EXPECT_EQ(engine.getLevel(b.firstMeter), 1);
+    EXPECT_EQ(b.count, 1u);
+    EXPECT_EQ(engine.update(), 1);
+    EXPECT_EQ(engine.getLevel(a.firstMeter + 0), 0);
+    EXPECT_EQ(engine.update(), 1);
+    EXPECT_EQ(engine.getLevel(b.firstMeter), 0);
+    EXPECT_EQ(a.count, 3u);
+    EXPECT_EQ(b.count, 2u);
+
+    // All meters are at zero, so millis is no longer called
+    EXPECT_EQ(engine.update(), 0);
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
+TEST(VUDecayEngine, hold) {
+    MCU::BasicVUDecayEngine<4> engine;
+    CountingClient a;
+    engine.add(a, 1, 0);
+    engine.setLevel(a.firstMeter, 5);
+    EXPECT_EQ(engine.update(), 0);
+    EXPECT_EQ(engine.getLevel(a.firstMeter), 5);
+    EXPECT_EQ(a.count, 0u);
+}
+
+TEST(VUDecayEngine, overload) {
+    MCU::BasicVUDecayEngine<4> engine;
+    CountingClient a;
+    engine.add(a, 2, 0);
+    engine.setLevel(a.firstMeter + 1, 7);
+    engine.setOverload(a.firstMeter + 1, true);
+    EXPECT_FALSE(engine.getOverload(a.firstMeter + 0));
+    EXPECT_TRUE(engine.getOverload(a.firstMeter + 1));
+    EXPECT_EQ(engine.getLevel(a.firstMeter + 1), 7);
+    engine.setOverload(a.firstMeter + 1, false);
+    EXPECT_FALSE(engine.getOverload(a.firstMeter + 1));
+    EXPECT_EQ(engine.getLevel(a.firstMeter + 1), 7);
+
+    engine.setOverload(a.firstMeter + 0, true);
+    engine.clear(a.firstMeter, 2);
+    EXPECT_FALSE(engine.getOverload(a.firstMeter + 0));
+    EXPECT_EQ(engine.getLevel(a.firstMeter + 1), 0);
+}
+
+namespace {
+
+/// The original approach: every meter is a separate object that checks the
+/// time in its own virtual update method.
+struct PollingMeter {
+    virtual ~PollingMeter() = default;
+    virtual void update() {
+        if (decayTime && (millis() - prevDecayTime >= decayTime)) {
+            prevDecayTime += decayTime;
+            if (value > 0)
+                --value;
+        }
+    }
+    uint8_t value = 0;
+    unsigned int decayTime = 150;
+    unsigned long prevDecayTime = 0;
+};
+
+} // namespace
+
+// Measures the time it takes to run 1000 loop iterations, one per millisecond,
+// with the given number of meters that keep receiving new levels.
+template <uint16_t NumMeters>
+void benchmarkDecay() {
+    using namespace std::chrono;
+    constexpr unsigned Loops = 1000;
+    unsigned long now = 0;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly([&now] { return now; });
+
+    std::unique_ptr<PollingMeter> polling[NumMeters];
+    for (auto &m : polling)
+        m.reset(new PollingMeter);
+    auto start = steady_clock::now();
+    for (now = 0; now < Loops; ++now) {
+        if (now % 100 == 0)
+            for (auto &m : polling)
+                m->value = 12, m->prevDecayTime = now;
+        for (auto &m : polling)
+            m->update();
+    }
+    auto naive = steady_clock::now() - start;
+
+    static MCU::BasicVUDecayEngine<NumMeters> engine;
+    std::unique_ptr<CountingClient> clients[NumMeters];
+    for (auto &c : clients) {
+        c.reset(new CountingClient);
+        engine.add(*c, 1, 150);
+    }
+    start = steady_clock::now();
+    for (now = 0; now < Loops; ++now) {
+        if (now % 100 == 0)
+            for (uint16_t i = 0; i < NumMeters; ++i)
+                engine.setLevel(i, 12);
+        engine.update();
+    }
+    auto soa = steady_clock::now() - start;
+
+    for (uint16_t i = 0; i < NumMeters; ++i)
+        EXPECT_EQ(engine.getLevel(i), polling[i]->value) << i;
+    for (auto &c : clients)
+        engine.remove(*c);
+    ::testing::Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    auto ns = [](nanoseconds t) { return std::to_string(t.count() / Loops); };
+    std::string prefix = "meters_" + std::to_string(NumMeters);
+    ::testing::Test::RecordProperty(prefix + "_polling_ns_per_loop", ns(naive));
+    ::testing::Test::RecordProperty(prefix + "_engine_ns_per_loop", ns(soa));
+}
+
+TEST(VUDecayEngine, benchmark) {
+    benchmarkDecay<8>();
+    benchmarkDecay<32>();
+    benchmarkDecay<128>();
+}
@@ -61,6 +61,21 @@ TEST(MCUVPotBankable, setValueBankChangeChannel) {
     EXPECT_EQ(vpot.getCenterLed(), true);
 }
 
+TEST(MCUVPotBankable, resetChannelKeepsOtherBanks) {
+    Bank<2> bank(4);
+    constexpr Channel channel = CHANNEL_3;
+    MCU::Bankable::VPotRing<2> vpot = {{bank, CHANGE_CHANNEL}, 5, channel};
+
+    ChannelMessageMatcher midimsg1 = {CONTROL_CHANGE, channel, 0x34, 0x15};
+    ChannelMessageMatcher midimsg2 = {CONTROL_CHANGE, channel + 4, 0x34, 0x26};
+    MIDIInputElementCC::updateAllWith(midimsg1);
+    MIDIInputElementCC::updateAllWith(midimsg2);
+    // Resetting the channel of the second bank doesn't affect the first one
+    vpot.resetChannel(channel + 4, 0);
+    EXPECT_EQ(vpot.getPosition(), 0x5);
+    EXPECT_EQ(vpot.getMode(), 0x1);
+}
+
 TEST(MCUVPotBankable, setValueBankChangeCN) {
     Bank<2> bank(4);
     constexpr Channel channel = CHANNEL_3;
@@ -155,4 +170,156 @@ TEST(MCUVPotLEDsBankable, displayOnBankChange) {
     Mock::VerifyAndClear(&ArduinoMock::getInstance());
 
     // TODO: test center led and more banks, updating active bank, etc.
-}
\ No newline at end of file
+}
+// -------------------------------------------------------------------------- //
+
+TEST(MCUVPot, ringMaskMatchesRange) {
+    MCU::VPotRing vpot = {1, CHANNEL_1};
+    for (uint8_t value = 0; value < 0x80; ++value) {
+        ChannelMessageMatcher midimsg = {CONTROL_CHANGE, CHANNEL_1,
+                                         MCU::VPotRingAddress, value};
+        MIDIInputElementCC::updateAllWith(midimsg);
+        uint16_t expected = 0;
+        for (uint8_t i = vpot.getStartOn(); i < vpot.getStartOff(); ++i)
+            expected |= 1 << i;
+        EXPECT_EQ(vpot.getRingMask(), expected) << +value;
+        EXPECT_EQ(vpot.getLEDMask(), expected | vpot.getCenterLed() << 11)
+            << +value;
+    }
+}
+
+#include <AH/Hardware/ExtendedInputOutput/StaticSizeExtendedIOElement.hpp>
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+/// ExtIO element that buffers its outputs, and counts how often the buffer is
+/// sent to the device.
+class BufferedOutputs : public AH::StaticSizeExtendedIOElement<8 * 11> {
+  public:
+    void pinModeBuffered(pin_t, PinMode_t) override {}
+    void digitalWriteBuffered(pin_t pin, PinStatus_t state) override {
+        buffer[pin] = state;
+    }
+    int digitalReadBuffered(pin_t pin) override { return buffer[pin]; }
+    analog_t analogReadBuffered(pin_t) override { return 0; }
+    void analogWriteBuffered(pin_t, analog_t) override {}
+    void begin() override {}
+    void updateBufferedOutputs() override { ++writes; }
+    void updateBufferedInputs() override {}
+
+    /// Get the pins of the given ring.
+    PinList<11> ring(uint8_t index) const {
+        PinList<11> ring;
+        for (uint8_t i = 0; i < 11; ++i)
+            ring[i] = pin(index * 11 + i);
+        return ring;
+    }
+
+    uint8_t buffer[8 * 11] = {};
+    unsigned writes = 0;
+};
+
+/// Sets the LEDs one by one, like VPotRingLEDsCallback did before the rings
+/// were looked up as bit masks.
+class RangeVPotRingLEDsCallback {
+  public:
+    RangeVPotRingLEDsCallback(const AH::LEDs<11> &leds) : leds(leds) {}
+    template <class T>
+    void begin(const T &) {}
+    template <class T>
+    void update(const T &t) {
+        leds.displayRange(t.getStartOn(), t.getStartOff());
+    }
+
+  private:
+    const AH::LEDs<11> leds;
+};
+
+} // namespace
+
+TEST(MCUVPotLEDs, ringOnExtIO) {
+    BufferedOutputs outputs;
+    MCU::VPotRingLEDs vpot = {outputs.ring(0), 1, CHANNEL_1};
+    ChannelMessageMatcher midimsg = {CONTROL_CHANGE, CHANNEL_1,
+                                     MCU::VPotRingAddress, 0x33};
+    MIDIInputElementCC::updateAllWith(midimsg);
+    EXPECT_EQ(outputs.writes, 1u);
+    for (uint8_t i = 0; i < 11; ++i)
+        EXPECT_EQ(outputs.buffer[i], i >= 3 && i <= 7) << +i;
+}
+
+// Measures the cost of updating eight V-Pot rings with their LEDs on a
+// buffered ExtIO element, while the DAW sweeps all modes and positions.
+TEST(MCUVPotLEDs, benchmark) {
+    using namespace std::chrono;
+    constexpr uint8_t NumRings = 8;
+    constexpr unsigned Updates = 200000;
+    BufferedOutputs outputs;
+
+    auto run = [&] {
+        outputs.writes = 0;
+        auto start = steady_clock::now();
+        for (unsigned i = 0; i < Updates; ++i) {
+            uint8_t track = i % NumRings;
+            uint8_t value = (i / NumRings) % 0x80;
+            ChannelMessageMatcher midimsg = {
+                CONTROL_CHANGE, CHANNEL_1,
+                uint8_t(MCU::VPotRingAddress + track), value};
+            MIDIInputElementCC::updateAllWith(midimsg);
+        }
+        auto time = duration_cast<nanoseconds>(steady_clock::now() - start);
+        return std::make_pair(time, outputs.writes);
+    };
+    auto checkRing = [&](uint8_t track, uint16_t mask) {
+        for (uint8_t i = 0; i < 11; ++i)
+            EXPECT_EQ(outputs.buffer[track * 11 + i], (mask >> i) & 1);
+    };
+
+    std::pair<nanoseconds, unsigned> range, bulk;
+    uint16_t masks[NumRings];
+    {
+        using RangeVPotRingLEDs =
+            MCU::GenericVPotRing<RangeVPotRingLEDsCallback>;
+        std::vector<std::unique_ptr<RangeVPotRingLEDs>> rings;
+        for (uint8_t t = 0; t < NumRings; ++t)
+            rings.emplace_back(new RangeVPotRingLEDs{
+                uint8_t(t + 1), CHANNEL_1, {outputs.ring(t)}});
+        range = run();
+        for (uint8_t t = 0; t < NumRings; ++t)
+            masks[t] = rings[t]->getRingMask();
+    }
+    std::fill(std::begin(outputs.buffer), std::end(outputs.buffer), 0);
+    {
+        std::vector<std::unique_ptr<MCU::VPotRingLEDs>> rings;
+        for (uint8_t t = 0; t < NumRings; ++t)
+            rings.emplace_back(new MCU::VPotRingLEDs{
+                outputs.ring(t), uint8_t(t + 1), CHANNEL_1});
+        bulk = run();
+        for (uint8_t t = 0; t < NumRings; ++t) {
+            EXPECT_EQ(rings[t]->getRingMask(), masks[t]);
+            checkRing(t, masks[t]);
+        }
+    }
+    EXPECT_EQ(range.second, 11 * Updates);
+    EXPECT_EQ(bulk.second, Updates);
+
+    auto perSecond = [](nanoseconds t) {
+        return std::to_string(Updates * 1000000000ull / t.count());
+    };
+    RecordProperty("rings", std::to_string(NumRings));
+    RecordProperty("range_ns_per_update",
+                   std::to_string(range.first.count() / Updates));
+    RecordProperty("bulk_ns_per_update",
+                   std::to_string(bulk.first.count() / Updates));
+    RecordProperty("range_updates_per_second", perSecond(range.first));
+    RecordProperty("bulk_updates_per_second", perSecond(bulk.first));
+    RecordProperty("range_writes_per_update",
+                   std::to_string(range.second / Updates));
+    RecordProperty("bulk_writes_per_update",
+                   std::to_string(bulk.second / Updates));
+}
@@ -2,6 +2,9 @@
 #include <MIDI_Inputs/MCU/VU.hpp>
 #include <gtest-wrapper.h>
 
+#include <memory>
+#include <vector>
+
 using namespace ::testing;
 using namespace CS;
 
@@ -183,6 +186,35 @@ TEST(MCUVUBankable, setValueBankChangeCN) {
     Mock::VerifyAndClear(&ArduinoMock::getInstance());
 }
 
+TEST(MCUVUBankable, decayEngineFull) {
+    Bank<8> bank(1);
+    constexpr uint8_t Fit = VU_DECAY_ENGINE_CAPACITY / 8;
+    std::vector<std::unique_ptr<MCU::Bankable::VU<8>>> vus;
+    for (uint8_t i = 0; i < Fit; ++i)
+        vus.emplace_back(new MCU::Bankable::VU<8>{bank, 1, CHANNEL_2, 100});
+    EXPECT_EQ(MCU::VUDecayEngine::getInstance().size(), Fit * 8);
+
+    // A VU that doesn't fit decays its own values
+    MCU::Bankable::VU<8> vu = {bank, 1, CHANNEL_3, 100};
+    EXPECT_EQ(MCU::VUDecayEngine::getInstance().size(), Fit * 8);
+    ChannelMessageMatcher midimsg1 = {CHANNEL_PRESSURE, CHANNEL_3, 0x06, 0};
+    ChannelMessageMatcher midimsg2 = {CHANNEL_PRESSURE, CHANNEL_2, 0x06, 0};
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(2)
+        .WillRepeatedly(Return(0));
+    MIDIInputElementChannelPressure::updateAllWith(midimsg1);
+    MIDIInputElementChannelPressure::updateAllWith(midimsg2);
+    EXPECT_EQ(vu.getValue(), 6);
+    EXPECT_EQ(vus[0]->getValue(), 6);
+    EXPECT_CALL(ArduinoMock::getInstance(), millis())
+        .Times(AnyNumber())
+        .WillRepeatedly(Return(100));
+    MIDIInputElementChannelPressure::updateAll();
+    EXPECT_EQ(vu.getValue(), 5);
+    EXPECT_EQ(vus[0]->getValue(), 5);
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
+
 TEST(MCUVUBankable, overloadBankChangeAddress) {
     Bank<2> bank(4);
     constexpr Channel channel = CHANNEL_3;
@@ -0,0 +1,186 @@
+#include <Control_Surface/Control_Surface_Class.hpp>
+#include <MIDI_Interfaces/ActiveNotes.hpp>
+#include <MockMIDI_Interface.hpp>
+#include <gmock-wrapper.h>
+#include <gtest-wrapper.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+using ::testing::InSequence;
+using ::testing::StrictMock;
+
+TEST(ActiveNotes, noteOnOff) {
+    BasicActiveNotes<2> notes;
+    EXPECT_EQ(notes.count(), 0);
+    notes.noteOn(0, 0, 0);
+    notes.noteOn(0, 15, 127);
+    notes.noteOn(1, 3, 64);
+    notes.noteOn(2, 3, 64); // not tracked
+    EXPECT_TRUE(notes.isActive({0, CHANNEL_1, 0}));
+    EXPECT_TRUE(notes.isActive({127, CHANNEL_16, 0}));
+    EXPECT_TRUE(notes.isActive({64, CHANNEL_4, 1}));
+    EXPECT_FALSE(notes.isActive({64, CHANNEL_4, 0}));
+    EXPECT_FALSE(notes.isActive({64, CHANNEL_4, 2}));
+    EXPECT_EQ(notes.count(), 3);
+
+    EXPECT_TRUE(notes.noteOff(1, 3, 64));
+    EXPECT_FALSE(notes.noteOff(1, 3, 64));
+    EXPECT_EQ(notes.count(), 2);
+    notes.clear();
+    EXPECT_EQ(notes.count(), 0);
+}
+
+TEST(ActiveNotes, releaseAll) {
+    BasicActiveNotes<2> notes;
+    notes.noteOn(1, 2, 100);
+    notes.noteOn(0, 9, 31);
+    notes.noteOn(0, 9, 32);
+    std::vector<std::vector<int>> released;
+    auto count = notes.releaseAll([&](uint8_t cn, uint8_t c, uint8_t note) {
+        released.push_back({cn, c, note});
+    });
+    EXPECT_EQ(count, 3);
+    std::vector<std::vector<int>> expected = {
+        {0, 9, 31}, {0, 9, 32}, {1, 2, 100}};
+    EXPECT_EQ(released, expected);
+    EXPECT_EQ(notes.count(), 0);
+}
+
+TEST(ActiveNotes, deduplicateNoteOffs) {
+    StrictMock<MockMIDI_Interface> midi;
+    BasicActiveNotes<> notes;
+    midi.setActiveNotes(notes);
+
+    InSequence seq;
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 2, 0x3C, 0x7F, 0));
+    midi.sendNoteOn({0x3C, CHANNEL_3}, 0x7F);
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 2, 0x3C, 0x10, 0));
+    midi.sendNoteOff({0x3C, CHANNEL_3}, 0x10);
+    // The note is no longer sounding
+    midi.sendNoteOff({0x3C, CHANNEL_3}, 0x7F);
+    midi.send(ChannelMessage{uint8_t(NOTE_ON | 2), 0x3C, 0x00, 0});
+    midi.sendOnCable(NOTE_OFF, 3, 0x3C, 0x40, 0);
+
+    // Note On with zero velocity is a Note Off
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 2, 0x3D, 0x7F, 0));
+    midi.sendNoteOn({0x3D, CHANNEL_3}, 0x7F);
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 2, 0x3D, 0x00, 0));
+    midi.send(ChannelMessage{uint8_t(NOTE_ON | 2), 0x3D, 0x00, 0});
+    EXPECT_FALSE(notes.isActive({0x3D, CHANNEL_3}));
+
+    // Other messages are not affected
+    EXPECT_CALL(midi, sendImpl(CC, 2, 0x3D, 0x00, 0));
+    midi.sendCC({0x3D, CHANNEL_3}, 0x00);
+
+    notes.setDeduplicateNoteOffs(false);
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 2, 0x3C, 0x40, 0));
+    midi.sendNoteOff({0x3C, CHANNEL_3}, 0x40);
+}
+
+TEST(ActiveNotes, releaseOnDisconnect) {
+    StrictMock<MockMIDI_Interface> midi;
+    BasicActiveNotes<16> notes;
+    midi.setActiveNotes(notes);
+    Control_Surface.connectDefaultMIDI_Interface();
+
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 0, 0x3C, 0x7F, 0));
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 4, 0x40, 0x7F, 7));
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 4, 0x41, 0x7F, 7));
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 4, 0x41, 0x7F, 7));
+    Control_Surface.sendNoteOn({0x3C, CHANNEL_1, 0}, 0x7F);
+    Control_Surface.sendNoteOn({0x40, CHANNEL_5, 7}, 0x7F);
+    Control_Surface.sendNoteOn({0x41, CHANNEL_5, 7}, 0x7F);
+    Control_Surface.sendNoteOff({0x41, CHANNEL_5, 7}, 0x7F);
+    ::testing::Mock::VerifyAndClear(&midi);
+
+    // Exactly the notes that are still sounding are turned off
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 0, 0x3C, 0x40, 0));
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 4, 0x40, 0x40, 7));
+    Control_Surface.disconnectMIDI_Interfaces();
+    EXPECT_EQ(notes.count(), 0);
+    EXPECT_EQ(midi.releaseActiveNotes(), 0);
+}
+
+namespace {
+
+/// Interface that only counts the messages it sends.
+class CountingMIDI_Interface : public MIDI_Interface {
+  public:
+    void update() override {}
+    void setCallbacks(MIDI_Callbacks *) override {}
+
+    void sendImpl(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) override {
+        ++count;
+    }
+    void sendImpl(uint8_t, uint8_t, uint8_t, uint8_t) override { ++count; }
+    void sendImpl(const uint8_t *, size_t, uint8_t) override { ++count; }
+    void sendImpl(uint8_t, uint8_t) override { ++count; }
+
+    unsigned count = 0;
+};
+
+} // namespace
+
+// Measures the cost of keeping track of the active notes while playing, and
+// the time it takes to turn off all notes that are still sounding, compared to
+// sending Note Off messages for all notes of all channels.
+TEST(ActiveNotes, benchmark) {
+    using namespace std::chrono;
+    constexpr unsigned Notes = 100000;
+    CountingMIDI_Interface midi;
+    BasicActiveNotes<> notes;
+
+    auto play = [&] {
+        for (unsigned i = 0; i < Notes; ++i) {
+            MIDIAddress address = {uint8_t(i % 128), Channel(i % 16)};
+            midi.sendNoteOn(address, 0x7F);
+            midi.sendNoteOff(address, 0x40);
+        }
+    };
+    auto start = steady_clock::now();
+    play();
+    auto untracked = steady_clock::now() - start;
+    midi.setActiveNotes(notes);
+    start = steady_clock::now();
+    play();
+    auto tracked = steady_clock::now() - start;
+    EXPECT_EQ(midi.count, 4 * Notes);
+
+    // Hanging notes: a chord of six notes on four channels
+    constexpr unsigned Repeat = 1000;
+    nanoseconds release = {}, sweep = {};
+    unsigned released = 0, swept = 0;
+    for (unsigned r = 0; r < Repeat; ++r) {
+        for (uint8_t c = 0; c < 4; ++c)
+            for (uint8_t n = 0; n < 6; ++n)
+                midi.sendNoteOn({uint8_t(48 + 7 * n), Channel(4 * c)}, 0x7F);
+        midi.count = 0;
+        start = steady_clock::now();
+        midi.releaseActiveNotes();
+        release += steady_clock::now() - start;
+        released += midi.count;
+
+        midi.count = 0;
+        start = steady_clock::now();
+        for (uint8_t c = 0; c < 16; ++c)
+            for (uint8_t n = 0; n < 128; ++n)
+                midi.sendImpl(NOTE_OFF, c, n, 0x40, 0);
+        sweep += steady_clock::now() - start;
+        swept += midi.count;
+    }
+    EXPECT_EQ(released, 24 * Repeat);
+    EXPECT_EQ(notes.count(), 0);
+
+    auto ns = [](nanoseconds t, unsigned n) {
+        return std::to_string(t.count() / n);
+    };
+    RecordProperty("untracked_ns_per_note", ns(untracked, Notes));
+    RecordProperty("tracked_ns_per_note", ns(tracked, Notes));
+    RecordProperty("panic_tracked_messages", std::to_string(released / Repeat));
+    RecordProperty("panic_sweep_messages", std::to_string(swept / Repeat));
+    RecordProperty("panic_tracked_ns", ns(release, Repeat));
+    RecordProperty("panic_sweep_ns", ns(sweep, Repeat));
+}
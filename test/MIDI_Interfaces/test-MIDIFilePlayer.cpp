@@ -0,0 +1,404 @@
+#include <MIDI_Interfaces/MIDIFilePlayer.hpp>
+#include <gmock-wrapper.h>
+#include <gtest-wrapper.h>
+
+#include <chrono>
+#include <fcntl.h>
+#include <random>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <vector>
+
+USING_CS_NAMESPACE;
+using ::testing::Mock;
+using ::testing::Return;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+void appendBE(Bytes &v, uint32_t value, uint8_t bytes) {
+    while (bytes-- > 0)
+        v.push_back(value >> (8 * bytes));
+}
+
+void appendVLQ(Bytes &v, uint32_t value) {
+    uint8_t buf[4];
+    uint8_t n = 0;
+    do {
+        buf[n++] = value & 0x7F;
+        value >>= 7;
+    } while (value > 0);
+    while (n-- > 1)
+        v.push_back(buf[n] | 0x80);
+    v.push_back(buf[0]);
+}
+
+/// Builds the events of an MTrk chunk.
+struct TrackBuilder {
+    Bytes events;
+    TrackBuilder &event(uint32_t delta, Bytes bytes) {
+        appendVLQ(events, delta);
+        events.insert(events.end(), bytes.begin(), bytes.end());
+        return *this;
+    }
+    TrackBuilder &tempo(uint32_t delta, uint32_t tempo) {
+        return event(delta, {0xFF, 0x51, 0x03, uint8_t(tempo >> 16),
+                             uint8_t(tempo >> 8), uint8_t(tempo)});
+    }
+    TrackBuilder &end(uint32_t delta = 0) {
+        return event(delta, {0xFF, 0x2F, 0x00});
+    }
+};
+
+Bytes buildFile(uint16_t format, uint16_t division,
+                const std::vector<TrackBuilder> &tracks) {
+    Bytes file = {'M', 'T', 'h', 'd'};
+    appendBE(file, 6, 4);
+    appendBE(file, format, 2);
+    appendBE(file, tracks.size(), 2);
+    appendBE(file, division, 2);
+    for (auto &track : tracks) {
+        file.insert(file.end(), {'M', 'T', 'r', 'k'});
+        appendBE(file, track.events.size(), 4);
+        file.insert(file.end(), track.events.begin(), track.events.end());
+    }
+    return file;
+}
+
+struct RecordingMIDI_Sink : TrueMIDI_Sink {
+    void sinkMIDIfromPipe(ChannelMessage msg) override {
+        channel.push_back(msg);
+    }
+    void sinkMIDIfromPipe(SysExMessage msg) override {
+        sysex.push_back(Bytes(msg.data, msg.data + msg.length));
+    }
+    void sinkMIDIfromPipe(RealTimeMessage) override {}
+
+    std::vector<ChannelMessage> channel;
+    std::vector<Bytes> sysex;
+};
+
+using Messages = std::vector<ChannelMessage>;
+
+} // namespace
+
+TEST(MIDIFilePlayer, format0) {
+    auto file = buildFile(0, 96,
+                          {TrackBuilder()
+                               .event(0, {0x90, 0x3C, 0x7F})
+                               .event(96, {0x80, 0x3C, 0x40})
+                               .event(0, {0xC1, 0x05})
+                               .end(48)});
+    MIDIFilePlayer<1> player;
+    RecordingMIDI_Sink sink;
+    MIDI_Pipe pipe;
+    player >> pipe >> sink;
+    ASSERT_TRUE(player.load(file.data(), file.size()));
+    EXPECT_EQ(player.getNumberOfTracks(), 1);
+
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(1000));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    EXPECT_TRUE(player.isPlaying());
+
+    EXPECT_TRUE(player.handleEventsUntil(0));
+    EXPECT_EQ(sink.channel, (Messages{{0x90, 0x3C, 0x7F, 0}}));
+    // 96 ticks = one quarter note = 500 ms at the default tempo of 120 bpm
+    EXPECT_TRUE(player.handleEventsUntil(499999));
+    EXPECT_EQ(sink.channel.size(), 1);
+
+    EXPECT_CALL(ArduinoMock::getInstance(), micros())
+        .WillOnce(Return(1000 + 500000));
+    player.update();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    EXPECT_EQ(sink.channel, (Messages{
+                                {0x90, 0x3C, 0x7F, 0},
+                                {0x80, 0x3C, 0x40, 0},
+                                {0xC1, 0x05, 0x00, 0},
+                            }));
+    EXPECT_EQ(player.getTick(), 96);
+    EXPECT_TRUE(player.isPlaying());
+
+    player.handleEventsUntil(750000);
+    EXPECT_EQ(player.getTick(), 144);
+    EXPECT_EQ(player.getEventCount(), 4);
+    EXPECT_FALSE(player.isPlaying());
+}
+
+TEST(MIDIFilePlayer, format1TempoMap) {
+    auto file = buildFile(1, 480,
+                          {
+                              TrackBuilder().tempo(480, 250000).end(),
+                              TrackBuilder()
+                                  .event(480, {0x91, 0x40, 0x10})
+                                  .event(480, {0x91, 0x41, 0x20})
+                                  .end(),
+                              TrackBuilder()
+                                  .event(240, {0x92, 0x30, 0x30})
+                                  .event(720, {0x92, 0x31, 0x40})
+                                  .end(),
+                          });
+    MIDIFilePlayer<4> player;
+    RecordingMIDI_Sink sink;
+    MIDI_Pipe pipe;
+    player >> pipe >> sink;
+    player.setCableNumber(5);
+    ASSERT_TRUE(player.load(file.data(), file.size()));
+    EXPECT_EQ(player.getNumberOfTracks(), 3);
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(0));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    player.handleEventsUntil(250000);
+    EXPECT_EQ(sink.channel, (Messages{{0x92, 0x30, 0x30, 5}}));
+    // The tempo change in the first track comes first at tick 480, even
+    // though the other track has an event at the same tick.
+    player.handleEventsUntil(500000);
+    EXPECT_EQ(player.getTempo(), 250000);
+    EXPECT_EQ(sink.channel, (Messages{
+                                {0x92, 0x30, 0x30, 5},
+                                {0x91, 0x40, 0x10, 5},
+                            }));
+    // Tick 960 is one quarter note later at the new tempo
+    player.handleEventsUntil(749999);
+    EXPECT_EQ(sink.channel.size(), 2);
+    player.handleEventsUntil(750000);
+    EXPECT_EQ(sink.channel, (Messages{
+                                {0x92, 0x30, 0x30, 5},
+                                {0x91, 0x40, 0x10, 5},
+                                {0x91, 0x41, 0x20, 5},
+                                {0x92, 0x31, 0x40, 5},
+                            }));
+    EXPECT_FALSE(player.isPlaying());
+}
+
+TEST(MIDIFilePlayer, runningStatus) {
+    auto file = buildFile(0, 96,
+                          {TrackBuilder()
+                               .event(0, {0x93, 0x3C, 0x7F})
+                               .event(0, {0x3E, 0x7F})
+                               .event(0, {0xD3, 0x20})
+                               .event(0, {0x21})
+                               .event(0, {0xFF, 0x01, 0x01, 'x'}) // text
+                               .event(0, {0x40, 0x00}) // cancelled by meta
+                               .event(0, {0x83, 0x3C, 0x00})
+                               .end()});
+    MIDIFilePlayer<1> player;
+    RecordingMIDI_Sink sink;
+    MIDI_Pipe pipe;
+    player >> pipe >> sink;
+    ASSERT_TRUE(player.load(file.data(), file.size()));
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(0));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    player.handleEventsUntil(0);
+    EXPECT_EQ(sink.channel, (Messages{
+                                {0x93, 0x3C, 0x7F, 0},
+                                {0x93, 0x3E, 0x7F, 0},
+                                {0xD3, 0x20, 0x00, 0},
+                                {0xD3, 0x21, 0x00, 0},
+                            }));
+    // A data byte without running status is invalid, the track is ended
+    EXPECT_FALSE(player.isPlaying());
+}
+
+TEST(MIDIFilePlayer, sysex) {
+    auto file = buildFile(0, 96,
+                          {TrackBuilder()
+                               .event(0, {0xF0, 0x03, 0x43, 0x12, 0xF7})
+                               .event(0, {0xF7, 0x02, 0x01, 0x02}) // escape
+                               .event(0, {0xF0, 0x08, 1, 2, 3, 4, 5, 6, 7,
+                                          0xF7}) // too long, dropped
+                               .event(0, {0xF0, 0x02, 0x7E, 0xF7})
+                               .end()});
+    MIDIFilePlayer<1, 8> player;
+    RecordingMIDI_Sink sink;
+    MIDI_Pipe pipe;
+    player >> pipe >> sink;
+    ASSERT_TRUE(player.load(file.data(), file.size()));
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(0));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    player.handleEventsUntil(0);
+    EXPECT_EQ(sink.sysex, (std::vector<Bytes>{
+                              {0xF0, 0x43, 0x12, 0xF7},
+                              {0xF0, 0x7E, 0xF7},
+                          }));
+    EXPECT_FALSE(player.isPlaying());
+}
+
+TEST(MIDIFilePlayer, smpte) {
+    // 25 fps, 40 ticks per frame = 1 ms per tick
+    auto file = buildFile(0, uint16_t(uint8_t(-25) << 8 | 40),
+                          {TrackBuilder()
+                               .tempo(0, 1) // ignored
+                               .event(1500, {0xB0, 0x07, 0x64})
+                               .end()});
+    MIDIFilePlayer<1> player;
+    RecordingMIDI_Sink sink;
+    MIDI_Pipe pipe;
+    player >> pipe >> sink;
+    ASSERT_TRUE(player.load(file.data(), file.size()));
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(0));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    player.handleEventsUntil(1499999);
+    EXPECT_TRUE(sink.channel.empty());
+    player.handleEventsUntil(1500000);
+    EXPECT_EQ(sink.channel, (Messages{{0xB0, 0x07, 0x64, 0}}));
+}
+
+TEST(MIDIFilePlayer, lockedPipe) {
+    auto file = buildFile(0, 96,
+                          {TrackBuilder()
+                               .event(0, {0x90, 0x3C, 0x7F})
+                               .event(0, {0x90, 0x3D, 0x7F})
+                               .end()});
+    MIDIFilePlayer<1> player;
+    TrueMIDI_Source other;
+    RecordingMIDI_Sink sink;
+    MIDI_PipeFactory<2> pipes;
+    player >> pipes >> sink;
+    other >> pipes >> sink;
+    ASSERT_TRUE(player.load(file.data(), file.size()));
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(0));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    other.exclusive(0);
+    EXPECT_FALSE(player.handleEventsUntil(0));
+    EXPECT_TRUE(sink.channel.empty());
+    other.exclusive(0, false);
+    // Nothing was lost while the pipe was locked
+    EXPECT_TRUE(player.handleEventsUntil(0));
+    EXPECT_EQ(sink.channel, (Messages{
+                                {0x90, 0x3C, 0x7F, 0},
+                                {0x90, 0x3D, 0x7F, 0},
+                            }));
+}
+
+TEST(MIDIFilePlayer, invalidFiles) {
+    MIDIFilePlayer<2> player;
+    auto valid = buildFile(1, 96, {TrackBuilder().end(), TrackBuilder().end()});
+    EXPECT_TRUE(player.load(valid.data(), valid.size()));
+
+    auto tooManyTracks = buildFile(
+        1, 96, {TrackBuilder().end(), TrackBuilder().end(), TrackBuilder()});
+    EXPECT_FALSE(player.load(tooManyTracks.data(), tooManyTracks.size()));
+    EXPECT_EQ(player.getNumberOfTracks(), 0);
+
+    auto format2 = buildFile(2, 96, {TrackBuilder().end()});
+    EXPECT_FALSE(player.load(format2.data(), format2.size()));
+
+    auto badHeader = valid;
+    badHeader[0] = 'X';
+    EXPECT_FALSE(player.load(badHeader.data(), badHeader.size()));
+
+    EXPECT_FALSE(player.load(valid.data(), 10));
+    EXPECT_FALSE(player.load(nullptr, 0));
+
+    // Truncated events end the track without reading past the data
+    auto truncated = buildFile(0, 96,
+                               {TrackBuilder()
+                                    .event(0, {0x90, 0x3C, 0x7F})
+                                    .event(0, {0x90, 0x3D, 0x7F})});
+    truncated.pop_back();
+    ASSERT_TRUE(player.load(truncated.data(), truncated.size()));
+    RecordingMIDI_Sink sink;
+    MIDI_Pipe pipe;
+    player >> pipe >> sink;
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(0));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    player.handleEventsUntil(0);
+    EXPECT_EQ(sink.channel, (Messages{{0x90, 0x3C, 0x7F, 0}}));
+    EXPECT_FALSE(player.isPlaying());
+}
+
+TEST(MIDIFilePlayer, memoryMappedFile) {
+    auto file = buildFile(0, 96,
+                          {TrackBuilder()
+                               .event(0, {0x90, 0x3C, 0x7F})
+                               .event(10, {0x80, 0x3C, 0x7F})
+                               .end()});
+    char path[] = "/tmp/test-MIDIFilePlayer-XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    ASSERT_EQ(write(fd, file.data(), file.size()), ssize_t(file.size()));
+    void *map = mmap(nullptr, file.size(), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    unlink(path);
+    ASSERT_NE(map, MAP_FAILED);
+
+    MIDIFilePlayer<1> player;
+    RecordingMIDI_Sink sink;
+    MIDI_Pipe pipe;
+    player >> pipe >> sink;
+    ASSERT_TRUE(player.load(static_cast<const uint8_t *>(map), file.size()));
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(0));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    player.handleEventsUntil(1000000);
+    EXPECT_EQ(sink.channel.size(), 2);
+    munmap(map, file.size());
+}
+
+TEST(MIDIFilePlayer, benchmark) {
+    constexpr uint8_t NumTracks = 16;
+    constexpr unsigned EventsPerTrack = 4000;
+    std::mt19937 rng(0x5EED);
+    std::uniform_int_distribution<uint32_t> delta(0, 60);
+    std::vector<TrackBuilder> tracks(NumTracks);
+    for (uint8_t t = 0; t < NumTracks; ++t)
+        for (unsigned e = 0; e < EventsPerTrack; ++e)
+            tracks[t].event(delta(rng),
+                            {uint8_t(0x90 | t), uint8_t(e & 0x7F), 0x40});
+    auto file = buildFile(1, 96, tracks);
+
+    struct CountingMIDI_Sink : TrueMIDI_Sink {
+        void sinkMIDIfromPipe(ChannelMessage msg) override {
+            ++count;
+            validChannel &= (msg.header & 0x0F) < NumTracks;
+        }
+        void sinkMIDIfromPipe(SysExMessage) override {}
+        void sinkMIDIfromPipe(RealTimeMessage) override {}
+        unsigned count = 0;
+        bool validChannel = true;
+    } sink;
+
+    MIDIFilePlayer<NumTracks> player;
+    MIDI_Pipe pipe;
+    player >> pipe >> sink;
+    ASSERT_TRUE(player.load(file.data(), file.size()));
+    EXPECT_CALL(ArduinoMock::getInstance(), micros()).WillOnce(Return(0));
+    player.play();
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    // Play the file in steps of one millisecond, like a main loop would, and
+    // check that the events never go back in time.
+    auto start = std::chrono::steady_clock::now();
+    uint32_t previousTick = 0;
+    bool monotonic = true;
+    for (uint32_t time = 0; player.isPlaying(); time += 1000) {
+        player.handleEventsUntil(time);
+        monotonic &= player.getTick() >= previousTick;
+        previousTick = player.getTick();
+    }
+    auto duration = std::chrono::steady_clock::now() - start;
+
+    EXPECT_TRUE(monotonic);
+    EXPECT_TRUE(sink.validChannel);
+    EXPECT_EQ(sink.count, NumTracks * EventsPerTrack);
+    EXPECT_EQ(player.getEventCount(), NumTracks * EventsPerTrack);
+    // The player state doesn't depend on the size of the file
+    EXPECT_LE(sizeof(player), sizeof(MIDIFilePlayerBase) +
+                                  NumTracks * sizeof(MIDIFilePlayerBase::Track) +
+                                  NumTracks + 32 + 8);
+
+    auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration);
+    double eventsPerSecond = 1e9 * sink.count / (ns.count() + 1);
+    RecordProperty("events_per_second", std::to_string(eventsPerSecond));
+    RecordProperty("file_size", std::to_string(file.size()));
+    RecordProperty("player_size", std::to_string(sizeof(player)));
+}
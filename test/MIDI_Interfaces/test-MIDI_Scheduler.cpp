@@ -0,0 +1,104 @@
+#include <MIDI_Interfaces/MIDI_Interface.hpp>
+#include <MockMIDI_Interface.hpp>
+#include <gmock-wrapper.h>
+#include <gtest-wrapper.h>
+
+USING_CS_NAMESPACE;
+using ::testing::Mock;
+using ::testing::Return;
+using ::testing::Sequence;
+using ::testing::StrictMock;
+
+using AH::ErrorException;
+
+class MIDI_SchedulerTest : public ::testing::Test {
+  protected:
+    void SetUp() override { MIDI_Scheduler::getInstance().clear(); }
+    void TearDown() override {
+        MIDI_Scheduler::getInstance().clear();
+        Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    }
+    void updateAt(unsigned long time) {
+        EXPECT_CALL(ArduinoMock::getInstance(), millis())
+            .WillOnce(Return(time));
+        MIDI_Scheduler::updateInstance();
+        Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    }
+};
+
+TEST_F(MIDI_SchedulerTest, sendAtInOrder) {
+    StrictMock<MockMIDI_Interface> midi;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis()).WillOnce(Return(1000));
+    midi.sendAt(1030, {0x80, 0x3C, 0x40, 0});
+    midi.sendAt(1010, {0x90, 0x3C, 0x7F, 0});
+    midi.sendAt(1020, {0x91, 0x3E, 0x7F, 3});
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    updateAt(1009);
+    Mock::VerifyAndClear(&midi);
+
+    EXPECT_CALL(midi, sendImpl(0x90, 0x00, 0x3C, 0x7F, 0));
+    updateAt(1010);
+    Mock::VerifyAndClear(&midi);
+
+    Sequence s;
+    EXPECT_CALL(midi, sendImpl(0x90, 0x01, 0x3E, 0x7F, 3)).InSequence(s);
+    EXPECT_CALL(midi, sendImpl(0x80, 0x00, 0x3C, 0x40, 0)).InSequence(s);
+    updateAt(1100);
+    EXPECT_EQ(MIDI_Scheduler::getInstance().size(), 0);
+}
+
+TEST_F(MIDI_SchedulerTest, sendAfter) {
+    StrictMock<MockMIDI_Interface> midi;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis()).WillRepeatedly(Return(5));
+    midi.sendAfter(250, {0xB2, 0x10, 0x20, 1});
+    midi.sendAfter(100, RealTimeMessage{0xF8, 2});
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+
+    updateAt(104);
+    EXPECT_CALL(midi, sendImpl(0xF8, 2));
+    updateAt(105);
+    Mock::VerifyAndClear(&midi);
+    updateAt(254);
+    EXPECT_CALL(midi, sendImpl(0xB0, 0x02, 0x10, 0x20, 1));
+    updateAt(255);
+}
+
+TEST_F(MIDI_SchedulerTest, twoByteMessages) {
+    StrictMock<MockMIDI_Interface> midi;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis()).WillOnce(Return(0));
+    midi.sendAt(1, {0xC5, 0x12, 0x00, 0});
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    EXPECT_CALL(midi, sendImpl(0xC0, 0x05, 0x12, 0));
+    updateAt(1);
+}
+
+TEST_F(MIDI_SchedulerTest, destructorCancels) {
+    StrictMock<MockMIDI_Interface> midiA;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis()).WillOnce(Return(0));
+    midiA.sendAt(10, {0x90, 0x3C, 0x7F, 0});
+    {
+        StrictMock<MockMIDI_Interface> midiB;
+        midiB.sendAt(10, {0x90, 0x3D, 0x7F, 0});
+        midiB.sendAt(20, {0x90, 0x3E, 0x7F, 0});
+    }
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    EXPECT_EQ(MIDI_Scheduler::getInstance().size(), 1);
+    EXPECT_CALL(midiA, sendImpl(0x90, 0x00, 0x3C, 0x7F, 0));
+    updateAt(20);
+}
+
+TEST_F(MIDI_SchedulerTest, full) {
+    StrictMock<MockMIDI_Interface> midi;
+    EXPECT_CALL(ArduinoMock::getInstance(), millis()).WillOnce(Return(0));
+    for (uint8_t i = 0; i < MIDI_SCHEDULER_CAPACITY; ++i)
+        EXPECT_TRUE(midi.sendAt(i, {0x90, i, 0x7F, 0}));
+    try {
+        midi.sendAt(100, {0x90, 0x00, 0x7F, 0});
+        FAIL();
+    } catch (ErrorException &e) {
+        EXPECT_EQ(e.getErrorCode(), 0x5C4E);
+    }
+    midi.cancelScheduled();
+    EXPECT_EQ(MIDI_Scheduler::getInstance().size(), 0);
+}
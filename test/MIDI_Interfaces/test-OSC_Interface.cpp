@@ -0,0 +1,182 @@
+#include <MIDI_Interfaces/OSC_Interface.hpp>
+#include <gtest-wrapper.h>
+
+#include <chrono>
+#include <functional>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using u8vec = std::vector<uint8_t>;
+
+namespace {
+
+/// Different ports for each test process, because tests may run in parallel.
+uint16_t basePort() { return 24000 + (getpid() % 4000) * 4; }
+
+UDP_Endpoint localhost(uint16_t port) { return {{127, 0, 0, 1}, port}; }
+
+struct Recorder : MIDI_Callbacks {
+    void onChannelMessage(Parsing_MIDI_Interface &midi) override {
+        channel.push_back(midi.getChannelMessage());
+    }
+    std::vector<ChannelMessage> channel;
+};
+
+const OSC_Mapping mappings[] {
+    {"/mixer/1/fader", CONTROL_CHANGE, {7, CHANNEL_1}},
+    {"/mixer/2/fader", CONTROL_CHANGE, {7, CHANNEL_2}},
+    {"/mixer/12/fader", CONTROL_CHANGE, {7, CHANNEL_12, 3}},
+    {"/master/fader", PITCH_BEND, CHANNEL_16},
+    {"/cue/go", NOTE_ON, {60, CHANNEL_1}, OSC_Mapping::Int},
+    {"/scene", PROGRAM_CHANGE, {CHANNEL_1, 1}, OSC_Mapping::Int},
+};
+
+class OSC_InterfaceTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        a.begin();
+        b.begin();
+        a.setCallbacks(recA);
+        b.setCallbacks(recB);
+        ASSERT_TRUE(socket.begin(basePort() + 2));
+    }
+
+    /// Update everything until the condition is true, or until it times out.
+    bool updateUntil(std::function<bool()> condition) {
+        auto start = std::chrono::steady_clock::now();
+        while (!condition()) {
+            if (std::chrono::steady_clock::now() - start >
+                std::chrono::seconds(2))
+                return false;
+            a.update();
+            b.update();
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        return true;
+    }
+
+    /// Wait for a datagram on the raw socket.
+    u8vec receive() {
+        uint8_t buffer[2048];
+        UDP_Endpoint from;
+        for (unsigned i = 0; i < 100000; ++i) {
+            if (size_t length = socket.receive(buffer, sizeof(buffer), from))
+                return u8vec(buffer, buffer + length);
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        return {};
+    }
+
+    OSC_Interface a {mappings, basePort(), localhost(basePort() + 1)};
+    OSC_Interface b {mappings, uint16_t(basePort() + 1),
+                     localhost(basePort())};
+    UDP_Socket socket;
+    Recorder recA, recB;
+};
+
+} // namespace
+
+TEST_F(OSC_InterfaceTest, sendReceive) {
+    a.sendCC({7, CHANNEL_1}, 127);
+    a.sendCC({7, CHANNEL_2}, 0);
+    a.sendCC({7, CHANNEL_12, 3}, 64);
+    a.sendCC({8, CHANNEL_1}, 1); // not mapped
+    a.sendPB(CHANNEL_16, 0x1234);
+    a.sendNoteOn({60, CHANNEL_1}, 100);
+    a.sendNoteOff({60, CHANNEL_1}, 100);
+    a.sendPC({CHANNEL_1, 1}, 5);
+    a.sendPC({CHANNEL_1, 0}, 5); // not mapped (cable 0)
+    uint8_t sysex[] = {0xF0, 0x01, 0xF7};
+    a.send(sysex); // not mapped
+
+    ASSERT_TRUE(updateUntil([&] { return recB.channel.size() == 7; }));
+    std::vector<ChannelMessage> expected = {
+        {0xB0, 7, 127, 0},   {0xB1, 7, 0, 0},    {0xBB, 7, 64, 3},
+        {0xEF, 0x34, 0x24, 0}, {0x90, 60, 100, 0}, {0x80, 60, 0x40, 0},
+        {0xC0, 5, 0, 1},
+    };
+    EXPECT_EQ(recB.channel, expected);
+    // All messages were sent in a single bundle
+    EXPECT_EQ(a.getPacketsSent(), 1u);
+    EXPECT_EQ(a.getMessagesSent(), 7u);
+    EXPECT_EQ(b.getPacketsReceived(), 1u);
+    EXPECT_EQ(b.getMessagesReceived(), 7u);
+
+    // A single message is sent without a bundle
+    b.sendCC({7, CHANNEL_2}, 33);
+    ASSERT_TRUE(updateUntil([&] { return recA.channel.size() == 1; }));
+    EXPECT_EQ(recA.channel[0], (ChannelMessage{0xB1, 7, 33, 0}));
+}
+
+TEST_F(OSC_InterfaceTest, encoding) {
+    a.setRemote(localhost(basePort() + 2));
+    a.sendPB(CHANNEL_16, 16383);
+    a.update();
+    u8vec expected = {
+        '/', 'm', 'a', 's', 't', 'e', 'r', '/', //
+        'f', 'a', 'd', 'e', 'r', 0,   0,   0,   //
+        ',', 'f', 0,   0,                       //
+        0x3F, 0x80, 0x00, 0x00,                 // 1.0f
+    };
+    EXPECT_EQ(receive(), expected);
+
+    a.sendNoteOn({60, CHANNEL_1}, 0x7F);
+    a.sendCC({7, CHANNEL_1}, 0);
+    a.update();
+    u8vec bundle = receive();
+    ASSERT_TRUE(OSC_Message::isBundle(bundle.data(), bundle.size()));
+    std::vector<std::string> addresses;
+    std::vector<char> types;
+    OSC_Message::forEach(bundle.data(), bundle.size(),
+                         [&](const OSC_Message &msg) {
+                             addresses.push_back(msg.getAddress());
+                             types.push_back(msg.getArgument(0).type);
+                         });
+    EXPECT_EQ(addresses,
+              (std::vector<std::string>{"/cue/go", "/mixer/1/fader"}));
+    EXPECT_EQ(types, (std::vector<char>{'i', 'f'}));
+}
+
+TEST_F(OSC_InterfaceTest, patterns) {
+    uint8_t buffer[256];
+    OSC_Writer writer {buffer, sizeof(buffer)};
+    writer.add("/mixer/*/fader", OSC_Argument::Float(0.5f));
+    writer.add("/master/fader", OSC_Argument::Int(2)); // float mapping, int arg
+    writer.add("/cue/go", OSC_Argument {'T', {0}});
+    writer.add("/scene", OSC_Argument::Float(3.9f)); // int mapping, float arg
+    writer.add("/unknown", OSC_Argument::Float(1));
+    writer.add("/mixer/1/fader", OSC_Argument::Float(-1)); // clamped
+    socket.send(localhost(basePort()), writer.getData(), writer.getLength());
+
+    ASSERT_TRUE(updateUntil([&] { return recA.channel.size() == 7; }));
+    std::vector<ChannelMessage> expected = {
+        {0xB0, 7, 64, 0},    {0xB1, 7, 64, 0}, {0xBB, 7, 64, 3},
+        {0xEF, 0x02, 0x00, 0}, {0x90, 60, 127, 0}, {0xC0, 3, 0, 1},
+        {0xB0, 7, 0, 0},
+    };
+    EXPECT_EQ(recA.channel, expected);
+}
+
+TEST_F(OSC_InterfaceTest, replyToSender) {
+    a.setRemote({{0, 0, 0, 0}, 0});
+    a.sendCC({7, CHANNEL_1}, 1);
+    a.update(); // nobody to send to yet
+    EXPECT_EQ(a.getPacketsSent(), 0u);
+
+    uint8_t buffer[64];
+    OSC_Writer writer {buffer, sizeof(buffer)};
+    writer.add("/mixer/2/fader", OSC_Argument::Float(0));
+    socket.send(localhost(basePort()), writer.getData(), writer.getLength());
+    ASSERT_TRUE(updateUntil([&] { return recA.channel.size() == 1; }));
+
+    a.sendCC({7, CHANNEL_2}, 127);
+    a.update();
+    u8vec reply = receive();
+    OSC_Message msg;
+    ASSERT_TRUE(msg.parse(reply.data(), reply.size()));
+    EXPECT_STREQ(msg.getAddress(), "/mixer/2/fader");
+    EXPECT_EQ(msg.getArgument(0).f, 1.0f);
+}
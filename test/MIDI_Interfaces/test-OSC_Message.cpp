@@ -0,0 +1,227 @@
+#include <MIDI_Interfaces/OSC/OSC_Message.hpp>
+#include <gtest-wrapper.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using u8vec = std::vector<uint8_t>;
+
+namespace {
+
+struct Received {
+    std::string address;
+    std::string typetags;
+    std::vector<OSC_Argument> args;
+};
+
+bool decode(const u8vec &packet, std::vector<Received> &received) {
+    return OSC_Message::forEach(
+        packet.data(), packet.size(), [&](const OSC_Message &msg) {
+            received.push_back({msg.getAddress(), msg.getTypeTags(), {}});
+            for (uint8_t i = 0; i < msg.getArgumentCount(); ++i)
+                received.back().args.push_back(msg.getArgument(i));
+        });
+}
+
+} // namespace
+
+TEST(OSC_Writer, bundle) {
+    uint8_t buffer[128];
+    OSC_Writer writer {buffer, sizeof(buffer)};
+    EXPECT_EQ(writer.getLength(), 16u);
+    EXPECT_TRUE(writer.add("/a", OSC_Argument::Int(0x01020304)));
+    OSC_Argument args[] = {OSC_Argument::Float(0.5f), {'T', {0}}};
+    EXPECT_TRUE(writer.add("/fader", args, 2));
+    EXPECT_EQ(writer.getMessageCount(), 2);
+
+    u8vec expected = {
+        '#', 'b', 'u', 'n', 'd', 'l', 'e', 0,    // bundle
+        0,   0,   0,   0,   0,   0,   0,   1,    // time tag: immediately
+        0,   0,   0,   12,                       // size
+        '/', 'a', 0,   0,                        // address
+        ',', 'i', 0,   0,                        // type tags
+        1,   2,   3,   4,                        // int32
+        0,   0,   0,   16,                       // size
+        '/', 'f', 'a', 'd', 'e', 'r', 0,   0,    // address
+        ',', 'f', 'T', 0,                        // type tags
+        0x3F, 0x00, 0x00, 0x00,                  // float32
+    };
+    EXPECT_EQ(u8vec(writer.getData(), writer.getData() + writer.getLength()),
+              expected);
+    EXPECT_EQ(u8vec(writer.getFirstMessage(),
+                    writer.getFirstMessage() + writer.getFirstMessageLength()),
+              u8vec(expected.begin() + 20, expected.begin() + 32));
+
+    writer.reset(0x0102030405060708);
+    EXPECT_EQ(writer.getLength(), 16u);
+    EXPECT_EQ(writer.getMessageCount(), 0);
+    EXPECT_EQ(buffer[8], 0x01);
+    EXPECT_EQ(buffer[15], 0x08);
+}
+
+TEST(OSC_Writer, full) {
+    uint8_t buffer[40];
+    OSC_Writer writer {buffer, sizeof(buffer)};
+    EXPECT_TRUE(writer.add("/abc", OSC_Argument::Int(1))); // 4 + 12 bytes
+    EXPECT_FALSE(writer.add("/abcdefgh", OSC_Argument::Int(2)));
+    EXPECT_EQ(writer.getLength(), 36u);
+    EXPECT_EQ(writer.getMessageCount(), 1);
+    OSC_Argument blob = {'b', {0}};
+    EXPECT_FALSE(writer.add("/", &blob, 1)); // unsupported type
+}
+
+TEST(OSC_Message, roundTrip) {
+    uint8_t buffer[256];
+    OSC_Writer writer {buffer, sizeof(buffer)};
+    writer.add("/mixer/1/fader", OSC_Argument::Float(0.25f));
+    writer.add("/cue", OSC_Argument::Int(-7));
+    writer.add("/empty", nullptr, 0);
+
+    std::vector<Received> received;
+    u8vec packet(writer.getData(), writer.getData() + writer.getLength());
+    ASSERT_TRUE(decode(packet, received));
+    ASSERT_EQ(received.size(), 3u);
+    EXPECT_EQ(received[0].address, "/mixer/1/fader");
+    EXPECT_EQ(received[0].typetags, "f");
+    EXPECT_EQ(received[0].args[0].f, 0.25f);
+    EXPECT_EQ(received[1].address, "/cue");
+    EXPECT_EQ(received[1].args[0].type, 'i');
+    EXPECT_EQ(received[1].args[0].i, -7);
+    EXPECT_EQ(received[2].address, "/empty");
+    EXPECT_EQ(received[2].args.size(), 0u);
+}
+
+TEST(OSC_Message, bareMessageWithOtherArguments) {
+    u8vec packet = {
+        '/', 'x', 0,   0,                             // address
+        ',', 's', 'b', 'h', 'i', 0,   0,   0,         // type tags
+        'a', 'b', 'c', 'd', 'e', 0,   0,   0,         // string
+        0,   0,   0,   2,   0xAA, 0xBB, 0, 0,         // blob
+        0,   0,   0,   0,   0,   0,   0,   1,         // int64
+        0,   0,   0,   42,                            // int32
+    };
+    std::vector<Received> received;
+    ASSERT_TRUE(decode(packet, received));
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].typetags, "sbhi");
+    EXPECT_EQ(received[0].args[3].type, 'i');
+    EXPECT_EQ(received[0].args[3].i, 42);
+}
+
+TEST(OSC_Message, nestedBundles) {
+    uint8_t inner[64];
+    OSC_Writer innerWriter {inner, sizeof(inner)};
+    innerWriter.add("/b", OSC_Argument::Int(2));
+    uint8_t outer[128];
+    OSC_Writer writer {outer, sizeof(outer)};
+    writer.add("/a", OSC_Argument::Int(1));
+    u8vec packet(outer, outer + writer.getLength());
+    // Append the inner bundle as an element of the outer bundle
+    size_t size = innerWriter.getLength();
+    packet.insert(packet.end(), {0, 0, 0, uint8_t(size)});
+    packet.insert(packet.end(), inner, inner + size);
+
+    std::vector<Received> received;
+    ASSERT_TRUE(decode(packet, received));
+    ASSERT_EQ(received.size(), 2u);
+    EXPECT_EQ(received[0].address, "/a");
+    EXPECT_EQ(received[1].address, "/b");
+    EXPECT_EQ(received[1].args[0].i, 2);
+}
+
+TEST(OSC_Message, invalid) {
+    std::vector<Received> received;
+    // Not a multiple of four bytes
+    EXPECT_FALSE(decode({'/', 'a', 0, 0, ',', 0, 0}, received));
+    // Doesn't start with a slash
+    EXPECT_FALSE(decode({'a', 0, 0, 0}, received));
+    // Unterminated address
+    EXPECT_FALSE(decode({'/', 'a', 'b', 'c'}, received));
+    // Missing argument
+    EXPECT_FALSE(decode({'/', 'a', 0, 0, ',', 'i', 0, 0}, received));
+    // Unknown type
+    EXPECT_FALSE(decode({'/', 'a', 0, 0, ',', 'x', 0, 0}, received));
+    // Bundle element that's too long
+    EXPECT_FALSE(decode({'#', 'b', 'u', 'n', 'd', 'l', 'e', 0, 0, 0, 0, 0, 0,
+                         0, 0, 1, 0, 0, 0, 8, '/', 'a', 0, 0},
+                        received));
+    EXPECT_TRUE(received.empty());
+    // No type tags at all (old implementations)
+    EXPECT_TRUE(decode({'/', 'a', 0, 0}, received));
+    ASSERT_EQ(received.size(), 1u);
+    EXPECT_EQ(received[0].typetags, "");
+}
+
+TEST(OSC_Message, matchPattern) {
+    auto match = OSC_Message::matchPattern;
+    EXPECT_TRUE(match("/mixer/1/fader", "/mixer/1/fader"));
+    EXPECT_FALSE(match("/mixer/1/fader", "/mixer/1/fade"));
+    EXPECT_FALSE(match("/mixer/1/fade", "/mixer/1/fader"));
+    EXPECT_TRUE(match("/mixer/?/fader", "/mixer/1/fader"));
+    EXPECT_FALSE(match("/mixer/?/fader", "/mixer/12/fader"));
+    EXPECT_TRUE(match("/mixer/*/fader", "/mixer/12/fader"));
+    EXPECT_TRUE(match("/mixer/*", "/mixer/12"));
+    EXPECT_FALSE(match("/mixer/*", "/mixer/12/fader"));
+    EXPECT_TRUE(match("/mixer/*/*", "/mixer/12/fader"));
+    EXPECT_TRUE(match("/mixer/1*2/fader", "/mixer/1002/fader"));
+    EXPECT_TRUE(match("/mixer/[1-4]/fader", "/mixer/3/fader"));
+    EXPECT_FALSE(match("/mixer/[1-4]/fader", "/mixer/5/fader"));
+    EXPECT_TRUE(match("/mixer/[!1-4]/fader", "/mixer/5/fader"));
+    EXPECT_TRUE(match("/mixer/[135]/fader", "/mixer/5/fader"));
+    EXPECT_FALSE(match("/mixer/[135]/fader", "/mixer/2/fader"));
+    EXPECT_TRUE(match("/mixer/1/{fader,knob}", "/mixer/1/knob"));
+    EXPECT_TRUE(match("/mixer/1/{fader,knob}", "/mixer/1/fader"));
+    EXPECT_FALSE(match("/mixer/1/{fader,knob}", "/mixer/1/mute"));
+    EXPECT_TRUE(match("/mixer/{1,12}/fader", "/mixer/12/fader"));
+    EXPECT_FALSE(match("/mixer/[1-4", "/mixer/1"));
+}
+
+TEST(OSC_Message, benchmark) {
+    using namespace std::chrono;
+    constexpr unsigned N = 100000;
+    const char *addresses[] = {"/mixer/1/fader", "/mixer/2/fader",
+                               "/mixer/3/fader", "/mixer/4/fader"};
+    uint8_t buffer[1024];
+    OSC_Writer writer {buffer, sizeof(buffer)};
+    unsigned encoded = 0;
+
+    auto start = steady_clock::now();
+    for (unsigned i = 0; i < N; ++i) {
+        OSC_Argument arg = OSC_Argument::Float(i * 1e-5f);
+        if (!writer.add(addresses[i % 4], arg)) {
+            encoded += writer.getMessageCount();
+            writer.reset();
+            writer.add(addresses[i % 4], arg);
+        }
+    }
+    auto encode = steady_clock::now() - start;
+    EXPECT_EQ(encoded + writer.getMessageCount(), N);
+
+    // Decode full bundles
+    writer.reset();
+    for (unsigned i = 0; writer.add(addresses[i % 4], OSC_Argument::Float(1));)
+        ++i;
+    unsigned perBundle = writer.getMessageCount();
+    EXPECT_EQ(perBundle, (sizeof(buffer) - 16) / 28);
+    unsigned decoded = 0;
+    float sum = 0;
+    start = steady_clock::now();
+    for (unsigned i = 0; i < N / perBundle; ++i)
+        OSC_Message::forEach(writer.getData(), writer.getLength(),
+                             [&](const OSC_Message &msg) {
+                                 sum += msg.getArgument(0).f;
+                                 ++decoded;
+                             });
+    auto decode = steady_clock::now() - start;
+    EXPECT_EQ(decoded, N / perBundle * perBundle);
+    EXPECT_EQ(sum, float(decoded));
+
+    auto ns = [](nanoseconds t, unsigned n) {
+        return std::to_string(t.count() / n);
+    };
+    RecordProperty("encode_ns_per_message", ns(encode, N));
+    RecordProperty("decode_ns_per_message", ns(decode, decoded));
+}
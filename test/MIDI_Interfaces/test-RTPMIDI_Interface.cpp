@@ -0,0 +1,318 @@
+#include <MIDI_Interfaces/RTPMIDI_Interface.hpp>
+#include <gmock-wrapper.h>
+#include <gtest-wrapper.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+USING_CS_NAMESPACE;
+using ::testing::Invoke;
+using ::testing::Mock;
+
+using u8vec = std::vector<uint8_t>;
+
+namespace {
+
+unsigned long realMicros() {
+    using namespace std::chrono;
+    static auto start = steady_clock::now();
+    return duration_cast<microseconds>(steady_clock::now() - start).count();
+}
+
+/// Different ports for each test process, because tests may run in parallel.
+uint16_t basePort() { return 20000 + (getpid() % 4000) * 8; }
+
+constexpr UDP_Endpoint localhost(uint16_t port) {
+    return {{127, 0, 0, 1}, port};
+}
+
+struct Recorder : MIDI_Callbacks {
+    void onChannelMessage(Parsing_MIDI_Interface &midi) override {
+        ChannelMessage msg = midi.getChannelMessage();
+        if ((msg.header & 0xE0) == 0xC0)
+            msg.data2 = 0; // two-byte message
+        channel.push_back(msg);
+    }
+    void onSysExMessage(Parsing_MIDI_Interface &midi) override {
+        SysExMessage msg = midi.getSysExMessage();
+        sysex.push_back(u8vec(msg.data, msg.data + msg.length));
+    }
+    void onRealtimeMessage(Parsing_MIDI_Interface &, uint8_t message) override {
+        realtime.push_back(message);
+    }
+
+    std::vector<ChannelMessage> channel;
+    std::vector<u8vec> sysex;
+    u8vec realtime;
+};
+
+/// Forwards the datagrams between an initiator and a responder, and drops
+/// some of the RTP-MIDI packets of the initiator.
+struct LossyRelay {
+    UDP_Socket sockets[2]; // control and data
+    UDP_Endpoint responder;
+    UDP_Endpoint initiator[2];
+    std::function<bool(unsigned)> drop = [](unsigned) { return false; };
+    unsigned packets = 0, dropped = 0;
+
+    void begin(uint16_t port, UDP_Endpoint responder) {
+        this->responder = responder;
+        ASSERT_TRUE(sockets[0].begin(port));
+        ASSERT_TRUE(sockets[1].begin(port + 1));
+    }
+
+    void update() {
+        uint8_t buffer[2048];
+        UDP_Endpoint from;
+        for (uint8_t i = 0; i < 2; ++i) {
+            uint16_t responderPort = responder.port + i;
+            while (size_t length = sockets[i].receive(buffer, 2048, from)) {
+                if (from.port == responderPort) {
+                    sockets[i].send(initiator[i], buffer, length);
+                    continue;
+                }
+                initiator[i] = from;
+                bool rtp = i == 1 && buffer[0] == 0x80;
+                if (rtp && drop(packets++)) {
+                    ++dropped;
+                    continue;
+                }
+                sockets[i].send(localhost(responderPort), buffer, length);
+            }
+        }
+    }
+};
+
+class RTPMIDI_InterfaceTest : public ::testing::Test {
+  protected:
+    void SetUp() override {
+        EXPECT_CALL(ArduinoMock::getInstance(), micros())
+            .WillRepeatedly(Invoke(realMicros));
+        a.begin();
+        b.begin();
+        a.setCallbacks(recA);
+        b.setCallbacks(recB);
+    }
+    void TearDown() override {
+        a.disconnect();
+        b.disconnect();
+        Mock::VerifyAndClear(&ArduinoMock::getInstance());
+    }
+
+    /// Update everything until the condition is true, or until it times out.
+    bool updateUntil(std::function<bool()> condition,
+                     unsigned long timeout = 2000000) {
+        unsigned long start = realMicros();
+        while (!condition()) {
+            if (realMicros() - start > timeout)
+                return false;
+            a.update();
+            b.update();
+            relay.update();
+            std::this_thread::sleep_for(std::chrono::microseconds(20));
+        }
+        return true;
+    }
+
+    void connect() {
+        a.connect(localhost(portB));
+        ASSERT_TRUE(updateUntil([&] { return a.isConnected(); }));
+        ASSERT_TRUE(updateUntil([&] { return b.isConnected(); }));
+    }
+
+    const uint16_t portA = basePort(), portB = basePort() + 2,
+                   portRelay = basePort() + 4;
+    RTPMIDI_Interface a{"Interface A", portA};
+    RTPMIDI_Interface b{"Interface B", portB};
+    Recorder recA, recB;
+    LossyRelay relay;
+};
+
+} // namespace
+
+TEST_F(RTPMIDI_InterfaceTest, handshakeAndSync) {
+    connect();
+    EXPECT_STREQ(a.getPeerName(), "Interface B");
+    EXPECT_STREQ(b.getPeerName(), "Interface A");
+    EXPECT_EQ(b.getPeer().port, portA);
+
+    // The initiator starts the clock synchronization immediately
+    ASSERT_TRUE(updateUntil([&] { return b.getLatency() > 0; }));
+    EXPECT_GT(a.getLatency(), 0u);
+    EXPECT_LT(a.getLatency(), 100000u);
+    // Both participants use the same clock
+    EXPECT_LT(std::abs(a.getClockOffset()), 20000);
+    EXPECT_LT(std::abs(b.getClockOffset()), 20000);
+
+    b.disconnect();
+    EXPECT_FALSE(b.isConnected());
+    ASSERT_TRUE(updateUntil([&] { return !a.isConnected(); }));
+}
+
+TEST_F(RTPMIDI_InterfaceTest, rejectSecondPeer) {
+    connect();
+    RTPMIDI_Interface c{"Interface C", portRelay};
+    c.begin();
+    c.connect(localhost(portB));
+    updateUntil(
+        [&] {
+            c.update();
+            return false;
+        },
+        200000);
+    EXPECT_FALSE(c.isConnected());
+    EXPECT_TRUE(b.isConnected());
+    EXPECT_STREQ(b.getPeerName(), "Interface A");
+}
+
+TEST_F(RTPMIDI_InterfaceTest, sendReceive) {
+    connect();
+    a.setBatchTime(0);
+    a.sendNoteOn({0x3C, CHANNEL_2}, 0x7F);
+    a.sendCC({0x07, CHANNEL_2}, 0x64);
+    a.sendPB(CHANNEL_16, 0x1234);
+    a.sendPC(CHANNEL_3, 0x05);
+    a.sendCP(CHANNEL_4, 0x20);
+    a.sendKP({0x3C, CHANNEL_5}, 0x30);
+    uint8_t sysex[] = {0xF0, 0x43, 0x12, 0x00, 0xF7};
+    a.send(sysex);
+    a.send(0xF8);
+
+    ASSERT_TRUE(updateUntil([&] {
+        return recB.channel.size() == 6 && recB.sysex.size() == 1 &&
+               recB.realtime.size() == 1;
+    }));
+    std::vector<ChannelMessage> expected = {
+        {0x91, 0x3C, 0x7F, 0}, {0xB1, 0x07, 0x64, 0}, {0xEF, 0x34, 0x24, 0},
+        {0xC2, 0x05, 0x00, 0}, {0xD3, 0x20, 0x00, 0}, {0xA4, 0x3C, 0x30, 0},
+    };
+    EXPECT_EQ(recB.channel, expected);
+    EXPECT_EQ(recB.sysex[0], u8vec(std::begin(sysex), std::end(sysex)));
+    EXPECT_EQ(recB.realtime, u8vec{0xF8});
+    EXPECT_EQ(a.getPacketsSent(), 8u);
+    EXPECT_EQ(b.getPacketsReceived(), 8u);
+    EXPECT_EQ(b.getPacketsLost(), 0u);
+
+    // The other way around, using the default batch time
+    b.sendCC({0x10, CHANNEL_1}, 0x11);
+    ASSERT_TRUE(updateUntil([&] { return recA.channel.size() == 1; }));
+    EXPECT_EQ(recA.channel[0], (ChannelMessage{0xB0, 0x10, 0x11, 0}));
+}
+
+TEST_F(RTPMIDI_InterfaceTest, batching) {
+    connect();
+    a.setBatchTime(10000000);
+    std::vector<ChannelMessage> expected;
+    for (uint8_t i = 0; i < 100; ++i) {
+        a.sendCC({0x07, CHANNEL_1}, i);
+        expected.push_back({0xB0, 0x07, i, 0});
+    }
+    a.send(0xFA); // real-time messages don't cancel running status
+    a.sendCC({0x07, CHANNEL_1}, 100);
+    expected.push_back({0xB0, 0x07, 100, 0});
+    a.flush();
+    EXPECT_EQ(a.getPacketsSent(), 1u);
+    ASSERT_TRUE(updateUntil([&] { return recB.channel.size() == 101; }));
+    EXPECT_EQ(recB.channel, expected);
+    EXPECT_EQ(recB.realtime, u8vec{0xFA});
+    EXPECT_EQ(b.getPacketsReceived(), 1u);
+
+    // Messages that don't fit in one packet are split over multiple packets
+    for (unsigned i = 0; i < 300; ++i)
+        a.sendNoteOn({uint8_t(i % 128), CHANNEL_1}, 0x7F);
+    a.flush();
+    EXPECT_GE(a.getPacketsSent(), 3u);
+    ASSERT_TRUE(updateUntil([&] { return recB.channel.size() == 401; }));
+}
+
+TEST_F(RTPMIDI_InterfaceTest, recoveryJournal) {
+    relay.begin(portRelay, localhost(portB));
+    a.connect(localhost(portRelay));
+    ASSERT_TRUE(updateUntil([&] { return a.isConnected() && b.isConnected(); }));
+    a.setBatchTime(0);
+
+    // Drop every third packet
+    relay.drop = [](unsigned i) { return i % 3 == 1; };
+    std::map<uint8_t, uint8_t> controllers, notes;
+    for (uint8_t i = 0; i < 60; ++i) {
+        uint8_t note = 0x30 + i % 12;
+        if (notes[note]) {
+            a.sendNoteOff({note, CHANNEL_1}, 0x40);
+            notes[note] = 0;
+        } else {
+            a.sendNoteOn({note, CHANNEL_1}, i + 1);
+            notes[note] = i + 1;
+        }
+        a.sendCC({uint8_t(i % 5), CHANNEL_1}, i);
+        controllers[i % 5] = i;
+        a.update(), b.update(), relay.update();
+    }
+    // Make sure the last packet arrives
+    relay.drop = [](unsigned) { return false; };
+    a.sendPC(CHANNEL_1, 0x01);
+    ASSERT_TRUE(updateUntil([&] {
+        return !recB.channel.empty() && recB.channel.back().header == 0xC0;
+    }));
+
+    // Reconstruct the state of the receiver from the messages it received
+    std::map<uint8_t, uint8_t> receivedControllers, receivedNotes;
+    for (ChannelMessage msg : recB.channel) {
+        if (msg.header == 0x90)
+            receivedNotes[msg.data1] = msg.data2;
+        else if (msg.header == 0x80)
+            receivedNotes[msg.data1] = 0;
+        else if (msg.header == 0xB0)
+            receivedControllers[msg.data1] = msg.data2;
+    }
+    for (auto &n : notes)
+        receivedNotes.emplace(n.first, 0);
+    EXPECT_EQ(receivedControllers, controllers);
+    EXPECT_EQ(receivedNotes, notes);
+    EXPECT_GT(relay.dropped, 0u);
+    EXPECT_EQ(b.getPacketsLost(), relay.dropped);
+    EXPECT_GT(b.getRecoveries(), 0u);
+}
+
+TEST_F(RTPMIDI_InterfaceTest, benchmark) {
+    connect();
+    a.setBatchTime(0);
+
+    // Latency: time between sending a message and receiving it
+    constexpr unsigned N = 200;
+    std::vector<unsigned long> latencies;
+    for (unsigned i = 0; i < N; ++i) {
+        unsigned long start = realMicros();
+        a.sendNoteOn({uint8_t(i % 128), CHANNEL_1}, 0x7F);
+        size_t count = recB.channel.size();
+        while (recB.channel.size() == count && realMicros() - start < 100000)
+            b.update();
+        latencies.push_back(realMicros() - start);
+    }
+    ASSERT_EQ(recB.channel.size(), N);
+    std::sort(latencies.begin(), latencies.end());
+
+    // Throughput: packets per second
+    constexpr unsigned M = 5000;
+    unsigned long start = realMicros();
+    for (unsigned i = 0; i < M; ++i) {
+        a.sendCC({0x07, CHANNEL_1}, i % 128);
+        b.update();
+    }
+    ASSERT_TRUE(updateUntil([&] {
+        return b.getPacketsReceived() + b.getPacketsLost() == N + M;
+    }));
+    unsigned long duration = realMicros() - start;
+    double packetsPerSecond = 1e6 * M / duration;
+
+    EXPECT_EQ(a.getPacketsSent(), N + M);
+    RecordProperty("median_latency_us", std::to_string(latencies[N / 2]));
+    RecordProperty("max_latency_us", std::to_string(latencies.back()));
+    RecordProperty("packets_per_second", std::to_string(packetsPerSecond));
+    RecordProperty("packets_lost", std::to_string(b.getPacketsLost()));
+}
@@ -0,0 +1,137 @@
+#include <MIDI_Interfaces/RTPMIDI/RTPMIDI_Journal.hpp>
+#include <MIDI_Parsers/MIDI_Parser.hpp>
+#include <gtest-wrapper.h>
+
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using u8vec = std::vector<uint8_t>;
+
+namespace {
+
+u8vec encode(const RTPMIDI_JournalSender &journal) {
+    u8vec buffer(2048);
+    buffer.resize(journal.encode(buffer.data(), buffer.size()));
+    return buffer;
+}
+
+u8vec recover(RTPMIDI_JournalReceiver &receiver, const u8vec &journal) {
+    u8vec buffer(2048);
+    buffer.resize(receiver.recover(journal.data(), journal.size(),
+                                   buffer.data(), buffer.size()));
+    return buffer;
+}
+
+} // namespace
+
+TEST(RTPMIDI_Journal, empty) {
+    RTPMIDI_JournalSender sender;
+    EXPECT_TRUE(sender.empty());
+    EXPECT_EQ(encode(sender), u8vec{});
+    sender.record({0xD0, 0x10, 0x00, 0}, 1); // Channel Pressure isn't journalled
+    EXPECT_TRUE(sender.empty());
+}
+
+TEST(RTPMIDI_Journal, encodeChapters) {
+    RTPMIDI_JournalSender sender;
+    sender.record({0xC2, 0x05, 0x00, 0}, 100);
+    sender.record({0xB2, 0x07, 0x64, 0}, 100);
+    sender.record({0xB2, 0x01, 0x10, 0}, 101);
+    sender.record({0xB2, 0x07, 0x65, 0}, 101);
+    sender.record({0xE2, 0x00, 0x40, 0}, 101);
+    sender.record({0x92, 0x3C, 0x7F, 0}, 102);
+    sender.record({0x92, 0x3E, 0x40, 0}, 102);
+    sender.record({0x82, 0x3E, 0x40, 0}, 102);
+    u8vec expected = {
+        0x20, 0x00, 0x64,       // A, 1 channel, checkpoint 100
+        0x10, 0x12, 0xD8,       // channel 2, length 18, chapters P C W N
+        0x05, 0x00, 0x00,       // P: program 5
+        0x01, 0x01, 0x10,       // C: 2 controllers, 1 = 0x10
+        0x07, 0x65,             //    7 = 0x65
+        0x00, 0x40,             // W: 0x2000
+        0x01, 0x77,             // N: 1 log, offbits 7 - 7
+        0x3C, 0xFF,             //    note 60 on, velocity 0x7F
+        0x02,                   //    note 62 off
+    };
+    EXPECT_EQ(encode(sender), expected);
+}
+
+TEST(RTPMIDI_Journal, acknowledge) {
+    RTPMIDI_JournalSender sender;
+    sender.record({0xB0, 0x07, 0x64, 0}, 0xFFFF);
+    sender.record({0xB1, 0x07, 0x64, 0}, 0x0001);
+    sender.acknowledge(0x0000); // wraps around
+    u8vec journal = encode(sender);
+    ASSERT_GE(journal.size(), 6u);
+    EXPECT_EQ(journal[0], 0x20); // only one channel left
+    EXPECT_EQ(journal[1], 0x00); // checkpoint 1
+    EXPECT_EQ(journal[2], 0x01);
+    EXPECT_EQ(journal[3] >> 3, 1); // channel 1
+    sender.acknowledge(0x0001);
+    EXPECT_TRUE(sender.empty());
+}
+
+TEST(RTPMIDI_Journal, recover) {
+    RTPMIDI_JournalSender sender;
+    RTPMIDI_JournalReceiver receiver;
+    // The receiver got the first packet
+    sender.record({0x90, 0x3C, 0x7F, 0}, 1);
+    sender.record({0x90, 0x3D, 0x7F, 0}, 1);
+    sender.record({0xB0, 0x07, 0x10, 0}, 1);
+    receiver.update({0x90, 0x3C, 0x7F, 0});
+    receiver.update({0x90, 0x3D, 0x7F, 0});
+    receiver.update({0xB0, 0x07, 0x10, 0});
+    // These were lost
+    sender.record({0x80, 0x3C, 0x40, 0}, 2);
+    sender.record({0x90, 0x3E, 0x50, 0}, 2);
+    sender.record({0xB0, 0x07, 0x20, 0}, 2);
+    sender.record({0xCF, 0x03, 0x00, 0}, 3);
+    sender.record({0xEF, 0x7F, 0x7F, 0}, 3);
+
+    u8vec expected = {
+        0xB0, 0x07, 0x20, // changed controller
+        0x90, 0x3E, 0x50, // note that was turned on
+        0x80, 0x3C, 0x40, // note that was turned off
+        0xCF, 0x03,       // program
+        0xEF, 0x7F, 0x7F, // pitch bend
+    };
+    EXPECT_EQ(recover(receiver, encode(sender)), expected);
+    EXPECT_EQ(receiver.getController(0, 0x07), 0x20);
+    EXPECT_EQ(receiver.getVelocity(0, 0x3C), 0x00);
+    EXPECT_EQ(receiver.getVelocity(0, 0x3D), 0x7F);
+    EXPECT_EQ(receiver.getVelocity(0, 0x3E), 0x50);
+    // The state is now up to date, nothing left to repair
+    EXPECT_EQ(recover(receiver, encode(sender)), u8vec{});
+}
+
+TEST(RTPMIDI_Journal, allNotesOn) {
+    RTPMIDI_JournalSender sender;
+    RTPMIDI_JournalReceiver receiver;
+    for (uint8_t note = 0; note < 128; ++note)
+        sender.record({0x93, note, 0x01, 0}, 1);
+    u8vec journal = encode(sender);
+    // N header: LEN = 127, LOW = 15, HIGH = 0 means 128 logs
+    EXPECT_EQ(journal[6], 127);
+    EXPECT_EQ(journal[7], 0xF0);
+    EXPECT_EQ(recover(receiver, journal).size(), 128u * 3);
+
+    sender.record({0x83, 0x00, 0x00, 0}, 2);
+    journal = encode(sender);
+    EXPECT_EQ(journal[6], 127);
+    EXPECT_EQ(journal[7], 0x00); // 127 logs, one octet of offbits
+    EXPECT_EQ(recover(receiver, journal), (u8vec{0x83, 0x00, 0x40}));
+}
+
+TEST(RTPMIDI_Journal, tooSmall) {
+    RTPMIDI_JournalSender sender;
+    for (uint8_t c = 0; c < 128; ++c)
+        sender.record({0xB0, c, c, 0}, 1);
+    u8vec buffer(64);
+    EXPECT_EQ(sender.encode(buffer.data(), buffer.size()), 0u);
+    // Truncated journals are ignored
+    RTPMIDI_JournalReceiver receiver;
+    u8vec journal = encode(sender);
+    journal.resize(journal.size() / 2);
+    EXPECT_EQ(recover(receiver, journal), u8vec{});
+}
@@ -0,0 +1,310 @@
+#include <MIDI_Interfaces/SharedMemoryMIDI_Interface.hpp>
+#include <MIDI_Parsers/SerialMIDI_Parser.hpp>
+#include <gtest-wrapper.h>
+
+#include <chrono>
+#include <fcntl.h>
+#include <string>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <termios.h>
+#include <unistd.h>
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using u8vec = std::vector<uint8_t>;
+
+namespace {
+
+/// Different names for each test process, because tests may run in parallel.
+std::string regionName() {
+    return "/cs-test-shm-" + std::to_string(getpid());
+}
+
+struct Recorder : MIDI_Callbacks {
+    void onChannelMessage(Parsing_MIDI_Interface &midi) override {
+        channel.push_back(midi.getChannelMessage());
+    }
+    void onSysExMessage(Parsing_MIDI_Interface &midi) override {
+        SysExMessage msg = midi.getSysExMessage();
+        sysex.push_back(u8vec(msg.data, msg.data + msg.length));
+        sysexCN.push_back(msg.CN);
+    }
+    void onRealtimeMessage(Parsing_MIDI_Interface &midi,
+                           uint8_t message) override {
+        realtime.push_back(message);
+        realtimeCN.push_back(midi.getCN());
+    }
+    std::vector<ChannelMessage> channel;
+    std::vector<u8vec> sysex;
+    u8vec sysexCN;
+    u8vec realtime;
+    u8vec realtimeCN;
+};
+
+/// Sends all incoming messages back, until it receives a Reset message.
+struct Echo : MIDI_Callbacks {
+    void onChannelMessage(Parsing_MIDI_Interface &midi) override {
+        midi.send(midi.getChannelMessage());
+    }
+    void onSysExMessage(Parsing_MIDI_Interface &midi) override {
+        midi.send(midi.getSysExMessage());
+    }
+    void onRealtimeMessage(Parsing_MIDI_Interface &, uint8_t message) override {
+        done |= message == 0xFF;
+    }
+    bool done = false;
+};
+
+using clock = std::chrono::steady_clock;
+
+double seconds(clock::duration d) {
+    return std::chrono::duration<double>(d).count();
+}
+
+} // namespace
+
+TEST(SharedMemoryMIDI_Interface, sendReceive) {
+    std::string name = regionName();
+    SharedMemoryMIDI_Interface server {name.c_str(),
+                                       SharedMemoryMIDI_Interface::Server};
+    SharedMemoryMIDI_Interface client {name.c_str(),
+                                       SharedMemoryMIDI_Interface::Client};
+    Recorder recServer, recClient;
+    server.setCallbacks(recServer);
+    client.setCallbacks(recClient);
+    server.begin();
+    client.begin();
+    ASSERT_TRUE(server.isOpen());
+    ASSERT_TRUE(client.isOpen());
+
+    server.sendNoteOn({0x3C, CHANNEL_2, 3}, 0x7F);
+    server.sendPC({CHANNEL_4, 5}, 0x12);
+    server.sendPB({CHANNEL_16, 15}, 0x3FFF);
+    uint8_t sysex[] = {0xF0, 0x01, 0x02, 0x03, 0xF7};
+    server.send(SysExMessage {sysex, sizeof(sysex), 7});
+    server.sendOnCable(0xF8, 9);
+    client.update();
+
+    std::vector<ChannelMessage> expected = {
+        {0x91, 0x3C, 0x7F, 3},
+        {0xC3, 0x12, 0x00, 5},
+        {0xEF, 0x7F, 0x7F, 15},
+    };
+    EXPECT_EQ(recClient.channel, expected);
+    ASSERT_EQ(recClient.sysex.size(), 1u);
+    EXPECT_EQ(recClient.sysex[0], u8vec(std::begin(sysex), std::end(sysex)));
+    EXPECT_EQ(recClient.sysexCN, u8vec{7});
+    EXPECT_EQ(recClient.realtime, u8vec{0xF8});
+    EXPECT_EQ(recClient.realtimeCN, u8vec{9});
+    EXPECT_TRUE(recServer.channel.empty());
+
+    client.sendCC({0x07, CHANNEL_1}, 0x10);
+    EXPECT_TRUE(server.wait(1000000));
+    server.update();
+    EXPECT_EQ(recServer.channel,
+              (std::vector<ChannelMessage>{{0xB0, 0x07, 0x10, 0}}));
+    EXPECT_EQ(server.getDroppedMessages(), 0u);
+}
+
+TEST(SharedMemoryMIDI_Interface, clientBeforeServer) {
+    std::string name = regionName();
+    SharedMemoryMIDI_Interface client {name.c_str(),
+                                       SharedMemoryMIDI_Interface::Client};
+    Recorder recClient;
+    client.setCallbacks(recClient);
+    client.begin();
+    EXPECT_FALSE(client.isOpen());
+    client.sendCC({0x07, CHANNEL_1}, 0x10);
+    EXPECT_EQ(client.getDroppedMessages(), 1u);
+    {
+        SharedMemoryMIDI_Interface server {name.c_str(),
+                                           SharedMemoryMIDI_Interface::Server};
+        server.begin();
+        client.update(); // Connects
+        EXPECT_TRUE(client.isOpen());
+        server.sendCC({0x07, CHANNEL_1}, 0x11);
+        client.update();
+        ASSERT_EQ(recClient.channel.size(), 1u);
+    }
+    // The server removes the region when it's destroyed
+    EXPECT_EQ(shm_open(name.c_str(), O_RDWR, 0), -1);
+}
+
+TEST(SharedMemoryMIDI_Interface, full) {
+    std::string name = regionName();
+    SharedMemoryMIDI_Interface server {name.c_str(),
+                                       SharedMemoryMIDI_Interface::Server, 64};
+    SharedMemoryMIDI_Interface client {name.c_str(),
+                                       SharedMemoryMIDI_Interface::Client};
+    Recorder recClient;
+    client.setCallbacks(recClient);
+    server.begin();
+    client.begin();
+    // Each channel message takes up 8 bytes
+    for (uint8_t i = 0; i < 10; ++i)
+        server.sendCC({0x07, CHANNEL_1}, i);
+    EXPECT_EQ(server.getDroppedMessages(), 2u);
+    client.update();
+    ASSERT_EQ(recClient.channel.size(), 8u);
+    EXPECT_EQ(recClient.channel.back().data2, 7);
+    server.sendCC({0x07, CHANNEL_1}, 10);
+    client.update();
+    EXPECT_EQ(recClient.channel.back().data2, 10);
+}
+
+/// Round-trip latency and throughput between two processes, compared to
+/// sending the same messages over a pseudo-terminal.
+TEST(SharedMemoryMIDI_Interface, twoProcessBenchmark) {
+    constexpr unsigned LatencyCount = 2000;
+    constexpr unsigned ThroughputCount = 50000;
+    constexpr unsigned Window = 256; // messages in flight
+
+    auto message = [](unsigned i) {
+        return ChannelMessage {uint8_t(0xB0 | (i % 16)), uint8_t((i >> 4) % 128),
+                               uint8_t(i % 128), 0};
+    };
+
+    // ---------------------------- Shared memory ---------------------------- //
+    std::string name = regionName();
+    SharedMemoryMIDI_Interface server {name.c_str(),
+                                       SharedMemoryMIDI_Interface::Server};
+    server.begin();
+    ASSERT_TRUE(server.isOpen());
+    pid_t child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        SharedMemoryMIDI_Interface client {name.c_str(),
+                                           SharedMemoryMIDI_Interface::Client};
+        Echo echo;
+        client.setCallbacks(echo);
+        client.begin();
+        while (!echo.done) {
+            client.wait(100000);
+            client.update();
+        }
+        _exit(client.getDroppedMessages() == 0 ? 0 : 1);
+    }
+
+    Recorder rec;
+    server.setCallbacks(rec);
+    auto receive = [&](size_t count) {
+        auto timeout = clock::now() + std::chrono::seconds(10);
+        while (rec.channel.size() < count && clock::now() < timeout)
+            if (server.wait(100000))
+                server.update();
+        return rec.channel.size() == count;
+    };
+
+    auto start = clock::now();
+    for (unsigned i = 0; i < LatencyCount; ++i) {
+        server.send(message(i));
+        ASSERT_TRUE(receive(i + 1));
+    }
+    double shmLatency = seconds(clock::now() - start) / LatencyCount;
+
+    rec.channel.clear();
+    start = clock::now();
+    for (unsigned i = 0; i < ThroughputCount; i += Window) {
+        for (unsigned j = i; j < i + Window; ++j)
+            server.send(message(j));
+        ASSERT_TRUE(receive(i + Window));
+    }
+    double shmThroughput = ThroughputCount / seconds(clock::now() - start);
+    for (unsigned i = 0; i < ThroughputCount; i += 997)
+        ASSERT_EQ(rec.channel[i], message(i));
+
+    server.send(uint8_t(0xFF));
+    int status;
+    waitpid(child, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    EXPECT_EQ(server.getDroppedMessages(), 0u);
+
+    // --------------------------------- PTY --------------------------------- //
+    int master = posix_openpt(O_RDWR | O_NOCTTY);
+    ASSERT_GE(master, 0);
+    ASSERT_EQ(grantpt(master), 0);
+    ASSERT_EQ(unlockpt(master), 0);
+    int slave = open(ptsname(master), O_RDWR | O_NOCTTY);
+    ASSERT_GE(slave, 0);
+    termios tio;
+    tcgetattr(slave, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(slave, TCSANOW, &tio);
+
+    child = fork();
+    ASSERT_GE(child, 0);
+    if (child == 0) {
+        close(master);
+        SerialMIDI_Parser parser;
+        uint8_t buffer[256];
+        while (true) {
+            ssize_t length = read(slave, buffer, sizeof(buffer));
+            if (length <= 0)
+                _exit(1);
+            for (ssize_t i = 0; i < length; ++i) {
+                MIDI_read_t event = parser.parse(buffer[i]);
+                if (event == 0xFF)
+                    _exit(0);
+                if (event != CHANNEL_MESSAGE)
+                    continue;
+                ChannelMessage msg = parser.getChannelMessage();
+                uint8_t out[3] = {msg.header, msg.data1, msg.data2};
+                if (write(slave, out, 3) != 3)
+                    _exit(1);
+            }
+        }
+    }
+    close(slave);
+
+    SerialMIDI_Parser parser;
+    std::vector<ChannelMessage> received;
+    auto send = [&](ChannelMessage msg) {
+        uint8_t out[3] = {msg.header, msg.data1, msg.data2};
+        return write(master, out, 3) == 3;
+    };
+    auto receivePty = [&](size_t count) {
+        uint8_t buffer[1024];
+        while (received.size() < count) {
+            ssize_t length = read(master, buffer, sizeof(buffer));
+            if (length <= 0)
+                return false;
+            for (ssize_t i = 0; i < length; ++i)
+                if (parser.parse(buffer[i]) == CHANNEL_MESSAGE)
+                    received.push_back(parser.getChannelMessage());
+        }
+        return received.size() == count;
+    };
+
+    start = clock::now();
+    for (unsigned i = 0; i < LatencyCount; ++i) {
+        ASSERT_TRUE(send(message(i)));
+        ASSERT_TRUE(receivePty(i + 1));
+    }
+    double ptyLatency = seconds(clock::now() - start) / LatencyCount;
+
+    received.clear();
+    start = clock::now();
+    for (unsigned i = 0; i < ThroughputCount; i += Window) {
+        for (unsigned j = i; j < i + Window; ++j)
+            ASSERT_TRUE(send(message(j)));
+        ASSERT_TRUE(receivePty(i + Window));
+    }
+    double ptyThroughput = ThroughputCount / seconds(clock::now() - start);
+    for (unsigned i = 0; i < ThroughputCount; i += 997)
+        ASSERT_EQ(received[i], message(i));
+
+    uint8_t reset = 0xFF;
+    EXPECT_EQ(write(master, &reset, 1), 1);
+    waitpid(child, &status, 0);
+    EXPECT_TRUE(WIFEXITED(status) && WEXITSTATUS(status) == 0);
+    close(master);
+
+    auto us = [](double s) { return std::to_string(s * 1e6); };
+    auto mps = [](double t) { return std::to_string(unsigned(t)); };
+    RecordProperty("shm_round_trip_us", us(shmLatency));
+    RecordProperty("pty_round_trip_us", us(ptyLatency));
+    RecordProperty("shm_messages_per_second", mps(shmThroughput));
+    RecordProperty("pty_messages_per_second", mps(ptyThroughput));
+}
@@ -0,0 +1,105 @@
+#include <MIDI_Interfaces/SharedMemory/SharedMemoryRing.hpp>
+#include <gtest-wrapper.h>
+
+#include <vector>
+
+USING_CS_NAMESPACE;
+
+using u8vec = std::vector<uint8_t>;
+
+namespace {
+
+struct alignas(64) Memory {
+    uint8_t data[sizeof(SharedMemoryRing::Header) + 64];
+};
+
+u8vec pop(SharedMemoryRing &ring) {
+    auto record = ring.peek();
+    if (record == nullptr)
+        return {};
+    u8vec result(record->data(), record->data() + record->length);
+    ring.pop();
+    return result;
+}
+
+} // namespace
+
+TEST(SharedMemoryRing, writeRead) {
+    Memory memory;
+    SharedMemoryRing::initialize(memory.data, 64);
+    SharedMemoryRing producer {memory.data}, consumer {memory.data};
+    EXPECT_TRUE(consumer.empty());
+    EXPECT_EQ(consumer.peek(), nullptr);
+
+    uint8_t a[] = {1, 2, 3};
+    uint8_t b[] = {4, 5, 6, 7, 8};
+    EXPECT_TRUE(producer.write(1, 2, a, sizeof(a)));
+    EXPECT_TRUE(producer.write(3, 4, b, sizeof(b)));
+    EXPECT_FALSE(consumer.empty());
+
+    auto record = consumer.peek();
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->type, 1);
+    EXPECT_EQ(record->cable, 2);
+    EXPECT_EQ(consumer.peek(), record); // peek doesn't consume
+    consumer.pop();
+    record = consumer.peek();
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(record->type, 3);
+    EXPECT_EQ(record->cable, 4);
+    EXPECT_EQ(pop(consumer), u8vec(b, b + sizeof(b)));
+    EXPECT_TRUE(consumer.empty());
+}
+
+TEST(SharedMemoryRing, fullAndWrapAround) {
+    Memory memory;
+    SharedMemoryRing::initialize(memory.data, 64);
+    SharedMemoryRing ring {memory.data};
+
+    // Records of 4 + 10 bytes take up 16 bytes, four of them fill the ring
+    u8vec data(10);
+    for (uint8_t i = 0; i < 4; ++i) {
+        data[0] = i;
+        EXPECT_TRUE(ring.write(0, 0, data.data(), data.size()));
+    }
+    EXPECT_FALSE(ring.write(0, 0, data.data(), 1));
+    for (uint8_t i = 0; i < 4; ++i)
+        EXPECT_EQ(pop(ring)[0], i);
+    EXPECT_TRUE(ring.empty());
+
+    for (uint8_t i = 0; i < 3; ++i) {
+        data[0] = i;
+        EXPECT_TRUE(ring.write(0, 0, data.data(), data.size()));
+    }
+    EXPECT_EQ(pop(ring)[0], 0);
+    // 32 bytes free, but only 16 before the end of the buffer and 16 at the
+    // start: a record of 24 bytes doesn't fit
+    u8vec large(20, 0xAB);
+    EXPECT_FALSE(ring.write(0, 0, large.data(), large.size()));
+    EXPECT_EQ(pop(ring)[0], 1);
+    // Now the 16 bytes at the end are padding, and the record wraps around
+    EXPECT_TRUE(ring.write(0, 0, large.data(), large.size()));
+    EXPECT_EQ(pop(ring)[0], 2);
+    EXPECT_EQ(pop(ring), large);
+    EXPECT_TRUE(ring.empty());
+
+    // Many more records to wrap around multiple times
+    for (uint8_t i = 0; i < 100; ++i) {
+        u8vec msg(i % 13, i);
+        ASSERT_TRUE(ring.write(i, 0, msg.data(), msg.size()));
+        auto record = ring.peek();
+        ASSERT_NE(record, nullptr);
+        EXPECT_EQ(record->type, i);
+        EXPECT_EQ(pop(ring), msg);
+    }
+}
+
+TEST(SharedMemoryRing, waitTimeout) {
+    Memory memory;
+    SharedMemoryRing::initialize(memory.data, 64);
+    SharedMemoryRing ring {memory.data};
+    EXPECT_FALSE(ring.wait(1000));
+    uint8_t data = 0;
+    ring.write(0, 0, &data, 1);
+    EXPECT_TRUE(ring.wait(1000000));
+}
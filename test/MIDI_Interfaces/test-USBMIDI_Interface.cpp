@@ -21,6 +21,12 @@ TEST(USBMIDI_Interface, send2B) {
     midi.sendPC({CHANNEL_4, 8}, 0x66);
 }
 
+TEST(USBMIDI_Interface, MTCQuarterFrame) {
+    StrictMock<USBMIDI_Interface> midi;
+    EXPECT_CALL(midi, writeUSBPacket(8, 0x2, 0xF1, 0x35, 0x00));
+    midi.send(ChannelMessage{0xF1, 0x35, 0x00, 8});
+}
+
 TEST(USBMIDI_Interface, RealTime) {
     StrictMock<USBMIDI_Interface> midi;
     Sequence seq;
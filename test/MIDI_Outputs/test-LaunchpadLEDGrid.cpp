@@ -0,0 +1,250 @@
+#include <MIDI_Outputs/LaunchpadLEDGrid.hpp>
+#include <MockMIDI_Interface.hpp>
+#include <gmock-wrapper.h>
+
+#include <Control_Surface/Control_Surface_Class.hpp>
+
+#include <string>
+#include <vector>
+
+USING_CS_NAMESPACE;
+using namespace ::testing;
+
+namespace {
+
+using Bytes = std::vector<uint8_t>;
+
+/// Appends the SysEx messages that are sent to the given list.
+auto appendSysEx(std::vector<Bytes> &messages) {
+    return [&messages](const uint8_t *data, size_t length, uint8_t) {
+        messages.emplace_back(data, data + length);
+    };
+}
+
+} // namespace
+
+TEST(LaunchpadLEDGrid, fewChangesUseNotes) {
+    StrictMock<MockMIDI_Interface> midi;
+    Control_Surface.connectDefaultMIDI_Interface();
+    LaunchpadLEDGrid<> grid = {{CHANNEL_3, 2}};
+
+    // Initially, the colors of all pads are unknown
+    EXPECT_EQ(grid.getNumChanges(), 64);
+    EXPECT_CALL(midi, sendImpl(_, _, 2)).Times(3);
+    EXPECT_EQ(grid.sendChanges(), 3 * (2 + 6) + 64 * 2);
+    Mock::VerifyAndClear(&midi);
+
+    grid.setColor(0, 0, 5);
+    grid.setColor(7, 7, 3);
+    grid.setColor(2, 3, 0); // unchanged
+    EXPECT_EQ(grid.getNumChanges(), 2);
+    InSequence seq;
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 2, 11, 5, 2));
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 2, 88, 3, 2));
+    EXPECT_EQ(grid.sendChanges(), 6);
+    EXPECT_EQ(grid.getColor(7, 7), 3);
+
+    // Nothing changed
+    EXPECT_EQ(grid.sendChanges(), 0);
+    grid.update();
+}
+
+TEST(LaunchpadLEDGrid, manyChangesUseSysEx) {
+    StrictMock<MockMIDI_Interface> midi;
+    Control_Surface.connectDefaultMIDI_Interface();
+    LaunchpadLEDGrid<3, 3> grid;
+    grid.fill(0);
+    EXPECT_CALL(midi, sendImpl(_, _, 0));
+    grid.sendChanges();
+    Mock::VerifyAndClear(&midi);
+
+    // Eight pads are cheaper as notes (24 < 8 + 16 bytes)
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 0, _, 1, 0)).Times(8);
+    for (uint8_t i = 0; i < 8; ++i)
+        grid.setColor(i / 3, i % 3, 1);
+    EXPECT_EQ(grid.sendChanges(), 24);
+    Mock::VerifyAndClear(&midi);
+
+    // Nine pads are cheaper as SysEx (26 < 27 bytes)
+    std::vector<Bytes> messages;
+    EXPECT_CALL(midi, sendImpl(_, _, 0))
+        .WillOnce(Invoke(appendSysEx(messages)));
+    grid.fill(0x45);
+    EXPECT_EQ(grid.sendChanges(), 26);
+    Bytes expected = {
+        0xF0, 0x00, 0x20, 0x29, 0x02, 0x18, 0x0A, // header
+        11,   0x45, 12,   0x45, 13,   0x45,       // row 0
+        21,   0x45, 22,   0x45, 23,   0x45,       // row 1
+        31,   0x45, 32,   0x45, 33,   0x45,       // row 2
+        0xF7,
+    };
+    ASSERT_EQ(messages.size(), 1u);
+    EXPECT_EQ(messages[0], expected);
+}
+
+TEST(LaunchpadLEDGrid, splitSysEx) {
+    StrictMock<MockMIDI_Interface> midi;
+    Control_Surface.connectDefaultMIDI_Interface();
+    LaunchpadLEDGrid<9, 9> grid;
+    grid.setLayout([](uint8_t row, uint8_t col) -> uint8_t {
+        return 9 * row + col;
+    });
+
+    std::vector<Bytes> messages;
+    EXPECT_CALL(midi, sendImpl(_, _, 0))
+        .WillRepeatedly(Invoke(appendSysEx(messages)));
+    for (uint8_t i = 0; i < 81; ++i)
+        grid.setColor(i / 9, i % 9, i);
+    EXPECT_EQ(grid.getSysExCost(81), 3 * (2 + 6) + 81 * 2);
+    EXPECT_EQ(grid.sendChanges(), 3 * (2 + 6) + 81 * 2);
+
+    // 28 pads per message: 28, 28, 25
+    ASSERT_EQ(messages.size(), 3u);
+    uint8_t led = 0;
+    for (const Bytes &msg : messages) {
+        size_t maxSize = LaunchpadLEDGrid_Base::SysExBufferSize;
+        EXPECT_LE(msg.size(), maxSize);
+        Bytes header = {0xF0, 0x00, 0x20, 0x29, 0x02, 0x18, 0x0A};
+        EXPECT_EQ(Bytes(msg.begin(), msg.begin() + 7), header);
+        EXPECT_EQ(msg.back(), 0xF7);
+        for (size_t i = 7; i + 1 < msg.size(); i += 2, ++led) {
+            EXPECT_EQ(msg[i + 0], led);
+            EXPECT_EQ(msg[i + 1], led);
+        }
+    }
+    EXPECT_EQ(led, 81);
+    EXPECT_EQ(grid.getNumChanges(), 0);
+}
+
+TEST(LaunchpadLEDGrid, lightingTypePrefix) {
+    StrictMock<MockMIDI_Interface> midi;
+    Control_Surface.connectDefaultMIDI_Interface();
+    LaunchpadLEDGrid<9, 9> grid = {CHANNEL_1, LaunchpadSysExFormat::X};
+
+    // 18 pads per message, three bytes per pad
+    EXPECT_EQ(grid.getSysExCost(18), 2 + 6 + 18 * 3);
+    EXPECT_EQ(grid.getSysExCost(81), 5 * (2 + 6) + 81 * 3);
+    // Notes take fewer bytes than the palette SysEx message of the Launchpad X
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 0, _, 0, 0)).Times(81);
+    EXPECT_EQ(grid.sendChanges(), 81 * 3);
+}
+
+TEST(LaunchpadLEDGrid, invalidate) {
+    StrictMock<MockMIDI_Interface> midi;
+    Control_Surface.connectDefaultMIDI_Interface();
+    LaunchpadLEDGrid<1, 2> grid;
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 0, 11, 0, 0));
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 0, 12, 0, 0));
+    grid.update();
+    Mock::VerifyAndClear(&midi);
+
+    // E.g. the Launchpad was reconnected
+    grid.begin();
+    EXPECT_EQ(grid.getNumChanges(), 2);
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 0, 11, 0, 0));
+    EXPECT_CALL(midi, sendImpl(NOTE_ON, 0, 12, 0, 0));
+    grid.update();
+}
+
+namespace {
+
+/// Interface that only counts the bytes of the messages it sends.
+class ByteCountingMIDI_Interface : public MIDI_Interface {
+  public:
+    void update() override {}
+    void setCallbacks(MIDI_Callbacks *) override {}
+
+    void sendImpl(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) override {
+        bytes += 3;
+        ++messages;
+    }
+    void sendImpl(uint8_t, uint8_t, uint8_t, uint8_t) override {
+        bytes += 2;
+        ++messages;
+    }
+    void sendImpl(const uint8_t *, size_t length, uint8_t) override {
+        bytes += length;
+        ++messages;
+    }
+    void sendImpl(uint8_t, uint8_t) override {
+        bytes += 1;
+        ++messages;
+    }
+
+    unsigned bytes = 0, messages = 0;
+};
+
+} // namespace
+
+// Counts the bytes that are sent to an 8×8 Launchpad for typical scene
+// changes, compared to sending a Note On message for every pad.
+TEST(LaunchpadLEDGrid, benchmarkSceneChanges) {
+    ByteCountingMIDI_Interface midi;
+    Control_Surface.connectDefaultMIDI_Interface();
+    LaunchpadLEDGrid<> grid;
+    grid.fill(0);
+    grid.sendChanges();
+
+    // Each scene sets the colors of the pads, the n-th time it is applied.
+    struct Scene {
+        const char *name;
+        void (*apply)(LaunchpadLEDGrid_Base &grid, uint8_t n);
+    };
+    const Scene scenes[] = {
+        // Blink the playing clip
+        {"blink",
+         [](LaunchpadLEDGrid_Base &g, uint8_t n) {
+             g.setColor(3, 4, n % 2 ? 0 : 21);
+         }},
+        // Launch a scene: one row starts playing, the previous one stops
+        {"scene_launch",
+         [](LaunchpadLEDGrid_Base &g, uint8_t n) {
+             for (uint8_t c = 0; c < 8; ++c) {
+                 g.setColor(n % 8, c, 21);
+                 g.setColor((n + 7) % 8, c, 5);
+             }
+         }},
+        // Stop a track: one column stops, the previous one plays
+        {"track_stop",
+         [](LaunchpadLEDGrid_Base &g, uint8_t n) {
+             for (uint8_t r = 0; r < 8; ++r) {
+                 g.setColor(r, n % 8, 5);
+                 g.setColor(r, (n + 7) % 8, 21);
+             }
+         }},
+        // Bank to the next eight tracks: half of the clip slots are filled
+        {"bank_change",
+         [](LaunchpadLEDGrid_Base &g, uint8_t n) {
+             for (uint8_t r = 0; r < 8; ++r)
+                 for (uint8_t c = 0; c < 8; ++c)
+                     g.setColor(r, c, (r + c + n) % 2 ? 0 : 37 + n % 8);
+         }},
+        // Switch to a full-grid mode, e.g. a drum rack or a mixer
+        {"mode_change",
+         [](LaunchpadLEDGrid_Base &g, uint8_t n) {
+             g.fill(n % 2 ? 45 : 9);
+         }},
+    };
+
+    constexpr unsigned Repeat = 100;
+    for (const Scene &scene : scenes) {
+        midi.bytes = midi.messages = 0;
+        unsigned changes = 0;
+        for (unsigned n = 0; n < Repeat; ++n) {
+            scene.apply(grid, n);
+            changes += grid.getNumChanges();
+            grid.sendChanges();
+        }
+        EXPECT_EQ(grid.getNumChanges(), 0);
+        EXPECT_LE(midi.bytes, LaunchpadLEDGrid_Base::getNoteCost(changes));
+        std::string name = scene.name;
+        RecordProperty(name + "_pads", std::to_string(changes / Repeat));
+        RecordProperty(name + "_bytes", std::to_string(midi.bytes / Repeat));
+        RecordProperty(name + "_messages",
+                       std::to_string(midi.messages / Repeat));
+        RecordProperty(name + "_note_bytes",
+                       std::to_string(3 * changes / Repeat));
+    }
+    RecordProperty("all_pads_note_bytes",
+                   std::to_string(LaunchpadLEDGrid_Base::getNoteCost(64)));
+}
@@ -1,6 +1,7 @@
 #include <MIDI_Outputs/Bankable/NoteButton.hpp>
 #include <MIDI_Outputs/Bankable/NoteButtons.hpp>
 #include <MIDI_Outputs/NoteButton.hpp>
+#include <MIDI_Outputs/NoteButtonBank.hpp>
 #include <MIDI_Outputs/NoteButtons.hpp>
 #include <MockMIDI_Interface.hpp>
 #include <gmock-wrapper.h>
@@ -181,4 +182,56 @@ TEST(NoteButtonBankable, pressAndChangeSettingAndRelease) {
     button.update();
 
     Mock::VerifyAndClear(&ArduinoMock::getInstance());
-}
\ No newline at end of file
+}
+
+// -------------------------------------------------------------------------- //
+
+TEST(NoteButtonBank, pressAndRelease) {
+    StrictMock<MockMIDI_Interface> midi;
+    Control_Surface.connectDefaultMIDI_Interface();
+
+    NoteButtonBank<3> buttons({2, 3, 4}, {0x3C, CHANNEL_7, 0xC}, 2);
+    EXPECT_CALL(ArduinoMock::getInstance(), pinMode(2, INPUT_PULLUP));
+    EXPECT_CALL(ArduinoMock::getInstance(), pinMode(3, INPUT_PULLUP));
+    EXPECT_CALL(ArduinoMock::getInstance(), pinMode(4, INPUT_PULLUP));
+    buttons.begin();
+
+    auto read = [](int a, int b, int c, unsigned long now) {
+        EXPECT_CALL(ArduinoMock::getInstance(), digitalRead(2))
+            .WillOnce(Return(a));
+        EXPECT_CALL(ArduinoMock::getInstance(), digitalRead(3))
+            .WillOnce(Return(b));
+        EXPECT_CALL(ArduinoMock::getInstance(), digitalRead(4))
+            .WillOnce(Return(c));
+        EXPECT_CALL(ArduinoMock::getInstance(), millis())
+            .WillOnce(Return(now));
+    };
+
+    // Still released
+    read(HIGH, HIGH, HIGH, 1000);
+    buttons.update();
+
+    // Pressing two buttons at once
+    read(HIGH, LOW, LOW, 1001);
+    {
+        InSequence seq;
+        EXPECT_CALL(midi, sendImpl(NOTE_ON, 6, 0x3C + 2, 0x7F, 0xC));
+        EXPECT_CALL(midi, sendImpl(NOTE_ON, 6, 0x3C + 4, 0x7F, 0xC));
+    }
+    buttons.update();
+    EXPECT_EQ(buttons.getButtonState(1), AH::Button::Falling);
+
+    // Bouncing
+    read(HIGH, HIGH, LOW, 1002);
+    buttons.update();
+    EXPECT_EQ(buttons.getButtonState(1), AH::Button::Pressed);
+
+    // Releasing
+    read(HIGH, HIGH, LOW, 2000);
+    EXPECT_CALL(midi, sendImpl(NOTE_OFF, 6, 0x3C + 2, 0x7F, 0xC));
+    buttons.update();
+    EXPECT_EQ(buttons.getButtonState(1), AH::Button::Rising);
+    EXPECT_EQ(buttons.getButtonState(2), AH::Button::Pressed);
+
+    Mock::VerifyAndClear(&ArduinoMock::getInstance());
+}
@@ -140,6 +140,16 @@ TEST(USBMIDIParser, Realtime) {
     EXPECT_EQ(uparser.parse(packet), 0xF8);
 }
 
+TEST(USBMIDIParser, MTCQuarterFrame) {
+    USBMIDI_Parser uparser;
+    uint8_t packet[4] = {0x32, 0xF1, 0x35, 0x00};
+    EXPECT_EQ(uparser.parse(packet), CHANNEL_MESSAGE);
+    ChannelMessage msg = uparser.getChannelMessage();
+    EXPECT_EQ(msg.header, 0xF1);
+    EXPECT_EQ(msg.data1, 0x35);
+    EXPECT_EQ(msg.CN, 0x03);
+}
+
 TEST(USBMIDIParser, sysExContinueWithoutStarting) {
     USBMIDI_Parser uparser;
     uint8_t packet[4] = {0x07, 0x33, 0x34, 0xF7};
@@ -271,6 +281,17 @@ TEST(SerialMIDIParser, pitchBend) {
     EXPECT_EQ(msg.data2, 0x66);
 }
 
+TEST(SerialMIDIParser, pitchBendChannel16) {
+    SerialMIDI_Parser sparser;
+    EXPECT_EQ(sparser.parse(0xEF), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0x55), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0x66), CHANNEL_MESSAGE);
+    ChannelMessage msg = sparser.getChannelMessage();
+    EXPECT_EQ(msg.header, 0xEF);
+    EXPECT_EQ(msg.data1, 0x55);
+    EXPECT_EQ(msg.data2, 0x66);
+}
+
 TEST(SerialMIDIParser, sysEx2Bytes) {
     SerialMIDI_Parser sparser;
     EXPECT_EQ(sparser.parse(0xF0), NO_MESSAGE);
@@ -377,6 +398,34 @@ TEST(SerialMIDIParser, RealTime) {
     EXPECT_EQ(sparser.parse(0xF8), 0xF8); //
 }
 
+TEST(SerialMIDIParser, MTCQuarterFrame) {
+    SerialMIDI_Parser sparser;
+    EXPECT_EQ(sparser.parse(0x92), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0x20), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0xF1), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0x71), CHANNEL_MESSAGE);
+    ChannelMessage msg = sparser.getChannelMessage();
+    EXPECT_EQ(msg.header, 0xF1);
+    EXPECT_EQ(msg.data1, 0x71);
+    EXPECT_EQ(msg.data2, 0x00);
+}
+
+TEST(SerialMIDIParser, MTCQuarterFrameNoRunningStatus) {
+    SerialMIDI_Parser sparser;
+    EXPECT_EQ(sparser.parse(0xF1), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0x12), CHANNEL_MESSAGE);
+    // Stray data bytes are not more Quarter Frames
+    EXPECT_EQ(sparser.parse(0x34), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0xF8), 0xF8);
+    EXPECT_EQ(sparser.parse(0x56), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0xF1), NO_MESSAGE);
+    EXPECT_EQ(sparser.parse(0xF8), 0xF8);
+    EXPECT_EQ(sparser.parse(0x78), CHANNEL_MESSAGE);
+    ChannelMessage msg = sparser.getChannelMessage();
+    EXPECT_EQ(msg.header, 0xF1);
+    EXPECT_EQ(msg.data1, 0x78);
+}
+
 TEST(SerialMIDIParser, noteOffInterruptedByRealTime) {
     SerialMIDI_Parser sparser;
     EXPECT_EQ(sparser.parse(0x82), NO_MESSAGE);